@@ -0,0 +1,43 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+// Keep the compiler from optimizing away the computation of `value`
+template <class T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Read positional argument `index` as a number, or `fallback` if it wasn't given
+inline size_t bench_arg(int argc, char** argv, int index, size_t fallback) {
+    return index < argc ? std::strtoull(argv[index], nullptr, 10) : fallback;
+}
+
+// Time `func` over `repetitions` runs and print the best run
+//
+// If `bytes` is non-zero, throughput is reported in MB/s. If `items` is non-zero, throughput is reported in
+// millions of items per second. Returns the best run in milliseconds
+template <class Func>
+double run_benchmark(const char* name, int repetitions, Func&& func, size_t bytes = 0, size_t items = 0) {
+    double best = 0;
+    for (int i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+
+        double duration = std::chrono::duration<double, std::milli>(end - start).count();
+        if (i == 0 || duration < best) best = duration;
+    }
+
+    std::cout << "BENCHMARK: " << name << "\n    best of " << repetitions << ": " << best << " ms";
+    if (bytes) std::cout << " (" << bytes / (best * 1000.0) << " MB/s)";
+    if (items) std::cout << " (" << items / (best * 1000.0) << " M items/s)";
+    std::cout << std::endl;
+    return best;
+}
+
+#endif   // BENCHMARK_H
@@ -0,0 +1,121 @@
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#include "benchmark.h"
+#include "concurrent_queue.h"
+#include "forward_list.h"
+#include "vector.h"
+
+namespace {
+
+// Mutex and condition variable around a linked list, allocating per item
+class locked_queue {
+public:
+    void push(uint64_t value) {
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _items.emplace_back(value);
+        }
+        _ready.notify_one();
+    }
+
+    uint64_t pop() {
+        std::unique_lock<std::mutex> lock(_lock);
+        _ready.wait(lock, [this]() { return !_items.empty(); });
+        uint64_t value = _items.front();
+        _items.pop_front();
+        return value;
+    }
+
+private:
+    std::mutex _lock;
+    std::condition_variable _ready;
+    ndash::forward_list<uint64_t> _items;
+};
+
+// Time `num_items` handed from one producer thread to one consumer thread
+template <class Produce, class Consume>
+void handoff(const char* name, size_t num_items, Produce produce, Consume consume) {
+    run_benchmark(name, 3, [&]() {
+        uint64_t sum = 0;
+        std::thread consumer([&]() { sum = consume(); });
+        produce();
+        consumer.join();
+        do_not_optimize(sum);
+    }, 0, num_items);
+}
+
+}   // namespace
+
+// Stage handoff between a producer and a consumer thread: a locked linked list against the lock-free queues, item by
+// item and in batches
+//
+// Usage: bench_concurrent_queue [num_items] [batch_size]
+int main(int argc, char** argv) {
+    size_t n = bench_arg(argc, argv, 1, 2000000);
+    size_t batch = bench_arg(argc, argv, 2, 64);
+
+    locked_queue locked;
+    handoff("locked_forward_list", n, [&]() {
+        for (size_t i = 0; i < n; ++i) locked.push(i);
+    }, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; ++i) sum += locked.pop();
+        return sum;
+    });
+
+    ndash::mpmc_queue<uint64_t> mpmc(1024);
+    handoff("mpmc_queue", n, [&]() {
+        for (size_t i = 0; i < n; ++i) mpmc.push(i);
+    }, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; ++i) sum += mpmc.pop();
+        return sum;
+    });
+
+    ndash::spsc_ring<uint64_t> spsc(1024);
+    handoff("spsc_ring", n, [&]() {
+        for (size_t i = 0; i < n; ++i) spsc.push(i);
+    }, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; ++i) sum += spsc.pop();
+        return sum;
+    });
+
+    ndash::vector<uint64_t> in(batch), out(batch);
+    handoff("mpmc_queue_batch", n, [&]() {
+        for (size_t i = 0; i < n; i += batch) {
+            size_t count = n - i < batch ? n - i : batch;
+            for (size_t j = 0; j < count; ++j) in[j] = i + j;
+            mpmc.push_batch(in.data(), count);
+        }
+    }, [&]() {
+        uint64_t sum = 0;
+        for (size_t received = 0; received < n;) {
+            size_t count = mpmc.pop_batch(out.data(), batch);
+            for (size_t j = 0; j < count; ++j) sum += out[j];
+            received += count;
+        }
+        return sum;
+    });
+
+    ndash::vector<uint64_t> spsc_in(batch), spsc_out(batch);
+    handoff("spsc_ring_batch", n, [&]() {
+        for (size_t i = 0; i < n; i += batch) {
+            size_t count = n - i < batch ? n - i : batch;
+            for (size_t j = 0; j < count; ++j) spsc_in[j] = i + j;
+            spsc.push_batch(spsc_in.data(), count);
+        }
+    }, [&]() {
+        uint64_t sum = 0;
+        for (size_t received = 0; received < n;) {
+            size_t count = spsc.pop_batch(spsc_out.data(), batch);
+            for (size_t j = 0; j < count; ++j) sum += spsc_out[j];
+            received += count;
+        }
+        return sum;
+    });
+}
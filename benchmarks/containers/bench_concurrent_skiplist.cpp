@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "benchmark.h"
+#include "concurrent_skiplist.h"
+#include "vector.h"
+
+// Real-time postings: doc ids inserted into a sorted map while queries look them up, lock-free skip lists with heap
+// and arena nodes against a mutex around `std::map`
+//
+// Usage: bench_concurrent_skiplist [inserts_per_thread] [max_threads]
+template <class Run>
+static void run_threads(size_t num_threads, Run&& run) {
+    ndash::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) threads.emplace_back([&run, t]() { run(t); });
+    for (auto& thread : threads) thread.join();
+}
+
+// Doc id `i` of thread `t`, scattered so inserts land all over the list
+static uint32_t doc_id(size_t t, size_t i, size_t num_threads) {
+    return uint32_t((i * 2654435761u) % (1u << 28) * num_threads + t);
+}
+
+template <class List>
+static void bench_list(const char* name, size_t num_threads, size_t per_thread) {
+    size_t total = num_threads * per_thread;
+    char label[96];
+    List* list = nullptr;
+
+    snprintf(label, sizeof(label), "%s_insert/%zu_threads", name, num_threads);
+    run_benchmark(label, 3, [&]() {
+        delete list;
+        list = new List();
+        run_threads(num_threads, [&](size_t t) {
+            for (size_t i = 0; i < per_thread; ++i) list->insert({ doc_id(t, i, num_threads), uint32_t(i) });
+        });
+    }, 0, total);
+
+    snprintf(label, sizeof(label), "%s_find/%zu_threads", name, num_threads);
+    run_benchmark(label, 3, [&]() {
+        run_threads(num_threads, [&](size_t t) {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < per_thread; ++i) sum += list->find(doc_id(t, i, num_threads))->second;
+            do_not_optimize(sum);
+        });
+    }, 0, total);
+
+    snprintf(label, sizeof(label), "%s_iterate", name);
+    run_benchmark(label, 3, [&]() {
+        uint64_t sum = 0;
+        for (const auto& entry : *list) sum += entry.second;
+        do_not_optimize(sum);
+    }, 0, total);
+    delete list;
+}
+
+int main(int argc, char** argv) {
+    size_t per_thread = bench_arg(argc, argv, 1, 500000);
+    size_t max_threads = bench_arg(argc, argv, 2, 4);
+
+    for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        size_t total = per_thread * num_threads;
+        char label[96];
+
+        snprintf(label, sizeof(label), "mutex_map_insert/%zu_threads", num_threads);
+        std::map<uint32_t, uint32_t> map;
+        std::mutex lock;
+        run_benchmark(label, 3, [&]() {
+            map.clear();
+            run_threads(num_threads, [&](size_t t) {
+                for (size_t i = 0; i < per_thread; ++i) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    map.emplace(doc_id(t, i, num_threads), uint32_t(i));
+                }
+            });
+        }, 0, total);
+
+        snprintf(label, sizeof(label), "mutex_map_find/%zu_threads", num_threads);
+        run_benchmark(label, 3, [&]() {
+            run_threads(num_threads, [&](size_t t) {
+                uint64_t sum = 0;
+                for (size_t i = 0; i < per_thread; ++i) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    sum += map.find(doc_id(t, i, num_threads))->second;
+                }
+                do_not_optimize(sum);
+            });
+        }, 0, total);
+
+        bench_list<ndash::concurrent_skiplist<uint32_t, uint32_t>>("skiplist", num_threads, per_thread);
+        bench_list<ndash::concurrent_skiplist<uint32_t, uint32_t, std::less<uint32_t>, 10>>("arena_skiplist",
+                                                                                          num_threads, per_thread);
+    }
+}
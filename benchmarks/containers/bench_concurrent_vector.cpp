@@ -0,0 +1,50 @@
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#include "benchmark.h"
+#include "concurrent_vector.h"
+#include "vector.h"
+
+// Parallel ingest: threads appending to one shared vector, lock-free against a mutex around `vector`
+//
+// Usage: bench_concurrent_vector [appends_per_thread] [max_threads]
+template <class Append>
+static void run_threads(size_t num_threads, Append&& append) {
+    ndash::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) threads.emplace_back([&append, t]() { append(t); });
+    for (auto& thread : threads) thread.join();
+}
+
+int main(int argc, char** argv) {
+    size_t per_thread = bench_arg(argc, argv, 1, 1000000);
+    size_t max_threads = bench_arg(argc, argv, 2, 32);
+
+    for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        size_t total = per_thread * num_threads;
+        char label[64];
+
+        snprintf(label, sizeof(label), "mutex_vector/%zu_threads", num_threads);
+        run_benchmark(label, 3, [&]() {
+            ndash::vector<uint64_t> vec;
+            std::mutex lock;
+            run_threads(num_threads, [&](size_t t) {
+                for (size_t i = 0; i < per_thread; ++i) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    vec.push_back(t * per_thread + i);
+                }
+            });
+            do_not_optimize(vec.size());
+        }, 0, total);
+
+        snprintf(label, sizeof(label), "concurrent_vector/%zu_threads", num_threads);
+        run_benchmark(label, 3, [&]() {
+            ndash::concurrent_vector<uint64_t> vec;
+            run_threads(num_threads, [&](size_t t) {
+                for (size_t i = 0; i < per_thread; ++i) vec.push_back(t * per_thread + i);
+            });
+            do_not_optimize(vec.size());
+        }, 0, total);
+    }
+}
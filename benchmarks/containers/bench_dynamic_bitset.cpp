@@ -0,0 +1,60 @@
+#include <cstdint>
+#include <random>
+
+#include "benchmark.h"
+#include "dynamic_bitset.h"
+#include "vector.h"
+
+// Combining document filters over a large index, packed bitsets against one byte per document
+//
+// Usage: bench_dynamic_bitset [num_documents]
+int main(int argc, char** argv) {
+    size_t num_docs = bench_arg(argc, argv, 1, 100000000);
+
+    std::mt19937_64 rng(5);
+    ndash::dynamic_bitset matches(num_docs);
+    ndash::dynamic_bitset deleted(num_docs);
+    ndash::vector<uint8_t> match_bytes(num_docs, 0);
+    ndash::vector<uint8_t> deleted_bytes(num_docs, 0);
+    for (size_t i = 0; i < num_docs; ++i) {
+        uint64_t r = rng();
+        if (r % 4 == 0) {
+            matches.set(i);
+            match_bytes[i] = 1;
+        }
+        if ((r >> 8) % 50 == 0) {
+            deleted.set(i);
+            deleted_bytes[i] = 1;
+        }
+    }
+
+    ndash::vector<uint8_t> byte_result(num_docs, 0);
+    run_benchmark("bytes_and_not_count", 5, [&]() {
+        size_t count = 0;
+        for (size_t i = 0; i < num_docs; ++i) {
+            byte_result[i] = match_bytes[i] & !deleted_bytes[i];
+            count += byte_result[i];
+        }
+        do_not_optimize(count);
+    }, 0, num_docs);
+
+    ndash::dynamic_bitset result(matches);
+    run_benchmark("bitset_and_not_in_place", 5, [&]() {
+        result.and_not(deleted);
+        do_not_optimize(result.data()[0]);
+    }, 0, num_docs);
+    run_benchmark("bitset_and_not_copy", 5, [&]() { do_not_optimize(and_not(matches, deleted).data()[0]); }, 0,
+                  num_docs);
+    run_benchmark("bitset_or_in_place", 5, [&]() {
+        result |= matches;
+        do_not_optimize(result.data()[0]);
+    }, 0, num_docs);
+    run_benchmark("bitset_count", 5, [&]() { do_not_optimize(matches.count()); }, 0, num_docs);
+    run_benchmark("bitset_count_and_not", 5, [&]() { do_not_optimize(matches.count_and_not(deleted)); }, 0,
+                  num_docs);
+    run_benchmark("bitset_iterate", 5, [&]() {
+        size_t sum = 0;
+        matches.for_each_set([&](size_t pos) { sum += pos; });
+        do_not_optimize(sum);
+    }, 0, num_docs);
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#include "benchmark.h"
+#include "elias_fano.h"
+#include "vector.h"
+
+// Posting lists encoded with Elias-Fano against plain sorted arrays of document ids
+//
+// Usage: bench_elias_fano [num_documents]
+int main(int argc, char** argv) {
+    size_t num_docs = bench_arg(argc, argv, 1, 50000000);
+
+    std::mt19937_64 rng(11);
+    ndash::vector<uint32_t> common, rare;
+    for (uint32_t doc = 0; doc < num_docs; ++doc) {
+        uint64_t r = rng();
+        if (r % 100 < 20) common.push_back(doc);
+        if ((r >> 8) % 1000 < 3) rare.push_back(doc);
+    }
+
+    ndash::elias_fano ef_common(common), ef_rare(rare);
+    std::printf("common: %zu ids, array %.2f bits/id, elias-fano %.2f bits/id\n", common.size(), 32.0,
+                double(ef_common.memory_usage() * 8) / double(common.size()));
+    std::printf("rare:   %zu ids, array %.2f bits/id, elias-fano %.2f bits/id\n", rare.size(), 32.0,
+                double(ef_rare.memory_usage() * 8) / double(rare.size()));
+
+    ndash::vector<uint32_t> positions(1000000);
+    for (auto& pos : positions) pos = uint32_t(rng() % common.size());
+
+    run_benchmark("array_random_access", 5, [&]() {
+        uint64_t sum = 0;
+        for (uint32_t pos : positions) sum += common[pos];
+        do_not_optimize(sum);
+    }, 0, positions.size());
+    run_benchmark("ef_random_access", 5, [&]() {
+        uint64_t sum = 0;
+        for (uint32_t pos : positions) sum += ef_common[pos];
+        do_not_optimize(sum);
+    }, 0, positions.size());
+
+    run_benchmark("array_decode", 5, [&]() {
+        uint64_t sum = 0;
+        for (uint32_t doc : common) sum += doc;
+        do_not_optimize(sum);
+    }, 0, common.size());
+    run_benchmark("ef_decode", 5, [&]() {
+        uint64_t sum = 0;
+        for (uint32_t doc : ef_common) sum += doc;
+        do_not_optimize(sum);
+    }, 0, common.size());
+
+    // Conjunctive query: drive the rare list and skip through the common one
+    run_benchmark("array_intersect_galloping", 5, [&]() {
+        size_t matches = 0;
+        const uint32_t* pos = common.data();
+        const uint32_t* end = common.data() + common.size();
+        for (uint32_t doc : rare) {
+            pos = std::lower_bound(pos, end, doc);
+            if (pos == end) break;
+            matches += *pos == doc;
+        }
+        do_not_optimize(matches);
+    }, 0, rare.size());
+    run_benchmark("ef_intersect_skip_to", 5, [&]() {
+        size_t matches = 0;
+        auto it = ef_common.begin();
+        for (uint32_t doc : ef_rare) {
+            it.skip_to(doc);
+            if (it == ef_common.end()) break;
+            matches += *it == doc;
+        }
+        do_not_optimize(matches);
+    }, 0, rare.size());
+
+    ndash::vector<uint32_t> targets(1000000);
+    for (auto& target : targets) target = uint32_t(rng() % num_docs);
+    run_benchmark("array_lower_bound", 5, [&]() {
+        size_t sum = 0;
+        for (uint32_t target : targets) {
+            sum += std::lower_bound(common.data(), common.data() + common.size(), target) - common.data();
+        }
+        do_not_optimize(sum);
+    }, 0, targets.size());
+    run_benchmark("ef_next_geq", 5, [&]() {
+        size_t sum = 0;
+        for (uint32_t target : targets) sum += ef_common.lower_bound(target);
+        do_not_optimize(sum);
+    }, 0, targets.size());
+}
@@ -0,0 +1,42 @@
+#include <cstdint>
+#include <random>
+
+#include "benchmark.h"
+#include "mapped_storage.h"
+#include "vector.h"
+
+// Growth and random access on a large posting style array, heap storage against huge page mappings
+//
+// Usage: bench_mapped_vector [num_elements] [num_lookups]
+template <class Vector>
+static void run(const char* growth_name, const char* lookup_name, size_t num_elements,
+                const ndash::vector<uint32_t>& lookups) {
+    run_benchmark(growth_name, 3, [&]() {
+        Vector vec;
+        for (size_t i = 0; i < num_elements; ++i) vec.push_back(uint32_t(i));
+        do_not_optimize(vec.data()[num_elements / 2]);
+    }, num_elements * sizeof(uint32_t), num_elements);
+
+    Vector vec;
+    vec.resize(num_elements);
+    for (size_t i = 0; i < num_elements; ++i) vec[i] = uint32_t(i * 3);
+
+    run_benchmark(lookup_name, 3, [&]() {
+        uint64_t sum = 0;
+        for (uint32_t index : lookups) sum += vec[index];
+        do_not_optimize(sum);
+    }, 0, lookups.size());
+}
+
+int main(int argc, char** argv) {
+    size_t num_elements = bench_arg(argc, argv, 1, size_t(1) << 28);
+    size_t num_lookups = bench_arg(argc, argv, 2, 20000000);
+
+    std::mt19937 rng(7);
+    ndash::vector<uint32_t> lookups;
+    lookups.reserve(num_lookups);
+    for (size_t i = 0; i < num_lookups; ++i) lookups.push_back(uint32_t(rng() % num_elements));
+
+    run<ndash::vector<uint32_t>>("heap_growth", "heap_random_access", num_elements, lookups);
+    run<ndash::mapped_vector<uint32_t>>("mapped_growth", "mapped_random_access", num_elements, lookups);
+}
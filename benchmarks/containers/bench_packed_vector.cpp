@@ -0,0 +1,77 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#include "benchmark.h"
+#include "packed_vector.h"
+#include "vector.h"
+
+// Scoring-time reads of a 10-bit document length column, packed against one `uint32_t` per document
+//
+// Usage: bench_packed_vector [num_documents]
+int main(int argc, char** argv) {
+    size_t num_docs = bench_arg(argc, argv, 1, 10000000);
+
+    std::mt19937_64 rng(3);
+    ndash::vector<uint32_t> lengths;
+    ndash::packed_vector<10> packed;
+    ndash::packed_vector<> packed_runtime(10);
+    for (size_t i = 0; i < num_docs; ++i) {
+        uint32_t length = uint32_t(rng() % 1024);
+        lengths.push_back(length);
+        packed.push_back(length);
+        packed_runtime.push_back(length);
+    }
+    packed.shrink_to_fit();
+    std::printf("memory: vector %zu bytes, packed %zu bytes (%.1fx)\n", lengths.size() * sizeof(uint32_t),
+                packed.memory_usage(), double(lengths.size() * sizeof(uint32_t)) / double(packed.memory_usage()));
+
+    ndash::vector<uint32_t> order(num_docs);
+    for (auto& doc : order) doc = uint32_t(rng() % num_docs);
+
+    run_benchmark("vector_random_get", 5, [&]() {
+        uint64_t sum = 0;
+        for (uint32_t doc : order) sum += lengths[doc];
+        do_not_optimize(sum);
+    }, 0, num_docs);
+    run_benchmark("packed_random_get", 5, [&]() {
+        uint64_t sum = 0;
+        for (uint32_t doc : order) sum += packed[doc];
+        do_not_optimize(sum);
+    }, 0, num_docs);
+    run_benchmark("packed_runtime_random_get", 5, [&]() {
+        uint64_t sum = 0;
+        for (uint32_t doc : order) sum += packed_runtime[doc];
+        do_not_optimize(sum);
+    }, 0, num_docs);
+
+    run_benchmark("packed_sequential_get", 5, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < num_docs; ++i) sum += packed[i];
+        do_not_optimize(sum);
+    }, 0, num_docs);
+
+    // Score blocks of 128 documents, as a posting list decoder hands them over
+    uint32_t block[128];
+    run_benchmark("packed_unpack_128", 5, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i + 128 <= num_docs; i += 128) {
+            packed.unpack(i, 128, block);
+            for (uint32_t length : block) sum += length;
+        }
+        do_not_optimize(sum);
+    }, 0, num_docs);
+    run_benchmark("packed_unpack_scalar_128", 5, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i + 128 <= num_docs; i += 128) {
+            ndash::detail::unpack_scalar(packed.data(), 10, i, 128, block);
+            for (uint32_t length : block) sum += length;
+        }
+        do_not_optimize(sum);
+    }, 0, num_docs);
+
+    run_benchmark("packed_set", 5, [&]() {
+        for (size_t i = 0; i < num_docs; ++i) packed.set(i, uint32_t(i));
+        do_not_optimize(packed.data()[0]);
+    }, 0, num_docs);
+}
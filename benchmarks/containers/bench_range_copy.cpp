@@ -0,0 +1,35 @@
+#include <cstring>
+
+#include "benchmark.h"
+#include "forward_list.h"
+#include "ndstring.h"
+#include "vector.h"
+
+// Copying documents and building vectors from ranges
+//
+// Usage: bench_range_copy [document_bytes] [num_elements]
+int main(int argc, char** argv) {
+    size_t document_bytes = bench_arg(argc, argv, 1, 10 << 20);
+    size_t num_elements = bench_arg(argc, argv, 2, 1 << 20);
+
+    ndash::string document(document_bytes, 'x');
+    for (size_t i = 0; i < document_bytes; i += 7) document[i] = ' ';
+
+    run_benchmark("copy_string", 20, [&]() { do_not_optimize(ndash::string(document).size()); }, document_bytes);
+    run_benchmark("string_from_pointer", 20,
+                  [&]() { do_not_optimize(ndash::string(document.data(), document.size()).size()); },
+                  document_bytes);
+
+    ndash::vector<int> numbers;
+    for (size_t i = 0; i < num_elements; ++i) numbers.push_back(int(i));
+    ndash::forward_list<int> list(numbers.begin(), numbers.end());
+
+    run_benchmark("vector_from_vector_range", 20,
+                  [&]() { do_not_optimize(ndash::vector<int>(numbers.begin(), numbers.end()).size()); }, 0,
+                  num_elements);
+    run_benchmark("vector_from_widening_range", 20,
+                  [&]() { do_not_optimize(ndash::vector<long>(numbers.begin(), numbers.end()).size()); }, 0,
+                  num_elements);
+    run_benchmark("vector_from_list_range", 5,
+                  [&]() { do_not_optimize(ndash::vector<int>(list.begin(), list.end()).size()); }, 0, num_elements);
+}
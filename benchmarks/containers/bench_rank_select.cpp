@@ -0,0 +1,58 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#include "benchmark.h"
+#include "rank_select_bitvector.h"
+#include "vector.h"
+
+// Random rank and select queries on bitvectors from 1M bits up to `max_bits`, at half and 5% density
+//
+// Usage: bench_rank_select [max_bits] [num_queries]
+int main(int argc, char** argv) {
+    size_t max_bits = bench_arg(argc, argv, 1, size_t(1) << 30);
+    size_t num_queries = bench_arg(argc, argv, 2, 1000000);
+
+    std::mt19937_64 rng(13);
+    for (size_t num_bits = size_t(1) << 20; num_bits <= max_bits; num_bits <<= 4) {
+        for (unsigned density : { 50u, 5u }) {
+            ndash::vector<uint64_t> words((num_bits + 63) / 64);
+            for (auto& word : words) {
+                word = 0;
+                for (int bit = 0; bit < 64; ++bit) word |= uint64_t(rng() % 100 < density) << bit;
+            }
+            ndash::rank_select_bitvector rs(words.data(), num_bits);
+            std::printf("%zu bits, %u%% ones: %.1f%% overhead\n", num_bits, density,
+                        100.0 * double(rs.memory_usage() * 8 - num_bits) / double(num_bits));
+
+            ndash::vector<uint64_t> positions(num_queries), ones(num_queries), zeros(num_queries);
+            for (size_t i = 0; i < num_queries; ++i) {
+                positions[i] = rng() % num_bits;
+                ones[i] = rng() % rs.count();
+                zeros[i] = rng() % (num_bits - rs.count());
+            }
+
+            char name[64];
+            std::snprintf(name, sizeof(name), "rank1_%zu_%u", num_bits, density);
+            run_benchmark(name, 3, [&]() {
+                size_t sum = 0;
+                for (uint64_t pos : positions) sum += rs.rank1(pos);
+                do_not_optimize(sum);
+            }, 0, num_queries);
+
+            std::snprintf(name, sizeof(name), "select1_%zu_%u", num_bits, density);
+            run_benchmark(name, 3, [&]() {
+                size_t sum = 0;
+                for (uint64_t k : ones) sum += rs.select1(k);
+                do_not_optimize(sum);
+            }, 0, num_queries);
+
+            std::snprintf(name, sizeof(name), "select0_%zu_%u", num_bits, density);
+            run_benchmark(name, 3, [&]() {
+                size_t sum = 0;
+                for (uint64_t k : zeros) sum += rs.select0(k);
+                do_not_optimize(sum);
+            }, 0, num_queries);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#include "benchmark.h"
+#include "roaring_bitmap.h"
+#include "vector.h"
+
+// Posting sets of mixed density stored as roaring bitmaps against sorted arrays of document ids
+//
+// Usage: bench_roaring_bitmap [num_documents]
+int main(int argc, char** argv) {
+    size_t num_docs = bench_arg(argc, argv, 1, 10000000);
+
+    // A common term in most documents, a rare term and a date filter covering a contiguous range of ids
+    std::mt19937_64 rng(7);
+    ndash::vector<uint32_t> common, rare, recent;
+    for (uint32_t doc = 0; doc < num_docs; ++doc) {
+        uint64_t r = rng();
+        if (r % 100 < 60) common.push_back(doc);
+        if ((r >> 8) % 100 < 2) rare.push_back(doc);
+        if (doc >= num_docs / 4 && doc < num_docs / 2) recent.push_back(doc);
+    }
+
+    ndash::roaring_bitmap common_bitmap, rare_bitmap, recent_bitmap;
+    run_benchmark("add_many_sorted", 3, [&]() {
+        common_bitmap.clear();
+        common_bitmap.add_many(common.data(), common.size());
+    }, 0, common.size());
+    rare_bitmap.add_many(rare.data(), rare.size());
+    recent_bitmap.add_many(recent.data(), recent.size());
+    recent_bitmap.run_optimize();
+
+    auto report = [](const char* name, size_t ids, size_t bitmap_bytes) {
+        std::printf("%-8s %10zu ids  array %10zu bytes  roaring %10zu bytes  (%.1fx)\n", name, ids,
+                    ids * sizeof(uint32_t), bitmap_bytes, double(ids * sizeof(uint32_t)) / double(bitmap_bytes));
+    };
+    report("common", common.size(), common_bitmap.memory_usage());
+    report("rare", rare.size(), rare_bitmap.memory_usage());
+    report("recent", recent.size(), recent_bitmap.memory_usage());
+
+    ndash::vector<uint32_t> out(num_docs);
+    run_benchmark("array_and_common_rare", 5, [&]() {
+        do_not_optimize(std::set_intersection(common.data(), common.data() + common.size(), rare.data(),
+                                              rare.data() + rare.size(), out.data()));
+    }, 0, common.size() + rare.size());
+    run_benchmark("roaring_and_common_rare", 5, [&]() { do_not_optimize((common_bitmap & rare_bitmap).cardinality()); },
+                  0, common.size() + rare.size());
+
+    run_benchmark("array_and_common_recent", 5, [&]() {
+        do_not_optimize(std::set_intersection(common.data(), common.data() + common.size(), recent.data(),
+                                              recent.data() + recent.size(), out.data()));
+    }, 0, common.size() + recent.size());
+    run_benchmark("roaring_and_common_recent", 5,
+                  [&]() { do_not_optimize((common_bitmap & recent_bitmap).cardinality()); }, 0,
+                  common.size() + recent.size());
+
+    run_benchmark("array_or_common_rare", 5, [&]() {
+        do_not_optimize(std::set_union(common.data(), common.data() + common.size(), rare.data(),
+                                       rare.data() + rare.size(), out.data()));
+    }, 0, common.size() + rare.size());
+    run_benchmark("roaring_or_common_rare", 5, [&]() { do_not_optimize((common_bitmap | rare_bitmap).cardinality()); },
+                  0, common.size() + rare.size());
+
+    run_benchmark("array_sub_common_rare", 5, [&]() {
+        do_not_optimize(std::set_difference(common.data(), common.data() + common.size(), rare.data(),
+                                            rare.data() + rare.size(), out.data()));
+    }, 0, common.size() + rare.size());
+    run_benchmark("roaring_sub_common_rare", 5, [&]() { do_not_optimize((common_bitmap - rare_bitmap).cardinality()); },
+                  0, common.size() + rare.size());
+
+    // Two sparse sets, where containers stay arrays and intersect with shuffles
+    ndash::vector<uint32_t> rare2;
+    for (uint32_t doc = 0; doc < num_docs; ++doc) {
+        if (rng() % 100 < 3) rare2.push_back(doc);
+    }
+    ndash::roaring_bitmap rare2_bitmap;
+    rare2_bitmap.add_many(rare2.data(), rare2.size());
+    run_benchmark("array_and_rare_rare", 5, [&]() {
+        do_not_optimize(std::set_intersection(rare.data(), rare.data() + rare.size(), rare2.data(),
+                                              rare2.data() + rare2.size(), out.data()));
+    }, 0, rare.size() + rare2.size());
+    run_benchmark("roaring_and_rare_rare", 5, [&]() { do_not_optimize((rare_bitmap & rare2_bitmap).cardinality()); },
+                  0, rare.size() + rare2.size());
+
+    ndash::vector<char> bytes(common_bitmap.serialized_size());
+    run_benchmark("serialize_common", 5, [&]() { common_bitmap.serialize(bytes.data()); }, bytes.size());
+    run_benchmark("deserialize_common", 5, [&]() {
+        ndash::roaring_bitmap copy;
+        do_not_optimize(ndash::roaring_bitmap::deserialize(bytes.data(), bytes.size(), copy));
+    }, bytes.size());
+}
@@ -0,0 +1,52 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#include "benchmark.h"
+#include "segmented_vector.h"
+#include "vector.h"
+
+// Append, random access and sequential iteration against vector
+//
+// Usage: bench_segmented_vector [num_elements] [num_lookups]
+template <class Vector>
+static void run(const char* name, size_t num_elements, const ndash::vector<uint32_t>& lookups) {
+    char label[64];
+
+    snprintf(label, sizeof(label), "%s_push_back", name);
+    run_benchmark(label, 5, [&]() {
+        Vector vec;
+        for (size_t i = 0; i < num_elements; ++i) vec.push_back(uint64_t(i));
+        do_not_optimize(vec[num_elements / 2]);
+    }, 0, num_elements);
+
+    Vector vec;
+    for (size_t i = 0; i < num_elements; ++i) vec.push_back(uint64_t(i) * 3);
+
+    snprintf(label, sizeof(label), "%s_random_access", name);
+    run_benchmark(label, 5, [&]() {
+        uint64_t sum = 0;
+        for (uint32_t index : lookups) sum += vec[index];
+        do_not_optimize(sum);
+    }, 0, lookups.size());
+
+    snprintf(label, sizeof(label), "%s_iteration", name);
+    run_benchmark(label, 5, [&]() {
+        uint64_t sum = 0;
+        for (uint64_t value : vec) sum += value;
+        do_not_optimize(sum);
+    }, num_elements * sizeof(uint64_t), num_elements);
+}
+
+int main(int argc, char** argv) {
+    size_t num_elements = bench_arg(argc, argv, 1, 1 << 24);
+    size_t num_lookups = bench_arg(argc, argv, 2, 10000000);
+
+    std::mt19937 rng(3);
+    ndash::vector<uint32_t> lookups;
+    lookups.reserve(num_lookups);
+    for (size_t i = 0; i < num_lookups; ++i) lookups.push_back(uint32_t(rng() % num_elements));
+
+    run<ndash::vector<uint64_t>>("vector", num_elements, lookups);
+    run<ndash::segmented_vector<uint64_t>>("segmented_vector", num_elements, lookups);
+}
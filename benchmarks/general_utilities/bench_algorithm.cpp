@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "algorithm.h"
+#include "benchmark.h"
+#include "pair.h"
+#include "vector.h"
+
+// Sorting and top-k selection against the standard library. Each repetition copies the unsorted input first, so
+// the copy is part of every timing
+//
+// Usage: bench_algorithm [num_values] [k]
+int main(int argc, char** argv) {
+    size_t n = bench_arg(argc, argv, 1, 10000000);
+    size_t k = bench_arg(argc, argv, 2, 1000);
+
+    std::mt19937_64 rng(5);
+    ndash::vector<uint32_t> input(n), work(n);
+    for (auto& value : input) value = uint32_t(rng());
+
+    auto reset = [&]() { std::memcpy(work.data(), input.data(), n * sizeof(uint32_t)); };
+    uint32_t* first = work.data();
+    uint32_t* last = work.data() + n;
+
+    run_benchmark("std_sort_u32", 5, [&]() {
+        reset();
+        std::sort(first, last);
+        do_not_optimize(work[n / 2]);
+    }, n * sizeof(uint32_t), n);
+    run_benchmark("ndash_sort_u32", 5, [&]() {
+        reset();
+        ndash::sort(work.begin(), work.end());
+        do_not_optimize(work[n / 2]);
+    }, n * sizeof(uint32_t), n);
+
+    run_benchmark("std_stable_sort_u32", 5, [&]() {
+        reset();
+        std::stable_sort(first, last);
+        do_not_optimize(work[n / 2]);
+    }, n * sizeof(uint32_t), n);
+    run_benchmark("ndash_stable_sort_u32", 5, [&]() {
+        reset();
+        ndash::stable_sort(work.begin(), work.end());
+        do_not_optimize(work[n / 2]);
+    }, n * sizeof(uint32_t), n);
+
+    // Nearly sorted postings: sorted ids with 1% displaced
+    ndash::vector<uint32_t> nearly(n);
+    for (size_t i = 0; i < n; ++i) nearly[i] = uint32_t(i);
+    for (size_t i = 0; i < n / 100; ++i) nearly[rng() % n] = uint32_t(rng() % n);
+    auto reset_nearly = [&]() { std::memcpy(work.data(), nearly.data(), n * sizeof(uint32_t)); };
+    run_benchmark("std_sort_nearly_sorted", 5, [&]() {
+        reset_nearly();
+        std::sort(first, last);
+        do_not_optimize(work[n / 2]);
+    }, n * sizeof(uint32_t), n);
+    run_benchmark("ndash_sort_nearly_sorted", 5, [&]() {
+        reset_nearly();
+        ndash::sort(work.begin(), work.end());
+        do_not_optimize(work[n / 2]);
+    }, n * sizeof(uint32_t), n);
+
+    // Top-k of (score, document) hits by descending score
+    ndash::vector<ndash::pair<float, uint32_t>> hits(n), top(n);
+    for (uint32_t doc = 0; doc < n; ++doc) hits[doc] = { float(rng() % 100000) / 7.0f, doc };
+    auto by_score = [](const auto& a, const auto& b) { return a.first > b.first; };
+    run_benchmark("std_partial_sort_topk", 5, [&]() {
+        std::memcpy((void*) top.data(), hits.data(), n * sizeof(hits[0]));
+        std::partial_sort(top.data(), top.data() + k, top.data() + n, by_score);
+        do_not_optimize(top[0].second);
+    }, 0, n);
+    run_benchmark("ndash_partial_sort_topk", 5, [&]() {
+        std::memcpy((void*) top.data(), hits.data(), n * sizeof(hits[0]));
+        ndash::partial_sort(top.begin(), top.begin() + ptrdiff_t(k), top.end(), by_score);
+        do_not_optimize(top[0].second);
+    }, 0, n);
+
+    run_benchmark("std_nth_element_u32", 5, [&]() {
+        reset();
+        std::nth_element(first, first + n / 2, last);
+        do_not_optimize(work[n / 2]);
+    }, n * sizeof(uint32_t), n);
+    run_benchmark("ndash_nth_element_u32", 5, [&]() {
+        reset();
+        ndash::nth_element(work.begin(), work.begin() + ptrdiff_t(n / 2), work.end());
+        do_not_optimize(work[n / 2]);
+    }, n * sizeof(uint32_t), n);
+}
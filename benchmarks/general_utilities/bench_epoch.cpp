@@ -0,0 +1,97 @@
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "benchmark.h"
+#include "epoch.h"
+
+namespace {
+
+struct node {
+    std::atomic<node*> next;
+    std::atomic<uint32_t> refs;
+    uint64_t value;
+};
+
+}   // namespace
+
+// Cost of protecting reads with epoch guards, against a lock or a reference count per node
+//
+// Usage: bench_epoch [num_operations] [list_length]
+int main(int argc, char** argv) {
+    size_t num_operations = bench_arg(argc, argv, 1, 10000000);
+    size_t list_length = bench_arg(argc, argv, 2, 1000);
+
+    run_benchmark("guard", 3, [&]() {
+        for (size_t i = 0; i < num_operations; ++i) {
+            ndash::epoch::guard guard;
+            do_not_optimize(i);
+        }
+    }, 0, num_operations);
+
+    run_benchmark("nested_guard", 3, [&]() {
+        ndash::epoch::guard outer;
+        for (size_t i = 0; i < num_operations; ++i) {
+            ndash::epoch::guard guard;
+            do_not_optimize(i);
+        }
+    }, 0, num_operations);
+
+    std::mutex lock;
+    run_benchmark("mutex", 3, [&]() {
+        for (size_t i = 0; i < num_operations; ++i) {
+            std::lock_guard<std::mutex> guard(lock);
+            do_not_optimize(i);
+        }
+    }, 0, num_operations);
+
+    // A linked list read under one guard touches nodes with plain loads; reference counting pays two RMWs per node
+    node* nodes = new node[list_length];
+    for (size_t i = 0; i < list_length; ++i) {
+        nodes[i].next.store(i + 1 < list_length ? &nodes[i + 1] : nullptr, std::memory_order_relaxed);
+        nodes[i].refs.store(1, std::memory_order_relaxed);
+        nodes[i].value = i;
+    }
+    size_t traversals = num_operations / list_length + 1;
+
+    run_benchmark("traverse_guarded", 3, [&]() {
+        for (size_t t = 0; t < traversals; ++t) {
+            ndash::epoch::guard guard;
+            uint64_t sum = 0;
+            for (node* n = &nodes[0]; n; n = n->next.load(std::memory_order_acquire)) sum += n->value;
+            do_not_optimize(sum);
+        }
+    }, 0, traversals * list_length);
+
+    run_benchmark("traverse_refcounted", 3, [&]() {
+        for (size_t t = 0; t < traversals; ++t) {
+            uint64_t sum = 0;
+            for (node* n = &nodes[0]; n;) {
+                n->refs.fetch_add(1, std::memory_order_acquire);
+                sum += n->value;
+                node* next = n->next.load(std::memory_order_acquire);
+                n->refs.fetch_sub(1, std::memory_order_release);
+                n = next;
+            }
+            do_not_optimize(sum);
+        }
+    }, 0, traversals * list_length);
+
+    // Retiring with batched reclamation, against freeing immediately
+    run_benchmark("retire", 3, [&]() {
+        for (size_t i = 0; i < num_operations; ++i) ndash::epoch::retire(new uint64_t(i));
+        ndash::epoch::flush();
+        ndash::epoch::flush();
+        ndash::epoch::flush();
+    }, 0, num_operations);
+
+    run_benchmark("delete", 3, [&]() {
+        for (size_t i = 0; i < num_operations; ++i) {
+            uint64_t* p = new uint64_t(i);
+            do_not_optimize(p);
+            delete p;
+        }
+    }, 0, num_operations);
+
+    delete[] nodes;
+}
@@ -0,0 +1,72 @@
+#include <cstdint>
+#include <functional>
+
+#include "benchmark.h"
+#include "function.h"
+#include "vector.h"
+
+namespace {
+
+// Callbacks handed through a scheduler in batches
+constexpr const size_t BATCH = 1024;
+
+// Queue callbacks capturing `Captures` words each, move them to a ready queue as a scheduler would, then run them
+template <class Function, size_t Captures>
+uint64_t queue_and_run(size_t count) {
+    ndash::vector<Function> queue;
+    ndash::vector<Function> ready;
+    queue.reserve(BATCH);
+    ready.reserve(BATCH);
+
+    uint64_t total = 0;
+    for (size_t begin = 0; begin < count; begin += BATCH) {
+        for (size_t i = begin; i < begin + BATCH; ++i) {
+            uint64_t words[Captures];
+            for (size_t w = 0; w < Captures; ++w) words[w] = i + w;
+            queue.push_back(Function([words]() {
+                uint64_t sum = 0;
+                for (uint64_t word : words) sum += word;
+                return sum;
+            }));
+        }
+        for (Function& f : queue) ready.push_back(std::move(f));
+        queue.clear();
+        for (Function& f : ready) total += f();
+        ready.clear();
+    }
+    return total;
+}
+
+}   // namespace
+
+// Type-erased callables with inline captures, against `std::function`
+//
+// Usage: bench_function [num_callbacks]
+int main(int argc, char** argv) {
+    size_t count = bench_arg(argc, argv, 1, 1000000);
+
+    run_benchmark("std_function_2_words", 3, [&]() {
+        do_not_optimize(queue_and_run<std::function<uint64_t()>, 2>(count));
+    }, 0, count);
+    run_benchmark("ndash_function_2_words", 3, [&]() {
+        do_not_optimize(queue_and_run<ndash::function<uint64_t()>, 2>(count));
+    }, 0, count);
+
+    run_benchmark("std_function_5_words", 3, [&]() {
+        do_not_optimize(queue_and_run<std::function<uint64_t()>, 5>(count));
+    }, 0, count);
+    run_benchmark("ndash_function_5_words", 3, [&]() {
+        do_not_optimize(queue_and_run<ndash::function<uint64_t()>, 5>(count));
+    }, 0, count);
+    run_benchmark("ndash_move_only_function_5_words", 3, [&]() {
+        do_not_optimize(queue_and_run<ndash::move_only_function<uint64_t()>, 5>(count));
+    }, 0, count);
+
+    // Past the inline buffer both allocate
+    run_benchmark("std_function_8_words", 3, [&]() {
+        do_not_optimize(queue_and_run<std::function<uint64_t()>, 8>(count));
+    }, 0, count);
+    run_benchmark("ndash_function_8_words", 3, [&]() {
+        do_not_optimize(queue_and_run<ndash::function<uint64_t()>, 8>(count));
+    }, 0, count);
+}
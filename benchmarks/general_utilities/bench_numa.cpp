@@ -0,0 +1,74 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "benchmark.h"
+#include "numa.h"
+#include "numa_storage.h"
+#include "vector.h"
+
+namespace {
+
+// Random reads of one shard, as posting list lookups touch it
+uint64_t lookups(const ndash::numa_vector<uint64_t>& shard, size_t count, uint64_t seed) {
+    uint64_t sum = 0;
+    uint64_t x = seed | 1;
+    for (size_t i = 0; i < count; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        sum += shard[x % shard.size()];
+    }
+    return sum;
+}
+
+// Run the lookups of every shard on the group of the node `offset` nodes past the one holding it, and wait
+void query_shards(ndash::numa::worker_groups& groups, const ndash::vector<ndash::numa_vector<uint64_t>*>& shards,
+                  size_t per_shard, size_t offset) {
+    std::atomic<size_t> done(0);
+    size_t expected = 0;
+    for (size_t s = 0; s < shards.size(); ++s) {
+        int home = ndash::numa::shard_node(s, shards.size());
+        size_t index = 0;
+        while (ndash::numa::node_id(index) != home) ++index;
+        ndash::thread_pool& pool = groups[(index + offset) % groups.size()];
+        expected += pool.size();
+        for (unsigned w = 0; w < pool.size(); ++w) {
+            pool.submit([&, s, w]() {
+                do_not_optimize(lookups(*shards[s], per_shard / pool.size(), s * 977 + w));
+                done.fetch_add(1);
+            });
+        }
+    }
+    while (done.load() < expected) std::this_thread::yield();
+}
+
+}   // namespace
+
+// Shard lookups from workers on the node holding the shard, against workers on the next node over
+//
+// On a single node machine both runs read local memory and should match
+//
+// Usage: bench_numa [num_shards] [shard_mb] [lookups_per_shard]
+int main(int argc, char** argv) {
+    size_t num_shards = bench_arg(argc, argv, 1, 8);
+    size_t shard_mb = bench_arg(argc, argv, 2, 64);
+    size_t per_shard = bench_arg(argc, argv, 3, 2000000);
+
+    std::printf("%zu nodes\n", ndash::numa::node_count());
+    ndash::numa::worker_groups groups(1);
+
+    ndash::vector<ndash::numa_vector<uint64_t>*> shards;
+    for (size_t s = 0; s < num_shards; ++s) {
+        ndash::numa::placement_scope place(ndash::numa::shard_node(s, num_shards));
+        shards.push_back(new ndash::numa_vector<uint64_t>((shard_mb << 20) / sizeof(uint64_t), s));
+    }
+
+    run_benchmark("lookups_local_node", 3, [&]() { query_shards(groups, shards, per_shard, 0); }, 0,
+                  num_shards * per_shard);
+    run_benchmark("lookups_remote_node", 3, [&]() { query_shards(groups, shards, per_shard, 1); }, 0,
+                  num_shards * per_shard);
+
+    for (ndash::numa_vector<uint64_t>* shard : shards) delete shard;
+}
@@ -0,0 +1,74 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "benchmark.h"
+#include "parallel.h"
+#include "vector.h"
+
+// Parallel algorithms over per-document scores from 1 thread up to `max_threads`, doubling each step
+//
+// Usage: bench_parallel [num_documents] [max_threads] [grain]
+int main(int argc, char** argv) {
+    size_t n = bench_arg(argc, argv, 1, 20000000);
+    size_t max_threads = bench_arg(argc, argv, 2, 64);
+    size_t grain = bench_arg(argc, argv, 3, ndash::par::DEFAULT_GRAIN);
+
+    std::mt19937_64 rng(3);
+    ndash::vector<float> scores(n), normalized(n);
+    ndash::vector<uint32_t> lengths(n), offsets(n), unsorted(n), work(n);
+    for (size_t i = 0; i < n; ++i) {
+        scores[i] = float(rng() % 100000) / 100.0f;
+        lengths[i] = uint32_t(rng() % 1000);
+        unsorted[i] = uint32_t(rng());
+    }
+
+    for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        ndash::par::set_concurrency(unsigned(num_threads));
+        char label[64];
+
+        snprintf(label, sizeof(label), "for_each_bm25_norm/%zu_threads", num_threads);
+        run_benchmark(label, 3, [&]() {
+            ndash::par::for_each(scores.begin(), scores.end(), [](float& score) {
+                score = score * 2.2f / (score + 1.2f * (0.25f + 0.75f * std::log1p(score)));
+            }, grain);
+            do_not_optimize(scores[n / 2]);
+        }, n * sizeof(float), n);
+
+        snprintf(label, sizeof(label), "transform/%zu_threads", num_threads);
+        run_benchmark(label, 3, [&]() {
+            ndash::par::transform(scores.begin(), scores.end(), normalized.begin(),
+                                  [](float score) { return std::sqrt(score) * 0.5f; }, grain);
+            do_not_optimize(normalized[n / 2]);
+        }, n * sizeof(float), n);
+
+        snprintf(label, sizeof(label), "reduce/%zu_threads", num_threads);
+        run_benchmark(label, 3, [&]() {
+            uint64_t total = ndash::par::reduce(lengths.begin(), lengths.end(), uint64_t(0), std::plus<>(), grain);
+            do_not_optimize(total);
+        }, n * sizeof(uint32_t), n);
+
+        snprintf(label, sizeof(label), "count_if/%zu_threads", num_threads);
+        run_benchmark(label, 3, [&]() {
+            auto is_long = [](uint32_t length) { return length > 900; };
+            size_t long_docs = ndash::par::count_if(lengths.begin(), lengths.end(), is_long, grain);
+            do_not_optimize(long_docs);
+        }, n * sizeof(uint32_t), n);
+
+        snprintf(label, sizeof(label), "exclusive_scan/%zu_threads", num_threads);
+        run_benchmark(label, 3, [&]() {
+            ndash::par::exclusive_scan(lengths.begin(), lengths.end(), offsets.begin(), uint32_t(0), std::plus<>(),
+                                       grain);
+            do_not_optimize(offsets[n - 1]);
+        }, n * sizeof(uint32_t), n);
+
+        snprintf(label, sizeof(label), "sort/%zu_threads", num_threads);
+        run_benchmark(label, 3, [&]() {
+            std::memcpy(work.data(), unsorted.data(), n * sizeof(uint32_t));
+            ndash::par::sort(work.begin(), work.end(), std::less<>(), grain);
+            do_not_optimize(work[n / 2]);
+        }, n * sizeof(uint32_t), n);
+    }
+}
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#include "algorithm.h"
+#include "benchmark.h"
+#include "radix_sort.h"
+#include "vector.h"
+
+namespace {
+
+struct posting {
+    uint32_t term_id;
+    uint32_t doc_id;
+    uint32_t position;
+};
+
+uint64_t term_doc_key(const posting& p) { return uint64_t(p.term_id) << 32 | p.doc_id; }
+
+}   // namespace
+
+// Radix sort of integers and index-building tuples against comparison sorts. Each repetition copies the unsorted
+// input first, so the copy is part of every timing
+//
+// Usage: bench_radix_sort [num_values] [num_threads]
+int main(int argc, char** argv) {
+    size_t n = bench_arg(argc, argv, 1, 10000000);
+    unsigned num_threads = unsigned(bench_arg(argc, argv, 2, 4));
+
+    std::mt19937_64 rng(9);
+    ndash::vector<uint32_t> input(n), work(n);
+    for (auto& value : input) value = uint32_t(rng());
+    auto reset = [&]() { std::memcpy(work.data(), input.data(), n * sizeof(uint32_t)); };
+
+    run_benchmark("std_sort_u32", 3, [&]() {
+        reset();
+        std::sort(work.data(), work.data() + n);
+        do_not_optimize(work[n / 2]);
+    }, n * sizeof(uint32_t), n);
+    run_benchmark("ndash_sort_u32", 3, [&]() {
+        reset();
+        ndash::sort(work.begin(), work.end());
+        do_not_optimize(work[n / 2]);
+    }, n * sizeof(uint32_t), n);
+    run_benchmark("radix_sort_u32", 3, [&]() {
+        reset();
+        ndash::radix_sort(work.begin(), work.end());
+        do_not_optimize(work[n / 2]);
+    }, n * sizeof(uint32_t), n);
+    run_benchmark("parallel_radix_sort_u32", 3, [&]() {
+        reset();
+        ndash::parallel_radix_sort(work.begin(), work.end(), ndash::detail::identity_key(), num_threads);
+        do_not_optimize(work[n / 2]);
+    }, n * sizeof(uint32_t), n);
+
+    // Postings of a Zipf-like vocabulary, sorted by (term, document)
+    ndash::vector<posting> postings(n), sorted(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t term = uint32_t(rng() % 1000000);
+        postings[i] = { uint32_t(uint64_t(term) * term / 1000000), uint32_t(rng() % 50000000), i % 200 };
+    }
+    auto reset_postings = [&]() { std::memcpy((void*) sorted.data(), postings.data(), n * sizeof(posting)); };
+    auto by_term_doc = [](const posting& a, const posting& b) { return term_doc_key(a) < term_doc_key(b); };
+
+    run_benchmark("ndash_sort_postings", 3, [&]() {
+        reset_postings();
+        ndash::sort(sorted.begin(), sorted.end(), by_term_doc);
+        do_not_optimize(sorted[n / 2].doc_id);
+    }, n * sizeof(posting), n);
+    run_benchmark("ndash_stable_sort_postings", 3, [&]() {
+        reset_postings();
+        ndash::stable_sort(sorted.begin(), sorted.end(), by_term_doc);
+        do_not_optimize(sorted[n / 2].doc_id);
+    }, n * sizeof(posting), n);
+    run_benchmark("radix_sort_postings", 3, [&]() {
+        reset_postings();
+        ndash::radix_sort(sorted.begin(), sorted.end(), term_doc_key);
+        do_not_optimize(sorted[n / 2].doc_id);
+    }, n * sizeof(posting), n);
+    run_benchmark("parallel_radix_sort_postings", 3, [&]() {
+        reset_postings();
+        ndash::parallel_radix_sort(sorted.begin(), sorted.end(), term_doc_key, num_threads);
+        do_not_optimize(sorted[n / 2].doc_id);
+    }, n * sizeof(posting), n);
+}
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#include "benchmark.h"
+#include "executor.h"
+#include "task.h"
+#include "thread_pool.h"
+#include "vector.h"
+
+namespace {
+
+ndash::task<uint64_t> leaf(uint64_t value) { co_return value; }
+
+// Awaits `depth` tasks in a row that complete without suspending
+ndash::task<uint64_t> chain(size_t depth) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < depth; ++i) sum += co_await leaf(i);
+    co_return sum;
+}
+
+// Query fanning out to `shards` lookups that answer immediately
+ndash::task<uint64_t> fan_out(size_t shards) {
+    ndash::vector<ndash::task<uint64_t>> lookups;
+    lookups.reserve(shards);
+    for (size_t shard = 0; shard < shards; ++shard) lookups.push_back(leaf(shard));
+    ndash::vector<uint64_t> results = co_await ndash::when_all(std::move(lookups));
+    uint64_t sum = 0;
+    for (uint64_t result : results) sum += result;
+    co_return sum;
+}
+
+ndash::task<uint64_t> slow_shard(ndash::executor& exec, uint64_t shard, std::chrono::microseconds latency) {
+    co_await exec.sleep_for(latency);
+    co_return shard;
+}
+
+}   // namespace
+
+// Task await and frame allocation costs, and query latency over shards answered one after another or concurrently
+//
+// Usage: bench_task [num_queries] [num_shards] [shard_latency_us]
+int main(int argc, char** argv) {
+    size_t num_queries = bench_arg(argc, argv, 1, 100000);
+    size_t num_shards = bench_arg(argc, argv, 2, 16);
+    std::chrono::microseconds latency(bench_arg(argc, argv, 3, 2000));
+
+    // A million awaits in a row run in constant stack thanks to symmetric transfer
+    run_benchmark("await_chain", 3, [&]() { do_not_optimize(ndash::sync_wait(chain(1000000))); }, 0, 1000000);
+
+    run_benchmark("fan_out_heap_frames", 3, [&]() {
+        for (size_t q = 0; q < num_queries; ++q) do_not_optimize(ndash::sync_wait(fan_out(num_shards)));
+    }, 0, num_queries);
+
+    // Each query thread keeps one arena and resets it between queries
+    ndash::frame_arena arena;
+    run_benchmark("fan_out_arena_frames", 3, [&]() {
+        for (size_t q = 0; q < num_queries; ++q) {
+            ndash::frame_arena::scope use(arena);
+            do_not_optimize(ndash::sync_wait(fan_out(num_shards)));
+            arena.reset();
+        }
+    }, 0, num_queries);
+
+    ndash::executor exec;
+    run_benchmark("query_sequential_shards", 3, [&]() {
+        uint64_t sum = 0;
+        for (size_t shard = 0; shard < num_shards; ++shard) sum += ndash::sync_wait(slow_shard(exec, shard, latency));
+        do_not_optimize(sum);
+    }, 0, num_shards);
+
+    run_benchmark("query_concurrent_shards", 3, [&]() {
+        ndash::vector<ndash::task<uint64_t>> lookups;
+        for (size_t shard = 0; shard < num_shards; ++shard) lookups.push_back(slow_shard(exec, shard, latency));
+        do_not_optimize(ndash::sync_wait(ndash::when_all(std::move(lookups))));
+    }, 0, num_shards);
+}
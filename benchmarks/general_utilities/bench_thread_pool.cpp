@@ -0,0 +1,77 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "benchmark.h"
+#include "thread_pool.h"
+#include "vector.h"
+
+namespace {
+
+uint64_t fib_sequential(unsigned n) { return n < 2 ? n : fib_sequential(n - 1) + fib_sequential(n - 2); }
+
+// Fork/join Fibonacci, spawning one task per call above `cutoff`
+uint64_t fib_tasks(ndash::thread_pool& pool, unsigned n, unsigned cutoff) {
+    if (n < cutoff) return fib_sequential(n);
+    uint64_t a = 0;
+    ndash::task_group group(pool);
+    group.spawn([&]() { a = fib_tasks(pool, n - 1, cutoff); });
+    uint64_t b = fib_tasks(pool, n - 2, cutoff);
+    group.wait();
+    return a + b;
+}
+
+}   // namespace
+
+// Task spawn, steal and wake-up costs of the work-stealing pool, against a thread per task
+//
+// Usage: bench_thread_pool [num_threads] [num_tasks]
+int main(int argc, char** argv) {
+    unsigned num_threads = unsigned(bench_arg(argc, argv, 1, std::thread::hardware_concurrency()));
+    size_t num_tasks = bench_arg(argc, argv, 2, 1000000);
+    ndash::thread_pool pool(num_threads);
+
+    run_benchmark("fib_30_sequential", 3, [&]() { do_not_optimize(fib_sequential(30)); });
+    run_benchmark("fib_30_fork_join_cutoff_16", 3, [&]() { do_not_optimize(fib_tasks(pool, 30, 16)); });
+    run_benchmark("fib_30_fork_join_cutoff_8", 3, [&]() { do_not_optimize(fib_tasks(pool, 30, 8)); });
+
+    // Empty tasks from outside the pool go through the shared queue
+    run_benchmark("spawn_external", 3, [&]() {
+        std::atomic<size_t> ran(0);
+        ndash::task_group group(pool);
+        for (size_t i = 0; i < num_tasks; ++i) group.spawn([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); });
+        group.wait();
+        do_not_optimize(ran.load());
+    }, 0, num_tasks);
+
+    // The same tasks spawned by a worker go to its own deque
+    run_benchmark("spawn_from_worker", 3, [&]() {
+        std::atomic<size_t> ran(0);
+        ndash::task_group outer(pool);
+        outer.spawn([&]() {
+            ndash::task_group group(pool);
+            for (size_t i = 0; i < num_tasks; ++i) {
+                group.spawn([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); });
+            }
+            group.wait();
+        });
+        outer.wait();
+        do_not_optimize(ran.load());
+    }, 0, num_tasks);
+
+    size_t thread_tasks = num_tasks / 100;
+    run_benchmark("thread_per_task", 3, [&]() {
+        std::atomic<size_t> ran(0);
+        ndash::vector<std::thread> threads;
+        for (size_t i = 0; i < thread_tasks; ++i) {
+            threads.emplace_back([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); });
+            if (threads.size() == 64) {
+                for (auto& thread : threads) thread.join();
+                threads.clear();
+            }
+        }
+        for (auto& thread : threads) thread.join();
+        do_not_optimize(ran.load());
+    }, 0, thread_tasks);
+}
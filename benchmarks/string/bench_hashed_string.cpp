@@ -0,0 +1,59 @@
+#include <cstdio>
+#include <random>
+
+#include "benchmark.h"
+#include "hashed_string.h"
+#include "ndstring.h"
+#include "unordered_map.h"
+#include "vector.h"
+
+// Query pipeline touching a term dictionary, a query cache and a stats map per query term
+//
+// Usage: bench_hashed_string [num_terms] [num_queries]
+template <class Key>
+static size_t run_pipeline(const ndash::vector<Key>& terms, const ndash::vector<size_t>& queries) {
+    ndash::unordered_map<Key, size_t> dictionary;
+    ndash::unordered_map<Key, size_t> query_cache;
+    ndash::unordered_map<Key, size_t> stats;
+
+    for (size_t i = 0; i < terms.size(); ++i) {
+        dictionary.emplace(terms[i], i);
+        if (i % 2 == 0) query_cache.emplace(terms[i], i * 3);
+    }
+
+    size_t checksum = 0;
+    for (size_t query : queries) {
+        const Key& term = terms[query];
+
+        auto cached = query_cache.find(term);
+        if (cached != query_cache.end()) {
+            checksum += cached->second;
+        } else {
+            checksum += dictionary.find(term)->second;
+        }
+        stats[term]++;
+    }
+    return checksum + stats.size();
+}
+
+int main(int argc, char** argv) {
+    size_t num_terms = bench_arg(argc, argv, 1, 100000);
+    size_t num_queries = bench_arg(argc, argv, 2, 1000000);
+
+    ndash::vector<ndash::string> terms;
+    ndash::vector<ndash::hashed_string> hashed_terms;
+    for (size_t i = 0; i < num_terms; ++i) {
+        char buf[32];
+        int len = snprintf(buf, sizeof(buf), "query-term-%012zu", i);
+        terms.emplace_back(buf, len);
+        hashed_terms.emplace_back(buf, len);
+    }
+
+    std::mt19937_64 rng(42);
+    ndash::vector<size_t> queries;
+    for (size_t i = 0; i < num_queries; ++i) queries.push_back(rng() % num_terms);
+
+    run_benchmark("string_keys", 3, [&]() { do_not_optimize(run_pipeline(terms, queries)); }, 0, num_queries);
+    run_benchmark("hashed_string_keys", 3, [&]() { do_not_optimize(run_pipeline(hashed_terms, queries)); }, 0,
+                  num_queries);
+}
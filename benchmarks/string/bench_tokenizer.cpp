@@ -0,0 +1,72 @@
+#include <random>
+
+#include "benchmark.h"
+#include "ndstring.h"
+#include "tokenizer.h"
+#include "vector.h"
+
+// Tokenizer throughput on plain text against splitting into one `ndash::string` per token
+//
+// Usage: bench_tokenizer [bytes]
+int main(int argc, char** argv) {
+    size_t bytes = bench_arg(argc, argv, 1, 256 << 20);
+
+    // Words of 1 to 12 letters separated by spaces and the occasional punctuation
+    std::mt19937 rng(42);
+    ndash::string text;
+    text.reserve(bytes);
+    while (text.size() + 16 < bytes) {
+        size_t word = 1 + rng() % 12;
+        for (size_t i = 0; i < word; ++i) text.push_back(static_cast<char>('a' + rng() % 26));
+        unsigned r = rng() % 10;
+        text.push_back(r == 0 ? ',' : (r == 1 ? '.' : ' '));
+        if (r == 1) text.push_back(' ');
+    }
+
+    ndash::tokenizer tok;
+    ndash::vector<ndash::token> tokens;
+    tokens.reserve(text.size() / 4);
+
+    run_benchmark("count", 5, [&]() { do_not_optimize(tok.count(text)); }, text.size());
+    run_benchmark(
+      "tokenize", 5,
+      [&]() {
+          tokens.clear();
+          tok.tokenize(text.data(), text.size(), tokens);
+          do_not_optimize(tokens.size());
+      },
+      text.size());
+    run_benchmark(
+      "streaming_64k", 5,
+      [&]() {
+          ndash::tokenizer::stream stream(tok);
+          size_t n = 0;
+          for (size_t pos = 0; pos < text.size(); pos += 65536) {
+              size_t len = text.size() - pos < 65536 ? text.size() - pos : 65536;
+              stream.feed(text.data() + pos, len, [&](ndash::string_view, size_t) { ++n; });
+          }
+          stream.finish([&](ndash::string_view, size_t) { ++n; });
+          do_not_optimize(n);
+      },
+      text.size());
+
+    // The allocating baseline is slow, so it only runs over a prefix
+    size_t baseline_bytes = text.size() < (16 << 20) ? text.size() : (16 << 20);
+    run_benchmark(
+      "split_into_strings", 1,
+      [&]() {
+          ndash::vector<ndash::string> words;
+          ndash::string current;
+          for (size_t i = 0; i < baseline_bytes; ++i) {
+              char ch = text[i];
+              if (ch == ' ' || ch == ',' || ch == '.') {
+                  if (!current.empty()) words.push_back(current);
+                  current.clear();
+              } else {
+                  current.push_back(ch);
+              }
+          }
+          do_not_optimize(words.size());
+      },
+      baseline_bytes);
+}
@@ -0,0 +1,46 @@
+#include <random>
+
+#include "benchmark.h"
+#include "ndstring.h"
+#include "utf8.h"
+
+// Validation, ASCII lowercasing and case folding throughput against a per byte loop over `operator[]`
+//
+// Usage: bench_utf8 [bytes]
+int main(int argc, char** argv) {
+    size_t bytes = bench_arg(argc, argv, 1, 64 << 20);
+
+    // Mostly ASCII text with an occasional two byte letter, like typical western documents
+    std::mt19937 rng(42);
+    ndash::string text;
+    text.reserve(bytes);
+    while (text.size() + 2 < bytes) {
+        unsigned r = rng() % 100;
+        if (r < 15) {
+            text.push_back(' ');
+        } else if (r < 17) {
+            text.append("\xC3\x89");
+        } else {
+            text.push_back(static_cast<char>((r % 2 ? 'A' : 'a') + rng() % 26));
+        }
+    }
+
+    ndash::string out(ndash::utf8::max_fold_size(text.size()), '\0');
+
+    run_benchmark("validate", 5, [&]() { do_not_optimize(ndash::utf8::validate(text)); }, text.size());
+    run_benchmark(
+      "to_lower_ascii", 5, [&]() { ndash::utf8::to_lower_ascii(text.data(), text.size(), out.data()); }, text.size());
+    run_benchmark(
+      "fold_case", 5, [&]() { do_not_optimize(ndash::utf8::fold_case(text.data(), text.size(), out.data())); },
+      text.size());
+    run_benchmark(
+      "per_byte_lowercase", 5,
+      [&]() {
+          for (size_t i = 0; i < text.size(); ++i) {
+              char ch = text[i];
+              out[i] = (ch >= 'A' && ch <= 'Z') ? ch + 32 : ch;
+          }
+          do_not_optimize(out);
+      },
+      text.size());
+}
@@ -0,0 +1,469 @@
+#ifndef CONCURRENT_QUEUE_H
+#define CONCURRENT_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace ndash {
+
+namespace detail {
+
+// Tries of a blocking operation before it sleeps
+constexpr const int QUEUE_SPINS = 64;
+
+// Smallest power of 2 at or above `n`, and at least 2
+inline size_t queue_capacity(size_t n) {
+    size_t capacity = 2;
+    while (capacity < n) capacity *= 2;
+    return capacity;
+}
+
+// Lets threads sleep until another thread reports progress
+//
+// The notifying side pays one load unless a thread is actually waiting. A waiter registers before its last try and
+// the notifier checks for waiters after making progress, so one of them always sees the other
+class queue_event {
+public:
+    queue_event()
+        : _epoch(0)
+        , _waiters(0) {}
+
+    // Call `try_op()` until it returns true, spinning briefly and then sleeping until `notify`
+    template <class TryOp>
+    void wait_until(TryOp try_op) {
+        for (int spin = 0; spin < QUEUE_SPINS; ++spin) {
+            if (try_op()) return;
+            if (spin >= QUEUE_SPINS / 2) std::this_thread::yield();
+        }
+
+        for (;;) {
+            _waiters.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            uint32_t epoch = _epoch.load(std::memory_order_acquire);
+            bool done = try_op();
+            if (!done) _epoch.wait(epoch, std::memory_order_acquire);
+            _waiters.fetch_sub(1, std::memory_order_relaxed);
+            if (done || try_op()) return;
+        }
+    }
+
+    // Wake the threads sleeping in `wait_until`
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_waiters.load(std::memory_order_relaxed)) {
+            _epoch.fetch_add(1, std::memory_order_release);
+            _epoch.notify_all();
+        }
+    }
+
+private:
+    std::atomic<uint32_t> _epoch;
+    std::atomic<uint32_t> _waiters;
+};
+
+}   // namespace detail
+
+// Bounded queue any number of threads can push to and pop from without locking (Vyukov's bounded MPMC queue)
+//
+// Each cell carries a sequence number saying whose turn it is: a producer may fill the cell for position `p` when
+// its sequence is `p`, and a consumer may empty it when the sequence is `p + 1`. Claiming a position is a single
+// compare-and-swap on the shared head or tail, and producers and consumers only meet on cells. The capacity is
+// rounded up to a power of 2 and allocated once
+//
+// A claimed cell must be published, or every later position stalls behind it, so elements must move without
+// throwing. Copies that may throw are made before a position is claimed
+//
+// Blocking operations spin briefly and then sleep until the other side makes progress. Destruction must not run
+// concurrently with other operations
+template <typename T>
+class mpmc_queue {
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>,
+                  "mpmc_queue elements must move without throwing");
+
+    struct cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructs an empty queue holding up to `capacity` elements, rounded up to a power of 2
+    explicit mpmc_queue(size_t capacity)
+        : _cells(nullptr)
+        , _mask(detail::queue_capacity(capacity) - 1)
+        , _tail(0)
+        , _head(0)
+        , _not_full()
+        , _not_empty() {
+        _cells = static_cast<cell*>(::operator new(sizeof(cell) * (_mask + 1), std::align_val_t(alignof(cell))));
+        for (size_t i = 0; i <= _mask; ++i) new (&_cells[i].sequence) std::atomic<size_t>(i);
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    // Destroys the elements still queued
+    ~mpmc_queue() {
+        for (size_t pos = _head.load(std::memory_order_relaxed); pos != _tail.load(std::memory_order_relaxed); ++pos) {
+            _cells[pos & _mask].value()->~T();
+        }
+        ::operator delete(_cells, std::align_val_t(alignof(cell)));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Maximum number of queued elements
+    size_t capacity() const { return _mask + 1; }
+
+    // Number of queued elements at some point during the call, counting ones being pushed or popped
+    size_t size() const {
+        size_t head = _head.load(std::memory_order_acquire);
+        size_t tail = _tail.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    // Check if the queue looked empty at some point during the call
+    bool empty() const { return !size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Add `value` at the back unless the queue is full. Returns whether it was added; if not, `value` is untouched
+    bool try_push(const T& value) { return emplace_impl(value); }
+
+    // Add `value` at the back unless the queue is full. Returns whether it was added; if not, `value` is untouched
+    bool try_push(T&& value) { return emplace_impl(std::move(value)); }
+
+    // Add `value` at the back, waiting for room if the queue is full
+    void push(const T& value) {
+        if constexpr (std::is_nothrow_copy_constructible_v<T>) {
+            _not_full.wait_until([&]() { return emplace_impl(value); });
+        } else {
+            push(T(value));
+        }
+    }
+
+    // Add `value` at the back, waiting for room if the queue is full
+    void push(T&& value) {
+        _not_full.wait_until([&]() { return emplace_impl(std::move(value)); });
+    }
+
+    // Remove the front element into `out` unless the queue is empty. Returns whether one was removed
+    bool try_pop(T& out) {
+        size_t pos;
+        if (!claim<false>(pos, 1)) return false;
+        take(pos, out);
+        return true;
+    }
+
+    // Remove and return the front element, waiting for one if the queue is empty
+    T pop() {
+        size_t pos = 0;
+        _not_empty.wait_until([&]() { return claim<false>(pos, 1) != 0; });
+        cell& c = _cells[pos & _mask];
+        T value(std::move(*c.value()));
+        c.value()->~T();
+        c.sequence.store(pos + _mask + 1, std::memory_order_release);
+        _not_full.notify();
+        return value;
+    }
+
+    // Move up to `count` elements from `values` to the back in one claim, as many as there is room for. Returns the
+    // number added; those are moved from, the rest untouched
+    size_t try_push_batch(T* values, size_t count) {
+        size_t pos;
+        size_t claimed = claim<true>(pos, count);
+        for (size_t i = 0; i < claimed; ++i) put(pos + i, std::move(values[i]), false);
+        if (claimed) _not_empty.notify();
+        return claimed;
+    }
+
+    // Move all `count` elements from `values` to the back, waiting for room as needed
+    void push_batch(T* values, size_t count) {
+        while (count) {
+            size_t pushed = 0;
+            _not_full.wait_until([&]() { return (pushed = try_push_batch(values, count)) != 0; });
+            values += pushed;
+            count -= pushed;
+        }
+    }
+
+    // Remove up to `max_count` elements from the front into `out` in one claim. Returns the number removed
+    size_t try_pop_batch(T* out, size_t max_count) {
+        size_t pos;
+        size_t claimed = claim<false>(pos, max_count);
+        for (size_t i = 0; i < claimed; ++i) take(pos + i, out[i], false);
+        if (claimed) _not_full.notify();
+        return claimed;
+    }
+
+    // Remove between 1 and `max_count` elements from the front into `out`, waiting if the queue is empty. Returns
+    // the number removed
+    size_t pop_batch(T* out, size_t max_count) {
+        size_t popped = 0;
+        if (max_count) _not_empty.wait_until([&]() { return (popped = try_pop_batch(out, max_count)) != 0; });
+        return popped;
+    }
+
+private:
+    template <typename U>
+    bool emplace_impl(U&& value) {
+        if constexpr (!std::is_nothrow_constructible_v<T, U&&>) {
+            T copy(std::forward<U>(value));
+            return emplace_impl(std::move(copy));
+        }
+        size_t pos;
+        if (!claim<true>(pos, 1)) return false;
+        put(pos, std::forward<U>(value));
+        return true;
+    }
+
+    // Claim up to `count` consecutive positions at the tail (`Push`) or head, storing the first in `pos`. Returns
+    // the number claimed, which is 0 when the queue is full or empty
+    //
+    // A position is ready when its cell's sequence is the position, plus 1 for consumers. Cells are released out of
+    // order, so only the ready prefix of the range is claimed
+    template <bool Push>
+    size_t claim(size_t& pos, size_t count) {
+        std::atomic<size_t>& index = Push ? _tail : _head;
+        pos = index.load(std::memory_order_relaxed);
+        for (;;) {
+            size_t ready = 0;
+            for (; ready < count && ready <= _mask; ++ready) {
+                size_t expected = pos + ready + (Push ? 0 : 1);
+                if (_cells[(pos + ready) & _mask].sequence.load(std::memory_order_acquire) != expected) break;
+            }
+
+            if (ready) {
+                if (index.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) return ready;
+                continue;
+            }
+
+            // A sequence behind the position means a full or empty queue; ahead means another thread claimed it
+            size_t expected = pos + (Push ? 0 : 1);
+            intptr_t behind = intptr_t(_cells[pos & _mask].sequence.load(std::memory_order_acquire) - expected);
+            if (behind < 0) return 0;
+            pos = index.load(std::memory_order_relaxed);
+        }
+    }
+
+    template <typename U>
+    void put(size_t pos, U&& value, bool notify = true) {
+        cell& c = _cells[pos & _mask];
+        new (c.storage) T(std::forward<U>(value));
+        c.sequence.store(pos + 1, std::memory_order_release);
+        if (notify) _not_empty.notify();
+    }
+
+    void take(size_t pos, T& out, bool notify = true) {
+        cell& c = _cells[pos & _mask];
+        out = std::move(*c.value());
+        c.value()->~T();
+        c.sequence.store(pos + _mask + 1, std::memory_order_release);
+        if (notify) _not_full.notify();
+    }
+
+    cell* _cells;
+    size_t _mask;
+    alignas(64) std::atomic<size_t> _tail;
+    alignas(64) std::atomic<size_t> _head;
+    alignas(64) detail::queue_event _not_full;
+    alignas(64) detail::queue_event _not_empty;
+};
+
+// Bounded ring passing elements from one producer thread to one consumer thread without locking
+//
+// The producer only writes the tail and the consumer only writes the head, each on its own cache line. Each side
+// also keeps a private copy of the other's index and rereads the shared one only when the copy says the ring is
+// full or empty, so in steady state a push or pop touches no cache line the other thread writes. Batch operations
+// publish many elements with one index store. The capacity is rounded up to a power of 2
+//
+// Destruction must not run concurrently with other operations
+template <typename T>
+class spsc_ring {
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructs an empty ring holding up to `capacity` elements, rounded up to a power of 2
+    explicit spsc_ring(size_t capacity)
+        : _data(nullptr)
+        , _mask(detail::queue_capacity(capacity) - 1)
+        , _tail(0)
+        , _cached_head(0)
+        , _head(0)
+        , _cached_tail(0)
+        , _not_full()
+        , _not_empty() {
+        _data = static_cast<T*>(::operator new(sizeof(T) * (_mask + 1), std::align_val_t(alignof(T))));
+    }
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    // Destroys the elements still queued
+    ~spsc_ring() {
+        for (size_t pos = _head.load(std::memory_order_relaxed); pos != _tail.load(std::memory_order_relaxed); ++pos) {
+            _data[pos & _mask].~T();
+        }
+        ::operator delete(_data, std::align_val_t(alignof(T)));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Maximum number of queued elements
+    size_t capacity() const { return _mask + 1; }
+
+    // Number of queued elements at some point during the call
+    size_t size() const {
+        size_t head = _head.load(std::memory_order_acquire);
+        return _tail.load(std::memory_order_acquire) - head;
+    }
+
+    // Check if the ring looked empty at some point during the call
+    bool empty() const { return !size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Add `value` at the back unless the ring is full. Returns whether it was added. Producer only
+    bool try_push(const T& value) { return emplace_impl(value); }
+
+    // Add `value` at the back unless the ring is full. Returns whether it was added; if not, `value` is untouched.
+    // Producer only
+    bool try_push(T&& value) { return emplace_impl(std::move(value)); }
+
+    // Add `value` at the back, waiting for room if the ring is full. Producer only
+    void push(const T& value) {
+        _not_full.wait_until([&]() { return emplace_impl(value); });
+    }
+
+    // Add `value` at the back, waiting for room if the ring is full. Producer only
+    void push(T&& value) {
+        _not_full.wait_until([&]() { return emplace_impl(std::move(value)); });
+    }
+
+    // Remove the front element into `out` unless the ring is empty. Returns whether one was removed. Consumer only
+    bool try_pop(T& out) { return try_pop_batch(&out, 1) == 1; }
+
+    // Remove and return the front element, waiting for one if the ring is empty. Consumer only
+    T pop() {
+        _not_empty.wait_until([&]() { return readable(1) != 0; });
+        size_t head = _head.load(std::memory_order_relaxed);
+        T value(std::move(_data[head & _mask]));
+        _data[head & _mask].~T();
+        _head.store(head + 1, std::memory_order_release);
+        _not_full.notify();
+        return value;
+    }
+
+    // Move up to `count` elements from `values` to the back, as many as there is room for. Returns the number
+    // added; those are moved from, the rest untouched. Producer only
+    size_t try_push_batch(T* values, size_t count) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t room = writable(count);
+        for (size_t i = 0; i < room; ++i) new (&_data[(tail + i) & _mask]) T(std::move(values[i]));
+        if (room) {
+            _tail.store(tail + room, std::memory_order_release);
+            _not_empty.notify();
+        }
+        return room;
+    }
+
+    // Move all `count` elements from `values` to the back, waiting for room as needed. Producer only
+    void push_batch(T* values, size_t count) {
+        while (count) {
+            size_t pushed = 0;
+            _not_full.wait_until([&]() { return (pushed = try_push_batch(values, count)) != 0; });
+            values += pushed;
+            count -= pushed;
+        }
+    }
+
+    // Remove up to `max_count` elements from the front into `out`. Returns the number removed. Consumer only
+    size_t try_pop_batch(T* out, size_t max_count) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t available = readable(max_count);
+        for (size_t i = 0; i < available; ++i) {
+            T& value = _data[(head + i) & _mask];
+            out[i] = std::move(value);
+            value.~T();
+        }
+        if (available) {
+            _head.store(head + available, std::memory_order_release);
+            _not_full.notify();
+        }
+        return available;
+    }
+
+    // Remove between 1 and `max_count` elements from the front into `out`, waiting if the ring is empty. Returns
+    // the number removed. Consumer only
+    size_t pop_batch(T* out, size_t max_count) {
+        size_t popped = 0;
+        if (max_count) _not_empty.wait_until([&]() { return (popped = try_pop_batch(out, max_count)) != 0; });
+        return popped;
+    }
+
+private:
+    template <typename U>
+    bool emplace_impl(U&& value) {
+        if (!writable(1)) return false;
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        new (&_data[tail & _mask]) T(std::forward<U>(value));
+        _tail.store(tail + 1, std::memory_order_release);
+        _not_empty.notify();
+        return true;
+    }
+
+    // Free slots up to `count`, rereading the consumer's head only if the cached one shows too few
+    size_t writable(size_t count) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t room = capacity() - (tail - _cached_head);
+        if (room < count) {
+            _cached_head = _head.load(std::memory_order_acquire);
+            room = capacity() - (tail - _cached_head);
+        }
+        return room < count ? room : count;
+    }
+
+    // Queued elements up to `count`, rereading the producer's tail only if the cached one shows too few
+    size_t readable(size_t count) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t available = _cached_tail - head;
+        if (available < count) {
+            _cached_tail = _tail.load(std::memory_order_acquire);
+            available = _cached_tail - head;
+        }
+        return available < count ? available : count;
+    }
+
+    T* _data;
+    size_t _mask;
+    alignas(64) std::atomic<size_t> _tail;
+    size_t _cached_head;
+    alignas(64) std::atomic<size_t> _head;
+    size_t _cached_tail;
+    alignas(64) detail::queue_event _not_full;
+    alignas(64) detail::queue_event _not_empty;
+};
+
+}   // namespace ndash
+
+#endif   // CONCURRENT_QUEUE_H
@@ -0,0 +1,328 @@
+#ifndef CONCURRENT_SKIPLIST_H
+#define CONCURRENT_SKIPLIST_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "concurrent_vector.h"
+#include "iterator.h"
+#include "pair.h"
+
+namespace ndash {
+
+// Sorted map that many threads can insert into and read from without locking
+//
+// Each element is a node linked into a sorted list on level 0 and, with probability 1/4 per level, on the levels
+// above it, which let searches skip ahead. Insertion links a node bottom-up with one compare-and-swap per level,
+// retrying a level from its last predecessor when another insert got in between. Elements are never removed, so
+// lookups and iterators follow links without retrying or waiting, and see every insert completed before they reach
+// its position. An iterator may or may not see elements inserted ahead of it while it advances
+//
+// With `FixedHeight` 0 each node is allocated on its own with a tower of the height it drew. With a `FixedHeight`,
+// towers are capped at that height and every node takes a slot of that size in a `concurrent_vector` arena, so
+// nodes sit next to each other in insertion order and the allocator is left out of inserts except to add an arena
+// block, which any inserting thread may do without waiting on the others. Searches walk the top
+// level linearly, so `FixedHeight` should be near log4 of the expected size
+//
+// Destruction must not run concurrently with other operations
+template <typename K, typename V, class Compare = std::less<K>, unsigned FixedHeight = 0>
+class concurrent_skiplist {
+    template <typename T2>
+    struct Iterator;
+
+    struct node;
+    using link = std::atomic<node*>;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = ndash::pair<const K, V>;
+    using iterator = Iterator<value_type>;
+    using const_iterator = Iterator<const value_type>;
+
+    // Tallest tower a node can draw
+    static constexpr const unsigned MAX_HEIGHT = FixedHeight ? FixedHeight : 24;
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructs an empty list ordered by `comp`
+    explicit concurrent_skiplist(const Compare& comp = Compare())
+        : _comp(comp)
+        , _height(1)
+        , _size(0)
+        , _arena() {
+        for (link& head : _head) head.store(nullptr, std::memory_order_relaxed);
+    }
+
+    concurrent_skiplist(const concurrent_skiplist&) = delete;
+    concurrent_skiplist& operator=(const concurrent_skiplist&) = delete;
+
+    // Destructor
+    ~concurrent_skiplist() {
+        node* n = _head[0].load(std::memory_order_relaxed);
+        while (n) {
+            node* next = n->next()[0].load(std::memory_order_relaxed);
+            n->entry.~value_type();
+            if constexpr (!FixedHeight) ::operator delete(n, std::align_val_t(NODE_ALIGN));
+            n = next;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Number of elements whose insertion has completed
+    size_t size() const { return _size.load(std::memory_order_acquire); }
+
+    // Check if no insertion has completed
+    bool empty() const { return !size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Inserts a copy of `value` unless its key is present. Returns the element with the key and whether it was added
+    ndash::pair<iterator, bool> insert(const value_type& value) { return emplace(value.first, value.second); }
+
+    // Inserts `value` using move semantics unless its key is present
+    ndash::pair<iterator, bool> insert(value_type&& value) {
+        return emplace(value.first, std::move(value.second));
+    }
+
+    // Inserts an element with `key` and a value constructed from `args` unless `key` is present. Returns the element
+    // with the key and whether it was added
+    //
+    // The value is only constructed once no element with `key` was found, but a concurrent insert of the same key
+    // can still win the race, in which case the new element is destroyed
+    template <class... Args>
+    ndash::pair<iterator, bool> emplace(const K& key, Args&&... args) {
+        link* preds[MAX_HEIGHT];
+        node* succs[MAX_HEIGHT];
+        find_splice(key, preds, succs);
+        if (matches(succs[0], key)) return { iterator(succs[0]), false };
+
+        unsigned height = random_height();
+        node* fresh = make_node(height, key, std::forward<Args>(args)...);
+        link* tower = fresh->next();
+        for (unsigned level = 0; level < height; ++level) tower[level].store(succs[level], std::memory_order_relaxed);
+
+        // Linking level 0 inserts the element; the levels above only speed up searches
+        while (!preds[0][0].compare_exchange_weak(succs[0], fresh, std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+            advance(preds[0], succs[0], 0, key);
+            if (matches(succs[0], key)) {
+                destroy_node(fresh);
+                return { iterator(succs[0]), false };
+            }
+            tower[0].store(succs[0], std::memory_order_relaxed);
+        }
+        _size.fetch_add(1, std::memory_order_release);
+
+        unsigned top = _height.load(std::memory_order_relaxed);
+        while (top < height
+               && !_height.compare_exchange_weak(top, height, std::memory_order_relaxed, std::memory_order_relaxed)) {}
+
+        for (unsigned level = 1; level < height; ++level) {
+            while (!preds[level][level].compare_exchange_weak(succs[level], fresh, std::memory_order_release,
+                                                              std::memory_order_relaxed)) {
+                advance(preds[level], succs[level], level, key);
+                tower[level].store(succs[level], std::memory_order_relaxed);
+            }
+        }
+        return { iterator(fresh), true };
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Operations //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Get an iterator to the element with `key`, or `end()` if there is none
+    iterator find(const K& key) {
+        node* n = search(key);
+        return iterator(matches(n, key) ? n : nullptr);
+    }
+
+    // Get a const iterator to the element with `key`, or `end()` if there is none
+    const_iterator find(const K& key) const {
+        node* n = search(key);
+        return const_iterator(matches(n, key) ? n : nullptr);
+    }
+
+    // Check if an element with `key` is present
+    bool contains(const K& key) const { return matches(search(key), key); }
+
+    // Get an iterator to the first element whose key is not less than `key`
+    iterator lower_bound(const K& key) { return iterator(search(key)); }
+
+    // Get a const iterator to the first element whose key is not less than `key`
+    const_iterator lower_bound(const K& key) const { return const_iterator(search(key)); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Iterators ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+private:
+    // Skip list iterator, following level 0
+    template <typename T2>
+    struct Iterator {
+        using value_type = T2;
+        using reference = T2&;
+        using pointer = T2*;
+        using difference_type = ptrdiff_t;
+
+        constexpr Iterator()
+            : _node(nullptr) {}
+
+        constexpr explicit Iterator(node* n)
+            : _node(n) {}
+
+        template <class U>
+        constexpr Iterator(const Iterator<U>& other)
+        requires std::is_same_v<T2, const U>
+            : _node(other._node) {}
+
+        reference operator*() const { return _node->entry; }
+        pointer operator->() const { return &_node->entry; }
+
+        Iterator& operator++() {
+            _node = _node->next()[0].load(std::memory_order_acquire);
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        friend bool constexpr operator==(const Iterator& a, const Iterator& b) { return a._node == b._node; }
+        friend bool constexpr operator!=(const Iterator& a, const Iterator& b) { return !(a == b); }
+
+    private:
+        template <typename>
+        friend struct Iterator;
+
+        node* _node;
+    };
+
+public:
+    static_assert(forward_iterator<iterator>);
+    static_assert(forward_iterator<const_iterator>);
+
+    // Iterator begin
+    iterator begin() { return iterator(_head[0].load(std::memory_order_acquire)); }
+    const_iterator begin() const { return const_iterator(_head[0].load(std::memory_order_acquire)); }
+
+    // Iterator end
+    iterator end() { return iterator(); }
+    const_iterator end() const { return const_iterator(); }
+
+private:
+    // Element followed by its tower of `height` links, one per level
+    struct node {
+        template <class... Args>
+        node(unsigned h, const K& key, Args&&... args)
+            : entry(key, V(std::forward<Args>(args)...))
+            , height(h) {}
+
+        value_type entry;
+        unsigned height;
+
+        link* next() { return reinterpret_cast<link*>(reinterpret_cast<char*>(this) + TOWER_OFFSET); }
+    };
+
+    static constexpr const size_t TOWER_OFFSET = (sizeof(node) + alignof(link) - 1) / alignof(link) * alignof(link);
+    static constexpr const size_t NODE_ALIGN = alignof(node) > alignof(link) ? alignof(node) : alignof(link);
+
+    static constexpr const size_t ARENA_SLOT_SIZE = TOWER_OFFSET + MAX_HEIGHT * sizeof(link);
+
+    // Arena slot holding a node with a full `FixedHeight` tower, on a single cache line when it fits in one
+    struct alignas(ARENA_SLOT_SIZE <= 64 ? 64 : NODE_ALIGN) arena_slot {
+        // Left uninitialized, the node is constructed into it. Can't throw, so claiming a slot never fails
+        arena_slot() noexcept {}
+
+        unsigned char bytes[ARENA_SLOT_SIZE];
+    };
+
+    struct no_arena {};
+
+    using arena_type = std::conditional_t<FixedHeight != 0, concurrent_vector<arena_slot>, no_arena>;
+
+    // Draw a tower height, each level above the first kept with probability 1/4
+    static unsigned random_height() {
+        thread_local uint64_t state = reinterpret_cast<uintptr_t>(&state) * 0x9e3779b97f4a7c15ull | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        unsigned height = 1 + unsigned(__builtin_ctzll(state | (uint64_t(1) << 62))) / 2;
+        return height < MAX_HEIGHT ? height : MAX_HEIGHT;
+    }
+
+    template <class... Args>
+    node* make_node(unsigned height, const K& key, Args&&... args) {
+        void* memory;
+        if constexpr (FixedHeight) {
+            memory = &_arena[_arena.emplace_back()];
+        } else {
+            memory = ::operator new(TOWER_OFFSET + height * sizeof(link), std::align_val_t(NODE_ALIGN));
+        }
+        node* n = new (memory) node(height, key, std::forward<Args>(args)...);
+        link* tower = n->next();
+        for (unsigned level = 0; level < height; ++level) new (tower + level) link(nullptr);
+        return n;
+    }
+
+    // Release a node that was never linked; an arena slot stays unused
+    void destroy_node(node* n) {
+        n->entry.~value_type();
+        if constexpr (!FixedHeight) ::operator delete(n, std::align_val_t(NODE_ALIGN));
+    }
+
+    bool matches(const node* n, const K& key) const { return n && !_comp(key, n->entry.first); }
+
+    // Move `pred` along `level` past every node less than `key`, leaving `succ` at the first node that is not
+    void advance(link*& pred, node*& succ, unsigned level, const K& key) const {
+        succ = pred[level].load(std::memory_order_acquire);
+        while (succ && _comp(succ->entry.first, key)) {
+            pred = succ->next();
+            succ = pred[level].load(std::memory_order_acquire);
+        }
+    }
+
+    // First node whose key is not less than `key`, or null
+    node* search(const K& key) const {
+        link* pred = const_cast<link*>(_head);
+        node* succ = nullptr;
+        for (unsigned level = _height.load(std::memory_order_relaxed); level-- > 0;) advance(pred, succ, level, key);
+        return succ;
+    }
+
+    // Fill `preds` with the towers of the last nodes before `key` on every level and `succs` with the nodes after
+    void find_splice(const K& key, link** preds, node** succs) const {
+        link* pred = const_cast<link*>(_head);
+        node* succ = nullptr;
+        for (unsigned level = MAX_HEIGHT; level-- > 0;) {
+            advance(pred, succ, level, key);
+            preds[level] = pred;
+            succs[level] = succ;
+        }
+    }
+
+    [[no_unique_address]] Compare _comp;
+    std::atomic<unsigned> _height;
+    alignas(64) std::atomic<size_t> _size;
+    alignas(64) link _head[MAX_HEIGHT];
+    [[no_unique_address]] arena_type _arena;
+};
+
+}   // namespace ndash
+
+#endif   // CONCURRENT_SKIPLIST_H
@@ -0,0 +1,361 @@
+#ifndef CONCURRENT_VECTOR_H
+#define CONCURRENT_VECTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "iterator.h"
+#include "segmented_vector.h"
+
+namespace ndash {
+
+// Vector that many threads can append to without locking
+//
+// `push_back` reserves a slot with an atomic fetch-add and constructs the element in place. Storage is a series of
+// geometrically growing blocks, as in `segmented_vector`, so growing adds a block and never moves an element.
+// Elements can finish construction out of order; `size` publishes the longest prefix of finished elements, and
+// indexing below a published size is safe from any thread while appends continue. Appending never waits on
+// another thread: whichever appender first needs a block allocates it and installs it with a compare-and-swap
+//
+// A slot whose element threw during construction is marked failed and holds no element. `size` steps over it so
+// later elements still publish; `constructed` tells readers which slots to skip. When a block can't be allocated,
+// the appender that needed it marks the whole block failed, as none of its elements can exist yet, and rethrows.
+// Later appends landing in that block throw `std::bad_alloc`, and `size` steps over all of it
+//
+// `clear`, `reserve` and destruction must not run concurrently with other operations
+template <typename T, size_t FirstBlockBits = segmented_first_block_bits<T>()>
+class concurrent_vector {
+    static constexpr const size_t FIRST_BLOCK_SIZE = size_t(1) << FirstBlockBits;
+    static constexpr const size_t MAX_BLOCKS = 64 - FirstBlockBits;
+
+    // States of a slot's construction flag
+    static constexpr const uint8_t PENDING = 0;
+    static constexpr const uint8_t READY = 1;
+    static constexpr const uint8_t FAILED = 2;
+
+    template <typename T2>
+    struct Iterator;
+
+public:
+    using iterator = Iterator<T>;
+    using const_iterator = Iterator<const T>;
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor
+    //
+    // Initializes to size 0 without allocating
+    concurrent_vector()
+        : _reserved(0)
+        , _published(0)
+        , _blocks {} {}
+
+    concurrent_vector(const concurrent_vector&) = delete;
+    concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+    // Destructor
+    ~concurrent_vector() {
+        clear();
+        for (size_t block = 0; block < MAX_BLOCKS; ++block) {
+            T* data = _blocks[block].load(std::memory_order_relaxed);
+            if (data) ::operator delete(data, std::align_val_t(alignof(T)));
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////////// Element Access ////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Access specified element, which must be below a published size or appended by this thread
+    T& operator[](size_t pos) { return *slot(pos); }
+
+    // Access specified element by const reference
+    const T& operator[](size_t pos) const { return *slot(pos); }
+
+    // Check if the slot at `pos`, below a published size, holds an element rather than a failed construction
+    bool constructed(size_t pos) const {
+        T* data = _blocks[block_of(pos)].load(std::memory_order_acquire);
+        if (!data || data == failed_block()) return false;
+        return ready_flags(data, block_of(pos))[offset_of(pos)].load(std::memory_order_acquire) == READY;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if no element has been published
+    bool empty() const { return size() == 0; }
+
+    // Publish and get the number of leading elements that have finished construction
+    //
+    // Every element below the returned size is safe to read, apart from slots whose construction failed
+    size_t size() const {
+        size_t published = _published.load(std::memory_order_acquire);
+        size_t reserved = _reserved.load(std::memory_order_acquire);
+
+        size_t end = published;
+        while (end < reserved) {
+            size_t block = block_of(end);
+            T* data = _blocks[block].load(std::memory_order_acquire);
+            if (data == failed_block()) {
+                end = capacity_of(block + 1) < reserved ? capacity_of(block + 1) : reserved;
+                continue;
+            }
+            if (!data || ready_flags(data, block)[offset_of(end)].load(std::memory_order_acquire) == PENDING) break;
+            ++end;
+        }
+
+        while (published < end
+               && !_published.compare_exchange_weak(published, end, std::memory_order_release,
+                                                    std::memory_order_acquire)) {}
+        return end > published ? end : published;
+    }
+
+    // Number of slots handed out, including elements still being constructed
+    size_t reserved_size() const { return _reserved.load(std::memory_order_acquire); }
+
+    // Allocate blocks until `new_cap` elements fit
+    void reserve(size_t new_cap) {
+        for (size_t block = 0; capacity_of(block) < new_cap; ++block) ensure_block(block);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Adds a copy of `value` and returns its index
+    size_t push_back(const T& value) { return emplace_back(value); }
+
+    // Adds `value` using move semantics and returns its index
+    size_t push_back(T&& value) { return emplace_back(std::move(value)); }
+
+    // Constructs an element in a newly reserved slot and returns its index
+    template <class... Args>
+    size_t emplace_back(Args&&... args) {
+        size_t index = _reserved.fetch_add(1, std::memory_order_relaxed);
+        size_t block = block_of(index);
+        size_t offset = offset_of(index);
+
+        // Whichever appender first finds the block missing installs it
+        T* data;
+        try {
+            data = ensure_block(block);
+        } catch (const std::bad_alloc&) {
+            // Unless another appender got a block in meanwhile, nothing can have been constructed in this one
+            data = nullptr;
+            if (_blocks[block].compare_exchange_strong(data, failed_block(), std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)
+                || data == failed_block()) {
+                throw;
+            }
+        }
+        if (data == failed_block()) throw std::bad_alloc();
+
+        // The halfway point of the previous block allocates ahead so that usually happens off the hot path. If it
+        // fails, the first appender of the next block tries again
+        if (offset == (FIRST_BLOCK_SIZE << block) / 2 && block + 1 < MAX_BLOCKS) {
+            try {
+                ensure_block(block + 1);
+            } catch (const std::bad_alloc&) {}
+        }
+
+        std::atomic<uint8_t>& flag = ready_flags(data, block)[offset];
+        if constexpr (std::is_nothrow_constructible_v<T, Args&&...>) {
+            new (data + offset) T(std::forward<Args>(args)...);
+        } else {
+            try {
+                new (data + offset) T(std::forward<Args>(args)...);
+            } catch (...) {
+                flag.store(FAILED, std::memory_order_release);
+                throw;
+            }
+        }
+        flag.store(READY, std::memory_order_release);
+        return index;
+    }
+
+    // Destroys every element, keeping the blocks. Blocks marked failed are forgotten so later appends try again
+    void clear() {
+        size_t reserved = _reserved.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < reserved; ++i) {
+            size_t block = block_of(i);
+            T* data = _blocks[block].load(std::memory_order_relaxed);
+            if (!data || data == failed_block()) {
+                _blocks[block].store(nullptr, std::memory_order_relaxed);
+                i = capacity_of(block + 1) - 1;
+                continue;
+            }
+            std::atomic<uint8_t>& flag = ready_flags(data, block_of(i))[offset_of(i)];
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                if (flag.load(std::memory_order_relaxed) == READY) data[offset_of(i)].~T();
+            }
+            flag.store(PENDING, std::memory_order_relaxed);
+        }
+        _reserved.store(0, std::memory_order_relaxed);
+        _published.store(0, std::memory_order_relaxed);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Iterators ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+private:
+    // Concurrent vector iterator, by index
+    template <typename T2>
+    struct Iterator {
+        using value = T2;
+        using reference = T2&;
+        using pointer = T2*;
+        using difference_type = ptrdiff_t;
+        using vector_pointer
+          = std::conditional_t<std::is_const_v<T2>, const concurrent_vector*, concurrent_vector*>;
+
+        constexpr Iterator(vector_pointer vec, size_t index)
+            : _vec(vec)
+            , _index(index) {}
+
+        template <class U>
+        constexpr Iterator(const Iterator<U>& other)
+        requires std::is_same_v<T2, const U>
+            : _vec(other._vec)
+            , _index(other._index) {}
+
+        reference operator*() const { return *_vec->slot(_index); }
+        pointer operator->() const { return _vec->slot(_index); }
+
+        constexpr Iterator& operator++() {
+            ++_index;
+            return *this;
+        }
+
+        constexpr Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        constexpr Iterator& operator--() {
+            --_index;
+            return *this;
+        }
+
+        constexpr Iterator operator--(int) {
+            Iterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+        constexpr Iterator& operator+=(ptrdiff_t diff) {
+            _index += diff;
+            return *this;
+        }
+
+        constexpr Iterator& operator-=(ptrdiff_t diff) {
+            _index -= diff;
+            return *this;
+        }
+
+        reference operator[](ptrdiff_t diff) { return *_vec->slot(_index + diff); }
+
+        friend constexpr Iterator operator+(const Iterator& a, ptrdiff_t diff) {
+            return Iterator(a._vec, a._index + diff);
+        }
+        friend constexpr Iterator operator+(ptrdiff_t diff, const Iterator& a) { return a + diff; }
+        friend constexpr Iterator operator-(const Iterator& a, ptrdiff_t diff) {
+            return Iterator(a._vec, a._index - diff);
+        }
+        friend constexpr ptrdiff_t operator-(const Iterator& a, const Iterator& b) {
+            return ptrdiff_t(a._index - b._index);
+        }
+
+        friend bool constexpr operator==(const Iterator& a, const Iterator& b) { return a._index == b._index; }
+        friend bool constexpr operator!=(const Iterator& a, const Iterator& b) { return !(a == b); }
+        friend difference_type constexpr operator<=>(const Iterator& a, const Iterator& b) { return a - b; }
+
+    private:
+        template <typename>
+        friend struct Iterator;
+
+        vector_pointer _vec;
+        size_t _index;
+    };
+
+public:
+    static_assert(random_access_iterator<iterator>);
+    static_assert(random_access_iterator<const_iterator>);
+
+    // Iterator begin
+    iterator begin() { return iterator(this, 0); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+
+    // Iterator end, at the size published when called
+    iterator end() { return iterator(this, size()); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+private:
+    // Block holding the element at `index`
+    static constexpr size_t block_of(size_t index) {
+        return size_t(63 - __builtin_clzll(index + FIRST_BLOCK_SIZE)) - FirstBlockBits;
+    }
+
+    // Position of the element at `index` within its block
+    static constexpr size_t offset_of(size_t index) {
+        size_t shifted = index + FIRST_BLOCK_SIZE;
+        return shifted - (size_t(1) << (63 - __builtin_clzll(shifted)));
+    }
+
+    // Number of elements in the blocks before block `block`
+    static constexpr size_t capacity_of(size_t block) { return (FIRST_BLOCK_SIZE << block) - FIRST_BLOCK_SIZE; }
+
+    // Construction flags of a block, stored after its elements
+    static std::atomic<uint8_t>* ready_flags(T* data, size_t block) {
+        return reinterpret_cast<std::atomic<uint8_t>*>(data + (FIRST_BLOCK_SIZE << block));
+    }
+
+    T* slot(size_t index) const {
+        return _blocks[block_of(index)].load(std::memory_order_acquire) + offset_of(index);
+    }
+
+    // Marker installed in place of a block that couldn't be allocated, never dereferenced
+    static T* failed_block() {
+        alignas(T) static unsigned char marker;
+        return reinterpret_cast<T*>(&marker);
+    }
+
+    // Get block `block`, allocating and installing it if no other thread has. Returns `failed_block()` if the block
+    // is marked failed, and throws `std::bad_alloc` if it can't be allocated
+    T* ensure_block(size_t block) {
+        T* data = _blocks[block].load(std::memory_order_acquire);
+        if (data) return data;
+
+        size_t count = FIRST_BLOCK_SIZE << block;
+        // Each element takes its bytes and a flag byte, and the total must stay below `PTRDIFF_MAX`
+        if (count > size_t(PTRDIFF_MAX) / (sizeof(T) + 1)) throw std::bad_array_new_length();
+        T* fresh = static_cast<T*>(::operator new(count * sizeof(T) + count, std::align_val_t(alignof(T))));
+        std::atomic<uint8_t>* flags = ready_flags(fresh, block);
+        for (size_t i = 0; i < count; ++i) {
+            new (flags + i) std::atomic<uint8_t>(PENDING);
+        }
+
+        if (_blocks[block].compare_exchange_strong(data, fresh, std::memory_order_acq_rel,
+                                                   std::memory_order_acquire)) {
+            return fresh;
+        }
+        ::operator delete(fresh, std::align_val_t(alignof(T)));
+        return data;
+    }
+
+    alignas(64) std::atomic<size_t> _reserved;
+    alignas(64) mutable std::atomic<size_t> _published;
+    alignas(64) std::atomic<T*> _blocks[MAX_BLOCKS];
+};
+
+}   // namespace ndash
+
+#endif   // CONCURRENT_VECTOR_H
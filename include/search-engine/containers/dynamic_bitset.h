@@ -0,0 +1,481 @@
+#ifndef DYNAMIC_BITSET_H
+#define DYNAMIC_BITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "cpu_features.h"
+#include "swap.h"
+#include "vector.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NDASH_BITSET_X86 1
+#endif
+
+namespace ndash {
+
+namespace detail {
+
+// Word-wise operation combining two bitsets
+enum class bit_op { AND, OR, XOR, AND_NOT };
+
+template <bit_op Op>
+constexpr uint64_t apply_bit_op(uint64_t a, uint64_t b) {
+    if constexpr (Op == bit_op::AND) return a & b;
+    if constexpr (Op == bit_op::OR) return a | b;
+    if constexpr (Op == bit_op::XOR) return a ^ b;
+    if constexpr (Op == bit_op::AND_NOT) return a & ~b;
+}
+
+template <bit_op Op>
+inline void bitwise_scalar(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = apply_bit_op<Op>(a[i], b[i]);
+    }
+}
+
+template <bit_op Op>
+inline size_t count_bitwise_scalar(const uint64_t* a, const uint64_t* b, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += __builtin_popcountll(apply_bit_op<Op>(a[i], b[i]));
+    }
+    return count;
+}
+
+inline size_t popcount_scalar(const uint64_t* words, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += __builtin_popcountll(words[i]);
+    }
+    return count;
+}
+
+#ifdef NDASH_BITSET_X86
+
+template <bit_op Op>
+__attribute__((target("avx2"))) inline __m256i apply_bit_op_avx2(__m256i a, __m256i b) {
+    if constexpr (Op == bit_op::AND) return _mm256_and_si256(a, b);
+    if constexpr (Op == bit_op::OR) return _mm256_or_si256(a, b);
+    if constexpr (Op == bit_op::XOR) return _mm256_xor_si256(a, b);
+    if constexpr (Op == bit_op::AND_NOT) return _mm256_andnot_si256(b, a);
+}
+
+// Per 64-bit lane bit counts of `v`, using nibble lookups (Mula, Kurz and Lemire)
+__attribute__((target("avx2"))) inline __m256i popcount_lanes_avx2(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1,
+                                            2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+
+    __m256i low = _mm256_and_si256(v, low_mask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2"))) inline size_t sum_lanes_avx2(__m256i lanes) {
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+    return size_t(_mm_cvtsi128_si64(sum)) + size_t(_mm_extract_epi64(sum, 1));
+}
+
+template <bit_op Op>
+__attribute__((target("avx2"))) inline void bitwise_avx2(uint64_t* dst, const uint64_t* a, const uint64_t* b,
+                                                         size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 4));
+        __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), apply_bit_op_avx2<Op>(a0, b0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 4), apply_bit_op_avx2<Op>(a1, b1));
+    }
+    bitwise_scalar<Op>(dst + i, a + i, b + i, n - i);
+}
+
+template <bit_op Op>
+__attribute__((target("avx2,popcnt"))) inline size_t count_bitwise_avx2(const uint64_t* a, const uint64_t* b,
+                                                                       size_t n) {
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        total = _mm256_add_epi64(total, popcount_lanes_avx2(apply_bit_op_avx2<Op>(va, vb)));
+    }
+
+    size_t count = sum_lanes_avx2(total);
+    for (; i < n; ++i) {
+        count += __builtin_popcountll(apply_bit_op<Op>(a[i], b[i]));
+    }
+    return count;
+}
+
+__attribute__((target("avx2,popcnt"))) inline size_t popcount_avx2(const uint64_t* words, size_t n) {
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        total = _mm256_add_epi64(total,
+                                 popcount_lanes_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i))));
+    }
+
+    size_t count = sum_lanes_avx2(total);
+    for (; i < n; ++i) {
+        count += __builtin_popcountll(words[i]);
+    }
+    return count;
+}
+
+#endif   // NDASH_BITSET_X86
+
+// Write `a[i] op b[i]` to `dst[i]` for `n` words. `dst` may alias `a` or `b`
+template <bit_op Op>
+inline void bitwise(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n) {
+#ifdef NDASH_BITSET_X86
+    if (cpu::has_avx2()) return bitwise_avx2<Op>(dst, a, b, n);
+#endif
+    bitwise_scalar<Op>(dst, a, b, n);
+}
+
+// Number of set bits in `a[i] op b[i]` over `n` words
+template <bit_op Op>
+inline size_t count_bitwise(const uint64_t* a, const uint64_t* b, size_t n) {
+#ifdef NDASH_BITSET_X86
+    if (cpu::has_avx2()) return count_bitwise_avx2<Op>(a, b, n);
+#endif
+    return count_bitwise_scalar<Op>(a, b, n);
+}
+
+// Number of set bits in `n` words
+inline size_t popcount(const uint64_t* words, size_t n) {
+#ifdef NDASH_BITSET_X86
+    if (cpu::has_avx2()) return popcount_avx2(words, n);
+#endif
+    return popcount_scalar(words, n);
+}
+
+inline unsigned select_in_word_scalar(uint64_t word, unsigned k) {
+    for (; k; --k) word &= word - 1;
+    return unsigned(__builtin_ctzll(word));
+}
+
+// Position of the `rank`-th set bit, or clear bit if `Zeros`, at or after bit `from`, which must exist
+template <bool Zeros>
+inline size_t select_bits_scalar(const uint64_t* words, size_t from, size_t rank) {
+    size_t index = from / 64;
+    uint64_t word = (Zeros ? ~words[index] : words[index]) & (~uint64_t(0) << (from % 64));
+    for (size_t count; rank >= (count = size_t(__builtin_popcountll(word)));) {
+        rank -= count;
+        ++index;
+        word = Zeros ? ~words[index] : words[index];
+    }
+    return index * 64 + select_in_word_scalar(word, unsigned(rank));
+}
+
+#ifdef NDASH_BITSET_X86
+
+// Deposit a single bit at the `k`-th set bit of `word` and find it
+__attribute__((target("bmi2"))) inline unsigned select_in_word_bmi2(uint64_t word, unsigned k) {
+    return unsigned(__builtin_ctzll(_pdep_u64(uint64_t(1) << k, word)));
+}
+
+template <bool Zeros>
+__attribute__((target("popcnt,bmi2"))) inline size_t select_bits_bmi2(const uint64_t* words, size_t from,
+                                                                      size_t rank) {
+    size_t index = from / 64;
+    uint64_t word = (Zeros ? ~words[index] : words[index]) & (~uint64_t(0) << (from % 64));
+    for (size_t count; rank >= (count = size_t(__builtin_popcountll(word)));) {
+        rank -= count;
+        ++index;
+        word = Zeros ? ~words[index] : words[index];
+    }
+    return index * 64 + size_t(__builtin_ctzll(_pdep_u64(uint64_t(1) << rank, word)));
+}
+
+#endif   // NDASH_BITSET_X86
+
+// Position of the `k`-th set bit of `word`, counting from 0. `word` must have more than `k` set bits
+inline unsigned select_in_word(uint64_t word, unsigned k) {
+#ifdef NDASH_BITSET_X86
+    if (cpu::has_bmi2()) return select_in_word_bmi2(word, k);
+#endif
+    return select_in_word_scalar(word, k);
+}
+
+// Position of the `rank`-th set bit, or clear bit if `Zeros`, counting from bit `from`
+//
+// Scans whole words with a population count and finishes with an in-word select, so callers keep `from` within a
+// few words of the answer with sampled positions
+template <bool Zeros>
+inline size_t select_bits(const uint64_t* words, size_t from, size_t rank) {
+#ifdef NDASH_BITSET_X86
+    if (cpu::has_bmi2() && cpu::has_popcnt()) return select_bits_bmi2<Zeros>(words, from, rank);
+#endif
+    return select_bits_scalar<Zeros>(words, from, rank);
+}
+
+}   // namespace detail
+
+// Resizable sequence of bits packed into 64-bit words
+//
+// Combining and counting bitsets of the same size runs 256 bits per instruction with AVX2 where available. Bits past
+// `size()` in the last word are always zero, so whole words can be combined and counted without masking
+class dynamic_bitset {
+public:
+    // Special value indicating no position
+    static constexpr const size_t npos = size_t(-1);
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor
+    //
+    // Initializes to an empty bitset
+    dynamic_bitset()
+        : _words()
+        , _size(0) {}
+
+    // Constructs a bitset of `num_bits` bits, all set to `value`
+    explicit dynamic_bitset(size_t num_bits, bool value = false)
+        : _words(words_for(num_bits), value ? ~uint64_t(0) : uint64_t(0))
+        , _size(num_bits) {
+        trim();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////////// Element Access ////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if bit `pos` is set
+    bool test(size_t pos) const { return (_words[pos / 64] >> (pos % 64)) & 1; }
+
+    // Check if bit `pos` is set
+    bool operator[](size_t pos) const { return test(pos); }
+
+    // Directly access the words, least significant bit first
+    const uint64_t* data() const { return _words.data(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if bitset has no bits
+    bool empty() const { return _size == 0; }
+
+    // Number of bits
+    size_t size() const { return _size; }
+
+    // Number of 64-bit words holding the bits
+    size_t num_words() const { return _words.size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Set bit `pos`
+    dynamic_bitset& set(size_t pos) {
+        _words[pos / 64] |= uint64_t(1) << (pos % 64);
+        return *this;
+    }
+
+    // Set bit `pos` to `value`
+    dynamic_bitset& set(size_t pos, bool value) { return value ? set(pos) : reset(pos); }
+
+    // Set every bit
+    dynamic_bitset& set() {
+        for (auto& word : _words) word = ~uint64_t(0);
+        trim();
+        return *this;
+    }
+
+    // Clear bit `pos`
+    dynamic_bitset& reset(size_t pos) {
+        _words[pos / 64] &= ~(uint64_t(1) << (pos % 64));
+        return *this;
+    }
+
+    // Clear every bit
+    dynamic_bitset& reset() {
+        if (!_words.empty()) std::memset(_words.data(), 0, _words.size() * sizeof(uint64_t));
+        return *this;
+    }
+
+    // Toggle bit `pos`
+    dynamic_bitset& flip(size_t pos) {
+        _words[pos / 64] ^= uint64_t(1) << (pos % 64);
+        return *this;
+    }
+
+    // Toggle every bit
+    dynamic_bitset& flip() {
+        for (auto& word : _words) word = ~word;
+        trim();
+        return *this;
+    }
+
+    // Resize to `num_bits` bits, setting added bits to `value`
+    void resize(size_t num_bits, bool value = false) {
+        size_t old_size = _size;
+        _words.resize(words_for(num_bits), 0);
+        _size = num_bits;
+
+        if (num_bits > old_size && value) {
+            size_t pos = old_size;
+            for (; pos < num_bits && pos % 64; ++pos) set(pos);
+            for (size_t word = pos / 64; word < _words.size(); ++word) _words[word] = ~uint64_t(0);
+        }
+        trim();
+    }
+
+    // Adds a bit to the end
+    void push_back(bool value) {
+        if (_size % 64 == 0) _words.push_back(0);
+        _words.back() |= uint64_t(value) << (_size % 64);
+        ++_size;
+    }
+
+    // Removes every bit
+    void clear() {
+        _words.clear();
+        _size = 0;
+    }
+
+    // Swap with another bitset
+    void swap(dynamic_bitset& other) {
+        ndash::swap(_words, other._words);
+        ndash::swap(_size, other._size);
+    }
+
+    // Keep only bits also set in `other`, which must have the same size
+    dynamic_bitset& operator&=(const dynamic_bitset& other) { return combine<detail::bit_op::AND>(other); }
+
+    // Add bits set in `other`, which must have the same size
+    dynamic_bitset& operator|=(const dynamic_bitset& other) { return combine<detail::bit_op::OR>(other); }
+
+    // Toggle bits set in `other`, which must have the same size
+    dynamic_bitset& operator^=(const dynamic_bitset& other) { return combine<detail::bit_op::XOR>(other); }
+
+    // Clear bits set in `other`, which must have the same size
+    dynamic_bitset& and_not(const dynamic_bitset& other) { return combine<detail::bit_op::AND_NOT>(other); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Operations //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Number of set bits
+    size_t count() const { return detail::popcount(_words.data(), _words.size()); }
+
+    // Number of bits set in both this and `other`, without building the intersection
+    size_t count_and(const dynamic_bitset& other) const {
+        return detail::count_bitwise<detail::bit_op::AND>(_words.data(), other._words.data(), _words.size());
+    }
+
+    // Number of bits set here but not in `other`, without building the difference
+    size_t count_and_not(const dynamic_bitset& other) const {
+        return detail::count_bitwise<detail::bit_op::AND_NOT>(_words.data(), other._words.data(), _words.size());
+    }
+
+    // Check if any bit is set
+    bool any() const {
+        for (auto word : _words) {
+            if (word) return true;
+        }
+        return false;
+    }
+
+    // Check if no bit is set
+    bool none() const { return !any(); }
+
+    // Check if every bit is set
+    bool all() const { return count() == _size; }
+
+    // Position of the first set bit, or `npos`
+    size_t find_first() const { return find_from(0); }
+
+    // Position of the first set bit after `pos`, or `npos`
+    size_t find_next(size_t pos) const { return pos + 1 >= _size ? npos : find_from(pos + 1); }
+
+    // Call `func(size_t pos)` for each set bit in increasing order
+    template <class Func>
+    void for_each_set(Func&& func) const {
+        for (size_t i = 0; i < _words.size(); ++i) {
+            for (uint64_t word = _words[i]; word; word &= word - 1) {
+                func(i * 64 + __builtin_ctzll(word));
+            }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////// Non-member functions //////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    friend dynamic_bitset operator&(const dynamic_bitset& a, const dynamic_bitset& b) {
+        return combined<detail::bit_op::AND>(a, b);
+    }
+    friend dynamic_bitset operator|(const dynamic_bitset& a, const dynamic_bitset& b) {
+        return combined<detail::bit_op::OR>(a, b);
+    }
+    friend dynamic_bitset operator^(const dynamic_bitset& a, const dynamic_bitset& b) {
+        return combined<detail::bit_op::XOR>(a, b);
+    }
+
+    // Bits set in `a` but not in `b`
+    friend dynamic_bitset and_not(const dynamic_bitset& a, const dynamic_bitset& b) {
+        return combined<detail::bit_op::AND_NOT>(a, b);
+    }
+
+    friend bool operator==(const dynamic_bitset& a, const dynamic_bitset& b) {
+        return a._size == b._size
+            && (a._words.empty()
+                || std::memcmp(a._words.data(), b._words.data(), a._words.size() * sizeof(uint64_t)) == 0);
+    }
+
+    // Swap specialization
+    friend void swap(dynamic_bitset& a, dynamic_bitset& b) { a.swap(b); }
+
+private:
+    static constexpr size_t words_for(size_t num_bits) { return (num_bits + 63) / 64; }
+
+    // Clear the unused bits of the last word
+    void trim() {
+        if (_size % 64) _words.back() &= (uint64_t(1) << (_size % 64)) - 1;
+    }
+
+    // First set bit at or after `pos`
+    size_t find_from(size_t pos) const {
+        size_t word = pos / 64;
+        if (word >= _words.size()) return npos;
+
+        uint64_t bits = _words[word] & (~uint64_t(0) << (pos % 64));
+        while (!bits) {
+            if (++word == _words.size()) return npos;
+            bits = _words[word];
+        }
+        return word * 64 + __builtin_ctzll(bits);
+    }
+
+    template <detail::bit_op Op>
+    dynamic_bitset& combine(const dynamic_bitset& other) {
+        detail::bitwise<Op>(_words.data(), _words.data(), other._words.data(), _words.size());
+        return *this;
+    }
+
+    template <detail::bit_op Op>
+    static dynamic_bitset combined(const dynamic_bitset& a, const dynamic_bitset& b) {
+        dynamic_bitset result(a._size);
+        detail::bitwise<Op>(result._words.data(), a._words.data(), b._words.data(), a._words.size());
+        return result;
+    }
+
+    vector<uint64_t> _words;
+    size_t _size;
+};
+
+}   // namespace ndash
+
+#undef NDASH_BITSET_X86
+
+#endif   // DYNAMIC_BITSET_H
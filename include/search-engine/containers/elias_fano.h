@@ -0,0 +1,282 @@
+#ifndef ELIAS_FANO_H
+#define ELIAS_FANO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "dynamic_bitset.h"
+#include "iterator.h"
+#include "packed_vector.h"
+#include "vector.h"
+
+namespace ndash {
+
+// Compressed non-decreasing sequence of 32-bit values, such as the document ids of a posting list
+//
+// Each value is split into `l = floor(log2(universe / size))` low bits, stored verbatim in a packed vector, and the
+// remaining high bits, stored in unary as a bitvector where value `i` sets bit `(value >> l) + i`. That takes about
+// `2 + l` bits per value, within half a bit of the information-theoretic minimum. Positions of every 256th one and
+// zero of the high bits are sampled, so `operator[]` is a select for a one and `next_geq` a select for a zero, each
+// finished with a short scan and an in-word select
+class elias_fano {
+    static constexpr const size_t SAMPLE_RATE = 256;
+
+public:
+    struct iterator;
+    using const_iterator = iterator;
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor
+    //
+    // Initializes to an empty sequence
+    elias_fano()
+        : _size(0)
+        , _universe(0)
+        , _low_bits(0)
+        , _low(1)
+        , _high()
+        , _ones()
+        , _zeros() {}
+
+    // Encodes the non-decreasing values in [ `first`, `last` ), all below `universe`
+    //
+    // A `universe` of 0 uses the last value plus one. Throws `std::invalid_argument` if the last value isn't below a
+    // given `universe`, or if `universe` is past 2^32, the end of the 32-bit values
+    elias_fano(const uint32_t* first, const uint32_t* last, uint64_t universe = 0)
+        : elias_fano() {
+        _size = size_t(last - first);
+        if (!_size) return;
+
+        if (universe && universe <= last[-1]) throw std::invalid_argument("elias_fano values must be below universe");
+        if (universe > (uint64_t(1) << 32)) throw std::invalid_argument("elias_fano universe is at most 2^32");
+        _universe = universe ? universe : uint64_t(last[-1]) + 1;
+        while ((_universe >> (_low_bits + 1)) >= _size) ++_low_bits;
+
+        // With no low bits the values are all in the upper half and `_low` stays empty
+        if (_low_bits) {
+            _low = packed_vector<>(_low_bits);
+            _low.reserve(_size);
+        }
+        _high = dynamic_bitset(_size + size_t((_universe - 1) >> _low_bits) + 1);
+        for (size_t i = 0; i < _size; ++i) {
+            if (_low_bits) _low.push_back(uint32_t(first[i] & low_mask()));
+            _high.set(size_t(uint64_t(first[i]) >> _low_bits) + i);
+        }
+        build_samples();
+    }
+
+    // Encodes the non-decreasing values in the vector
+    explicit elias_fano(const vector<uint32_t>& values, uint64_t universe = 0)
+        : elias_fano(values.data(), values.data() + values.size(), universe) {}
+
+    // Encodes the non-decreasing values in the initializer list
+    elias_fano(std::initializer_list<uint32_t> list)
+        : elias_fano(list.begin(), list.end()) {}
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////////// Element Access ////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Get the value at `pos`
+    uint32_t operator[](size_t pos) const { return value_at(pos, select_one(pos)); }
+
+    // Get the first value
+    uint32_t front() const { return (*this)[0]; }
+
+    // Get the last value
+    uint32_t back() const { return (*this)[_size - 1]; }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if the sequence is empty
+    bool empty() const { return !_size; }
+
+    // Number of values
+    size_t size() const { return _size; }
+
+    // Exclusive upper bound of the values
+    uint64_t universe() const { return _universe; }
+
+    // Bits of each value stored verbatim
+    unsigned low_bits() const { return _low_bits; }
+
+    // Bytes of heap memory held, including the select samples
+    size_t memory_usage() const {
+        return _low.memory_usage() + _high.num_words() * sizeof(uint64_t)
+             + (_ones.capacity() + _zeros.capacity()) * sizeof(uint64_t);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Iterators ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Sequential decoder
+    //
+    // Walks the high bits a word at a time, so `++` is a bit clear and a count of trailing zeros. `skip_to` moves
+    // forward to the first value at or above a target, which is what posting list intersection needs
+    struct iterator {
+        using value = uint32_t;
+        using reference = const uint32_t&;
+        using pointer = const uint32_t*;
+        using difference_type = ptrdiff_t;
+
+        iterator()
+            : _ef(nullptr)
+            , _index(0)
+            , _word_index(0)
+            , _word(0)
+            , _value(0) {}
+
+        reference operator*() const { return _value; }
+        pointer operator->() const { return &_value; }
+
+        iterator& operator++() {
+            if (++_index < _ef->_size) {
+                _word &= _word - 1;
+                decode();
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        // Move to the first value at or above `target`, or the end, never moving back
+        iterator& skip_to(uint32_t target) {
+            if (_index == _ef->_size || _value >= target) return *this;
+
+            // Targets in the current bucket are a few steps away; anything further selects its bucket directly
+            if ((uint64_t(target) >> _ef->_low_bits) == (uint64_t(_value) >> _ef->_low_bits)) {
+                while (++(*this), _index < _ef->_size && _value < target) {}
+            } else {
+                *this = _ef->next_geq(target);
+            }
+            return *this;
+        }
+
+        // Position of the current value in the sequence
+        size_t index() const { return _index; }
+
+        friend bool operator==(const iterator& a, const iterator& b) { return a._index == b._index; }
+        friend bool operator!=(const iterator& a, const iterator& b) { return !(a == b); }
+
+    private:
+        friend class elias_fano;
+
+        // Position at value `index`, whose one in the high bits is at or after bit `from`
+        iterator(const elias_fano* ef, size_t index, size_t from)
+            : _ef(ef)
+            , _index(index)
+            , _word_index(from / 64)
+            , _word(0)
+            , _value(0) {
+            if (_index < _ef->_size) {
+                _word = _ef->_high.data()[_word_index] & (~uint64_t(0) << (from % 64));
+                decode();
+            }
+        }
+
+        // Read the value whose one is the lowest set bit at or after `_word`
+        void decode() {
+            while (!_word) _word = _ef->_high.data()[++_word_index];
+            size_t pos = _word_index * 64 + size_t(__builtin_ctzll(_word));
+            _value = _ef->value_at(_index, pos);
+        }
+
+        const elias_fano* _ef;
+        size_t _index;
+        size_t _word_index;
+        uint64_t _word;
+        uint32_t _value;
+    };
+
+    static_assert(forward_iterator<iterator>);
+
+    // Iterator begin
+    iterator begin() const { return iterator(this, 0, 0); }
+
+    // Iterator end
+    iterator end() const { return iterator(this, _size, 0); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Operations //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Iterator to the first value at or above `target`, or `end()` if there is none
+    //
+    // The zero ending bucket `target >> l` is found with a select, then the bucket's few values are scanned
+    iterator next_geq(uint32_t target) const {
+        if (!_size || target > back()) return end();
+
+        size_t bucket = size_t(uint64_t(target) >> _low_bits);
+        size_t from = bucket ? select_zero(bucket - 1) + 1 : 0;
+        iterator it(this, from - bucket, from);
+        while (*it < target) ++it;
+        return it;
+    }
+
+    // Position of the first value at or above `target`, or `size()` if there is none
+    size_t lower_bound(uint32_t target) const { return next_geq(target).index(); }
+
+private:
+    uint64_t low_mask() const { return (uint64_t(1) << _low_bits) - 1; }
+
+    // Value `index`, whose one in the high bits is at `pos`
+    uint32_t value_at(size_t index, size_t pos) const {
+        return uint32_t((uint64_t(pos - index) << _low_bits) | (_low_bits ? _low[index] : 0));
+    }
+
+    // Record the position of every `SAMPLE_RATE`th one and zero of the high bits
+    void build_samples() {
+        size_t ones = 0, zeros = 0;
+        for (size_t word_index = 0; word_index < _high.num_words(); ++word_index) {
+            size_t valid = _high.size() - word_index * 64 < 64 ? _high.size() - word_index * 64 : 64;
+            uint64_t word = _high.data()[word_index];
+            uint64_t inverted = ~word & (~uint64_t(0) >> (64 - valid));
+            sample_word(_ones, ones, word, word_index);
+            sample_word(_zeros, zeros, inverted, word_index);
+        }
+    }
+
+    // Add the samples falling among the set bits of `word`, given the `seen` set bits before it
+    static void sample_word(vector<uint64_t>& samples, size_t& seen, uint64_t word, size_t word_index) {
+        size_t count = size_t(__builtin_popcountll(word));
+        for (size_t next = (seen + SAMPLE_RATE - 1) / SAMPLE_RATE * SAMPLE_RATE; next < seen + count;
+             next += SAMPLE_RATE) {
+            samples.push_back(word_index * 64 + detail::select_in_word(word, unsigned(next - seen)));
+        }
+        seen += count;
+    }
+
+    // Position of the `k`-th one of the high bits
+    size_t select_one(size_t k) const {
+        return detail::select_bits<false>(_high.data(), _ones[k / SAMPLE_RATE], k % SAMPLE_RATE);
+    }
+
+    // Position of the `k`-th zero of the high bits
+    size_t select_zero(size_t k) const {
+        return detail::select_bits<true>(_high.data(), _zeros[k / SAMPLE_RATE], k % SAMPLE_RATE);
+    }
+
+    size_t _size;
+    uint64_t _universe;
+    unsigned _low_bits;
+    packed_vector<> _low;
+    dynamic_bitset _high;
+    vector<uint64_t> _ones;
+    vector<uint64_t> _zeros;
+};
+
+}   // namespace ndash
+
+#endif   // ELIAS_FANO_H
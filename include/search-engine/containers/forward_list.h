@@ -87,9 +87,7 @@ public:
     // Copy assignment operator
     forward_list& operator=(const forward_list& other) {
         if (&other != this) {
-            clear();
-            forward_list temp(other);
-            this->swap(temp);
+            assign(other.begin(), other.end());
         }
         return *this;
     }
@@ -108,10 +106,7 @@ public:
 
     // Initializer list assignment
     forward_list& operator=(std::initializer_list<T> ilist) {
-        clear();
-        for (auto it = ilist.begin(); it != ilist.end(); ++it) {
-            emplace_back(*it);
-        }
+        assign(ilist.begin(), ilist.end());
         return *this;
     }
 
@@ -218,6 +213,28 @@ public:
         while (_size) pop_front();
     }
 
+    // Replaces the contents with the range [`first`, `last`)
+    //
+    // Existing nodes are overwritten in place when `T` is copy assignable, so only the difference in length is
+    // allocated or freed
+    template <typename ForwardIt>
+    void assign(ForwardIt first, ForwardIt last)
+    requires forward_iterator<ForwardIt>
+    {
+        Node* prev = &before;
+        if constexpr (std::is_copy_assignable_v<T>) {
+            for (Node* node = head; node && first != last; node = node->next, ++first) {
+                node->val = *first;
+                prev = node;
+            }
+        }
+
+        while (prev->next) erase_after(const_iterator(prev));
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
     // Insert a copy of `value` after `pos`
     iterator insert_after(const_iterator pos, const T& value) { return emplace_after(pos, value); }
 
@@ -0,0 +1,114 @@
+#ifndef MAPPED_STORAGE_H
+#define MAPPED_STORAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include <sys/mman.h>
+
+#include "vector.h"
+
+namespace ndash {
+
+// Storage policy for `vector` that maps large buffers directly from the kernel
+//
+// Buffers of at least `Threshold` bytes are anonymous mappings aligned to and advised for transparent huge pages,
+// which cuts TLB misses on random access to large arrays. Growing a mapped buffer remaps its pages instead of copying
+// them, and shrinking a vector returns the whole huge pages past its last element. Smaller buffers come from
+// `heap_storage`
+template <size_t Threshold = (size_t(2) << 20)>
+struct mapped_storage {
+    static constexpr const size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+
+    template <typename T>
+    static T* allocate(size_t count) {
+        size_t bytes = count * sizeof(T);
+        if (bytes < Threshold) return heap_storage::allocate<T>(count);
+        return static_cast<T*>(map(mapping_size(bytes)));
+    }
+
+    template <typename T>
+    static void deallocate(T* data, size_t count) {
+        size_t bytes = count * sizeof(T);
+        if (bytes < Threshold) {
+            heap_storage::deallocate<T>(data, count);
+        } else {
+            munmap(data, mapping_size(bytes));
+        }
+    }
+
+    // Remap a mapped buffer to hold `new_count` elements, moving pages rather than bytes
+    template <typename T>
+    static T* reallocate(T* data, size_t old_count, size_t new_count) {
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+        size_t old_bytes = old_count * sizeof(T);
+        size_t new_bytes = new_count * sizeof(T);
+        if (old_bytes < Threshold || new_bytes < Threshold) return nullptr;
+
+        size_t old_size = mapping_size(old_bytes);
+        size_t new_size = mapping_size(new_bytes);
+        if (old_size == new_size) return data;
+
+        void* moved = mremap(data, old_size, new_size, MREMAP_MAYMOVE);
+        if (moved == MAP_FAILED) return nullptr;
+        advise_huge_pages(moved, new_size);
+        return static_cast<T*>(moved);
+#else
+        (void) data;
+        (void) old_count;
+        (void) new_count;
+        return nullptr;
+#endif
+    }
+
+    // Drop the pages of whole huge pages past the first `size` elements
+    template <typename T>
+    static void release_unused(T* data, size_t size, size_t capacity) {
+        size_t bytes = capacity * sizeof(T);
+        if (bytes < Threshold) return;
+
+        uintptr_t used_end = reinterpret_cast<uintptr_t>(data + size);
+        uintptr_t start = (used_end + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        uintptr_t end = reinterpret_cast<uintptr_t>(data) + mapping_size(bytes);
+        if (start < end) madvise(reinterpret_cast<void*>(start), end - start, MADV_DONTNEED);
+    }
+
+protected:
+    // Mappings are whole huge pages so growth and release work on huge page boundaries
+    static constexpr size_t mapping_size(size_t bytes) { return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1); }
+
+    static void advise_huge_pages(void* start, size_t size) {
+#ifdef MADV_HUGEPAGE
+        madvise(start, size, MADV_HUGEPAGE);
+#else
+        (void) start;
+        (void) size;
+#endif
+    }
+
+    // Map `size` bytes aligned to a huge page by over-mapping and trimming the ends
+    static void* map(size_t size) {
+        size_t padded = size + HUGE_PAGE_SIZE;
+        void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) throw std::bad_alloc();
+
+        uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (begin + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        if (aligned > begin) munmap(raw, aligned - begin);
+
+        uintptr_t tail = aligned + size;
+        if (begin + padded > tail) munmap(reinterpret_cast<void*>(tail), begin + padded - tail);
+
+        advise_huge_pages(reinterpret_cast<void*>(aligned), size);
+        return reinterpret_cast<void*>(aligned);
+    }
+};
+
+// Vector whose large buffers are huge page backed mappings that grow without copying
+template <typename T>
+using mapped_vector = vector<T, mapped_storage<>>;
+
+}   // namespace ndash
+
+#endif   // MAPPED_STORAGE_H
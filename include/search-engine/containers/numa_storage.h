@@ -0,0 +1,37 @@
+#ifndef NUMA_STORAGE_H
+#define NUMA_STORAGE_H
+
+#include <cstddef>
+
+#include "mapped_storage.h"
+#include "numa.h"
+#include "vector.h"
+
+namespace ndash {
+
+// Storage policy for `vector` that places large buffers on the node of the allocating thread's `placement_scope`
+//
+// Buffers of at least `Threshold` bytes are `mapped_storage` mappings bound to the scope's node before their pages
+// are touched, so a shard built by a thread on one node can live on another. Growing a mapping in place or by
+// remapping keeps its node, while growth that copies into a new buffer, as for elements that aren't trivially
+// copyable, places the new buffer by the scope of the thread growing it. Smaller buffers, and all buffers allocated
+// outside a scope or on single node machines, are placed as `mapped_storage` places them
+template <size_t Threshold = (size_t(2) << 20)>
+struct numa_storage : mapped_storage<Threshold> {
+    template <typename T>
+    static T* allocate(size_t count) {
+        T* data = mapped_storage<Threshold>::template allocate<T>(count);
+        size_t bytes = count * sizeof(T);
+        int node = numa::placement_node();
+        if (node >= 0 && bytes >= Threshold) numa::bind(data, mapped_storage<Threshold>::mapping_size(bytes), node);
+        return data;
+    }
+};
+
+// Vector whose large buffers are placed on the node of the current `numa::placement_scope`
+template <typename T>
+using numa_vector = vector<T, numa_storage<>>;
+
+}   // namespace ndash
+
+#endif   // NUMA_STORAGE_H
@@ -0,0 +1,311 @@
+#ifndef PACKED_VECTOR_H
+#define PACKED_VECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "cpu_features.h"
+#include "swap.h"
+#include "vector.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NDASH_PACKED_X86 1
+#endif
+
+namespace ndash {
+
+namespace detail {
+
+// Value of `width` bits starting at bit `bit` of `words`, which must have a word after the one holding `bit`
+inline uint32_t read_packed(const uint64_t* words, size_t bit, unsigned width) {
+    const uint64_t* word = words + bit / 64;
+    unsigned offset = bit % 64;
+
+    // The second shift is split so an offset of 0 doesn't shift by 64
+    uint64_t value = (word[0] >> offset) | ((word[1] << 1) << (63 - offset));
+    return uint32_t(value & ((uint64_t(1) << width) - 1));
+}
+
+// Store the low `width` bits of `value` at bit `bit` of `words`, which must have a word after the one holding `bit`
+inline void write_packed(uint64_t* words, size_t bit, unsigned width, uint32_t value) {
+    uint64_t* word = words + bit / 64;
+    unsigned offset = bit % 64;
+    uint64_t mask = (uint64_t(1) << width) - 1;
+    uint64_t bits = value & mask;
+
+    word[0] = (word[0] & ~(mask << offset)) | (bits << offset);
+    // Both masks are zero unless the value straddles into the next word
+    word[1] = (word[1] & ~((mask >> 1) >> (63 - offset))) | ((bits >> 1) >> (63 - offset));
+}
+
+inline void unpack_scalar(const uint64_t* words, unsigned width, size_t first, size_t count, uint32_t* out) {
+    size_t bit = first * width;
+    for (size_t i = 0; i < count; ++i, bit += width) out[i] = read_packed(words, bit, width);
+}
+
+#ifdef NDASH_PACKED_X86
+
+// Unpack 64 values with byte-offset gathers, 8 at a time
+//
+// Each lane loads the bytes holding its value and shifts it down. Widths up to 25 bits fit in a 4-byte load at any
+// bit offset, wider values load 8 bytes into 64-bit lanes and are narrowed afterwards. Reads may extend into the
+// padding word after the last value
+__attribute__((target("avx2"))) inline void unpack64_avx2(const uint64_t* words, unsigned width, size_t first,
+                                                          uint32_t* out) {
+    const char* bytes = reinterpret_cast<const char*>(words);
+    __m256i lane_bits = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(int(width)));
+    __m256i mask = _mm256_set1_epi32(int((uint64_t(1) << width) - 1));
+    __m256i seven = _mm256_set1_epi32(7);
+
+    size_t bit = first * width;
+    if (width <= 25) {
+        for (int group = 0; group < 8; ++group, bit += 8 * width) {
+            __m256i rel = _mm256_add_epi32(lane_bits, _mm256_set1_epi32(int(bit % 8)));
+            __m256i loaded
+              = _mm256_i32gather_epi32(reinterpret_cast<const int*>(bytes + bit / 8), _mm256_srli_epi32(rel, 3), 1);
+            __m256i values = _mm256_and_si256(_mm256_srlv_epi32(loaded, _mm256_and_si256(rel, seven)), mask);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + group * 8), values);
+        }
+        return;
+    }
+
+    __m256i narrow = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    for (int group = 0; group < 8; ++group, bit += 8 * width) {
+        __m256i rel = _mm256_add_epi32(lane_bits, _mm256_set1_epi32(int(bit % 8)));
+        __m256i offsets = _mm256_srli_epi32(rel, 3);
+        __m256i shifts = _mm256_and_si256(rel, seven);
+        const long long* base = reinterpret_cast<const long long*>(bytes + bit / 8);
+
+        __m256i low = _mm256_i32gather_epi64(base, _mm256_castsi256_si128(offsets), 1);
+        __m256i high = _mm256_i32gather_epi64(base, _mm256_extracti128_si256(offsets, 1), 1);
+        low = _mm256_srlv_epi64(low, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(shifts)));
+        high = _mm256_srlv_epi64(high, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(shifts, 1)));
+
+        __m128i low32 = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(low, narrow));
+        __m128i high32 = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(high, narrow));
+        __m256i values = _mm256_and_si256(_mm256_set_m128i(high32, low32), mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + group * 8), values);
+    }
+}
+
+#endif   // NDASH_PACKED_X86
+
+// Unpack `count` values from index `first`, 64 at a time with AVX2 where available
+inline void unpack(const uint64_t* words, unsigned width, size_t first, size_t count, uint32_t* out) {
+    size_t i = 0;
+#ifdef NDASH_PACKED_X86
+    if (cpu::has_avx2()) {
+        for (; i + 64 <= count; i += 64) unpack64_avx2(words, width, first + i, out + i);
+    }
+#endif
+    unpack_scalar(words, width, first + i, count - i, out + i);
+}
+
+}   // namespace detail
+
+// Vector of unsigned integers stored in `Bits` bits each
+//
+// Values are packed back to back into 64-bit words, so a value may straddle two words; a padding word after the
+// last value lets every read and write touch both words without a branch. `Bits` of 0 takes the width, from 1 to
+// 32, at construction instead. Values wider than the width are truncated
+template <unsigned Bits = 0>
+class packed_vector {
+    static_assert(Bits <= 32, "packed values are at most 32 bits");
+
+public:
+    using value_type = uint32_t;
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor
+    //
+    // Initializes to size 0 without allocating
+    packed_vector()
+    requires(Bits != 0)
+        : _words()
+        , _size(0)
+        , _width(Bits) {}
+
+    // Constructs with `count` copies of `value`
+    explicit packed_vector(size_t count, uint32_t value = 0)
+    requires(Bits != 0)
+        : packed_vector() {
+        resize(count, value);
+    }
+
+    // Constructs from the initializer list
+    packed_vector(std::initializer_list<uint32_t> list)
+    requires(Bits != 0)
+        : packed_vector() {
+        reserve(list.size());
+        for (uint32_t value : list) push_back(value);
+    }
+
+    // Constructs an empty vector of `width`-bit values. Throws `std::invalid_argument` unless `width` is 1 to 32
+    explicit packed_vector(unsigned width)
+    requires(Bits == 0)
+        : _words()
+        , _size(0)
+        , _width(width) {
+        if (width < 1 || width > 32) throw std::invalid_argument("packed_vector width must be 1 to 32");
+    }
+
+    // Constructs with `count` copies of `value` in `width` bits each
+    packed_vector(unsigned width, size_t count, uint32_t value = 0)
+    requires(Bits == 0)
+        : packed_vector(width) {
+        resize(count, value);
+    }
+
+    // Bits needed to store values up to `max_value`
+    static constexpr unsigned width_for(uint32_t max_value) {
+        return max_value ? unsigned(32 - __builtin_clz(max_value)) : 1;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////////// Element Access ////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Get the value at `pos`
+    uint32_t get(size_t pos) const { return detail::read_packed(_words.data(), pos * width(), width()); }
+
+    // Get the value at `pos`
+    uint32_t operator[](size_t pos) const { return get(pos); }
+
+    // Get the last value
+    uint32_t back() const { return get(_size - 1); }
+
+    // Set the value at `pos`
+    void set(size_t pos, uint32_t value) { detail::write_packed(_words.data(), pos * width(), width(), value); }
+
+    // Copy `count` values starting at `first` into `out`
+    //
+    // Runs of 64 values are unpacked with vector gathers where AVX2 is available
+    void unpack(size_t first, size_t count, uint32_t* out) const {
+        if (count) detail::unpack(_words.data(), width(), first, count, out);
+    }
+
+    // Directly access the packed words
+    const uint64_t* data() const { return _words.data(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if container is empty
+    bool empty() const { return !_size; }
+
+    // Get number of values
+    size_t size() const { return _size; }
+
+    // Bits per value
+    unsigned width() const {
+        if constexpr (Bits != 0) {
+            return Bits;
+        } else {
+            return _width;
+        }
+    }
+
+    // Largest storable value
+    uint32_t max_value() const { return uint32_t((uint64_t(1) << width()) - 1); }
+
+    // Number of 64-bit words holding the values, including padding
+    size_t num_words() const { return _words.size(); }
+
+    // Bytes of heap memory held
+    size_t memory_usage() const { return _words.capacity() * sizeof(uint64_t); }
+
+    // Allocate room for `new_cap` values
+    void reserve(size_t new_cap) { _words.reserve(words_for(new_cap)); }
+
+    // Free memory not needed by the current values
+    void shrink_to_fit() { _words.shrink_to_fit(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Adds a value to the end
+    void push_back(uint32_t value) {
+        // Each value adds at most one word, except the first which also adds the padding word
+        while (_words.size() < words_for(_size + 1)) _words.push_back(0);
+        set(_size++, value);
+    }
+
+    // Adds the values in [ `first`, `last` ) to the end
+    void append(const uint32_t* first, const uint32_t* last) {
+        reserve(_size + size_t(last - first));
+        for (; first != last; ++first) push_back(*first);
+    }
+
+    // Removes the last value
+    void pop_back() {
+        set(--_size, 0);
+        _words.resize(words_for(_size));
+    }
+
+    // Resize to `count` values, setting new ones to `value`
+    void resize(size_t count, uint32_t value = 0) {
+        if (count <= _size) {
+            // Zero the dropped values so the words past the end stay clear
+            for (size_t i = count; i < _size; ++i) set(i, 0);
+            _size = count;
+            _words.resize(words_for(count));
+            return;
+        }
+
+        _words.resize(words_for(count), 0);
+        if (value) {
+            for (size_t i = _size; i < count; ++i) set(i, value);
+        }
+        _size = count;
+    }
+
+    // Removes every value
+    void clear() {
+        _words.clear();
+        _size = 0;
+    }
+
+    // Swap with another packed vector
+    void swap(packed_vector& other) {
+        ndash::swap(_words, other._words);
+        ndash::swap(_size, other._size);
+        ndash::swap(_width, other._width);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////// Non-member functions //////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    friend bool operator==(const packed_vector& a, const packed_vector& b) {
+        if (a._size != b._size || a.width() != b.width()) return false;
+        for (size_t i = 0; i < a._words.size(); ++i) {
+            if (a._words[i] != b._words[i]) return false;
+        }
+        return true;
+    }
+
+    // Swap specialization
+    friend void swap(packed_vector& a, packed_vector& b) { a.swap(b); }
+
+private:
+    // Words holding `count` values plus the padding word after the last one
+    size_t words_for(size_t count) const { return count ? (count - 1) * width() / 64 + 2 : 0; }
+
+    vector<uint64_t> _words;
+    size_t _size;
+    unsigned _width;
+};
+
+}   // namespace ndash
+
+#undef NDASH_PACKED_X86
+
+#endif   // PACKED_VECTOR_H
@@ -0,0 +1,225 @@
+#ifndef RANK_SELECT_BITVECTOR_H
+#define RANK_SELECT_BITVECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "dynamic_bitset.h"
+#include "iterator.h"
+#include "vector.h"
+
+namespace ndash {
+
+// Immutable bitvector answering rank in constant time and select in a few probes of a directory
+//
+// Ranks use the rank9 directory (Vigna, "Broadword implementation of rank/select queries"): each 512-bit block
+// stores the number of ones before it in one word and the counts at each of its other 7 words in 9-bit fields of a
+// second, so a rank is two directory reads and one population count. That costs 25% on top of the bits. Select
+// samples the block holding every 4096th one and zero, binary searches the blocks between two samples, picks the
+// word from the 9-bit counts and finishes with `pdep` and `tzcnt` where BMI2 is available
+class rank_select_bitvector {
+    static constexpr const size_t BLOCK_BITS = 512;
+    static constexpr const size_t BLOCK_WORDS = 8;
+    static constexpr const size_t SELECT_SAMPLE = 4096;
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor
+    //
+    // Initializes to an empty bitvector
+    rank_select_bitvector()
+        : _bits()
+        , _size(0)
+        , _ones(0)
+        , _directory()
+        , _select_ones()
+        , _select_zeros() {}
+
+    // Constructs from the first `num_bits` bits of `words`, least significant bit first
+    rank_select_bitvector(const uint64_t* words, size_t num_bits)
+        : rank_select_bitvector() {
+        size_t num_words = (num_bits + 63) / 64;
+        _bits.reserve(padded_words(num_bits));
+        _bits.append_range(words, words + num_words);
+        if (num_bits % 64) _bits.back() &= ~uint64_t(0) >> (64 - num_bits % 64);
+        _size = num_bits;
+        build();
+    }
+
+    // Constructs from the bits of a bitset
+    explicit rank_select_bitvector(const dynamic_bitset& bits)
+        : rank_select_bitvector(bits.data(), bits.size()) {}
+
+    // Constructs from a range of values converted to bool
+    template <typename ForwardIt>
+    rank_select_bitvector(ForwardIt first, ForwardIt last)
+    requires forward_iterator<ForwardIt>
+        : rank_select_bitvector() {
+        for (size_t pos = 0; first != last; ++first, ++pos) {
+            if (pos % 64 == 0) _bits.push_back(0);
+            _bits.back() |= uint64_t(bool(*first)) << (pos % 64);
+            ++_size;
+        }
+        build();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////////// Element Access ////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if bit `pos` is set
+    bool test(size_t pos) const { return (_bits[pos / 64] >> (pos % 64)) & 1; }
+
+    // Check if bit `pos` is set
+    bool operator[](size_t pos) const { return test(pos); }
+
+    // Directly access the words, least significant bit first. Padded with zero words to a whole block
+    const uint64_t* data() const { return _bits.data(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if bitvector has no bits
+    bool empty() const { return !_size; }
+
+    // Number of bits
+    size_t size() const { return _size; }
+
+    // Number of set bits
+    size_t count() const { return _ones; }
+
+    // Bytes of heap memory held by the bits and the rank and select directories
+    size_t memory_usage() const {
+        return (_bits.capacity() + _directory.capacity()) * sizeof(uint64_t)
+             + (_select_ones.capacity() + _select_zeros.capacity()) * sizeof(uint32_t);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Operations //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Number of set bits before `pos`, for `pos` up to `size()`
+    size_t rank1(size_t pos) const {
+        size_t word = pos / 64;
+        size_t block = word / BLOCK_WORDS;
+        uint64_t in_block = word % BLOCK_WORDS;
+
+        // Word 0 of a block reads the always-zero top field instead of branching: `t - 1` wraps to 7 via the mask
+        uint64_t t = in_block - 1;
+        uint64_t relative = (_directory[2 * block + 1] >> ((t + ((t >> 60) & 8)) * 9)) & 0x1FF;
+        uint64_t below = _bits[word] & ((uint64_t(1) << (pos % 64)) - 1);
+        return size_t(_directory[2 * block] + relative) + size_t(__builtin_popcountll(below));
+    }
+
+    // Number of clear bits before `pos`, for `pos` up to `size()`
+    size_t rank0(size_t pos) const { return pos - rank1(pos); }
+
+    // Position of the `k`-th set bit, counting from 0. `k` must be below `count()`
+    size_t select1(size_t k) const { return select<false>(k); }
+
+    // Position of the `k`-th clear bit, counting from 0. `k` must be below `size() - count()`
+    size_t select0(size_t k) const { return select<true>(k); }
+
+private:
+    static size_t padded_words(size_t num_bits) {
+        return (num_bits / BLOCK_BITS + 1) * BLOCK_WORDS;
+    }
+
+    // Ones before block `block`, or zeros if `Zeros`
+    template <bool Zeros>
+    size_t block_rank(size_t block) const {
+        size_t ones = size_t(_directory[2 * block]);
+        return Zeros ? block * BLOCK_BITS - ones : ones;
+    }
+
+    // Pad the bits to whole blocks, with one spare so `rank1(size())` stays in bounds, and fill the directories
+    void build() {
+        size_t num_blocks = _size / BLOCK_BITS + 1;
+        _bits.resize(num_blocks * BLOCK_WORDS, 0);
+        _directory.resize(2 * (num_blocks + 1));
+
+        uint64_t ones = 0;
+        for (size_t block = 0; block < num_blocks; ++block) {
+            const uint64_t* words = _bits.data() + block * BLOCK_WORDS;
+            uint64_t relative = 0, fields = 0;
+            for (size_t i = 0; i < BLOCK_WORDS; ++i) {
+                if (i) fields |= relative << (9 * (i - 1));
+                relative += uint64_t(__builtin_popcountll(words[i]));
+            }
+            _directory[2 * block] = ones;
+            _directory[2 * block + 1] = fields;
+            ones += relative;
+        }
+        _directory[2 * num_blocks] = ones;
+        _directory[2 * num_blocks + 1] = 0;
+        _ones = size_t(ones);
+
+        sample<false>(_select_ones, _ones, num_blocks);
+        sample<true>(_select_zeros, num_blocks * BLOCK_BITS - _ones, num_blocks);
+    }
+
+    // Record the block holding every `SELECT_SAMPLE`th one, or zero if `Zeros`, then the last block
+    template <bool Zeros>
+    void sample(vector<uint32_t>& samples, size_t total, size_t num_blocks) {
+        samples.clear();
+        size_t block = 0;
+        for (size_t k = 0; k < total; k += SELECT_SAMPLE) {
+            while (block_rank<Zeros>(block + 1) <= k) ++block;
+            samples.push_back(uint32_t(block));
+        }
+        samples.push_back(uint32_t(num_blocks - 1));
+        samples.shrink_to_fit();
+    }
+
+    // 1 in each of the 7 9-bit fields, the top bit of each field, and `64 * i` in field `i - 1`
+    static constexpr const uint64_t ONES_STEP_9 = 0x0040201008040201;
+    static constexpr const uint64_t MSBS_STEP_9 = ONES_STEP_9 << 8;
+    static constexpr const uint64_t ZERO_FIELDS = 0x7030140803010040;
+
+    // 1 in the low bit of each 9-bit field where `x <= y`, for unsigned fields (Vigna's `ULEQ_STEP_9`)
+    static constexpr uint64_t leq_fields(uint64_t x, uint64_t y) {
+        return (((((y | MSBS_STEP_9) - (x & ~MSBS_STEP_9)) | (x ^ y)) ^ (x & ~y)) & MSBS_STEP_9) >> 8;
+    }
+
+    template <bool Zeros>
+    size_t select(size_t k) const {
+        const vector<uint32_t>& samples = Zeros ? _select_zeros : _select_ones;
+
+        // Last block between the two samples whose count before it is at most `k`
+        size_t lo = samples[k / SELECT_SAMPLE];
+        size_t hi = samples[k / SELECT_SAMPLE + 1] + 1;
+        while (hi - lo > 1) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (block_rank<Zeros>(mid) <= k) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+
+        // Pick the word by comparing `rank` against all 7 counts at once. Counts of zeros are `64 * i` minus the ones
+        size_t rank = k - block_rank<Zeros>(lo);
+        uint64_t fields = _directory[2 * lo + 1];
+        if (Zeros) fields = ZERO_FIELDS - fields;
+        size_t word = size_t((leq_fields(fields, rank * ONES_STEP_9) * ONES_STEP_9 >> 54) & 0x7);
+        if (word) rank -= size_t((fields >> (9 * (word - 1))) & 0x1FF);
+
+        return detail::select_bits<Zeros>(_bits.data(), (lo * BLOCK_WORDS + word) * 64, rank);
+    }
+
+    vector<uint64_t> _bits;
+    size_t _size;
+    size_t _ones;
+    vector<uint64_t> _directory;
+    vector<uint32_t> _select_ones;
+    vector<uint32_t> _select_zeros;
+};
+
+}   // namespace ndash
+
+#endif   // RANK_SELECT_BITVECTOR_H
@@ -0,0 +1,940 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#include "cpu_features.h"
+#include "dynamic_bitset.h"
+#include "swap.h"
+#include "vector.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NDASH_ROARING_X86 1
+#endif
+
+namespace ndash {
+
+namespace detail {
+
+// Shuffle masks moving the 16-bit lanes selected by an 8-bit mask to the front of a vector
+struct lane_compress_table {
+    alignas(16) uint8_t rows[256][16];
+};
+
+constexpr lane_compress_table make_lane_compress_table() {
+    lane_compress_table table {};
+    for (int mask = 0; mask < 256; ++mask) {
+        int out = 0;
+        for (int lane = 0; lane < 8; ++lane) {
+            if ((mask >> lane) & 1) {
+                table.rows[mask][out++] = uint8_t(2 * lane);
+                table.rows[mask][out++] = uint8_t(2 * lane + 1);
+            }
+        }
+        while (out < 16) table.rows[mask][out++] = 0x80;
+    }
+    return table;
+}
+
+inline constexpr lane_compress_table LANE_COMPRESS = make_lane_compress_table();
+
+// Write the values in both sorted arrays to `out`, returning how many
+inline size_t intersect_arrays_scalar(const uint16_t* a, size_t na, const uint16_t* b, size_t nb, uint16_t* out) {
+    size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            ++i;
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            out[k++] = a[i];
+            ++i;
+            ++j;
+        }
+    }
+    return k;
+}
+
+// Intersection of a small sorted array with a much larger one, by binary search in the larger
+inline size_t intersect_arrays_galloping(const uint16_t* small, size_t ns, const uint16_t* large, size_t nl,
+                                         uint16_t* out) {
+    size_t k = 0;
+    const uint16_t* end = large + nl;
+    for (size_t i = 0; i < ns && large != end; ++i) {
+        large = std::lower_bound(large, end, small[i]);
+        if (large != end && *large == small[i]) out[k++] = small[i];
+    }
+    return k;
+}
+
+#ifdef NDASH_ROARING_X86
+
+// Compares blocks of 8 values from each array against each other with every rotation of the second block, then
+// compacts the matches with a shuffle. `out` needs room for 8 values past the result
+__attribute__((target("avx2,popcnt"))) inline size_t intersect_arrays_simd(const uint16_t* a, size_t na,
+                                                                           const uint16_t* b, size_t nb,
+                                                                           uint16_t* out) {
+    size_t i = 0, j = 0, k = 0;
+    while (i + 8 <= na && j + 8 <= nb) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+
+        __m128i hit = _mm_cmpeq_epi16(va, vb);
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 2)));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 4)));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 6)));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 8)));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 10)));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 12)));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 14)));
+
+        int mask = _mm_movemask_epi8(_mm_packs_epi16(hit, _mm_setzero_si128())) & 0xFF;
+        __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(LANE_COMPRESS.rows[mask]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), _mm_shuffle_epi8(va, shuffle));
+        k += __builtin_popcount(mask);
+
+        uint16_t a_max = a[i + 7];
+        uint16_t b_max = b[j + 7];
+        if (a_max <= b_max) i += 8;
+        if (b_max <= a_max) j += 8;
+    }
+    return k + intersect_arrays_scalar(a + i, na - i, b + j, nb - j, out + k);
+}
+
+#endif   // NDASH_ROARING_X86
+
+// Intersection of two sorted arrays of distinct values. `out` needs room for `min(na, nb) + 8` values
+inline size_t intersect_arrays(const uint16_t* a, size_t na, const uint16_t* b, size_t nb, uint16_t* out) {
+    if (na * 32 < nb) return intersect_arrays_galloping(a, na, b, nb, out);
+    if (nb * 32 < na) return intersect_arrays_galloping(b, nb, a, na, out);
+#ifdef NDASH_ROARING_X86
+    if (cpu::has_avx2()) return intersect_arrays_simd(a, na, b, nb, out);
+#endif
+    return intersect_arrays_scalar(a, na, b, nb, out);
+}
+
+// Set bits [ `first`, `last` ] of a bitmap
+inline void set_bit_range(uint64_t* words, uint32_t first, uint32_t last) {
+    uint32_t first_word = first / 64;
+    uint32_t last_word = last / 64;
+    uint64_t first_mask = ~uint64_t(0) << (first % 64);
+    uint64_t last_mask = ~uint64_t(0) >> (63 - last % 64);
+
+    if (first_word == last_word) {
+        words[first_word] |= first_mask & last_mask;
+        return;
+    }
+    words[first_word] |= first_mask;
+    for (uint32_t word = first_word + 1; word < last_word; ++word) words[word] = ~uint64_t(0);
+    words[last_word] |= last_mask;
+}
+
+// Set of the 16-bit low halves of values sharing the same high half
+//
+// Arrays hold up to `ARRAY_MAX` sorted values and bitmaps hold more, which bounds a container at 8 KB. Run containers
+// store (start, length - 1) pairs and only come from ranges and `run_optimize`; modifying one converts it back
+struct roaring_container {
+    enum kind : uint8_t { ARRAY, BITMAP, RUN };
+
+    static constexpr const uint32_t ARRAY_MAX = 4096;
+    static constexpr const size_t BITMAP_WORDS = 1024;
+
+    kind type = ARRAY;
+    uint32_t cardinality = 0;
+    vector<uint16_t> values;
+    vector<uint64_t> words;
+
+    size_t num_runs() const { return values.size() / 2; }
+
+    bool contains(uint16_t value) const {
+        switch (type) {
+        case ARRAY: return std::binary_search(values.data(), values.data() + values.size(), value);
+        case BITMAP: return (words[value / 64] >> (value % 64)) & 1;
+        case RUN: {
+            // Last run starting at or before `value`
+            size_t lo = 0, hi = num_runs();
+            while (lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                if (values[2 * mid] <= value) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            return lo && value - values[2 * (lo - 1)] <= values[2 * (lo - 1) + 1];
+        }
+        }
+        return false;
+    }
+
+    // Call `func(uint16_t)` for each value in increasing order
+    template <class Func>
+    void for_each(Func&& func) const {
+        switch (type) {
+        case ARRAY:
+            for (uint16_t value : values) func(value);
+            break;
+        case BITMAP:
+            for (size_t i = 0; i < BITMAP_WORDS; ++i) {
+                for (uint64_t word = words[i]; word; word &= word - 1) {
+                    func(uint16_t(i * 64 + __builtin_ctzll(word)));
+                }
+            }
+            break;
+        case RUN:
+            for (size_t r = 0; r < num_runs(); ++r) {
+                uint32_t start = values[2 * r];
+                uint32_t end = start + values[2 * r + 1];
+                for (uint32_t value = start; value <= end; ++value) func(uint16_t(value));
+            }
+            break;
+        }
+    }
+
+    bool add(uint16_t value) {
+        if (type == RUN) {
+            if (contains(value)) return false;
+            expand_runs();
+        }
+
+        if (type == BITMAP) {
+            uint64_t& word = words[value / 64];
+            uint64_t bit = uint64_t(1) << (value % 64);
+            if (word & bit) return false;
+            word |= bit;
+            ++cardinality;
+            return true;
+        }
+
+        uint16_t* begin = values.data();
+        uint16_t* pos = std::lower_bound(begin, begin + values.size(), value);
+        if (pos != begin + values.size() && *pos == value) return false;
+        if (cardinality == ARRAY_MAX) {
+            to_bitmap();
+            return add(value);
+        }
+        values.insert(values.begin() + (pos - begin), value);
+        ++cardinality;
+        return true;
+    }
+
+    bool remove(uint16_t value) {
+        if (!contains(value)) return false;
+        if (type == RUN) expand_runs();
+
+        if (type == BITMAP) {
+            words[value / 64] &= ~(uint64_t(1) << (value % 64));
+            if (--cardinality <= ARRAY_MAX) to_array();
+            return true;
+        }
+
+        uint16_t* begin = values.data();
+        uint16_t* pos = std::lower_bound(begin, begin + values.size(), value);
+        values.erase(values.begin() + (pos - begin));
+        --cardinality;
+        return true;
+    }
+
+    // Add `count` low halves, in any order
+    void add_many(const uint32_t* lows, size_t count) {
+        if (type == RUN) expand_runs();
+        if (type == ARRAY && cardinality + count > ARRAY_MAX) to_bitmap();
+
+        if (type == BITMAP) {
+            for (size_t i = 0; i < count; ++i) {
+                uint16_t value = uint16_t(lows[i]);
+                uint64_t bit = uint64_t(1) << (value % 64);
+                cardinality += !(words[value / 64] & bit);
+                words[value / 64] |= bit;
+            }
+            if (cardinality <= ARRAY_MAX) to_array();
+            return;
+        }
+
+        // Sorted input past the current maximum appends directly, anything else is merged by sorting
+        size_t old_size = values.size();
+        bool sorted = true;
+        for (size_t i = 0; i < count; ++i) {
+            uint16_t value = uint16_t(lows[i]);
+            if (!values.empty() && value <= values.back()) sorted = false;
+            values.push_back(value);
+        }
+        if (!sorted) {
+            uint16_t* begin = values.data();
+            std::sort(begin + old_size, begin + values.size());
+            std::inplace_merge(begin, begin + old_size, begin + values.size());
+            values.resize(std::unique(begin, begin + values.size()) - begin);
+        }
+        cardinality = uint32_t(values.size());
+    }
+
+    // Add the values in [ `first`, `last` ]
+    void add_range(uint32_t first, uint32_t last) {
+        if (type == RUN) expand_runs();
+        if (type == ARRAY && cardinality + (last - first + 1) > ARRAY_MAX) to_bitmap();
+
+        if (type == BITMAP) {
+            set_bit_range(words.data(), first, last);
+            cardinality = uint32_t(detail::popcount(words.data(), BITMAP_WORDS));
+            // Values already present were counted twice when choosing the bitmap
+            normalize();
+        } else {
+            for (uint32_t value = first; value <= last; ++value) add(uint16_t(value));
+        }
+    }
+
+    void to_bitmap() {
+        vector<uint64_t> bits(BITMAP_WORDS, 0);
+        for_each([&](uint16_t value) { bits[value / 64] |= uint64_t(1) << (value % 64); });
+        words = std::move(bits);
+        values = vector<uint16_t>();
+        type = BITMAP;
+    }
+
+    void to_array() {
+        vector<uint16_t> sorted;
+        sorted.reserve(cardinality);
+        for_each([&](uint16_t value) { sorted.push_back(value); });
+        values = std::move(sorted);
+        words = vector<uint64_t>();
+        type = ARRAY;
+    }
+
+    // Replace runs with whichever of an array or bitmap suits the cardinality
+    void expand_runs() {
+        if (cardinality <= ARRAY_MAX) {
+            to_array();
+        } else {
+            to_bitmap();
+        }
+    }
+
+    // Convert between arrays and bitmaps to match the cardinality
+    void normalize() {
+        if (type == BITMAP && cardinality <= ARRAY_MAX) to_array();
+        if (type == ARRAY && cardinality > ARRAY_MAX) to_bitmap();
+    }
+
+    // Number of runs of consecutive values
+    size_t count_runs() const {
+        switch (type) {
+        case ARRAY: {
+            size_t runs = values.empty() ? 0 : 1;
+            for (size_t i = 1; i < values.size(); ++i) runs += values[i] != values[i - 1] + 1;
+            return runs;
+        }
+        case BITMAP: {
+            size_t runs = 0;
+            uint64_t carry = 0;
+            for (size_t i = 0; i < BITMAP_WORDS; ++i) {
+                uint64_t word = words[i];
+                runs += __builtin_popcountll(word & ~((word << 1) | carry));
+                carry = word >> 63;
+            }
+            return runs;
+        }
+        case RUN: return num_runs();
+        }
+        return 0;
+    }
+
+    // Switch to runs when they take less space than the current form, returning whether it did
+    bool run_optimize() {
+        if (type == RUN) return false;
+
+        size_t runs = count_runs();
+        size_t current_bytes = type == ARRAY ? cardinality * sizeof(uint16_t) : BITMAP_WORDS * sizeof(uint64_t);
+        if (runs * 2 * sizeof(uint16_t) >= current_bytes) return false;
+
+        vector<uint16_t> pairs;
+        pairs.reserve(runs * 2);
+        for_each([&](uint16_t value) {
+            if (!pairs.empty() && uint32_t(pairs[pairs.size() - 2]) + pairs.back() + 1 == value) {
+                ++pairs.back();
+            } else {
+                pairs.push_back(value);
+                pairs.push_back(0);
+            }
+        });
+        values = std::move(pairs);
+        words = vector<uint64_t>();
+        type = RUN;
+        return true;
+    }
+
+    // Bytes of heap memory held, including the container itself
+    size_t memory_usage() const {
+        return sizeof(*this) + values.capacity() * sizeof(uint16_t) + words.capacity() * sizeof(uint64_t);
+    }
+};
+
+// `c`, or a copy of it in `scratch` converted out of run form
+inline const roaring_container& without_runs(const roaring_container& c, roaring_container& scratch) {
+    if (c.type != roaring_container::RUN) return c;
+    scratch = c;
+    scratch.expand_runs();
+    return scratch;
+}
+
+// Values of `array` whose bit in `bitmap` is `keep`
+inline roaring_container filter_array(const roaring_container& array, const roaring_container& bitmap, bool keep) {
+    roaring_container out;
+    out.values.reserve(array.cardinality);
+    for (uint16_t value : array.values) {
+        if (bool((bitmap.words[value / 64] >> (value % 64)) & 1) == keep) out.values.push_back(value);
+    }
+    out.cardinality = uint32_t(out.values.size());
+    return out;
+}
+
+// Combine two bitmaps word by word
+template <bit_op Op>
+inline roaring_container combine_bitmaps(const roaring_container& a, const roaring_container& b) {
+    roaring_container out;
+    out.type = roaring_container::BITMAP;
+    out.words.resize(roaring_container::BITMAP_WORDS);
+    bitwise<Op>(out.words.data(), a.words.data(), b.words.data(), roaring_container::BITMAP_WORDS);
+    out.cardinality = uint32_t(popcount(out.words.data(), roaring_container::BITMAP_WORDS));
+    out.normalize();
+    return out;
+}
+
+inline roaring_container intersect(const roaring_container& x, const roaring_container& y) {
+    roaring_container scratch_x, scratch_y;
+    const roaring_container& a = without_runs(x, scratch_x);
+    const roaring_container& b = without_runs(y, scratch_y);
+
+    if (a.type == roaring_container::BITMAP && b.type == roaring_container::BITMAP) {
+        return combine_bitmaps<bit_op::AND>(a, b);
+    }
+    if (a.type == roaring_container::BITMAP) return filter_array(b, a, true);
+    if (b.type == roaring_container::BITMAP) return filter_array(a, b, true);
+
+    roaring_container out;
+    out.values.resize((a.cardinality < b.cardinality ? a.cardinality : b.cardinality) + 8);
+    size_t count = intersect_arrays(a.values.data(), a.cardinality, b.values.data(), b.cardinality, out.values.data());
+    out.values.resize(count);
+    out.cardinality = uint32_t(count);
+    return out;
+}
+
+inline roaring_container unite(const roaring_container& x, const roaring_container& y) {
+    roaring_container scratch_x, scratch_y;
+    const roaring_container& a = without_runs(x, scratch_x);
+    const roaring_container& b = without_runs(y, scratch_y);
+
+    if (a.type == roaring_container::BITMAP && b.type == roaring_container::BITMAP) {
+        return combine_bitmaps<bit_op::OR>(a, b);
+    }
+    if (a.type == roaring_container::BITMAP || b.type == roaring_container::BITMAP) {
+        const roaring_container& bitmap = a.type == roaring_container::BITMAP ? a : b;
+        const roaring_container& array = a.type == roaring_container::BITMAP ? b : a;
+        roaring_container out = bitmap;
+        for (uint16_t value : array.values) {
+            uint64_t bit = uint64_t(1) << (value % 64);
+            out.cardinality += !(out.words[value / 64] & bit);
+            out.words[value / 64] |= bit;
+        }
+        return out;
+    }
+
+    roaring_container out;
+    out.values.reserve(a.cardinality + b.cardinality);
+    size_t i = 0, j = 0;
+    while (i < a.values.size() && j < b.values.size()) {
+        uint16_t va = a.values[i];
+        uint16_t vb = b.values[j];
+        out.values.push_back(va < vb ? va : vb);
+        i += va <= vb;
+        j += vb <= va;
+    }
+    out.values.append_range(a.values.begin() + i, a.values.end());
+    out.values.append_range(b.values.begin() + j, b.values.end());
+    out.cardinality = uint32_t(out.values.size());
+    out.normalize();
+    return out;
+}
+
+inline roaring_container subtract(const roaring_container& x, const roaring_container& y) {
+    roaring_container scratch_x, scratch_y;
+    const roaring_container& a = without_runs(x, scratch_x);
+    const roaring_container& b = without_runs(y, scratch_y);
+
+    if (a.type == roaring_container::BITMAP && b.type == roaring_container::BITMAP) {
+        return combine_bitmaps<bit_op::AND_NOT>(a, b);
+    }
+    if (b.type == roaring_container::BITMAP) return filter_array(a, b, false);
+    if (a.type == roaring_container::BITMAP) {
+        roaring_container out = a;
+        for (uint16_t value : b.values) {
+            uint64_t bit = uint64_t(1) << (value % 64);
+            out.cardinality -= bool(out.words[value / 64] & bit);
+            out.words[value / 64] &= ~bit;
+        }
+        out.normalize();
+        return out;
+    }
+
+    roaring_container out;
+    out.values.reserve(a.cardinality);
+    size_t j = 0;
+    for (uint16_t value : a.values) {
+        while (j < b.values.size() && b.values[j] < value) ++j;
+        if (j == b.values.size() || b.values[j] != value) out.values.push_back(value);
+    }
+    out.cardinality = uint32_t(out.values.size());
+    return out;
+}
+
+// Check if two vectors of keys or container values hold the same elements
+inline bool equal_values(const vector<uint16_t>& a, const vector<uint16_t>& b) {
+    return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(uint16_t)) == 0);
+}
+
+inline bool equal(const roaring_container& x, const roaring_container& y) {
+    if (x.cardinality != y.cardinality) return false;
+    if (x.type == y.type && x.type != roaring_container::BITMAP) return equal_values(x.values, y.values);
+    if (x.type == y.type) return std::memcmp(x.words.data(), y.words.data(), x.words.size() * sizeof(uint64_t)) == 0;
+    return intersect(x, y).cardinality == x.cardinality;
+}
+
+}   // namespace detail
+
+// Compressed set of 32-bit values, such as document ids
+//
+// Values are split by their high 16 bits into containers holding the low halves as a sorted array, a 65536-bit
+// bitmap or a list of runs, whichever the density calls for (Chambi, Lemire et al., "Better bitmap performance with
+// Roaring bitmaps"). Set operations pair up containers by key; bitmap pairs combine with AVX2 and array pairs
+// intersect 8 by 8 with SSE shuffles. Each container caches its cardinality
+class roaring_bitmap {
+    using container = detail::roaring_container;
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor
+    //
+    // Initializes to the empty set
+    roaring_bitmap()
+        : _keys()
+        , _containers() {}
+
+    // Constructs from the values in the initializer list
+    roaring_bitmap(std::initializer_list<uint32_t> list)
+        : roaring_bitmap() {
+        add_many(list.begin(), list.size());
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Lookup /////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if `value` is in the set
+    bool contains(uint32_t value) const {
+        size_t index = find(uint16_t(value >> 16));
+        return index != NOT_FOUND && _containers[index].contains(uint16_t(value));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if the set is empty
+    bool empty() const { return _containers.empty(); }
+
+    // Number of values in the set, summed over the containers' cached counts
+    uint64_t cardinality() const {
+        uint64_t total = 0;
+        for (const auto& c : _containers) total += c.cardinality;
+        return total;
+    }
+
+    // Number of containers
+    size_t num_containers() const { return _containers.size(); }
+
+    // Bytes of memory held by the set
+    size_t memory_usage() const {
+        size_t bytes = sizeof(*this) + _keys.capacity() * sizeof(uint16_t);
+        bytes += (_containers.capacity() - _containers.size()) * sizeof(container);
+        for (const auto& c : _containers) bytes += c.memory_usage();
+        return bytes;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Add `value`, returning whether it was new
+    bool add(uint32_t value) { return container_for(uint16_t(value >> 16)).add(uint16_t(value)); }
+
+    // Remove `value`, returning whether it was present
+    bool remove(uint32_t value) {
+        size_t index = find(uint16_t(value >> 16));
+        if (index == NOT_FOUND || !_containers[index].remove(uint16_t(value))) return false;
+        if (_containers[index].cardinality == 0) erase_container(index);
+        return true;
+    }
+
+    // Add `count` values
+    //
+    // Consecutive values with the same high half go to their container in one step, so sorted input loads in a
+    // single pass
+    void add_many(const uint32_t* values, size_t count) {
+        uint32_t lows[256];
+        size_t i = 0;
+        while (i < count) {
+            uint16_t key = uint16_t(values[i] >> 16);
+            container& c = container_for(key);
+
+            size_t n = 0;
+            for (; i < count && uint16_t(values[i] >> 16) == key; ++i) {
+                lows[n++] = values[i] & 0xFFFF;
+                if (n == 256) {
+                    c.add_many(lows, n);
+                    n = 0;
+                }
+            }
+            c.add_many(lows, n);
+        }
+    }
+
+    // Add every value in [ `first`, `last` ). Containers created for the range hold a single run
+    void add_range(uint64_t first, uint64_t last) {
+        if (last > (uint64_t(1) << 32)) last = uint64_t(1) << 32;
+        while (first < last) {
+            uint16_t key = uint16_t(first >> 16);
+            uint64_t chunk_end = (uint64_t(key) + 1) << 16;
+            uint32_t low_first = uint32_t(first & 0xFFFF);
+            uint32_t low_last = uint32_t((last < chunk_end ? last : chunk_end) - 1) & 0xFFFF;
+
+            size_t index = find(key);
+            if (index == NOT_FOUND) {
+                container& c = container_for(key);
+                c.type = container::RUN;
+                c.values.push_back(uint16_t(low_first));
+                c.values.push_back(uint16_t(low_last - low_first));
+                c.cardinality = low_last - low_first + 1;
+            } else {
+                _containers[index].add_range(low_first, low_last);
+            }
+            first = chunk_end;
+        }
+    }
+
+    // Convert containers to runs wherever that saves memory, returning whether any changed
+    bool run_optimize() {
+        bool changed = false;
+        for (auto& c : _containers) changed |= c.run_optimize();
+        return changed;
+    }
+
+    // Removes every value
+    void clear() {
+        _keys.clear();
+        _containers.clear();
+    }
+
+    // Swap with another bitmap
+    void swap(roaring_bitmap& other) {
+        ndash::swap(_keys, other._keys);
+        ndash::swap(_containers, other._containers);
+    }
+
+    roaring_bitmap& operator&=(const roaring_bitmap& other) {
+        roaring_bitmap result = *this & other;
+        swap(result);
+        return *this;
+    }
+
+    roaring_bitmap& operator|=(const roaring_bitmap& other) {
+        roaring_bitmap result = *this | other;
+        swap(result);
+        return *this;
+    }
+
+    roaring_bitmap& operator-=(const roaring_bitmap& other) {
+        roaring_bitmap result = *this - other;
+        swap(result);
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Operations //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Call `func(uint32_t)` for each value in increasing order
+    template <class Func>
+    void for_each(Func&& func) const {
+        for (size_t i = 0; i < _containers.size(); ++i) {
+            uint32_t high = uint32_t(_keys[i]) << 16;
+            _containers[i].for_each([&](uint16_t low) { func(high | low); });
+        }
+    }
+
+    // Copy the values into a sorted vector
+    vector<uint32_t> to_vector() const {
+        vector<uint32_t> out;
+        out.reserve(cardinality());
+        for_each([&](uint32_t value) { out.push_back(value); });
+        return out;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////////// Serialization /////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Bytes written by `serialize`
+    size_t serialized_size() const {
+        size_t bytes = HEADER_SIZE;
+        for (const auto& c : _containers) bytes += CONTAINER_HEADER_SIZE + payload_size(c);
+        return bytes;
+    }
+
+    // Write the set to `out`, which needs `serialized_size()` bytes
+    //
+    // The layout is a magic number and container count, then for each container its key, type, cardinality and
+    // element count followed by the raw array, bitmap or run data, all in host byte order
+    void serialize(char* out) const {
+        out = put(out, MAGIC);
+        out = put(out, uint32_t(_containers.size()));
+        for (size_t i = 0; i < _containers.size(); ++i) {
+            const container& c = _containers[i];
+            out = put(out, _keys[i]);
+            out = put(out, uint8_t(c.type));
+            out = put(out, uint8_t(0));
+            out = put(out, c.cardinality);
+
+            if (c.type == container::BITMAP) {
+                out = put(out, uint32_t(c.words.size()));
+                std::memcpy(out, c.words.data(), c.words.size() * sizeof(uint64_t));
+            } else {
+                out = put(out, uint32_t(c.values.size()));
+                if (!c.values.empty()) std::memcpy(out, c.values.data(), c.values.size() * sizeof(uint16_t));
+            }
+            out += payload_size(c);
+        }
+    }
+
+    // Read a set written by `serialize` from [ `data`, `data + len` ) into `out`
+    //
+    // Returns false and leaves `out` empty when the data is truncated or inconsistent
+    static bool deserialize(const char* data, size_t len, roaring_bitmap& out) {
+        out.clear();
+        const char* end = data + len;
+
+        uint32_t magic, count;
+        if (len < HEADER_SIZE) return false;
+        data = get(data, magic);
+        data = get(data, count);
+        if (magic != MAGIC) return false;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            if (size_t(end - data) < CONTAINER_HEADER_SIZE) return fail(out);
+
+            uint16_t key;
+            uint8_t type, padding;
+            uint32_t cardinality, elements;
+            data = get(data, key);
+            data = get(data, type);
+            data = get(data, padding);
+            data = get(data, cardinality);
+            data = get(data, elements);
+
+            if (type > container::RUN || (i && key <= out._keys.back())) return fail(out);
+
+            container c;
+            c.type = container::kind(type);
+            c.cardinality = cardinality;
+            size_t bytes;
+            if (c.type == container::BITMAP) {
+                if (elements != container::BITMAP_WORDS) return fail(out);
+                bytes = elements * sizeof(uint64_t);
+                if (size_t(end - data) < bytes) return fail(out);
+                c.words.resize(elements);
+                std::memcpy(c.words.data(), data, bytes);
+                if (detail::popcount(c.words.data(), elements) != cardinality) return fail(out);
+            } else {
+                if (elements > 2 * container::ARRAY_MAX + 2 * 65536) return fail(out);
+                bytes = elements * sizeof(uint16_t);
+                if (size_t(end - data) < bytes) return fail(out);
+                c.values.resize(elements);
+                if (bytes) std::memcpy(c.values.data(), data, bytes);
+                if (!valid_values(c)) return fail(out);
+            }
+            data += bytes;
+
+            out._keys.push_back(key);
+            out._containers.push_back(std::move(c));
+        }
+        return true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////// Non-member functions //////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Values in both sets
+    friend roaring_bitmap operator&(const roaring_bitmap& a, const roaring_bitmap& b) {
+        roaring_bitmap out;
+        size_t i = 0, j = 0;
+        while (i < a._keys.size() && j < b._keys.size()) {
+            if (a._keys[i] < b._keys[j]) {
+                ++i;
+            } else if (b._keys[j] < a._keys[i]) {
+                ++j;
+            } else {
+                container c = detail::intersect(a._containers[i], b._containers[j]);
+                if (c.cardinality) out.append(a._keys[i], std::move(c));
+                ++i;
+                ++j;
+            }
+        }
+        return out;
+    }
+
+    // Values in either set
+    friend roaring_bitmap operator|(const roaring_bitmap& a, const roaring_bitmap& b) {
+        roaring_bitmap out;
+        size_t i = 0, j = 0;
+        while (i < a._keys.size() || j < b._keys.size()) {
+            if (j == b._keys.size() || (i < a._keys.size() && a._keys[i] < b._keys[j])) {
+                out.append(a._keys[i], a._containers[i]);
+                ++i;
+            } else if (i == a._keys.size() || b._keys[j] < a._keys[i]) {
+                out.append(b._keys[j], b._containers[j]);
+                ++j;
+            } else {
+                out.append(a._keys[i], detail::unite(a._containers[i], b._containers[j]));
+                ++i;
+                ++j;
+            }
+        }
+        return out;
+    }
+
+    // Values in `a` but not in `b`
+    friend roaring_bitmap operator-(const roaring_bitmap& a, const roaring_bitmap& b) {
+        roaring_bitmap out;
+        size_t j = 0;
+        for (size_t i = 0; i < a._keys.size(); ++i) {
+            while (j < b._keys.size() && b._keys[j] < a._keys[i]) ++j;
+            if (j == b._keys.size() || b._keys[j] != a._keys[i]) {
+                out.append(a._keys[i], a._containers[i]);
+            } else {
+                container c = detail::subtract(a._containers[i], b._containers[j]);
+                if (c.cardinality) out.append(a._keys[i], std::move(c));
+            }
+        }
+        return out;
+    }
+
+    friend bool operator==(const roaring_bitmap& a, const roaring_bitmap& b) {
+        if (!detail::equal_values(a._keys, b._keys)) return false;
+        for (size_t i = 0; i < a._containers.size(); ++i) {
+            if (!detail::equal(a._containers[i], b._containers[i])) return false;
+        }
+        return true;
+    }
+
+    // Swap specialization
+    friend void swap(roaring_bitmap& a, roaring_bitmap& b) { a.swap(b); }
+
+private:
+    static constexpr const size_t NOT_FOUND = size_t(-1);
+    static constexpr const uint32_t MAGIC = 0x42524E44;   // "DNRB"
+    static constexpr const size_t HEADER_SIZE = 8;
+    static constexpr const size_t CONTAINER_HEADER_SIZE = 12;
+
+    // Index of the container for `key`, or `NOT_FOUND`
+    size_t find(uint16_t key) const {
+        const uint16_t* begin = _keys.data();
+        const uint16_t* pos = std::lower_bound(begin, begin + _keys.size(), key);
+        return pos != begin + _keys.size() && *pos == key ? size_t(pos - begin) : NOT_FOUND;
+    }
+
+    // Container for `key`, inserting an empty one if needed
+    container& container_for(uint16_t key) {
+        if (_keys.empty() || _keys.back() < key) {
+            append(key, container());
+            return _containers.back();
+        }
+
+        const uint16_t* begin = _keys.data();
+        size_t index = std::lower_bound(begin, begin + _keys.size(), key) - begin;
+        if (_keys[index] != key) {
+            _keys.insert(_keys.begin() + index, key);
+            _containers.insert(_containers.begin() + index, container());
+        }
+        return _containers[index];
+    }
+
+    void append(uint16_t key, container c) {
+        _keys.push_back(key);
+        _containers.push_back(std::move(c));
+    }
+
+    void erase_container(size_t index) {
+        _keys.erase(_keys.begin() + index);
+        _containers.erase(_containers.begin() + index);
+    }
+
+    static size_t payload_size(const container& c) {
+        return c.type == container::BITMAP ? c.words.size() * sizeof(uint64_t) : c.values.size() * sizeof(uint16_t);
+    }
+
+    // Check an array or run container read from serialized data
+    static bool valid_values(const container& c) {
+        if (c.type == container::ARRAY) {
+            if (c.values.size() != c.cardinality || c.cardinality > container::ARRAY_MAX) return false;
+            for (size_t i = 1; i < c.values.size(); ++i) {
+                if (c.values[i] <= c.values[i - 1]) return false;
+            }
+            return c.cardinality > 0;
+        }
+
+        if (c.values.size() % 2 || c.values.empty()) return false;
+        uint64_t total = 0;
+        uint32_t next_start = 0;
+        for (size_t r = 0; r < c.num_runs(); ++r) {
+            uint32_t start = c.values[2 * r];
+            uint32_t end = start + c.values[2 * r + 1];
+            if (start < next_start || end > 0xFFFF) return false;
+            total += end - start + 1;
+            next_start = end + 2;
+        }
+        return total == c.cardinality;
+    }
+
+    static bool fail(roaring_bitmap& out) {
+        out.clear();
+        return false;
+    }
+
+    template <typename V>
+    static char* put(char* out, V value) {
+        std::memcpy(out, &value, sizeof(V));
+        return out + sizeof(V);
+    }
+
+    template <typename V>
+    static const char* get(const char* in, V& value) {
+        std::memcpy(&value, in, sizeof(V));
+        return in + sizeof(V);
+    }
+
+    vector<uint16_t> _keys;
+    vector<container> _containers;
+};
+
+}   // namespace ndash
+
+#undef NDASH_ROARING_X86
+
+#endif   // ROARING_BITMAP_H
@@ -0,0 +1,380 @@
+#ifndef SEGMENTED_VECTOR_H
+#define SEGMENTED_VECTOR_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "iterator.h"
+#include "swap.h"
+
+namespace ndash {
+
+// Bits of the element count of a segmented vector's first block, sized to about 4 KB
+template <typename T>
+constexpr size_t segmented_first_block_bits() {
+    size_t bits = 0;
+    while (bits < 12 && (sizeof(T) << (bits + 1)) <= 4096) ++bits;
+    return bits;
+}
+
+// Vector made of geometrically growing blocks that never move
+//
+// Block `k` holds `2^(FirstBlockBits + k)` elements, so the block and offset of an index come from its highest set
+// bit. Growing allocates the next block instead of moving existing elements, which keeps references, pointers and
+// iterators valid across `push_back` and caps the memory overhead at the one partially filled block
+template <typename T, size_t FirstBlockBits = segmented_first_block_bits<T>()>
+class segmented_vector {
+    static constexpr const size_t FIRST_BLOCK_SIZE = size_t(1) << FirstBlockBits;
+    static constexpr const size_t MAX_BLOCKS = 64 - FirstBlockBits;
+
+    template <typename T2>
+    struct Iterator;
+
+public:
+    using iterator = Iterator<T>;
+    using const_iterator = Iterator<const T>;
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor
+    //
+    // Initializes to size 0 without allocating
+    constexpr segmented_vector()
+        : _size(0)
+        , _num_blocks(0)
+        , _blocks {} {}
+
+    // Constructs with `count` default initialized elements
+    explicit segmented_vector(size_t count)
+        : segmented_vector() {
+        resize(count);
+    }
+
+    // Constructs with `count` copies of `value`
+    segmented_vector(size_t count, const T& value)
+        : segmented_vector() {
+        resize(count, value);
+    }
+
+    // Constructs with the contents of the range [`first`, `last`)
+    template <typename ForwardIt>
+    segmented_vector(ForwardIt first, ForwardIt last)
+    requires forward_iterator<ForwardIt>
+        : segmented_vector() {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    // Constructs from the initializer list
+    segmented_vector(std::initializer_list<T> list)
+        : segmented_vector(list.begin(), list.end()) {}
+
+    // Copy constructor
+    segmented_vector(const segmented_vector& other)
+        : segmented_vector(other.begin(), other.end()) {}
+
+    // Move constructor
+    //
+    // Blocks are handed over, so references into `other` now refer into this vector
+    segmented_vector(segmented_vector&& other)
+        : segmented_vector() {
+        swap(other);
+    }
+
+    // Assignment operator
+    segmented_vector& operator=(const segmented_vector& other) {
+        if (&other != this) {
+            segmented_vector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    segmented_vector& operator=(segmented_vector&& other) {
+        if (&other != this) {
+            clear();
+            release_blocks(0);
+            swap(other);
+        }
+        return *this;
+    }
+
+    // Destructor
+    ~segmented_vector() {
+        clear();
+        release_blocks(0);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////////// Element Access ////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Access specified element
+    T& operator[](size_t pos) { return *locate(pos); }
+
+    // Access specified element by const reference
+    const T& operator[](size_t pos) const { return *locate(pos); }
+
+    // Access first element
+    T& front() { return _blocks[0][0]; }
+
+    // Access first element by const reference
+    const T& front() const { return _blocks[0][0]; }
+
+    // Access last element
+    T& back() { return *locate(_size - 1); }
+
+    // Access last element by const reference
+    const T& back() const { return *locate(_size - 1); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if container is empty
+    constexpr bool empty() const { return !_size; }
+
+    // Get number of elements
+    constexpr size_t size() const { return _size; }
+
+    // Get number of elements that fit in the allocated blocks
+    constexpr size_t capacity() const { return capacity_of(_num_blocks); }
+
+    // Number of allocated blocks
+    constexpr size_t num_blocks() const { return _num_blocks; }
+
+    // Allocate blocks until `new_cap` elements fit
+    void reserve(size_t new_cap) {
+        while (capacity() < new_cap) add_block();
+    }
+
+    // Free blocks that hold no elements
+    void shrink_to_fit() { release_blocks(_size ? block_of(_size - 1) + 1 : 0); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Destroys every element, keeping the blocks
+    void clear() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (auto& value : *this) value.~T();
+        }
+        _size = 0;
+    }
+
+    // Adds an element to the end
+    void push_back(const T& value) { emplace_back(value); }
+
+    // Adds an element to the end using move semantics
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    // Creates an element at the end and returns a reference that stays valid until it is removed
+    template <class... Args>
+    T& emplace_back(Args&&... args) {
+        [[unlikely]] if (_size == capacity()) { add_block(); }
+        T* slot = locate(_size);
+        new (slot) T(std::forward<Args>(args)...);
+        ++_size;
+        return *slot;
+    }
+
+    // Removes the last element
+    void pop_back() { locate(--_size)->~T(); }
+
+    // Resize to `count` elements, default initializing new ones
+    void resize(size_t count) {
+        reserve(count);
+        while (_size < count) emplace_back();
+        while (_size > count) pop_back();
+    }
+
+    // Resize to `count` elements, copying `value` into new ones
+    void resize(size_t count, const T& value) {
+        reserve(count);
+        while (_size < count) emplace_back(value);
+        while (_size > count) pop_back();
+    }
+
+    // Swap with another segmented vector
+    void swap(segmented_vector& other) {
+        ndash::swap(_size, other._size);
+        ndash::swap(_num_blocks, other._num_blocks);
+        for (size_t i = 0; i < MAX_BLOCKS; ++i) {
+            ndash::swap(_blocks[i], other._blocks[i]);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Iterators ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+private:
+    // Segmented vector iterator
+    //
+    // Keeps a pointer into the current block so sequential traversal only locates an element at block boundaries
+    template <typename T2>
+    struct Iterator {
+        using value = T2;
+        using reference = T2&;
+        using pointer = T2*;
+        using difference_type = ptrdiff_t;
+        using blocks_pointer = std::conditional_t<std::is_const_v<T2>, T* const*, T**>;
+
+        constexpr Iterator(blocks_pointer blocks, size_t index)
+            : _blocks(blocks)
+            , _index(index) {
+            seek();
+        }
+
+        template <class U>
+        constexpr Iterator(const Iterator<U>& other)
+        requires std::is_same_v<T2, const U>
+            : _blocks(other._blocks)
+            , _index(other._index)
+            , _ptr(other._ptr)
+            , _block_end(other._block_end) {}
+
+        constexpr reference operator*() const { return *_ptr; }
+        constexpr pointer operator->() const { return _ptr; }
+
+        constexpr Iterator& operator++() {
+            ++_index;
+            if (++_ptr == _block_end) seek();
+            return *this;
+        }
+
+        constexpr Iterator operator++(int) {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        constexpr Iterator& operator--() {
+            --_index;
+            seek();
+            return *this;
+        }
+
+        constexpr Iterator operator--(int) {
+            Iterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+        constexpr Iterator& operator+=(ptrdiff_t diff) {
+            _index += diff;
+            seek();
+            return *this;
+        }
+
+        constexpr Iterator& operator-=(ptrdiff_t diff) {
+            _index -= diff;
+            seek();
+            return *this;
+        }
+
+        constexpr reference operator[](ptrdiff_t diff) { return *(*this + diff); }
+
+        friend constexpr Iterator operator+(const Iterator& a, ptrdiff_t diff) {
+            return Iterator(a._blocks, a._index + diff);
+        }
+        friend constexpr Iterator operator+(ptrdiff_t diff, const Iterator& a) { return a + diff; }
+        friend constexpr Iterator operator-(const Iterator& a, ptrdiff_t diff) {
+            return Iterator(a._blocks, a._index - diff);
+        }
+        friend constexpr ptrdiff_t operator-(const Iterator& a, const Iterator& b) {
+            return ptrdiff_t(a._index - b._index);
+        }
+
+        friend bool constexpr operator==(const Iterator& a, const Iterator& b) { return a._index == b._index; }
+        friend bool constexpr operator!=(const Iterator& a, const Iterator& b) { return !(a == b); }
+        friend difference_type constexpr operator<=>(const Iterator& a, const Iterator& b) { return a - b; }
+
+    private:
+        template <typename>
+        friend struct Iterator;
+
+        // Point at the element at `_index`. Positions in unallocated blocks get a null pointer
+        constexpr void seek() {
+            size_t block = block_of(_index);
+            if (block < MAX_BLOCKS && _blocks[block]) {
+                _ptr = _blocks[block] + (_index - capacity_of(block));
+                _block_end = _blocks[block] + (FIRST_BLOCK_SIZE << block);
+            } else {
+                _ptr = nullptr;
+                _block_end = nullptr;
+            }
+        }
+
+        blocks_pointer _blocks;
+        size_t _index;
+        pointer _ptr;
+        pointer _block_end;
+    };
+
+public:
+    static_assert(random_access_iterator<iterator>);
+    static_assert(random_access_iterator<const_iterator>);
+
+    // Iterator begin
+    iterator begin() { return iterator(_blocks, 0); }
+    const_iterator begin() const { return const_iterator(_blocks, 0); }
+
+    // Iterator end
+    iterator end() { return iterator(_blocks, _size); }
+    const_iterator end() const { return const_iterator(_blocks, _size); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////// Non-member functions //////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Swap specialization
+    friend void swap(segmented_vector& a, segmented_vector& b) { a.swap(b); }
+
+private:
+    // Block holding the element at `index`
+    static constexpr size_t block_of(size_t index) {
+        return size_t(63 - __builtin_clzll(index + FIRST_BLOCK_SIZE)) - FirstBlockBits;
+    }
+
+    // Number of elements in the blocks before block `block`
+    static constexpr size_t capacity_of(size_t block) { return (FIRST_BLOCK_SIZE << block) - FIRST_BLOCK_SIZE; }
+
+    // Address of the element at `index`
+    T* locate(size_t index) const {
+        size_t shifted = index + FIRST_BLOCK_SIZE;
+        size_t high_bit = size_t(63 - __builtin_clzll(shifted));
+        return _blocks[high_bit - FirstBlockBits] + (shifted - (size_t(1) << high_bit));
+    }
+
+    void add_block() {
+        size_t count = FIRST_BLOCK_SIZE << _num_blocks;
+        _blocks[_num_blocks] = static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+        ++_num_blocks;
+    }
+
+    // Free the blocks from `first_block` on, which must hold no elements
+    void release_blocks(size_t first_block) {
+        while (_num_blocks > first_block) {
+            --_num_blocks;
+            ::operator delete(_blocks[_num_blocks], std::align_val_t(alignof(T)));
+            _blocks[_num_blocks] = nullptr;
+        }
+    }
+
+    size_t _size;
+    size_t _num_blocks;
+    T* _blocks[MAX_BLOCKS];
+};
+
+}   // namespace ndash
+
+#endif   // SEGMENTED_VECTOR_H
@@ -4,6 +4,8 @@
 #include <cstddef>
 #include <cstring>
 #include <initializer_list>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 #include "iterator.h"
@@ -11,9 +13,40 @@
 
 namespace ndash {
 
-template <typename T>
+// Default storage for `vector`, from the global aligned `operator new`
+//
+// A storage policy provides `allocate`, `deallocate`, `reallocate` and `release_unused`. `reallocate` resizes a
+// buffer of trivially copyable elements without copying them, or returns nullptr when the policy can't.
+// `release_unused` may return the memory past the last element to the system after the vector shrinks
+struct heap_storage {
+    template <typename T>
+    static T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    template <typename T>
+    static void deallocate(T* data, size_t) {
+        ::operator delete(data, std::align_val_t(alignof(T)));
+    }
+
+    template <typename T>
+    static T* reallocate(T*, size_t, size_t) {
+        return nullptr;
+    }
+
+    template <typename T>
+    static void release_unused(T*, size_t, size_t) {}
+};
+
+template <typename T, typename Storage = heap_storage>
 class vector {
+    template <typename T2>
+    struct Iterator;
+
 public:
+    using iterator = Iterator<T>;
+    using const_iterator = Iterator<const T>;
+
     ///////////////////////////////////////////////////////////////////////////
     ////////////////////////// Constructors/Destructors ///////////////////////
     ///////////////////////////////////////////////////////////////////////////
@@ -28,48 +61,48 @@ public:
 
     // Constructs a vector with `count` size and `count` capacity, all default initialized
     vector(size_t count)
-        : _size(count)
+        : _size(0)
         , _capacity(count)
-        , _data(new T[count] {}) {}
+        , _data(allocate(count)) {
+        for (size_t i = 0; i < count; ++i) {
+            emplace_back();
+        }
+    }
 
     // Constructs a vector with `count` size and `count` capacity, all set to `value`
     vector(size_t count, const T& value)
         : _size(0)
         , _capacity(count)
-        , _data(new T[count]) {
+        , _data(allocate(count)) {
         for (size_t i = 0; i < count; ++i) {
             emplace_back(value);
         }
     }
 
     // Constructs a vector with the contents of the range [`first`, `last`)
+    //
+    // Ranges with a known size allocate once, see `assign`
     template <typename ForwardIt>
     vector(ForwardIt first, ForwardIt last)
     requires forward_iterator<ForwardIt>
         : vector() {
-        while (first != last) {
-            emplace_back(*(first++));
-        }
+        assign(first, last);
     }
 
     // Constructs a vector from the initializer list
     vector(std::initializer_list<T> list)
         : _size(0)
         , _capacity(list.size())
-        , _data(new T[list.size()]) {
-        for (auto it = list.begin(); it != list.end(); ++it) {
-            emplace_back(*it);
-        }
+        , _data(allocate(list.size())) {
+        construct_at_end(list.begin(), list.size());
     }
 
     // Copy constructor
     vector(const vector& other)
         : _size(0)
         , _capacity(other._capacity)
-        , _data(new T[other._capacity]) {
-        for (auto it = other.begin(); it != other.end(); ++it) {
-            emplace_back(*it);
-        }
+        , _data(allocate(other._capacity)) {
+        construct_at_end(other._data, other._size);
     }
 
     // Move constructor
@@ -85,11 +118,7 @@ public:
     // Assignment operator
     vector& operator=(const vector& other) {
         if (&other != this) {
-            clear();
-            reserve(other._size);
-            for (auto it = other.begin(); it != other.end(); ++it) {
-                emplace_back(*it);
-            }
+            assign(other._data, other._data + other._size);
         }
         return *this;
     }
@@ -97,7 +126,8 @@ public:
     // Move assignment operator
     vector& operator=(vector&& other) {
         if (&other != this) {
-            delete[] _data;
+            destroy_elements();
+            deallocate(_data, _capacity);
 
             _size = other._size;
             _capacity = other._capacity;
@@ -111,22 +141,14 @@ public:
     }
 
     vector& operator=(std::initializer_list<T> ilist) {
-        clear();
-        reserve(ilist.size());
-        int i = 0;
-        for (auto it = ilist.begin(); it != ilist.end(); ++it, ++i) {
-            emplace_back(*it);
-        }
+        assign(ilist.begin(), ilist.end());
         return *this;
     }
 
     // Destructor
     ~vector() {
-        for (size_t i = 0; i < _size; ++i) {
-            _data[i].~T();
-        }
-        delete[] _data;
-        _data = nullptr;
+        destroy_elements();
+        deallocate(_data, _capacity);
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -172,21 +194,23 @@ public:
     // If `new_cap` is less than current capacity, nothing is done
     void reserve(size_t new_cap) {
         if (new_cap <= _capacity) return;
+        if (try_reallocate(new_cap)) return;
 
         // Create new buffer
-        T* copy = new T[new_cap];
+        T* copy = allocate(new_cap);
 
         // Copy elements
-        for (size_t i = 0; i < _size; ++i) {
-            new (copy + i) T(std::move_if_noexcept(_data[i]));
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (_size) std::memcpy(copy, _data, _size * sizeof(T));
+        } else {
+            for (size_t i = 0; i < _size; ++i) {
+                new (copy + i) T(std::move_if_noexcept(_data[i]));
+            }
         }
 
         // Destroy old elements
-        for (size_t i = 0; i < _size; ++i) {
-            _data[i].~T();
-        }
-
-        delete[] _data;
+        destroy_elements();
+        deallocate(_data, _capacity);
 
         _data = copy;
         _capacity = new_cap;
@@ -195,13 +219,154 @@ public:
     // Get number of elements that can be held in vector
     constexpr size_t capacity() const { return _capacity; }
 
+    // Largest number of elements a vector can hold
+    static constexpr size_t max_size() { return size_t(-1) / 2 / sizeof(T); }
+
+    // Reduce capacity to the number of elements
+    void shrink_to_fit() {
+        if (_size == _capacity) return;
+        if (_size && try_reallocate(_size)) return;
+
+        T* copy = allocate(_size);
+        relocate(copy, _data, _size);
+        deallocate(_data, _capacity);
+
+        _data = copy;
+        _capacity = _size;
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     ///////////////////////////////// Modifiers ///////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
 
     // Clears the contents of the vector
     void clear() {
-        while (_size != 0) pop_back();
+        destroy_elements();
+        _size = 0;
+    }
+
+    // Replaces the contents with the range [`first`, `last`)
+    //
+    // Ranges with a known size allocate at most once, and contiguous ranges of trivially copyable elements are
+    // copied with a single memcpy. Other forward ranges are counted first so they also allocate once
+    template <typename ForwardIt>
+    void assign(ForwardIt first, ForwardIt last)
+    requires forward_iterator<ForwardIt>
+    {
+        clear();
+        size_t count = ndash::distance(first, last);
+        if (count > _capacity) {
+            deallocate(_data, _capacity);
+            _data = allocate(count);
+            _capacity = count;
+        }
+        construct_at_end(first, count);
+    }
+
+    // Replaces the contents with the initializer list
+    void assign(std::initializer_list<T> ilist) { assign(ilist.begin(), ilist.end()); }
+
+    // Appends the range [`first`, `last`), growing at most once
+    template <typename ForwardIt>
+    void append_range(ForwardIt first, ForwardIt last)
+    requires forward_iterator<ForwardIt>
+    {
+        size_t count = ndash::distance(first, last);
+        if (_size + count > _capacity) reserve(grown_capacity(_size + count));
+        construct_at_end(first, count);
+    }
+
+    // Appends the elements of `range`, growing at most once
+    template <typename Range>
+    void append_range(const Range& range) {
+        append_range(range.begin(), range.end());
+    }
+
+    // Inserts a copy of `value` before `pos`
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+
+    // Inserts `value` before `pos` using move semantics
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+    // Inserts `count` copies of `value` before `pos`
+    iterator insert(const_iterator pos, size_t count, const T& value) {
+        size_t index = ndash::to_address(pos) - _data;
+        if (!count) return iterator(_data + index);
+
+        // `value` may live in the elements about to move
+        T copy(value);
+        T* gap = open_gap(index, count);
+        for (size_t i = 0; i < count; ++i) {
+            new (gap + i) T(copy);
+        }
+        _size += count;
+        return iterator(gap);
+    }
+
+    // Inserts the range [`first`, `last`) before `pos`
+    //
+    // Later elements are shifted once by the length of the range, with memmove for trivially copyable types, and
+    // storage grows at most once. The range must not point into the vector
+    template <typename ForwardIt>
+    iterator insert(const_iterator pos, ForwardIt first, ForwardIt last)
+    requires forward_iterator<ForwardIt>
+    {
+        size_t index = ndash::to_address(pos) - _data;
+        size_t count = ndash::distance(first, last);
+        if (!count) return iterator(_data + index);
+
+        T* gap = open_gap(index, count);
+        if constexpr (is_memcpy_range<ForwardIt>()) {
+            std::memcpy(gap, ndash::to_address(first), count * sizeof(T));
+        } else {
+            for (size_t i = 0; i < count; ++i, ++first) {
+                new (gap + i) T(*first);
+            }
+        }
+        _size += count;
+        return iterator(gap);
+    }
+
+    // Inserts the elements of the initializer list before `pos`
+    iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    // Constructs an element in place before `pos`
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        size_t index = ndash::to_address(pos) - _data;
+        if (index == _size) {
+            emplace_back(std::forward<Args>(args)...);
+            return iterator(_data + index);
+        }
+
+        // Arguments may refer to the elements about to move
+        T value(std::forward<Args>(args)...);
+        T* gap = open_gap(index, 1);
+        new (gap) T(std::move(value));
+        ++_size;
+        return iterator(gap);
+    }
+
+    // Removes the element at `pos`
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    // Removes the elements in [`first`, `last`)
+    //
+    // Later elements are shifted down once, with memmove for trivially copyable types
+    iterator erase(const_iterator first, const_iterator last) {
+        T* begin = _data + (ndash::to_address(first) - _data);
+        T* end = _data + (ndash::to_address(last) - _data);
+        if (begin == end) return iterator(begin);
+
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (T* it = begin; it != end; ++it) it->~T();
+        }
+        relocate(begin, end, (_data + _size) - end);
+        _size -= end - begin;
+        release_unused();
+        return iterator(begin);
     }
 
     // Adds an element to the end of the vector
@@ -233,7 +398,8 @@ public:
                 emplace_back();
             }
         } else if (count < _size) {
-            _size = count;
+            while (_size > count) pop_back();
+            release_unused();
         }
     }
 
@@ -249,7 +415,8 @@ public:
                 emplace_back(value);
             }
         } else if (count < _size) {
-            _size = count;
+            while (_size > count) pop_back();
+            release_unused();
         }
     }
 
@@ -268,6 +435,8 @@ private:
     // Vector iterator struct
     template <typename T2>
     struct Iterator {
+        static constexpr bool is_contiguous = true;
+
         using value = T2;
         using reference = T2&;
         using pointer = T2*;
@@ -300,7 +469,7 @@ private:
             return *this;
         }
 
-        constexpr Iterator& operator--(int) {
+        constexpr Iterator operator--(int) {
             Iterator tmp = *this;
             --(*this);
             return tmp;
@@ -328,14 +497,17 @@ private:
         friend difference_type constexpr operator<=>(const Iterator& a, const Iterator& b) { return a._ptr - b._ptr; }
 
     private:
+        template <typename>
+        friend struct Iterator;
+
         pointer _ptr;
     };
 
 public:
-    using iterator = Iterator<T>;
-    using const_iterator = Iterator<const T>;
     static_assert(random_access_iterator<iterator>);
     static_assert(random_access_iterator<const_iterator>);
+    static_assert(contiguous_iterator<iterator>);
+    static_assert(contiguous_iterator<const_iterator>);
 
     // Iterator begin
     constexpr iterator begin() { return iterator(_data); }
@@ -358,9 +530,144 @@ public:
     ///////////////////////////////////////////////////////////////////////////
 
     // Swap specialization
-    friend void swap(vector<T>& a, vector<T>& b) { a.swap(b); }
+    friend void swap(vector& a, vector& b) { a.swap(b); }
+
+    // Removes every element matching `pred` in a single pass, returning the number removed
+    template <class Pred>
+    friend size_t erase_if(vector& vec, Pred pred) {
+        T* out = vec._data;
+        T* end = vec._data + vec._size;
+        for (T* it = vec._data; it != end; ++it) {
+            if (pred(static_cast<const T&>(*it))) continue;
+            if (out != it) *out = std::move(*it);
+            ++out;
+        }
+
+        size_t removed = end - out;
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (T* it = out; it != end; ++it) it->~T();
+        }
+        vec._size -= removed;
+        vec.release_unused();
+        return removed;
+    }
 
 private:
+    // Allocate uninitialized storage for `count` elements
+    //
+    // Oversized requests throw like `new[]` instead of wrapping the byte count
+    static T* allocate(size_t count) {
+        if (!count) return nullptr;
+        if (count > max_size()) throw std::bad_array_new_length();
+        return Storage::template allocate<T>(count);
+    }
+
+    // Free storage from `allocate` holding `capacity` elements
+    static void deallocate(T* data, size_t capacity) {
+        if (data) Storage::template deallocate<T>(data, capacity);
+    }
+
+    // Resize storage to `new_cap` elements without copying them, if the storage policy supports it for `T`
+    bool try_reallocate(size_t new_cap) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (!_data || !new_cap) return false;
+            if (new_cap > max_size()) throw std::bad_array_new_length();
+
+            T* moved = Storage::template reallocate<T>(_data, _capacity, new_cap);
+            if (!moved) return false;
+
+            _data = moved;
+            _capacity = new_cap;
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    // Let the storage policy reclaim memory past the last element
+    void release_unused() { Storage::template release_unused<T>(_data, _size, _capacity); }
+
+    // Check if elements of the range starting at `It` can be copied into the vector with memcpy
+    template <typename It>
+    static constexpr bool is_memcpy_range() {
+        if constexpr (contiguous_iterator<It>) {
+            return std::is_trivially_copyable_v<T>
+                && std::is_same_v<std::remove_cvref_t<decltype(*std::declval<It>())>, T>;
+        } else {
+            return false;
+        }
+    }
+
+    // Copy construct `count` elements from the range starting at `first` after the last element
+    //
+    // Capacity must already be available
+    template <typename It>
+    void construct_at_end(It first, size_t count) {
+        if constexpr (is_memcpy_range<It>()) {
+            if (count) std::memcpy(_data + _size, ndash::to_address(first), count * sizeof(T));
+            _size += count;
+        } else {
+            for (size_t i = 0; i < count; ++i, ++first) {
+                new (_data + _size) T(*first);
+                ++_size;
+            }
+        }
+    }
+
+    // Capacity to grow to when at least `min_capacity` elements are needed
+    size_t grown_capacity(size_t min_capacity) const {
+        size_t doubled = _capacity ? _capacity * 2 : 8;
+        return doubled > min_capacity ? doubled : min_capacity;
+    }
+
+    // Move `count` elements from `src` into uninitialized `dst`, leaving `src` uninitialized. The ranges may overlap
+    static void relocate(T* dst, T* src, size_t count) {
+        if (!count || dst == src) return;
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memmove(dst, src, count * sizeof(T));
+        } else if (dst < src) {
+            for (size_t i = 0; i < count; ++i) {
+                new (dst + i) T(std::move(src[i]));
+                src[i].~T();
+            }
+        } else {
+            for (size_t i = count; i-- > 0;) {
+                new (dst + i) T(std::move(src[i]));
+                src[i].~T();
+            }
+        }
+    }
+
+    // Shift the elements from `index` up to open `count` uninitialized slots there, growing storage at most once
+    //
+    // Returns the first slot. The caller constructs the slots and adds `count` to `_size`
+    T* open_gap(size_t index, size_t count) {
+        if (_size + count > _capacity) {
+            size_t new_cap = grown_capacity(_size + count);
+            if (!try_reallocate(new_cap)) {
+                T* copy = allocate(new_cap);
+                relocate(copy, _data, index);
+                relocate(copy + index + count, _data + index, _size - index);
+                deallocate(_data, _capacity);
+
+                _data = copy;
+                _capacity = new_cap;
+                return _data + index;
+            }
+        }
+        relocate(_data + index + count, _data + index, _size - index);
+        return _data + index;
+    }
+
+    // Destroy the elements in [ `0`, `_size` ) without freeing storage
+    void destroy_elements() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = 0; i < _size; ++i) {
+                _data[i].~T();
+            }
+        }
+    }
+
     size_t _size;
     size_t _capacity;
     T* _data;
@@ -0,0 +1,632 @@
+#ifndef ALGORITHM_H
+#define ALGORITHM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "iterator.h"
+#include "swap.h"
+#include "vector.h"
+
+namespace ndash {
+
+// Iterators the sorting algorithms can index into: random access iterators and raw pointers
+template <typename It>
+concept sortable_iterator = random_access_iterator<It> || std::is_pointer_v<It>;
+
+namespace detail {
+
+// Type of the elements an iterator refers to
+template <typename It>
+using iter_value_t = std::remove_cvref_t<decltype(*std::declval<It&>())>;
+
+constexpr const ptrdiff_t INSERTION_SORT_THRESHOLD = 24;
+constexpr const ptrdiff_t NINTHER_THRESHOLD = 128;
+constexpr const ptrdiff_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+constexpr const size_t PARTITION_BLOCK = 64;
+constexpr const ptrdiff_t STABLE_RUN = 32;
+constexpr const ptrdiff_t HEAP_SELECT_RATIO = 16;
+
+// Partition arithmetic keys under the standard orderings without branching on comparisons
+template <typename T, class Compare>
+constexpr bool use_branchless_partition
+  = std::is_arithmetic_v<T>
+ && (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>
+     || std::is_same_v<Compare, std::greater<>> || std::is_same_v<Compare, std::greater<T>>);
+
+template <typename It>
+void iter_swap(It a, It b) {
+    ndash::swap(*a, *b);
+}
+
+// Floor of log2(`n`), for `n` above 0
+inline int floor_log2(ptrdiff_t n) { return 63 - __builtin_clzll(uint64_t(n)); }
+
+template <typename It, class Compare>
+void insertion_sort(It begin, It end, Compare& comp) {
+    if (begin == end) return;
+    for (It cur = begin + 1; cur != end; ++cur) {
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            iter_value_t<It> tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (sift != begin && comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Insertion sort that relies on `*(begin - 1)` being no greater than any element to stop
+template <typename It, class Compare>
+void unguarded_insertion_sort(It begin, It end, Compare& comp) {
+    if (begin == end) return;
+    for (It cur = begin + 1; cur != end; ++cur) {
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            iter_value_t<It> tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Insertion sort that gives up once more than `PARTIAL_INSERTION_SORT_LIMIT` elements have moved, returning
+// whether it finished
+template <typename It, class Compare>
+bool partial_insertion_sort(It begin, It end, Compare& comp) {
+    if (begin == end) return true;
+    ptrdiff_t moved = 0;
+    for (It cur = begin + 1; cur != end; ++cur) {
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            iter_value_t<It> tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (sift != begin && comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+            moved += cur - sift;
+        }
+        if (moved > PARTIAL_INSERTION_SORT_LIMIT) return false;
+    }
+    return true;
+}
+
+template <typename It, class Compare>
+void sort2(It a, It b, Compare& comp) {
+    if (comp(*b, *a)) detail::iter_swap(a, b);
+}
+
+template <typename It, class Compare>
+void sort3(It a, It b, It c, Compare& comp) {
+    detail::sort2(a, b, comp);
+    detail::sort2(b, c, comp);
+    detail::sort2(a, b, comp);
+}
+
+// Move the median of 3, or of 3 medians of 3 for large ranges, to `*begin`
+template <typename It, class Compare>
+void choose_pivot(It begin, It end, Compare& comp) {
+    ptrdiff_t size = end - begin;
+    ptrdiff_t half = size / 2;
+    if (size > NINTHER_THRESHOLD) {
+        detail::sort3(begin, begin + half, end - 1, comp);
+        detail::sort3(begin + 1, begin + (half - 1), end - 2, comp);
+        detail::sort3(begin + 2, begin + (half + 1), end - 3, comp);
+        detail::sort3(begin + (half - 1), begin + half, begin + (half + 1), comp);
+        detail::iter_swap(begin, begin + half);
+    } else {
+        detail::sort3(begin + half, begin, end - 1, comp);
+    }
+}
+
+template <typename It, class Compare>
+void sift_down(It first, ptrdiff_t hole, ptrdiff_t len, iter_value_t<It> value, Compare& comp) {
+    ptrdiff_t child;
+    while ((child = 2 * hole + 1) < len) {
+        if (child + 1 < len && comp(first[child], first[child + 1])) ++child;
+        if (!comp(value, first[child])) break;
+        first[hole] = std::move(first[child]);
+        hole = child;
+    }
+    first[hole] = std::move(value);
+}
+
+template <typename It, class Compare>
+void make_heap(It first, It last, Compare& comp) {
+    ptrdiff_t len = last - first;
+    for (ptrdiff_t i = len / 2; i-- > 0;) {
+        detail::sift_down(first, i, len, std::move(first[i]), comp);
+    }
+}
+
+// Sort a heap built by `make_heap`
+template <typename It, class Compare>
+void sort_heap(It first, It last, Compare& comp) {
+    for (ptrdiff_t end = last - first; end-- > 1;) {
+        iter_value_t<It> value = std::move(first[end]);
+        first[end] = std::move(first[0]);
+        detail::sift_down(first, 0, end, std::move(value), comp);
+    }
+}
+
+template <typename It, class Compare>
+void heap_sort(It first, It last, Compare& comp) {
+    detail::make_heap(first, last, comp);
+    detail::sort_heap(first, last, comp);
+}
+
+// Sort the smallest elements of [ `first`, `last` ) into [ `first`, `middle` ) by keeping them in a heap while
+// scanning the rest. Most elements are rejected by a single comparison against the heap's top
+template <typename It, class Compare>
+void heap_select(It first, It middle, It last, Compare& comp) {
+    detail::make_heap(first, middle, comp);
+    ptrdiff_t k = middle - first;
+    for (It it = middle; it != last; ++it) {
+        if (comp(*it, *first)) {
+            iter_value_t<It> value = std::move(*it);
+            *it = std::move(*first);
+            detail::sift_down(first, 0, k, std::move(value), comp);
+        }
+    }
+    detail::sort_heap(first, middle, comp);
+}
+
+// Partition around the pivot `*begin`, with elements equal to it going right
+//
+// Returns the pivot's final position and whether the range was already partitioned
+template <typename It, class Compare>
+std::pair<It, bool> partition_right(It begin, It end, Compare& comp) {
+    iter_value_t<It> pivot(std::move(*begin));
+    It first = begin;
+    It last = end;
+
+    // The median of 3 guarantees an element not less than the pivot on the right, unless it was the first
+    while (comp(*++first, pivot)) {}
+    if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot)) {}
+    } else {
+        while (!comp(*--last, pivot)) {}
+    }
+
+    bool already_partitioned = first >= last;
+    while (first < last) {
+        detail::iter_swap(first, last);
+        while (comp(*++first, pivot)) {}
+        while (!comp(*--last, pivot)) {}
+    }
+
+    It pivot_pos = first - 1;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return { pivot_pos, already_partitioned };
+}
+
+// Swap `num` elements at the offsets from `first` and back from `last`. A cyclic permutation takes one move per
+// element instead of three when the two sides aren't balanced
+template <typename It>
+void swap_offsets(It first, It last, const unsigned char* offsets_l, const unsigned char* offsets_r, size_t num,
+                  bool use_swaps) {
+    if (use_swaps) {
+        for (size_t i = 0; i < num; ++i) detail::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+    } else if (num > 0) {
+        It l = first + offsets_l[0];
+        It r = last - offsets_r[0];
+        iter_value_t<It> tmp(std::move(*l));
+        *l = std::move(*r);
+        for (size_t i = 1; i < num; ++i) {
+            l = first + offsets_l[i];
+            *r = std::move(*l);
+            r = last - offsets_r[i];
+            *l = std::move(*r);
+        }
+        *r = std::move(tmp);
+    }
+}
+
+// `partition_right` for cheap comparisons, in the style of BlockQuicksort (Edelkamp and Weiss)
+//
+// Blocks of 64 elements from each end are compared first, recording the offsets of misplaced elements with an
+// unconditional store and a counter increment instead of a branch, then pairs of offsets are swapped
+template <typename It, class Compare>
+std::pair<It, bool> partition_right_branchless(It begin, It end, Compare& comp) {
+    iter_value_t<It> pivot(std::move(*begin));
+    It first = begin;
+    It last = end;
+
+    while (comp(*++first, pivot)) {}
+    if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot)) {}
+    } else {
+        while (!comp(*--last, pivot)) {}
+    }
+
+    bool already_partitioned = first >= last;
+    if (!already_partitioned) {
+        detail::iter_swap(first, last);
+        ++first;
+
+        alignas(64) unsigned char offsets_l[PARTITION_BLOCK];
+        alignas(64) unsigned char offsets_r[PARTITION_BLOCK];
+        It offsets_l_base = first;
+        It offsets_r_base = last;
+        size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+        while (first < last) {
+            // Fill whichever offset buffers are empty, splitting the remaining elements if both are
+            size_t num_unknown = size_t(last - first);
+            size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+            size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+            if (left_split > PARTITION_BLOCK) left_split = PARTITION_BLOCK;
+            if (right_split > PARTITION_BLOCK) right_split = PARTITION_BLOCK;
+
+            for (size_t i = 0; i < left_split; ++i, ++first) {
+                offsets_l[num_l] = static_cast<unsigned char>(i);
+                num_l += !comp(*first, pivot);
+            }
+            for (size_t i = 0; i < right_split;) {
+                offsets_r[num_r] = static_cast<unsigned char>(++i);
+                num_r += comp(*--last, pivot);
+            }
+
+            size_t num = num_l < num_r ? num_l : num_r;
+            detail::swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r, num,
+                         num_l == num_r);
+            num_l -= num;
+            num_r -= num;
+            start_l += num;
+            start_r += num;
+
+            if (num_l == 0) {
+                start_l = 0;
+                offsets_l_base = first;
+            }
+            if (num_r == 0) {
+                start_r = 0;
+                offsets_r_base = last;
+            }
+        }
+
+        // One side may have misplaced elements left, which go to the boundary
+        if (num_l) {
+            while (num_l--) detail::iter_swap(offsets_l_base + offsets_l[start_l + num_l], --last);
+            first = last;
+        }
+        if (num_r) {
+            while (num_r--) {
+                detail::iter_swap(offsets_r_base - offsets_r[start_r + num_r], first);
+                ++first;
+            }
+            last = first;
+        }
+    }
+
+    It pivot_pos = first - 1;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return { pivot_pos, already_partitioned };
+}
+
+// Partition around the pivot `*begin`, with elements equal to it going left. Returns the pivot's final position
+//
+// Used when the pivot equals the element before the range, so everything that lands left equals the pivot
+template <typename It, class Compare>
+It partition_left(It begin, It end, Compare& comp) {
+    iter_value_t<It> pivot(std::move(*begin));
+    It first = begin;
+    It last = end;
+
+    while (comp(pivot, *--last)) {}
+    if (last + 1 == end) {
+        while (first < last && !comp(pivot, *++first)) {}
+    } else {
+        while (!comp(pivot, *++first)) {}
+    }
+
+    while (first < last) {
+        detail::iter_swap(first, last);
+        while (comp(pivot, *--last)) {}
+        while (!comp(pivot, *++first)) {}
+    }
+
+    It pivot_pos = last;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return pivot_pos;
+}
+
+template <bool Branchless, typename It, class Compare>
+std::pair<It, bool> partition_pivot(It begin, It end, Compare& comp) {
+    if constexpr (Branchless) {
+        return detail::partition_right_branchless(begin, end, comp);
+    } else {
+        return detail::partition_right(begin, end, comp);
+    }
+}
+
+// Pattern-defeating quicksort (Peters, "Pattern-defeating quicksort")
+//
+// `bad_allowed` counts the highly unbalanced partitions left before switching to heap sort, and `leftmost` is false
+// when the element before `begin` is no greater than anything in the range
+template <bool Branchless, typename It, class Compare>
+void pdqsort_loop(It begin, It end, Compare& comp, int bad_allowed, bool leftmost = true) {
+    for (;;) {
+        ptrdiff_t size = end - begin;
+        if (size < INSERTION_SORT_THRESHOLD) {
+            if (leftmost) {
+                detail::insertion_sort(begin, end, comp);
+            } else {
+                detail::unguarded_insertion_sort(begin, end, comp);
+            }
+            return;
+        }
+
+        detail::choose_pivot(begin, end, comp);
+
+        // A pivot equal to the previous one starts a run of equal elements, which needs no further sorting
+        if (!leftmost && !comp(*(begin - 1), *begin)) {
+            begin = detail::partition_left(begin, end, comp) + 1;
+            continue;
+        }
+
+        auto [pivot_pos, already_partitioned] = detail::partition_pivot<Branchless>(begin, end, comp);
+        ptrdiff_t l_size = pivot_pos - begin;
+        ptrdiff_t r_size = end - (pivot_pos + 1);
+
+        if (l_size < size / 8 || r_size < size / 8) {
+            if (--bad_allowed == 0) {
+                detail::heap_sort(begin, end, comp);
+                return;
+            }
+
+            // Break up patterns that defeat the median of 3 by shuffling a few elements of each side
+            if (l_size >= INSERTION_SORT_THRESHOLD) {
+                detail::iter_swap(begin, begin + l_size / 4);
+                detail::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                if (l_size > NINTHER_THRESHOLD) {
+                    detail::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+                    detail::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+                    detail::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    detail::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+            if (r_size >= INSERTION_SORT_THRESHOLD) {
+                detail::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                detail::iter_swap(end - 1, end - r_size / 4);
+                if (r_size > NINTHER_THRESHOLD) {
+                    detail::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    detail::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    detail::iter_swap(end - 2, end - (1 + r_size / 4));
+                    detail::iter_swap(end - 3, end - (2 + r_size / 4));
+                }
+            }
+        } else if (already_partitioned && detail::partial_insertion_sort(begin, pivot_pos, comp)
+                   && detail::partial_insertion_sort(pivot_pos + 1, end, comp)) {
+            // A partition that swapped nothing suggests sorted input, which a bounded insertion sort confirms
+            return;
+        }
+
+        // Recurse into the left side and loop on the right
+        detail::pdqsort_loop<Branchless>(begin, pivot_pos, comp, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+template <typename It>
+void reverse(It first, It last) {
+    while (first < last) detail::iter_swap(first++, --last);
+}
+
+// Exchange [ `first`, `middle` ) and [ `middle`, `last` ) by three reversals
+template <typename It>
+void rotate(It first, It middle, It last) {
+    detail::reverse(first, middle);
+    detail::reverse(middle, last);
+    detail::reverse(first, last);
+}
+
+// Merge sorted [ `first`, `middle` ) and [ `middle`, `last` ) by moving the left run into `buffer`
+template <typename It, class Compare>
+void merge_with_buffer(It first, It middle, It last, vector<iter_value_t<It>>& buffer, Compare& comp) {
+    buffer.clear();
+    for (It it = first; it != middle; ++it) buffer.push_back(std::move(*it));
+
+    size_t i = 0;
+    It out = first;
+    while (i < buffer.size() && middle != last) {
+        if (comp(*middle, buffer[i])) {
+            *out++ = std::move(*middle++);
+        } else {
+            *out++ = std::move(buffer[i++]);
+        }
+    }
+    while (i < buffer.size()) *out++ = std::move(buffer[i++]);
+}
+
+// Merge sorted [ `first`, `middle` ) and [ `middle`, `last` ) in place, by splitting around the median of the
+// longer run and rotating
+template <typename It, class Compare>
+void merge_in_place(It first, It middle, It last, Compare& comp) {
+    ptrdiff_t left = middle - first;
+    ptrdiff_t right = last - middle;
+    if (!left || !right) return;
+    if (left + right == 2) {
+        if (comp(*middle, *first)) detail::iter_swap(first, middle);
+        return;
+    }
+
+    It cut_l = first;
+    It cut_r = middle;
+    if (left > right) {
+        cut_l = first + left / 2;
+        // First element of the right run not less than `*cut_l`
+        for (ptrdiff_t count = right; count > 0;) {
+            ptrdiff_t step = count / 2;
+            if (comp(cut_r[step], *cut_l)) {
+                cut_r += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+    } else {
+        cut_r = middle + right / 2;
+        // First element of the left run greater than `*cut_r`
+        for (ptrdiff_t count = left; count > 0;) {
+            ptrdiff_t step = count / 2;
+            if (!comp(*cut_r, cut_l[step])) {
+                cut_l += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+    }
+
+    detail::rotate(cut_l, middle, cut_r);
+    It new_middle = cut_l + (cut_r - middle);
+    detail::merge_in_place(first, cut_l, new_middle, comp);
+    detail::merge_in_place(new_middle, cut_r, last, comp);
+}
+
+// Top-down merge sort. Runs already in order are not merged, and without a buffer the merges are done in place
+template <typename It, class Compare>
+void merge_sort(It first, It last, vector<iter_value_t<It>>& buffer, bool buffered, Compare& comp) {
+    ptrdiff_t size = last - first;
+    if (size <= STABLE_RUN) {
+        detail::insertion_sort(first, last, comp);
+        return;
+    }
+
+    It middle = first + size / 2;
+    detail::merge_sort(first, middle, buffer, buffered, comp);
+    detail::merge_sort(middle, last, buffer, buffered, comp);
+    if (!comp(*middle, *(middle - 1))) return;
+
+    if (buffered) {
+        detail::merge_with_buffer(first, middle, last, buffer, comp);
+    } else {
+        detail::merge_in_place(first, middle, last, comp);
+    }
+}
+
+}   // namespace detail
+
+// Check if [ `first`, `last` ) is sorted by `comp`
+template <typename It, class Compare = std::less<>>
+requires sortable_iterator<It>
+bool is_sorted(It first, It last, Compare comp = Compare()) {
+    if (first == last) return true;
+    for (It next = first + 1; next != last; ++first, ++next) {
+        if (comp(*next, *first)) return false;
+    }
+    return true;
+}
+
+// Sort [ `first`, `last` ) by `comp`, not preserving the order of equal elements
+//
+// Pattern-defeating quicksort: median of 3 pivots, insertion sort for small ranges, detection of already sorted
+// runs and runs of equal elements, and heap sort as the worst case bound. Arithmetic keys under `std::less` or
+// `std::greater` partition with branchless block comparisons
+template <typename It, class Compare = std::less<>>
+requires sortable_iterator<It>
+void sort(It first, It last, Compare comp = Compare()) {
+    if (last - first < 2) return;
+    constexpr bool branchless = detail::use_branchless_partition<detail::iter_value_t<It>, Compare>;
+    detail::pdqsort_loop<branchless>(first, last, comp, detail::floor_log2(last - first));
+}
+
+// Sort [ `first`, `last` ) by `comp`, preserving the order of equal elements
+//
+// Merge sort over insertion-sorted runs of 32, skipping merges of runs already in order. Merges move the left run
+// into a scratch buffer of half the range; if that can't be allocated they rotate in place instead
+template <typename It, class Compare = std::less<>>
+requires sortable_iterator<It>
+void stable_sort(It first, It last, Compare comp = Compare()) {
+    ptrdiff_t size = last - first;
+    if (size < 2) return;
+
+    vector<detail::iter_value_t<It>> buffer;
+    bool buffered = true;
+    try {
+        buffer.reserve(size_t(size / 2 + 1));
+    } catch (const std::bad_alloc&) {
+        buffered = false;
+    }
+    detail::merge_sort(first, last, buffer, buffered, comp);
+}
+
+// Rearrange [ `first`, `last` ) so `*nth` is the element that would be there if sorted, with no greater element
+// before it and no smaller one after
+//
+// Quickselect with the same pivots and partitions as `sort`, falling back to heap sort after too many unbalanced
+// partitions
+template <typename It, class Compare = std::less<>>
+requires sortable_iterator<It>
+void nth_element(It first, It nth, It last, Compare comp = Compare()) {
+    if (nth == last) return;
+    constexpr bool branchless = detail::use_branchless_partition<detail::iter_value_t<It>, Compare>;
+
+    It begin = first;
+    int bad_allowed = last - first > 1 ? detail::floor_log2(last - first) : 0;
+    while (last - first >= detail::INSERTION_SORT_THRESHOLD) {
+        ptrdiff_t size = last - first;
+        detail::choose_pivot(first, last, comp);
+
+        // Elements equal to a previous pivot can all be placed at once
+        if (first != begin && !comp(*(first - 1), *first)) {
+            It pivot_pos = detail::partition_left(first, last, comp);
+            if (nth <= pivot_pos) return;
+            first = pivot_pos + 1;
+            continue;
+        }
+
+        It pivot_pos = detail::partition_pivot<branchless>(first, last, comp).first;
+        if (pivot_pos == nth) return;
+
+        ptrdiff_t l_size = pivot_pos - first;
+        if ((l_size < size / 8 || size - l_size - 1 < size / 8) && --bad_allowed <= 0) {
+            detail::heap_sort(first, last, comp);
+            return;
+        }
+
+        if (nth < pivot_pos) {
+            last = pivot_pos;
+        } else {
+            first = pivot_pos + 1;
+        }
+    }
+    detail::insertion_sort(first, last, comp);
+}
+
+// Sort the smallest `middle - first` elements of [ `first`, `last` ) into [ `first`, `middle` ), leaving the rest
+// in unspecified order
+//
+// Small prefixes, as in top-k extraction, are selected with a heap; larger ones with `nth_element` before sorting
+// only the front
+template <typename It, class Compare = std::less<>>
+requires sortable_iterator<It>
+void partial_sort(It first, It middle, It last, Compare comp = Compare()) {
+    if ((middle - first) * detail::HEAP_SELECT_RATIO <= last - first) {
+        if (first != middle) detail::heap_select(first, middle, last, comp);
+    } else if (middle == last) {
+        ndash::sort(first, last, comp);
+    } else {
+        ndash::nth_element(first, middle - 1, last, comp);
+        ndash::sort(first, middle - 1, comp);
+    }
+}
+
+}   // namespace ndash
+
+#endif   // ALGORITHM_H
@@ -0,0 +1,37 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// Runtime checks for optional instruction sets
+//
+// Kernels compiled with `__attribute__((target(...)))` call these before taking a SIMD path, so binaries built
+// for baseline x86-64 still use AVX2 and BMI2 where the machine has them. Each answer is computed once
+namespace ndash::cpu {
+
+#if defined(__x86_64__) || defined(__i386__)
+
+inline bool has_avx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+inline bool has_bmi2() {
+    static const bool supported = __builtin_cpu_supports("bmi2");
+    return supported;
+}
+
+inline bool has_popcnt() {
+    static const bool supported = __builtin_cpu_supports("popcnt");
+    return supported;
+}
+
+#else
+
+inline bool has_avx2() { return false; }
+inline bool has_bmi2() { return false; }
+inline bool has_popcnt() { return false; }
+
+#endif
+
+}   // namespace ndash::cpu
+
+#endif   // CPU_FEATURES_H
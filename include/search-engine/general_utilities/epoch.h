@@ -0,0 +1,229 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "vector.h"
+
+namespace ndash {
+
+// Epoch-based memory reclamation (Fraser, "Practical lock-freedom")
+//
+// Threads reading a shared lock-free structure hold an `epoch::guard`, which records the global epoch the thread
+// started in. A node unlinked from the structure is passed to `retire` instead of being freed, tagged with the epoch
+// it was retired in. The global epoch only advances once every thread holding a guard has seen the current one, so
+// two advances after a node's retirement no guard from before it can remain and the node is freed. Readers pay one
+// store and one fence per guard, and nothing per node they visit
+//
+// A thread that stays inside a guard holds back reclamation for everyone, so guards should cover single operations
+namespace epoch {
+
+namespace detail {
+
+// Retirements a thread collects before trying to advance the epoch and free what is safe
+constexpr const size_t RETIRE_BATCH = 64;
+
+struct retired {
+    void* ptr;
+    void (*deleter)(void*);
+    uint64_t epoch;
+};
+
+// Epoch state of one thread. Records are kept in a list and reused by later threads, never freed
+struct record {
+    // Epoch the thread is pinned in shifted left by 1, with the low bit set while pinned
+    alignas(64) std::atomic<uint64_t> state;
+    std::atomic<bool> in_use;
+    record* next;
+
+    // Private to the owning thread
+    unsigned nesting;
+    vector<retired> bag;
+    size_t bag_head;
+    size_t since_collect;
+
+    record()
+        : state(0)
+        , in_use(true)
+        , next(nullptr)
+        , nesting(0)
+        , bag()
+        , bag_head(0)
+        , since_collect(0) {}
+};
+
+// Free the retirements from `first` on whose epoch is at least 2 behind `epoch`. Returns the index of the first
+// still waiting; retirements are in epoch order
+inline size_t free_expired(vector<retired>& items, size_t first, uint64_t epoch) {
+    for (; first < items.size() && items[first].epoch + 2 <= epoch; ++first) {
+        items[first].deleter(items[first].ptr);
+    }
+    return first;
+}
+
+class domain {
+public:
+    domain()
+        : _epoch(0)
+        , _records(nullptr)
+        , _orphans_lock()
+        , _orphans() {}
+
+    // The domain is never destroyed: threads of pools that outlive static destruction, such as
+    // `default_thread_pool`, may still hold guards or release their records at exit. Retirements still waiting
+    // then are left for the process to reclaim
+    static domain& instance() {
+        static domain* global = new domain();
+        return *global;
+    }
+
+    uint64_t current() const { return _epoch.load(std::memory_order_relaxed); }
+
+    // Claim a free record, or add a new one
+    record* acquire() {
+        for (record* r = _records.load(std::memory_order_acquire); r; r = r->next) {
+            bool expected = false;
+            if (!r->in_use.load(std::memory_order_relaxed)
+                && r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return r;
+            }
+        }
+
+        record* r = new record();
+        r->next = _records.load(std::memory_order_relaxed);
+        while (!_records.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {}
+        return r;
+    }
+
+    // Give up `r` when its thread exits, handing its waiting retirements to the other threads
+    void release(record* r) {
+        if (r->bag_head < r->bag.size()) {
+            std::lock_guard<std::mutex> guard(_orphans_lock);
+            for (size_t i = r->bag_head; i < r->bag.size(); ++i) _orphans.push_back(r->bag[i]);
+        }
+        r->bag.clear();
+        r->bag_head = 0;
+        r->since_collect = 0;
+        r->state.store(0, std::memory_order_release);
+        r->in_use.store(false, std::memory_order_release);
+    }
+
+    // Advance the global epoch if every pinned thread has seen it. Returns the epoch afterwards
+    uint64_t try_advance() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t epoch = _epoch.load(std::memory_order_relaxed);
+        for (record* r = _records.load(std::memory_order_acquire); r; r = r->next) {
+            uint64_t state = r->state.load(std::memory_order_acquire);
+            if ((state & 1) && (state >> 1) != epoch) return epoch;
+        }
+        if (_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst)) return epoch + 1;
+        return epoch;
+    }
+
+    // Free the expired retirements of `r` and of exited threads. Returns the number freed
+    size_t collect(record& r) {
+        uint64_t epoch = try_advance();
+        size_t before = r.bag_head;
+        r.bag_head = free_expired(r.bag, r.bag_head, epoch);
+        size_t freed = r.bag_head - before;
+        if (r.bag_head == r.bag.size() || r.bag_head > r.bag.size() / 2) {
+            r.bag.erase(r.bag.begin(), r.bag.begin() + ptrdiff_t(r.bag_head));
+            r.bag_head = 0;
+        }
+        r.since_collect = 0;
+
+        std::unique_lock<std::mutex> lock(_orphans_lock, std::try_to_lock);
+        if (lock.owns_lock() && !_orphans.empty()) {
+            size_t expired = free_expired(_orphans, 0, epoch);
+            _orphans.erase(_orphans.begin(), _orphans.begin() + ptrdiff_t(expired));
+            freed += expired;
+        }
+        return freed;
+    }
+
+private:
+    std::atomic<uint64_t> _epoch;
+    std::atomic<record*> _records;
+    std::mutex _orphans_lock;
+    vector<retired> _orphans;
+};
+
+// Owns the calling thread's record from its first use until the thread exits
+struct thread_handle {
+    record* rec = nullptr;
+
+    record& get() {
+        if (!rec) rec = domain::instance().acquire();
+        return *rec;
+    }
+
+    ~thread_handle() {
+        if (rec) domain::instance().release(rec);
+    }
+};
+
+inline thread_local thread_handle current_thread;
+
+}   // namespace detail
+
+// Critical section in which nodes reachable from shared structures stay allocated
+//
+// Guards nest; only the outermost one pins the thread
+class guard {
+public:
+    // Pin the calling thread to the current epoch
+    guard()
+        : _record(detail::current_thread.get()) {
+        if (_record.nesting++) return;
+        uint64_t epoch = detail::domain::instance().current();
+        _record.state.store((epoch << 1) | 1, std::memory_order_relaxed);
+        // Publishes the pin before any shared pointer is read. A stale epoch only holds back the next advance
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    guard(const guard&) = delete;
+    guard& operator=(const guard&) = delete;
+
+    // Unpin the thread when the outermost guard ends
+    ~guard() {
+        if (!--_record.nesting) _record.state.store(0, std::memory_order_release);
+    }
+
+private:
+    detail::record& _record;
+};
+
+// Check if the calling thread holds a guard
+inline bool is_pinned() { return detail::current_thread.get().nesting != 0; }
+
+// Free `ptr` with `deleter(ptr)` once no thread can still be reading it
+//
+// `ptr` must already be unreachable for threads taking new guards. Every `RETIRE_BATCH` retirements the thread tries
+// to advance the epoch and frees its expired retirements
+inline void retire(void* ptr, void (*deleter)(void*)) {
+    detail::domain& global = detail::domain::instance();
+    detail::record& r = detail::current_thread.get();
+    // Orders the unlinking of `ptr` before reading the epoch it is tagged with
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    r.bag.push_back({ ptr, deleter, global.current() });
+    if (++r.since_collect >= detail::RETIRE_BATCH) global.collect(r);
+}
+
+// Delete `ptr` once no thread can still be reading it
+template <typename T>
+void retire(T* ptr) {
+    retire(static_cast<void*>(ptr), [](void* p) { delete static_cast<T*>(p); });
+}
+
+// Try to advance the epoch and free what the calling thread and exited threads retired, if it's safe. Returns the
+// number of retirements freed
+inline size_t flush() { return detail::domain::instance().collect(detail::current_thread.get()); }
+
+}   // namespace epoch
+
+}   // namespace ndash
+
+#endif   // EPOCH_H
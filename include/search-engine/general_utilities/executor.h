@@ -0,0 +1,251 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#include <unistd.h>
+
+#include "task.h"
+#include "thread_pool.h"
+#include "vector.h"
+
+namespace ndash {
+
+namespace detail {
+
+// Pool task resuming a suspended coroutine in its frame arena
+//
+// Embedded in the awaiter the coroutine is suspended on, which lives in the coroutine's frame, so handing the
+// coroutine back to the pool doesn't allocate
+struct resume_task : pool_task {
+    resume_task()
+        : pool_task { &run, nullptr }
+        , handle()
+        , arena(nullptr) {}
+
+    // Record the coroutine to resume and the arena it allocates frames from
+    void prepare(std::coroutine_handle<> h) {
+        handle = h;
+        arena = current_frame_arena;
+    }
+
+    // Resuming may finish the coroutine and free this task, so nothing of it is read afterwards
+    static void run(pool_task* base) {
+        resume_task* self = static_cast<resume_task*>(base);
+        resume_in(self->handle, self->arena);
+    }
+
+    std::coroutine_handle<> handle;
+    frame_arena* arena;
+};
+
+}   // namespace detail
+
+// Runs coroutine tasks on a `thread_pool`
+//
+// Tasks hop onto the pool by awaiting `schedule`, and are resumed there by the timer and file read awaitables, each
+// resumption carrying the frame arena of the coroutine that suspended. Resumptions are pool tasks embedded in the
+// awaiters, so a fan-out whose frames come from a `frame_arena` doesn't allocate on any hop. Timers are kept by one
+// timer thread per executor. File reads are blocking `pread` calls made on a pool worker, so concurrent reads from a
+// query's shards overlap as far as the pool has workers
+class executor {
+public:
+    using clock = std::chrono::steady_clock;
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructs an executor resuming tasks on `pool` and starts its timer thread
+    explicit executor(thread_pool& pool = default_thread_pool())
+        : _pool(pool)
+        , _lock()
+        , _changed()
+        , _timers()
+        , _stopping(false)
+        , _timer_thread(&executor::timer_main, this) {}
+
+    executor(const executor&) = delete;
+    executor& operator=(const executor&) = delete;
+
+    // Stops the timer thread, resuming tasks whose timers are still pending right away
+    ~executor() {
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _stopping = true;
+        }
+        _changed.notify_one();
+        _timer_thread.join();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Operations //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Pool the executor resumes tasks on
+    thread_pool& pool() { return _pool; }
+
+    // Awaitable resuming the awaiting task on a pool worker
+    auto schedule() {
+        struct awaiter : detail::resume_task {
+            explicit awaiter(executor& e)
+                : exec(e) {}
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) {
+                prepare(handle);
+                exec._pool.submit_intrusive(*this);
+            }
+            void await_resume() const noexcept {}
+
+            executor& exec;
+        };
+        return awaiter(*this);
+    }
+
+    // Awaitable resuming the awaiting task on a pool worker once `deadline` has passed
+    auto sleep_until(clock::time_point deadline) {
+        struct awaiter : detail::resume_task {
+            awaiter(executor& e, clock::time_point d)
+                : exec(e)
+                , deadline(d) {}
+
+            bool await_ready() const noexcept { return clock::now() >= deadline; }
+            void await_suspend(std::coroutine_handle<> handle) {
+                prepare(handle);
+                exec.add_timer(deadline, *this);
+            }
+            void await_resume() const noexcept {}
+
+            executor& exec;
+            clock::time_point deadline;
+        };
+        return awaiter(*this, deadline);
+    }
+
+    // Awaitable resuming the awaiting task on a pool worker once `delay` has passed
+    template <class Rep, class Period>
+    auto sleep_for(std::chrono::duration<Rep, Period> delay) {
+        return sleep_until(clock::now() + std::chrono::duration_cast<clock::duration>(delay));
+    }
+
+    // Awaitable reading up to `count` bytes at `offset` of file `fd` into `buffer` on a pool worker
+    //
+    // Resumes with the number of bytes read, fewer than `count` only at the end of the file, or throws
+    // `std::system_error` if the read fails
+    auto read(int fd, void* buffer, size_t count, uint64_t offset) {
+        struct awaiter : detail::resume_task {
+            awaiter(executor& e, int f, char* b, size_t c, uint64_t o)
+                : exec(e)
+                , fd(f)
+                , buffer(b)
+                , count(c)
+                , offset(o)
+                , done(0)
+                , error(0) {
+                invoke = &read_and_resume;
+            }
+
+            bool await_ready() const noexcept { return count == 0; }
+
+            void await_suspend(std::coroutine_handle<> handle) {
+                prepare(handle);
+                exec._pool.submit_intrusive(*this);
+            }
+
+            size_t await_resume() const {
+                if (error) throw std::system_error(error, std::generic_category(), "pread");
+                return done;
+            }
+
+            void read_all() {
+                while (done < count) {
+                    ssize_t n = ::pread(fd, buffer + done, count - done, off_t(offset + done));
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n < 0) {
+                        error = errno;
+                        return;
+                    }
+                    if (n == 0) return;
+                    done += size_t(n);
+                }
+            }
+
+            static void read_and_resume(detail::pool_task* base) {
+                static_cast<awaiter*>(base)->read_all();
+                run(base);
+            }
+
+            executor& exec;
+            int fd;
+            char* buffer;
+            size_t count;
+            uint64_t offset;
+            size_t done;
+            int error;
+        };
+        return awaiter(*this, fd, static_cast<char*>(buffer), count, offset);
+    }
+
+private:
+    struct timer {
+        clock::time_point deadline;
+        detail::resume_task* task;
+
+        // Orders the heap with the earliest deadline on top
+        friend bool operator<(const timer& a, const timer& b) { return a.deadline > b.deadline; }
+    };
+
+    void add_timer(clock::time_point deadline, detail::resume_task& task) {
+        bool earliest;
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _timers.push_back({ deadline, &task });
+            std::push_heap(_timers.data(), _timers.data() + _timers.size());
+            earliest = _timers.front().task == &task;
+        }
+        if (earliest) _changed.notify_one();
+    }
+
+    // Wait for the earliest timer and hand its task to the pool, until stopped
+    void timer_main() {
+        std::unique_lock<std::mutex> guard(_lock);
+        for (;;) {
+            if (_timers.empty()) {
+                if (_stopping) return;
+                _changed.wait(guard);
+                continue;
+            }
+            if (!_stopping && clock::now() < _timers.front().deadline) {
+                _changed.wait_until(guard, _timers.front().deadline);
+                continue;
+            }
+            std::pop_heap(_timers.data(), _timers.data() + _timers.size());
+            timer expired = _timers.back();
+            _timers.pop_back();
+            guard.unlock();
+            _pool.submit_intrusive(*expired.task);
+            guard.lock();
+        }
+    }
+
+    thread_pool& _pool;
+    std::mutex _lock;
+    std::condition_variable _changed;
+    vector<timer> _timers;
+    bool _stopping;
+    std::thread _timer_thread;
+};
+
+}   // namespace ndash
+
+#endif   // EXECUTOR_H
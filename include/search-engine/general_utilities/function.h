@@ -0,0 +1,314 @@
+#ifndef FUNCTION_H
+#define FUNCTION_H
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ndash {
+
+// Bytes of captures a `function` or `move_only_function` holds without allocating
+constexpr const size_t FUNCTION_INLINE_SIZE = 48;
+
+namespace detail {
+
+// Operations on the callable held by a function, one table per callable type
+//
+// A null `relocate` means the callable moves by copying the buffer's bytes, which holds for trivially copyable
+// callables and for heap-allocated ones, whose buffer is just a pointer. A null `destroy` means nothing needs to run
+template <class R, class... Args>
+struct function_vtable {
+    R (*invoke)(void* storage, Args&&... args);
+    void (*relocate)(void* to, void* from) noexcept;
+    void (*copy)(void* to, const void* from);
+    void (*destroy)(void* storage) noexcept;
+};
+
+template <class F, size_t InlineSize>
+constexpr bool stored_inline = sizeof(F) <= InlineSize && alignof(F) <= alignof(std::max_align_t)
+                            && std::is_nothrow_move_constructible_v<F>;
+
+template <class F, size_t InlineSize>
+F* stored_callable(void* storage) {
+    if constexpr (stored_inline<F, InlineSize>) {
+        return std::launder(static_cast<F*>(storage));
+    } else {
+        return *static_cast<F**>(storage);
+    }
+}
+
+template <class F, size_t InlineSize, bool Copyable, class R, class... Args>
+struct function_ops {
+    static R invoke(void* storage, Args&&... args) {
+        return std::invoke(*stored_callable<F, InlineSize>(storage), std::forward<Args>(args)...);
+    }
+
+    static void relocate(void* to, void* from) noexcept {
+        F* source = stored_callable<F, InlineSize>(from);
+        new (to) F(std::move(*source));
+        source->~F();
+    }
+
+    static void copy(void* to, const void* from) {
+        const F& source = *stored_callable<F, InlineSize>(const_cast<void*>(from));
+        if constexpr (stored_inline<F, InlineSize>) {
+            new (to) F(source);
+        } else {
+            *static_cast<F**>(to) = new F(source);
+        }
+    }
+
+    static void destroy(void* storage) noexcept {
+        if constexpr (stored_inline<F, InlineSize>) {
+            stored_callable<F, InlineSize>(storage)->~F();
+        } else {
+            delete stored_callable<F, InlineSize>(storage);
+        }
+    }
+
+    // Copying is only instantiated for `function`, so move-only callables can be held by `move_only_function`
+    static constexpr auto copier() {
+        using copy_type = void (*)(void*, const void*);
+        if constexpr (Copyable) {
+            return copy_type(&copy);
+        } else {
+            return copy_type(nullptr);
+        }
+    }
+
+    static constexpr function_vtable<R, Args...> table {
+        &invoke,
+        stored_inline<F, InlineSize> && !std::is_trivially_copyable_v<F> ? &relocate : nullptr,
+        copier(),
+        !stored_inline<F, InlineSize> || !std::is_trivially_destructible_v<F> ? &destroy : nullptr,
+    };
+};
+
+template <class R, class... Args>
+struct empty_function_ops {
+    [[noreturn]] static R invoke(void*, Args&&...) { throw std::bad_function_call(); }
+
+    static constexpr function_vtable<R, Args...> table { &invoke, nullptr, nullptr, nullptr };
+};
+
+// Storage and dispatch shared by `function` and `move_only_function`
+//
+// Callables that fit the buffer, are aligned for it and can't throw on move live inline; others are allocated once
+// and the buffer holds a pointer to them. Calls go through the vtable without checking for emptiness, an empty
+// function's table throwing instead
+template <bool Copyable, size_t InlineSize, class R, class... Args>
+class function_base {
+public:
+    using result_type = R;
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    function_base() noexcept
+        : _vtable(&empty_function_ops<R, Args...>::table) {}
+
+    template <class F>
+    explicit function_base(F&& callable) {
+        using D = std::decay_t<F>;
+        if constexpr (std::is_pointer_v<std::remove_reference_t<F>> || std::is_member_pointer_v<D>) {
+            if (!callable) {
+                _vtable = &empty_function_ops<R, Args...>::table;
+                return;
+            }
+        }
+        if constexpr (stored_inline<D, InlineSize>) {
+            new (_buffer) D(std::forward<F>(callable));
+        } else {
+            *reinterpret_cast<D**>(_buffer) = new D(std::forward<F>(callable));
+        }
+        _vtable = &function_ops<D, InlineSize, Copyable, R, Args...>::table;
+    }
+
+    function_base(const function_base& other)
+        : _vtable(other._vtable) {
+        if (_vtable->copy) {
+            _vtable->copy(_buffer, other._buffer);
+        } else {
+            std::memcpy(_buffer, other._buffer, InlineSize);
+        }
+    }
+
+    function_base(function_base&& other) noexcept
+        : _vtable(other._vtable) {
+        take(other);
+    }
+
+    ~function_base() { reset(); }
+
+    function_base& operator=(const function_base& other) {
+        if (&other != this) {
+            function_base copy(other);
+            reset();
+            _vtable = copy._vtable;
+            take(copy);
+        }
+        return *this;
+    }
+
+    function_base& operator=(function_base&& other) noexcept {
+        if (&other != this) {
+            reset();
+            _vtable = other._vtable;
+            take(other);
+        }
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Operations //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if a callable is held
+    explicit operator bool() const noexcept { return _vtable != &empty_function_ops<R, Args...>::table; }
+
+    // Invoke the held callable, or throw `std::bad_function_call` if there is none
+    R operator()(Args... args) const {
+        return _vtable->invoke(const_cast<unsigned char*>(_buffer), std::forward<Args>(args)...);
+    }
+
+    // Check if a callable `F` would be held without allocating
+    template <class F>
+    static constexpr bool fits_inline() {
+        return stored_inline<std::decay_t<F>, InlineSize>;
+    }
+
+    friend bool operator==(const function_base& f, std::nullptr_t) noexcept { return !f; }
+
+protected:
+    void swap_with(function_base& other) noexcept {
+        function_base tmp(std::move(other));
+        other._vtable = _vtable;
+        other.take(*this);
+        _vtable = tmp._vtable;
+        take(tmp);
+    }
+
+    void reset() noexcept {
+        if (_vtable->destroy) _vtable->destroy(_buffer);
+        _vtable = &empty_function_ops<R, Args...>::table;
+    }
+
+private:
+    // Move the callable of `other`, whose vtable `_vtable` already is, leaving `other` empty
+    void take(function_base& other) noexcept {
+        if (_vtable->relocate) {
+            _vtable->relocate(_buffer, other._buffer);
+        } else {
+            std::memcpy(_buffer, other._buffer, InlineSize);
+        }
+        other._vtable = &empty_function_ops<R, Args...>::table;
+    }
+
+    alignas(std::max_align_t) unsigned char _buffer[InlineSize];
+    const function_vtable<R, Args...>* _vtable;
+};
+
+}   // namespace detail
+
+template <class Signature, size_t InlineSize = FUNCTION_INLINE_SIZE>
+class function;
+
+// Copyable type-erased callable with `InlineSize` bytes of inline storage
+//
+// Unlike `std::function`, which allocates for captures larger than about two pointers, captures up to
+// `InlineSize` bytes are stored inline. Moving a function holding a trivially copyable or heap-allocated callable
+// copies bytes without an indirect call
+//
+// Meant for callbacks kept in containers and queues the caller owns. `thread_pool` doesn't use it: its task nodes
+// already hold callables by their own type, and coroutine resumptions go through tasks embedded in their awaiters
+template <class R, class... Args, size_t InlineSize>
+class function<R(Args...), InlineSize> : public detail::function_base<true, InlineSize, R, Args...> {
+    using base = detail::function_base<true, InlineSize, R, Args...>;
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructs an empty function
+    function() noexcept = default;
+
+    // Constructs an empty function
+    function(std::nullptr_t) noexcept {}
+
+    // Constructs a function holding `callable`
+    template <class F>
+    requires(!std::is_same_v<std::decay_t<F>, function> && std::is_copy_constructible_v<std::decay_t<F>>
+             && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    function(F&& callable)
+        : base(std::forward<F>(callable)) {}
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Drop the held callable
+    function& operator=(std::nullptr_t) noexcept {
+        this->reset();
+        return *this;
+    }
+
+    // Exchange the callables of two functions
+    void swap(function& other) noexcept { this->swap_with(other); }
+};
+
+template <class Signature, size_t InlineSize = FUNCTION_INLINE_SIZE>
+class move_only_function;
+
+// Type-erased callable with `InlineSize` bytes of inline storage that can hold move-only callables
+//
+// Suits tasks and callbacks that own their captures, such as buffers or promises
+template <class R, class... Args, size_t InlineSize>
+class move_only_function<R(Args...), InlineSize> : public detail::function_base<false, InlineSize, R, Args...> {
+    using base = detail::function_base<false, InlineSize, R, Args...>;
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructs an empty function
+    move_only_function() noexcept = default;
+
+    // Constructs an empty function
+    move_only_function(std::nullptr_t) noexcept {}
+
+    // Constructs a function holding `callable`
+    template <class F>
+    requires(!std::is_same_v<std::decay_t<F>, move_only_function>
+             && std::is_constructible_v<std::decay_t<F>, F&&> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    move_only_function(F&& callable)
+        : base(std::forward<F>(callable)) {}
+
+    move_only_function(move_only_function&&) noexcept = default;
+    move_only_function& operator=(move_only_function&&) noexcept = default;
+
+    move_only_function(const move_only_function&) = delete;
+    move_only_function& operator=(const move_only_function&) = delete;
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Drop the held callable
+    move_only_function& operator=(std::nullptr_t) noexcept {
+        this->reset();
+        return *this;
+    }
+
+    // Exchange the callables of two functions
+    void swap(move_only_function& other) noexcept { this->swap_with(other); }
+};
+
+}   // namespace ndash
+
+#endif   // FUNCTION_H
@@ -8,6 +8,16 @@ namespace ndash {
 constexpr const size_t FNV_OFFSET_BASIS = 14695981039346656037u;
 constexpr const size_t FNV_PRIME = 1099511628211u;
 
+// FNV-1a hash of the bytes in [ `s`, `s + len` )
+constexpr inline size_t fnv1a(const char* s, size_t len) {
+    size_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= s[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
 // Default hash function
 template <class Key>
 struct hash {
@@ -0,0 +1,284 @@
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "thread_pool.h"
+#include "vector.h"
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// NUMA topology, memory placement and node-pinned workers
+//
+// Built on the kernel's interfaces directly: nodes and their cpus come from sysfs, placement from the `mbind` and
+// `get_mempolicy` system calls and pinning from `sched_setaffinity`, so nothing links against libnuma. Where there
+// is no NUMA information, as on single-socket machines, in containers without sysfs or off Linux, the machine is
+// one node holding every cpu the process may run on, placement does nothing and pinning to the node pins to all of
+// them. Nodes are named by their kernel ids throughout
+namespace ndash::numa {
+
+namespace detail {
+
+// Nodes a placement mask can name
+constexpr const int MAX_NODES = 1024;
+
+struct node_info {
+    int id;
+    vector<int> cpus;
+};
+
+// Parse a sysfs list such as "0-3,8,10-11" into `out`, returning false if `text` isn't one
+inline bool parse_list(const char* text, vector<int>& out) {
+    out.clear();
+    const char* p = text;
+    while (*p && *p != '\n') {
+        if (*p < '0' || *p > '9') return false;
+        int first = 0;
+        while (*p >= '0' && *p <= '9') first = first * 10 + (*p++ - '0');
+        int last = first;
+        if (*p == '-') {
+            ++p;
+            if (*p < '0' || *p > '9') return false;
+            last = 0;
+            while (*p >= '0' && *p <= '9') last = last * 10 + (*p++ - '0');
+        }
+        if (last < first) return false;
+        for (int value = first; value <= last; ++value) out.push_back(value);
+        if (*p == ',') ++p;
+    }
+    return true;
+}
+
+inline bool read_list(const char* path, vector<int>& out) {
+    std::FILE* file = std::fopen(path, "r");
+    if (!file) return false;
+    char line[4096];
+    bool read = std::fgets(line, sizeof(line), file) != nullptr;
+    std::fclose(file);
+    return read && parse_list(line, out);
+}
+
+// Cpus the process may run on, or the first `hardware_concurrency` where that can't be asked
+inline vector<int> allowed_cpus() {
+    vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        unsigned count = std::thread::hardware_concurrency();
+        for (int cpu = 0; cpu < int(count ? count : 1); ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+// Online nodes that have cpus, or a single node 0 holding the allowed cpus
+inline vector<node_info> discover_nodes() {
+    vector<node_info> nodes;
+    vector<int> online;
+    if (read_list("/sys/devices/system/node/online", online)) {
+        for (int id : online) {
+            char path[64];
+            std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", id);
+            node_info node { id, vector<int>() };
+            if (id < MAX_NODES && read_list(path, node.cpus) && !node.cpus.empty()) nodes.push_back(std::move(node));
+        }
+    }
+    if (nodes.empty()) nodes.push_back({ 0, allowed_cpus() });
+    return nodes;
+}
+
+inline const vector<node_info>& topology() {
+    static const vector<node_info> nodes = discover_nodes();
+    return nodes;
+}
+
+inline const node_info* find_node(int node) {
+    for (const node_info& info : topology()) {
+        if (info.id == node) return &info;
+    }
+    return nullptr;
+}
+
+// Node that buffers allocated by the calling thread are placed on, or -1 to leave placement to the kernel
+inline thread_local int placement_node = -1;
+
+}   // namespace detail
+
+// Number of nodes with cpus, 1 where there's no NUMA information
+inline size_t node_count() { return detail::topology().size(); }
+
+// Id of the `index`th node, in increasing order
+inline int node_id(size_t index) { return detail::topology()[index].id; }
+
+// Cpus of `node`, or an empty list if there's no such node
+inline const vector<int>& cpus_of(int node) {
+    static const vector<int> none;
+    const detail::node_info* info = detail::find_node(node);
+    return info ? info->cpus : none;
+}
+
+// Node the calling thread is running on
+inline int current_node() {
+#if defined(__linux__) && defined(SYS_getcpu)
+    if (node_count() > 1) {
+        unsigned cpu = 0, node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) return int(node);
+    }
+#endif
+    return node_id(0);
+}
+
+// Node holding the page at `address`, or -1 if the page hasn't been touched or the kernel won't say
+inline int node_of(const void* address) {
+    if (node_count() == 1) return node_id(0);
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0UL, const_cast<void*>(address), MPOL_F_NODE | MPOL_F_ADDR) == 0) {
+        return node;
+    }
+#else
+    (void) address;
+#endif
+    return -1;
+}
+
+// Prefer `node` for the pages of `bytes` bytes at `address`, moving pages already touched there
+//
+// Pages come from other nodes once `node` runs out of memory. The range is widened to whole pages. Returns false if
+// there's no such node or the kernel refuses, and true without doing anything when there's only one node
+inline bool bind(void* address, size_t bytes, int node) {
+    if (!detail::find_node(node)) return false;
+    if (node_count() == 1 || bytes == 0) return true;
+#if defined(__linux__) && defined(SYS_mbind)
+    uintptr_t page = uintptr_t(sysconf(_SC_PAGESIZE));
+    uintptr_t start = reinterpret_cast<uintptr_t>(address) & ~(page - 1);
+    uintptr_t end = reinterpret_cast<uintptr_t>(address) + bytes;
+
+    constexpr const size_t WORD_BITS = 8 * sizeof(unsigned long);
+    unsigned long mask[detail::MAX_NODES / WORD_BITS] = {};
+    mask[size_t(node) / WORD_BITS] |= 1UL << (size_t(node) % WORD_BITS);
+    // The kernel reads one bit fewer than the `maxnode` it's given
+    unsigned long max_node = detail::MAX_NODES + 1;
+    return syscall(SYS_mbind, start, end - start, MPOL_PREFERRED, mask, max_node, MPOL_MF_MOVE) == 0;
+#else
+    (void) address;
+    return false;
+#endif
+}
+
+// Pin the calling thread to the cpus of `node`. Returns false if there's no such node or the cpus can't be used
+inline bool pin_current_thread_to_node(int node) {
+    const detail::node_info* info = detail::find_node(node);
+    if (!info) return false;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : info->cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+// Node that shard `shard` of `shard_count` is placed on
+//
+// Shards are dealt out in contiguous blocks, so every node holds the same number of shards give or take one
+inline int shard_node(size_t shard, size_t shard_count) {
+    return node_id(shard_count ? shard * node_count() / shard_count : 0);
+}
+
+// Node buffers allocated by the calling thread are placed on, or -1 if placement is left to the kernel
+inline int placement_node() { return detail::placement_node; }
+
+// Places the buffers of `numa_storage` vectors allocated by the calling thread on a node while in scope
+//
+// Scopes nest, the innermost one deciding. Without one, pages land on the node of the thread that first touches them
+class placement_scope {
+public:
+    explicit placement_scope(int node)
+        : _previous(detail::placement_node) {
+        detail::placement_node = node;
+    }
+
+    placement_scope(const placement_scope&) = delete;
+    placement_scope& operator=(const placement_scope&) = delete;
+
+    ~placement_scope() { detail::placement_node = _previous; }
+
+private:
+    int _previous;
+};
+
+// One `thread_pool` per node, each worker pinned to a cpu of its node
+//
+// Routing the lookups of a shard to the group of the node it's placed on keeps them off the interconnect, and what
+// the workers allocate lands on their own node. On a single node machine this is one pool over every allowed cpu
+class worker_groups {
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Starts `threads_per_node` workers on each node, or one per cpu of the node if 0
+    explicit worker_groups(unsigned threads_per_node = 0)
+        : _pools() {
+        _pools.reserve(node_count());
+        for (size_t i = 0; i < node_count(); ++i) {
+            const vector<int>& cpus = detail::topology()[i].cpus;
+            _pools.push_back(new thread_pool(threads_per_node ? threads_per_node : unsigned(cpus.size()), cpus));
+        }
+    }
+
+    worker_groups(const worker_groups&) = delete;
+    worker_groups& operator=(const worker_groups&) = delete;
+
+    // Runs every queued task, then stops the workers
+    ~worker_groups() {
+        for (thread_pool* pool : _pools) delete pool;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Operations //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Number of groups, one per node
+    size_t size() const { return _pools.size(); }
+
+    // Pool of the `index`th node
+    thread_pool& operator[](size_t index) { return *_pools[index]; }
+
+    // Pool of `node`, or of the first node if there's no such node
+    thread_pool& pool_for_node(int node) {
+        for (size_t i = 0; i < _pools.size(); ++i) {
+            if (node_id(i) == node) return *_pools[i];
+        }
+        return *_pools[0];
+    }
+
+    // Pool of the node shard `shard` of `shard_count` is placed on by `shard_node`
+    thread_pool& pool_for_shard(size_t shard, size_t shard_count) {
+        return pool_for_node(shard_node(shard, shard_count));
+    }
+
+private:
+    vector<thread_pool*> _pools;
+};
+
+}   // namespace ndash::numa
+
+#endif   // NUMA_H
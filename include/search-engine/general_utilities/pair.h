@@ -95,6 +95,13 @@ struct pair {
     /////////////////////////// Non-member functions //////////////////////////
     ///////////////////////////////////////////////////////////////////////////
 
+    friend bool operator==(const pair& x, const pair& y) { return x.first == y.first && x.second == y.second; }
+
+    // Lexicographic order, comparing `second` only when `first` is equivalent
+    friend bool operator<(const pair& x, const pair& y) {
+        return x.first < y.first || (!(y.first < x.first) && x.second < y.second);
+    }
+
     // Swap specialization
     friend void swap(pair& x, pair& y) { x.swap(y); }
 };
@@ -0,0 +1,301 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "algorithm.h"
+#include "iterator.h"
+#include "thread_pool.h"
+#include "vector.h"
+
+namespace ndash {
+
+namespace detail {
+
+// Run `fn(thread)` for each thread index below `num_threads`, index 0 on the calling thread and the rest as tasks of
+// the default pool, and wait for all of them. Indices may share a worker, so `fn` must not wait on another index
+template <class Function>
+void run_on_threads(unsigned num_threads, Function fn) {
+    if (num_threads <= 1) {
+        fn(0u);
+        return;
+    }
+
+    task_group group(default_thread_pool());
+    for (unsigned thread = 1; thread < num_threads; ++thread) {
+        group.spawn([&fn, thread]() { fn(thread); });
+    }
+    fn(0u);
+    group.wait();
+}
+
+}   // namespace detail
+
+// Parallel versions of the algorithms over random access ranges
+//
+// Each call splits its range into chunks of at least `grain` elements and runs them on up to `concurrency()`
+// threads of the default thread pool, which take chunks in turn so uneven work balances out. The calling thread
+// works on chunks too, and every call returns only once all of its chunks are done. A range of a single chunk runs
+// on the calling thread alone. Calls from inside pool tasks nest
+namespace par {
+
+// Smallest chunk by default, large enough that handing out a chunk costs little next to running it
+constexpr const size_t DEFAULT_GRAIN = 4096;
+
+namespace detail {
+
+// Chunks given to each thread when the range is large, so threads finishing early can take more
+constexpr const size_t CHUNKS_PER_THREAD = 8;
+
+inline std::atomic<unsigned>& concurrency_setting() {
+    static std::atomic<unsigned> setting(0);
+    return setting;
+}
+
+// Split [ 0, `n` ) into chunks of at least `grain` indices
+struct chunking {
+    size_t n;
+    size_t size;
+    size_t count;
+
+    chunking(size_t n, size_t grain, unsigned num_threads)
+        : n(n)
+        , size(0)
+        , count(0) {
+        size_t even = (n + num_threads * CHUNKS_PER_THREAD - 1) / (num_threads * CHUNKS_PER_THREAD);
+        size = even > grain ? even : (grain ? grain : 1);
+        count = (n + size - 1) / size;
+    }
+
+    size_t begin(size_t chunk) const { return chunk * size; }
+    size_t end(size_t chunk) const { return chunk + 1 < count ? (chunk + 1) * size : n; }
+};
+
+// Run `fn(chunk, begin, end)` for every chunk of `chunks` across the threads
+template <class Function>
+void run_chunks(const chunking& chunks, unsigned num_threads, Function&& fn);
+
+}   // namespace detail
+
+// Threads the parallel algorithms use: the value of `set_concurrency`, or one per core
+inline unsigned concurrency() {
+    unsigned setting = detail::concurrency_setting().load(std::memory_order_relaxed);
+    if (setting) return setting;
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores ? cores : 1;
+}
+
+// Use `num_threads` threads in the parallel algorithms, or one per core if 0
+inline void set_concurrency(unsigned num_threads) {
+    detail::concurrency_setting().store(num_threads, std::memory_order_relaxed);
+}
+
+template <class Function>
+void detail::run_chunks(const chunking& chunks, unsigned num_threads, Function&& fn) {
+    if (chunks.count <= 1) {
+        if (chunks.count) fn(size_t(0), chunks.begin(0), chunks.end(0));
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    unsigned workers = chunks.count < num_threads ? unsigned(chunks.count) : num_threads;
+    ndash::detail::run_on_threads(workers, [&](unsigned) {
+        for (size_t chunk; (chunk = next.fetch_add(1, std::memory_order_relaxed)) < chunks.count;) {
+            fn(chunk, chunks.begin(chunk), chunks.end(chunk));
+        }
+    });
+}
+
+// Call `fn` on each element of [ `first`, `last` )
+template <typename It, class Function>
+requires sortable_iterator<It>
+void for_each(It first, It last, Function fn, size_t grain = DEFAULT_GRAIN) {
+    unsigned num_threads = concurrency();
+    detail::chunking chunks(size_t(last - first), grain, num_threads);
+    detail::run_chunks(chunks, num_threads, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) fn(first[ptrdiff_t(i)]);
+    });
+}
+
+// Store `fn(element)` for each element of [ `first`, `last` ) at the same position from `out`, which may be `first`.
+// Returns the end of the output
+template <typename It, typename OutIt, class Function>
+requires sortable_iterator<It> && sortable_iterator<OutIt>
+OutIt transform(It first, It last, OutIt out, Function fn, size_t grain = DEFAULT_GRAIN) {
+    unsigned num_threads = concurrency();
+    detail::chunking chunks(size_t(last - first), grain, num_threads);
+    detail::run_chunks(chunks, num_threads, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) out[ptrdiff_t(i)] = fn(first[ptrdiff_t(i)]);
+    });
+    return out + (last - first);
+}
+
+// Combine `init` and the elements of [ `first`, `last` ) with the associative `op`
+//
+// Each chunk is reduced on its own and the partial results combined in order, so `op` need not be commutative
+template <typename It, typename T, class BinaryOp = std::plus<>>
+requires sortable_iterator<It>
+T reduce(It first, It last, T init, BinaryOp op = BinaryOp(), size_t grain = DEFAULT_GRAIN) {
+    unsigned num_threads = concurrency();
+    detail::chunking chunks(size_t(last - first), grain, num_threads);
+    vector<T> partials(chunks.count);
+    detail::run_chunks(chunks, num_threads, [&](size_t chunk, size_t begin, size_t end) {
+        T partial = first[ptrdiff_t(begin)];
+        for (size_t i = begin + 1; i < end; ++i) partial = op(std::move(partial), first[ptrdiff_t(i)]);
+        partials[chunk] = std::move(partial);
+    });
+
+    for (size_t chunk = 0; chunk < chunks.count; ++chunk) init = op(std::move(init), std::move(partials[chunk]));
+    return init;
+}
+
+// Count the elements of [ `first`, `last` ) satisfying `pred`
+template <typename It, class Predicate>
+requires sortable_iterator<It>
+size_t count_if(It first, It last, Predicate pred, size_t grain = DEFAULT_GRAIN) {
+    unsigned num_threads = concurrency();
+    detail::chunking chunks(size_t(last - first), grain, num_threads);
+    vector<size_t> counts(chunks.count, 0);
+    detail::run_chunks(chunks, num_threads, [&](size_t chunk, size_t begin, size_t end) {
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i) count += bool(pred(first[ptrdiff_t(i)]));
+        counts[chunk] = count;
+    });
+
+    size_t total = 0;
+    for (size_t count : counts) total += count;
+    return total;
+}
+
+namespace detail {
+
+// Two passes over the chunks: the first reduces each chunk, then after the chunk totals are scanned in order, the
+// second scans each chunk starting from the total before it. With `Inclusive` false the output at `i` combines the
+// elements before `i` only, starting from `init`
+template <bool Inclusive, typename It, typename OutIt, typename T, class BinaryOp>
+OutIt scan(It first, It last, OutIt out, T init, bool has_init, BinaryOp& op, size_t grain) {
+    unsigned num_threads = concurrency();
+    chunking chunks(size_t(last - first), grain, num_threads);
+    vector<T> totals(chunks.count);
+    run_chunks(chunks, num_threads, [&](size_t chunk, size_t begin, size_t end) {
+        T total = first[ptrdiff_t(begin)];
+        for (size_t i = begin + 1; i < end; ++i) total = op(std::move(total), first[ptrdiff_t(i)]);
+        totals[chunk] = std::move(total);
+    });
+
+    // Turn the totals into the value each chunk starts from. Without an initial value the first chunk starts empty
+    T running = std::move(init);
+    for (size_t chunk = 0; chunk < chunks.count; ++chunk) {
+        T total = std::move(totals[chunk]);
+        if (!chunk && !has_init) {
+            running = std::move(total);
+            continue;
+        }
+        totals[chunk] = running;
+        running = op(std::move(running), std::move(total));
+    }
+
+    run_chunks(chunks, num_threads, [&](size_t chunk, size_t begin, size_t end) {
+        bool set = has_init || chunk;
+        T acc = set ? totals[chunk] : T();
+        for (size_t i = begin; i < end; ++i) {
+            // Read before writing, since `out` may be `first`
+            T value = first[ptrdiff_t(i)];
+            if constexpr (Inclusive) {
+                acc = set ? op(std::move(acc), std::move(value)) : std::move(value);
+                set = true;
+                out[ptrdiff_t(i)] = acc;
+            } else {
+                out[ptrdiff_t(i)] = acc;
+                acc = op(std::move(acc), std::move(value));
+            }
+        }
+    });
+    return out + (last - first);
+}
+
+}   // namespace detail
+
+// Store at each position from `out` the combination by `op` of the elements of [ `first`, `last` ) up to and
+// including that position. `out` may be `first`. Returns the end of the output
+template <typename It, typename OutIt, class BinaryOp = std::plus<>>
+requires sortable_iterator<It> && sortable_iterator<OutIt>
+OutIt inclusive_scan(It first, It last, OutIt out, BinaryOp op = BinaryOp(), size_t grain = DEFAULT_GRAIN) {
+    using T = ndash::detail::iter_value_t<It>;
+    return detail::scan<true>(first, last, out, T(), false, op, grain);
+}
+
+// Store at each position from `out` the combination by `op` of `init` and the elements of [ `first`, `last` )
+// before that position. `out` may be `first`. Returns the end of the output
+template <typename It, typename OutIt, typename T, class BinaryOp = std::plus<>>
+requires sortable_iterator<It> && sortable_iterator<OutIt>
+OutIt exclusive_scan(It first, It last, OutIt out, T init, BinaryOp op = BinaryOp(), size_t grain = DEFAULT_GRAIN) {
+    return detail::scan<false>(first, last, out, std::move(init), true, op, grain);
+}
+
+namespace detail {
+
+// Move the merge of sorted [ `a`, `a_end` ) and [ `b`, `b_end` ) to `out`, taking from the first run on ties
+template <typename T, class Compare>
+void merge_into(T* a, T* a_end, T* b, T* b_end, T* out, Compare& comp) {
+    while (a != a_end && b != b_end) *out++ = comp(*b, *a) ? std::move(*b++) : std::move(*a++);
+    while (a != a_end) *out++ = std::move(*a++);
+    while (b != b_end) *out++ = std::move(*b++);
+}
+
+}   // namespace detail
+
+// Sort [ `first`, `last` ) by `comp`, not preserving the order of equal elements
+//
+// Each thread sorts a run with `ndash::sort`, then rounds of merges pair up the runs through a scratch copy of the
+// range, each merge on its own thread. The last merge is sequential, so speedup levels off with many threads
+template <typename It, class Compare = std::less<>>
+requires contiguous_iterator<It>
+void sort(It first, It last, Compare comp = Compare(), size_t grain = DEFAULT_GRAIN) {
+    using T = ndash::detail::iter_value_t<It>;
+    size_t n = size_t(last - first);
+    unsigned num_threads = concurrency();
+    size_t runs = n / (grain ? grain : 1);
+    if (runs > num_threads) runs = num_threads;
+    if (runs < 2) {
+        ndash::sort(first, last, comp);
+        return;
+    }
+
+    T* data = ndash::to_address(first);
+    vector<size_t> bounds;
+    for (size_t run = 0; run <= runs; ++run) bounds.push_back(n * run / runs);
+    ndash::detail::run_on_threads(unsigned(runs), [&](unsigned run) {
+        ndash::sort(data + bounds[run], data + bounds[run + 1], comp);
+    });
+
+    vector<T> scratch(n);
+    T* src = data;
+    T* dst = scratch.data();
+    for (size_t width = 1; width < runs; width *= 2) {
+        size_t merges = (runs + 2 * width - 1) / (2 * width);
+        ndash::detail::run_on_threads(unsigned(merges), [&](unsigned merge) {
+            size_t lo = 2 * width * merge;
+            size_t mid = lo + width < runs ? lo + width : runs;
+            size_t hi = lo + 2 * width < runs ? lo + 2 * width : runs;
+            detail::merge_into(src + bounds[lo], src + bounds[mid], src + bounds[mid], src + bounds[hi],
+                               dst + bounds[lo], comp);
+        });
+        ndash::swap(src, dst);
+    }
+
+    if (src != data) {
+        par::transform(src, src + n, data, [](T& value) { return std::move(value); }, grain);
+    }
+}
+
+}   // namespace par
+
+}   // namespace ndash
+
+#endif   // PARALLEL_H
@@ -0,0 +1,216 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "algorithm.h"
+#include "iterator.h"
+#include "parallel.h"
+#include "vector.h"
+
+namespace ndash {
+
+namespace detail {
+
+// Projection sorting unsigned integers by their own value
+struct identity_key {
+    template <typename T>
+    constexpr const T& operator()(const T& value) const {
+        return value;
+    }
+};
+
+template <class Key, typename T>
+using radix_key_t = std::remove_cvref_t<std::invoke_result_t<Key&, const T&>>;
+
+// Ranges below this are insertion sorted
+constexpr const size_t RADIX_SMALL = 64;
+// Ranges from this size sort 32 and 64-bit keys with 11-bit digits, saving a pass at the cost of histograms too
+// large to pay off on fewer elements
+constexpr const size_t RADIX_WIDE_MIN = size_t(1) << 16;
+// Elements ahead whose destination is prefetched during a scatter
+constexpr const size_t RADIX_PREFETCH = 16;
+// Ranges below this are not split across threads
+constexpr const size_t RADIX_PARALLEL_MIN = size_t(1) << 18;
+
+// Sort `n` elements of `data` by the low `key_bits` bits of their keys, scattering between `data` and `scratch`.
+// Returns whichever of the two holds the result
+//
+// One read of the keys fills the histograms of every pass. A pass whose digit is the same for every key would copy
+// the elements unchanged, so it is skipped
+template <unsigned DigitBits, typename T, class Key>
+T* lsd_radix_passes(T* data, T* scratch, size_t n, unsigned key_bits, Key& key) {
+    constexpr size_t RADIX = size_t(1) << DigitBits;
+    unsigned passes = (key_bits + DigitBits - 1) / DigitBits;
+    if (!passes || n < 2) return data;
+
+    auto digit = [&key](const T& value, unsigned shift) { return size_t(key(value) >> shift) & (RADIX - 1); };
+
+    vector<size_t> counts(passes * RADIX, 0);
+    for (size_t i = 0; i < n; ++i) {
+        auto k = key(data[i]);
+        for (unsigned pass = 0; pass < passes; ++pass) {
+            ++counts[pass * RADIX + (size_t(k >> (pass * DigitBits)) & (RADIX - 1))];
+        }
+    }
+
+    T* src = data;
+    T* dst = scratch;
+    for (unsigned pass = 0; pass < passes; ++pass) {
+        size_t* offsets = counts.data() + pass * RADIX;
+        unsigned shift = pass * DigitBits;
+        if (offsets[digit(src[0], shift)] == n) continue;
+
+        size_t sum = 0;
+        for (size_t d = 0; d < RADIX; ++d) {
+            size_t count = offsets[d];
+            offsets[d] = sum;
+            sum += count;
+        }
+
+        size_t i = 0;
+        for (; i + RADIX_PREFETCH < n; ++i) {
+            __builtin_prefetch(dst + offsets[digit(src[i + RADIX_PREFETCH], shift)], 1);
+            dst[offsets[digit(src[i], shift)]++] = std::move(src[i]);
+        }
+        for (; i < n; ++i) dst[offsets[digit(src[i], shift)]++] = std::move(src[i]);
+        ndash::swap(src, dst);
+    }
+    return src;
+}
+
+// Sort `n` elements of `data` by the low `key_bits` bits of their keys, leaving the result in `data`
+template <typename T, class Key>
+void lsd_radix_sort(T* data, T* scratch, size_t n, unsigned key_bits, Key& key) {
+    using K = radix_key_t<Key, T>;
+    if (n < RADIX_SMALL) {
+        auto comp = [&key](const T& a, const T& b) { return key(a) < key(b); };
+        detail::insertion_sort(data, data + n, comp);
+        return;
+    }
+
+    T* result = sizeof(K) >= 4 && n >= RADIX_WIDE_MIN ? lsd_radix_passes<11>(data, scratch, n, key_bits, key)
+                                                      : lsd_radix_passes<8>(data, scratch, n, key_bits, key);
+    if (result != data) {
+        for (size_t i = 0; i < n; ++i) data[i] = std::move(result[i]);
+    }
+}
+
+}   // namespace detail
+
+// Keys `radix_sort` can sort by: projections of the element to an unsigned integer
+template <class Key, typename T>
+concept radix_key = std::is_invocable_v<Key&, const T&> && std::is_unsigned_v<detail::radix_key_t<Key, T>>
+                 && !std::is_same_v<detail::radix_key_t<Key, T>, bool>;
+
+// Sort [ `first`, `last` ) by the unsigned integer `key(element)`, preserving the order of equal keys
+//
+// Least significant digit radix sort: 8-bit digits for small ranges and 16-bit keys, 11-bit digits otherwise, so
+// 32-bit keys take 3 passes and 64-bit keys 6. Digits every key shares, such as the high digits of small term ids,
+// cost no pass. Needs a scratch copy of the range. To sort by several fields, pack them into one key with the most
+// significant field highest, e.g. `uint64_t(term_id) << 32 | doc_id`
+template <typename It, class Key = detail::identity_key>
+requires contiguous_iterator<It> && radix_key<Key, detail::iter_value_t<It>>
+void radix_sort(It first, It last, Key key = Key()) {
+    using T = detail::iter_value_t<It>;
+    size_t n = size_t(last - first);
+    if (n < 2) return;
+
+    T* data = ndash::to_address(first);
+    vector<T> scratch(n < detail::RADIX_SMALL ? 0 : n);
+    detail::lsd_radix_sort(data, scratch.data(), n, sizeof(detail::radix_key_t<Key, T>) * 8, key);
+}
+
+// `radix_sort` split across `num_threads` threads, or `par::concurrency()` if 0
+//
+// The elements are partitioned on the 8 most significant bits of the largest key, each thread counting and
+// scattering its own slice, then threads take buckets in turn and radix sort them on the remaining bits. Keys
+// concentrated in a single bucket leave the other threads idle
+template <typename It, class Key = detail::identity_key>
+requires contiguous_iterator<It> && radix_key<Key, detail::iter_value_t<It>>
+void parallel_radix_sort(It first, It last, Key key = Key(), unsigned num_threads = 0) {
+    using T = detail::iter_value_t<It>;
+    constexpr size_t RADIX = 256;
+    size_t n = size_t(last - first);
+    if (!num_threads) num_threads = par::concurrency();
+    if (num_threads < 2 || n < detail::RADIX_PARALLEL_MIN) {
+        ndash::radix_sort(first, last, key);
+        return;
+    }
+
+    T* data = ndash::to_address(first);
+    vector<T> scratch(n);
+    size_t slice = (n + num_threads - 1) / num_threads;
+    auto slice_begin = [&](unsigned thread) { return thread * slice < n ? thread * slice : n; };
+
+    // The top digit sits below the highest bit any key sets
+    vector<uint64_t> maxima(num_threads, 0);
+    detail::run_on_threads(num_threads, [&](unsigned thread) {
+        uint64_t max = 0;
+        for (size_t i = slice_begin(thread); i < slice_begin(thread + 1); ++i) {
+            uint64_t k = uint64_t(key(data[i]));
+            max = k > max ? k : max;
+        }
+        maxima[thread] = max;
+    });
+    uint64_t max_key = 0;
+    for (uint64_t max : maxima) max_key = max > max_key ? max : max_key;
+    unsigned width = unsigned(std::bit_width(max_key));
+    unsigned shift = width > 8 ? width - 8 : 0;
+    auto bucket = [&](const T& value) { return size_t(uint64_t(key(value)) >> shift) & (RADIX - 1); };
+
+    // Each thread scatters its slice after the same bucket's elements from earlier slices, keeping the sort stable
+    vector<size_t> offsets(num_threads * RADIX, 0);
+    detail::run_on_threads(num_threads, [&](unsigned thread) {
+        size_t* counts = offsets.data() + thread * RADIX;
+        for (size_t i = slice_begin(thread); i < slice_begin(thread + 1); ++i) ++counts[bucket(data[i])];
+    });
+    vector<size_t> bucket_begin(RADIX + 1, 0);
+    size_t sum = 0;
+    for (size_t d = 0; d < RADIX; ++d) {
+        bucket_begin[d] = sum;
+        for (unsigned thread = 0; thread < num_threads; ++thread) {
+            size_t count = offsets[thread * RADIX + d];
+            offsets[thread * RADIX + d] = sum;
+            sum += count;
+        }
+    }
+    bucket_begin[RADIX] = n;
+    detail::run_on_threads(num_threads, [&](unsigned thread) {
+        size_t* next = offsets.data() + thread * RADIX;
+        for (size_t i = slice_begin(thread); i < slice_begin(thread + 1); ++i) {
+            scratch[next[bucket(data[i])]++] = std::move(data[i]);
+        }
+    });
+
+    // Sort each bucket in `scratch` using the same span of `data` as its scratch, so results may land in either
+    std::atomic<size_t> next_bucket(0);
+    detail::run_on_threads(num_threads, [&](unsigned) {
+        for (size_t d; (d = next_bucket.fetch_add(1, std::memory_order_relaxed)) < RADIX;) {
+            size_t begin = bucket_begin[d];
+            size_t count = bucket_begin[d + 1] - begin;
+            T* sorted = scratch.data() + begin;
+            if (count >= detail::RADIX_SMALL) {
+                using K = detail::radix_key_t<Key, T>;
+                sorted = sizeof(K) >= 4 && count >= detail::RADIX_WIDE_MIN
+                         ? detail::lsd_radix_passes<11>(sorted, data + begin, count, shift, key)
+                         : detail::lsd_radix_passes<8>(sorted, data + begin, count, shift, key);
+            } else {
+                auto comp = [&key](const T& a, const T& b) { return key(a) < key(b); };
+                detail::insertion_sort(sorted, sorted + count, comp);
+            }
+            if (sorted != data + begin) {
+                for (size_t i = 0; i < count; ++i) data[begin + i] = std::move(sorted[i]);
+            }
+        }
+    });
+}
+
+}   // namespace ndash
+
+#endif   // RADIX_SORT_H
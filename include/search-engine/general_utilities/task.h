@@ -0,0 +1,683 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "pair.h"
+#include "vector.h"
+
+namespace ndash {
+
+class frame_arena;
+
+template <typename T = void>
+class task;
+
+namespace detail {
+
+// Arena coroutine frames started on this thread are allocated from, if any
+inline thread_local frame_arena* current_frame_arena = nullptr;
+
+// Bytes in front of every frame recording the arena it came from, keeping the frame aligned
+constexpr const size_t FRAME_HEADER = alignof(std::max_align_t);
+
+void* allocate_frame(size_t size);
+void deallocate_frame(void* frame);
+
+}   // namespace detail
+
+// Bump allocator for the coroutine frames of one query
+//
+// While a `frame_arena::scope` is active on a thread, frames of tasks started there come from the arena instead of
+// the heap, and executors carry the arena along when they resume a task on another thread, so a query's whole
+// fan-out allocates from it. Freeing a frame only counts it; the memory is released with the arena. Allocation is
+// a fetch-add on the current chunk and is safe from any thread
+//
+// Destruction waits for frames still alive, such as those of tasks that lost a `when_any`
+class frame_arena {
+public:
+    static constexpr const size_t DEFAULT_CHUNK_SIZE = 16 * 1024;
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructs an arena allocating chunks of `chunk_size` bytes, the first one up front
+    explicit frame_arena(size_t chunk_size = DEFAULT_CHUNK_SIZE)
+        : _chunk_size(chunk_size)
+        , _current(nullptr)
+        , _live(0)
+        , _lock() {
+        _current.store(new_chunk(chunk_size, nullptr), std::memory_order_relaxed);
+    }
+
+    frame_arena(const frame_arena&) = delete;
+    frame_arena& operator=(const frame_arena&) = delete;
+
+    // Destructor
+    ~frame_arena() {
+        for (size_t live; (live = _live.load(std::memory_order_acquire));) _live.wait(live);
+        chunk* c = _current.load(std::memory_order_relaxed);
+        while (c) {
+            chunk* previous = c->previous;
+            ::operator delete(c, std::align_val_t(alignof(std::max_align_t)));
+            c = previous;
+        }
+    }
+
+    // Makes an arena the source of frames for tasks started on the calling thread until the scope ends
+    class scope {
+    public:
+        explicit scope(frame_arena& arena)
+            : _previous(detail::current_frame_arena) {
+            detail::current_frame_arena = &arena;
+        }
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+        ~scope() { detail::current_frame_arena = _previous; }
+
+    private:
+        frame_arena* _previous;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Number of frames allocated and not yet freed
+    size_t live_frames() const { return _live.load(std::memory_order_acquire); }
+
+    // Bytes handed out so far
+    size_t bytes_used() const {
+        std::lock_guard<std::mutex> guard(_lock);
+        size_t used = 0;
+        for (chunk* c = _current.load(std::memory_order_acquire); c; c = c->previous) {
+            size_t offset = c->used.load(std::memory_order_relaxed);
+            used += offset < c->capacity ? offset : c->filled;
+        }
+        return used;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Allocate `size` bytes aligned for any type
+    void* allocate(size_t size) {
+        size = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        _live.fetch_add(1, std::memory_order_relaxed);
+        for (;;) {
+            chunk* c = _current.load(std::memory_order_acquire);
+            size_t offset = c->used.fetch_add(size, std::memory_order_relaxed);
+            if (offset + size <= c->capacity) return c->data() + offset;
+
+            std::lock_guard<std::mutex> guard(_lock);
+            if (_current.load(std::memory_order_relaxed) != c) continue;
+            // The allocation that overflowed first records where the chunk's data ends
+            if (offset <= c->capacity) c->filled = offset;
+            size_t capacity = size > _chunk_size ? size : _chunk_size;
+            _current.store(new_chunk(capacity, c), std::memory_order_release);
+        }
+    }
+
+    // Reuse the arena for another query, keeping its newest chunk. No frame may be alive
+    void reset() {
+        chunk* c = _current.load(std::memory_order_relaxed);
+        chunk* previous = c->previous;
+        while (previous) {
+            chunk* next = previous->previous;
+            ::operator delete(previous, std::align_val_t(alignof(std::max_align_t)));
+            previous = next;
+        }
+        c->previous = nullptr;
+        c->filled = c->capacity;
+        c->used.store(0, std::memory_order_relaxed);
+    }
+
+    // Mark an allocation freed
+    void deallocate() {
+        if (_live.fetch_sub(1, std::memory_order_acq_rel) == 1) _live.notify_all();
+    }
+
+private:
+    // Chunk header, followed by its data
+    struct alignas(std::max_align_t) chunk {
+        chunk* previous;
+        size_t capacity;
+        size_t filled;
+        std::atomic<size_t> used;
+
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    static chunk* new_chunk(size_t capacity, chunk* previous) {
+        void* memory = ::operator new(sizeof(chunk) + capacity, std::align_val_t(alignof(std::max_align_t)));
+        chunk* c = new (memory) chunk;
+        c->previous = previous;
+        c->capacity = capacity;
+        c->filled = capacity;
+        c->used.store(0, std::memory_order_relaxed);
+        return c;
+    }
+
+    size_t _chunk_size;
+    std::atomic<chunk*> _current;
+    std::atomic<size_t> _live;
+    mutable std::mutex _lock;
+};
+
+namespace detail {
+
+inline void* allocate_frame(size_t size) {
+    frame_arena* arena = current_frame_arena;
+    void* raw = arena ? arena->allocate(FRAME_HEADER + size) : ::operator new(FRAME_HEADER + size);
+    char* memory = static_cast<char*>(raw);
+    *reinterpret_cast<frame_arena**>(memory) = arena;
+    return memory + FRAME_HEADER;
+}
+
+inline void deallocate_frame(void* frame) {
+    char* memory = static_cast<char*>(frame) - FRAME_HEADER;
+    frame_arena* arena = *reinterpret_cast<frame_arena**>(memory);
+    if (arena) {
+        arena->deallocate();
+    } else {
+        ::operator delete(memory);
+    }
+}
+
+// Run `handle` until it suspends with `arena` as the calling thread's frame arena
+inline void resume_in(std::coroutine_handle<> handle, frame_arena* arena) {
+    frame_arena* previous = current_frame_arena;
+    current_frame_arena = arena;
+    handle.resume();
+    current_frame_arena = previous;
+}
+
+// Promise members shared by every task: the awaiting coroutine and the exception the task ended with
+struct task_promise_base {
+    // Resumes the awaiting coroutine directly from the final suspend point, so chains of tasks completing one
+    // after another don't grow the stack
+    struct final_awaiter {
+        bool await_ready() noexcept { return false; }
+
+        template <class Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            std::coroutine_handle<> continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    final_awaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+
+    static void* operator new(size_t size) { return allocate_frame(size); }
+    static void operator delete(void* frame) { deallocate_frame(frame); }
+
+    std::coroutine_handle<> continuation = nullptr;
+    std::exception_ptr error = nullptr;
+};
+
+template <typename T>
+struct task_promise : task_promise_base {
+    task_promise() noexcept {}
+
+    ~task_promise() {
+        if (has_value) value.~T();
+    }
+
+    task<T> get_return_object() noexcept;
+
+    template <class U>
+    requires std::is_convertible_v<U&&, T>
+    void return_value(U&& result) {
+        new (&value) T(std::forward<U>(result));
+        has_value = true;
+    }
+
+    // Move the result out, or rethrow the exception the task ended with
+    T result() {
+        if (error) std::rethrow_exception(error);
+        return std::move(value);
+    }
+
+    union {
+        T value;
+    };
+    bool has_value = false;
+};
+
+template <>
+struct task_promise<void> : task_promise_base {
+    task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void result() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+}   // namespace detail
+
+// Lazily started coroutine producing a `T`
+//
+// A task runs when first awaited, on the awaiting thread, and resumes its awaiter as soon as it finishes, on
+// whichever thread it finished on. Awaiting a task yields its result or rethrows the exception it ended with; the
+// result can be taken once. Frames come from the calling thread's `frame_arena` if one is in scope
+template <typename T>
+class [[nodiscard]] task {
+public:
+    using promise_type = detail::task_promise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructs a task with no coroutine
+    task() noexcept
+        : _handle(nullptr) {}
+
+    explicit task(handle_type handle) noexcept
+        : _handle(handle) {}
+
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+
+    // Move constructor
+    task(task&& other) noexcept
+        : _handle(std::exchange(other._handle, nullptr)) {}
+
+    // Move assignment operator
+    task& operator=(task&& other) noexcept {
+        if (&other != this) {
+            if (_handle) _handle.destroy();
+            _handle = std::exchange(other._handle, nullptr);
+        }
+        return *this;
+    }
+
+    // Destroys the coroutine, which must not be running
+    ~task() {
+        if (_handle) _handle.destroy();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if the task holds a coroutine
+    explicit operator bool() const noexcept { return bool(_handle); }
+
+    // Check if the coroutine has finished
+    bool done() const noexcept { return _handle && _handle.done(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Operations //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Start the task and suspend the awaiter until it finishes, then take its result
+    //
+    // Awaiting an empty task throws `std::logic_error`
+    auto operator co_await() noexcept {
+        struct awaiter : ready_awaiter {
+            T await_resume() {
+                if (!this->handle) throw std::logic_error("awaiting an empty task");
+                return this->handle.promise().result();
+            }
+        };
+        return awaiter { { _handle } };
+    }
+
+    // Awaitable starting the task and resuming the awaiter when it finishes, leaving the result in the task
+    auto when_ready() noexcept { return ready_awaiter { _handle }; }
+
+    // Take the result of a finished task, or rethrow the exception it ended with. Throws `std::logic_error` if the
+    // task is empty
+    T result() {
+        if (!_handle) throw std::logic_error("result of an empty task");
+        return _handle.promise().result();
+    }
+
+private:
+    struct ready_awaiter {
+        handle_type handle;
+
+        bool await_ready() const noexcept { return !handle || handle.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    handle_type _handle;
+};
+
+namespace detail {
+
+template <typename T>
+task<T> task_promise<T>::get_return_object() noexcept {
+    return task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+inline task<void> task_promise<void>::get_return_object() noexcept {
+    return task<void>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+// Coroutine run by a combinator for one of its tasks, reporting to the combinator when the task finishes
+//
+// `Complete` is called from the final suspend point with the finished coroutine and returns the coroutine to
+// transfer to. A coroutine started detached destroys itself there
+template <class Complete>
+struct watcher {
+    struct promise_type {
+        struct final_awaiter {
+            bool await_ready() noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                return handle.promise().complete(handle);
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        watcher get_return_object() noexcept {
+            return watcher(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        final_awaiter final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        // The watched task keeps its own exception; awaiting its `when_ready` doesn't throw
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        static void* operator new(size_t size) { return allocate_frame(size); }
+        static void operator delete(void* frame) { deallocate_frame(frame); }
+
+        Complete complete;
+    };
+
+    explicit watcher(std::coroutine_handle<promise_type> h) noexcept
+        : handle(h) {}
+
+    watcher(watcher&& other) noexcept
+        : handle(std::exchange(other.handle, nullptr)) {}
+
+    watcher(const watcher&) = delete;
+    watcher& operator=(const watcher&) = delete;
+    watcher& operator=(watcher&&) = delete;
+
+    ~watcher() {
+        if (handle) handle.destroy();
+    }
+
+    // Run the coroutine until it first suspends
+    void start(const Complete& complete) {
+        handle.promise().complete = complete;
+        handle.resume();
+    }
+
+    // Run the coroutine until it first suspends, letting it destroy itself when it finishes
+    void start_detached(const Complete& complete) {
+        std::coroutine_handle<promise_type> h = std::exchange(handle, nullptr);
+        h.promise().complete = complete;
+        h.resume();
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Countdown of the tasks of a `when_all` plus one for the combinator itself, so that tasks finishing while the
+// others are still being started can't resume it early
+struct all_latch {
+    std::atomic<size_t> count;
+    std::coroutine_handle<> awaiting;
+};
+
+struct all_complete {
+    all_latch* latch = nullptr;
+
+    std::coroutine_handle<> operator()(std::coroutine_handle<>) const noexcept {
+        return latch->count.fetch_sub(1, std::memory_order_acq_rel) == 1 ? latch->awaiting : std::noop_coroutine();
+    }
+};
+
+template <typename T>
+watcher<all_complete> watch_all(task<T>& t) {
+    co_await t.when_ready();
+}
+
+// Awaitable starting every watcher and resuming the awaiter when the last task has finished
+struct all_awaiter {
+    vector<watcher<all_complete>>& watchers;
+    all_latch latch;
+
+    bool await_ready() const noexcept { return watchers.empty(); }
+
+    bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        latch.awaiting = awaiting;
+        for (watcher<all_complete>& w : watchers) w.start({ &latch });
+        return latch.count.fetch_sub(1, std::memory_order_acq_rel) > 1;
+    }
+
+    void await_resume() const noexcept {}
+};
+
+// Result type of a task in a `when_all` tuple
+template <typename T>
+using all_result_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+template <typename T>
+all_result_t<T> take_result(task<T>& t) {
+    if constexpr (std::is_void_v<T>) {
+        t.result();
+        return {};
+    } else {
+        return t.result();
+    }
+}
+
+// Shared by a `when_any` and its tasks. The awaiter is resumed by whichever of the first finished task and the end
+// of its own startup comes second; the state is freed by the last of the tasks and the awaiter to let go of it
+template <typename T>
+struct any_state {
+    explicit any_state(vector<task<T>>&& t)
+        : tasks(std::move(t))
+        , refs(tasks.size() + 1)
+        , gate(2)
+        , won(false)
+        , winner(0)
+        , awaiting(nullptr) {}
+
+    void release() {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+    }
+
+    vector<task<T>> tasks;
+    std::atomic<size_t> refs;
+    std::atomic<int> gate;
+    std::atomic<bool> won;
+    size_t winner;
+    std::coroutine_handle<> awaiting;
+};
+
+template <typename T>
+struct any_complete {
+    any_state<T>* state = nullptr;
+    size_t index = 0;
+
+    std::coroutine_handle<> operator()(std::coroutine_handle<> self) const noexcept {
+        any_state<T>* s = state;
+        std::coroutine_handle<> next = std::noop_coroutine();
+        if (!s->won.exchange(true, std::memory_order_acq_rel)) {
+            s->winner = index;
+            if (s->gate.fetch_sub(1, std::memory_order_acq_rel) == 1) next = s->awaiting;
+        }
+        self.destroy();
+        s->release();
+        return next;
+    }
+};
+
+template <typename T>
+watcher<any_complete<T>> watch_any(task<T>& t) {
+    co_await t.when_ready();
+}
+
+template <typename T>
+struct any_awaiter {
+    any_state<T>* state;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        state->awaiting = awaiting;
+        for (size_t i = 0; i < state->tasks.size(); ++i) {
+            watch_any(state->tasks[i]).start_detached({ state, i });
+        }
+        return state->gate.fetch_sub(1, std::memory_order_acq_rel) > 1;
+    }
+
+    void await_resume() const noexcept {}
+};
+
+// Flag a thread blocks on until a coroutine sets it
+struct sync_flag {
+    std::mutex lock;
+    std::condition_variable changed;
+    bool done = false;
+};
+
+struct sync_complete {
+    sync_flag* flag = nullptr;
+
+    std::coroutine_handle<> operator()(std::coroutine_handle<>) const noexcept {
+        std::lock_guard<std::mutex> guard(flag->lock);
+        flag->done = true;
+        flag->changed.notify_one();
+        return std::noop_coroutine();
+    }
+};
+
+template <typename T>
+watcher<sync_complete> watch_sync(task<T>& t) {
+    co_await t.when_ready();
+}
+
+}   // namespace detail
+
+// Run `t` and block the calling thread until it finishes. Returns its result or rethrows its exception
+//
+// Must not be called from a thread that `t` needs to make progress, such as the only worker of its pool
+template <typename T>
+T sync_wait(task<T> t) {
+    detail::sync_flag flag;
+    detail::watcher<detail::sync_complete> w = detail::watch_sync(t);
+    w.start({ &flag });
+    {
+        std::unique_lock<std::mutex> guard(flag.lock);
+        flag.changed.wait(guard, [&flag]() { return flag.done; });
+    }
+    return t.result();
+}
+
+// Task running every task in `tasks` and finishing with their results in order once all have finished
+//
+// Tasks are started one after another on the awaiting thread and run concurrently from their first suspension on.
+// If any throws, the exception of the first in order is rethrown after all have finished
+template <typename T>
+task<vector<T>> when_all(vector<task<T>> tasks) {
+    vector<detail::watcher<detail::all_complete>> watchers;
+    watchers.reserve(tasks.size());
+    for (task<T>& t : tasks) watchers.push_back(detail::watch_all(t));
+    co_await detail::all_awaiter { watchers, { tasks.size() + 1, nullptr } };
+
+    vector<T> results;
+    results.reserve(tasks.size());
+    for (task<T>& t : tasks) results.push_back(t.result());
+    co_return results;
+}
+
+// Task running every task in `tasks` and finishing once all have finished
+inline task<void> when_all(vector<task<void>> tasks) {
+    vector<detail::watcher<detail::all_complete>> watchers;
+    watchers.reserve(tasks.size());
+    for (task<void>& t : tasks) watchers.push_back(detail::watch_all(t));
+    co_await detail::all_awaiter { watchers, { tasks.size() + 1, nullptr } };
+    for (task<void>& t : tasks) t.result();
+}
+
+// Task running tasks of different types concurrently and finishing with a tuple of their results, `void` tasks
+// giving `std::monostate`
+template <typename... Ts>
+task<std::tuple<detail::all_result_t<Ts>...>> when_all(task<Ts>... tasks) {
+    vector<detail::watcher<detail::all_complete>> watchers;
+    watchers.reserve(sizeof...(Ts));
+    (watchers.push_back(detail::watch_all(tasks)), ...);
+    co_await detail::all_awaiter { watchers, { sizeof...(Ts) + 1, nullptr } };
+    co_return std::tuple<detail::all_result_t<Ts>...>(detail::take_result(tasks)...);
+}
+
+// Task running every task in `tasks` and finishing with the index and result of the first to finish, or rethrowing
+// its exception
+//
+// The other tasks can't be cancelled; they run to completion in the background and are then destroyed, so whatever
+// they reference must outlive them. Awaiting it throws `std::invalid_argument` if `tasks` is empty
+template <typename T>
+requires(!std::is_void_v<T>)
+task<ndash::pair<size_t, T>> when_any(vector<task<T>> tasks) {
+    if (tasks.empty()) throw std::invalid_argument("when_any of no tasks");
+    detail::any_state<T>* state = new detail::any_state<T>(std::move(tasks));
+    co_await detail::any_awaiter<T> { state };
+    size_t winner = state->winner;
+    try {
+        ndash::pair<size_t, T> result(winner, state->tasks[winner].result());
+        state->release();
+        co_return result;
+    } catch (...) {
+        state->release();
+        throw;
+    }
+}
+
+// Task running every task in `tasks` and finishing with the index of the first to finish, or rethrowing its
+// exception. Awaiting it throws `std::invalid_argument` if `tasks` is empty
+inline task<size_t> when_any(vector<task<void>> tasks) {
+    if (tasks.empty()) throw std::invalid_argument("when_any of no tasks");
+    detail::any_state<void>* state = new detail::any_state<void>(std::move(tasks));
+    co_await detail::any_awaiter<void> { state };
+    size_t winner = state->winner;
+    try {
+        state->tasks[winner].result();
+    } catch (...) {
+        state->release();
+        throw;
+    }
+    state->release();
+    co_return winner;
+}
+
+}   // namespace ndash
+
+#endif   // TASK_H
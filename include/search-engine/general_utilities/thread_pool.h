@@ -0,0 +1,491 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "vector.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ndash {
+
+// Pin the calling thread to `cpu`. Returns false where affinity isn't supported or the cpu can't be used
+inline bool pin_current_thread(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void) cpu;
+    return false;
+#endif
+}
+
+// Work-stealing deque of pointers (Chase and Lev, "Dynamic circular work-stealing deque", with the memory orderings
+// of Lê et al., "Correct and efficient work-stealing for weak memory models")
+//
+// The owning thread pushes and pops at the bottom without contention; any thread may steal from the top, racing
+// the owner only for the last element. The ring grows when full. Rings it outgrew are kept until destruction
+// since a thief may still be reading one
+template <typename T>
+class work_stealing_deque {
+    struct ring {
+        explicit ring(size_t capacity)
+            : mask(capacity - 1)
+            , slots(new std::atomic<T*>[capacity]) {}
+
+        size_t capacity() const { return mask + 1; }
+        T* get(int64_t index) const { return slots[size_t(index) & mask].load(std::memory_order_acquire); }
+        void put(int64_t index, T* value) { slots[size_t(index) & mask].store(value, std::memory_order_release); }
+
+        size_t mask;
+        std::unique_ptr<std::atomic<T*>[]> slots;
+    };
+
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructs an empty deque with room for `capacity` elements, rounded up to a power of 2
+    explicit work_stealing_deque(size_t capacity = 256)
+        : _top(0)
+        , _bottom(0)
+        , _ring(nullptr)
+        , _rings() {
+        size_t rounded = 2;
+        while (rounded < capacity) rounded *= 2;
+        _rings.push_back(new ring(rounded));
+        _ring.store(_rings.back(), std::memory_order_relaxed);
+    }
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    ~work_stealing_deque() {
+        for (ring* r : _rings) delete r;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if the deque looked empty at some point during the call
+    bool empty() const {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        int64_t top = _top.load(std::memory_order_relaxed);
+        return bottom <= top;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Add `value` at the bottom. Owner only
+    void push(T* value) {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        int64_t top = _top.load(std::memory_order_acquire);
+        ring* r = _ring.load(std::memory_order_relaxed);
+        if (bottom - top > int64_t(r->capacity()) - 1) r = grow(r, top, bottom);
+        r->put(bottom, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    // Remove the most recently pushed value, or nullptr if empty. Owner only
+    T* pop() {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        ring* r = _ring.load(std::memory_order_relaxed);
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = _top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T* value = r->get(bottom);
+        if (top == bottom) {
+            // Last element: whoever moves `_top` past it first gets it
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                value = nullptr;
+            }
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    // Remove the least recently pushed value, or nullptr if empty or another thread got it first. Any thread
+    T* steal() {
+        int64_t top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = _bottom.load(std::memory_order_acquire);
+        if (top >= bottom) return nullptr;
+
+        T* value = _ring.load(std::memory_order_acquire)->get(top);
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return value;
+    }
+
+private:
+    ring* grow(ring* old, int64_t top, int64_t bottom) {
+        ring* bigger = new ring(old->capacity() * 2);
+        for (int64_t i = top; i < bottom; ++i) bigger->put(i, old->get(i));
+        _rings.push_back(bigger);
+        _ring.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<int64_t> _top;
+    alignas(64) std::atomic<int64_t> _bottom;
+    std::atomic<ring*> _ring;
+    vector<ring*> _rings;
+};
+
+class thread_pool;
+class task_group;
+
+namespace detail {
+
+// Task queued in a pool. `invoke` runs it and destroys it if the pool owns it
+struct pool_task {
+    void (*invoke)(pool_task*);
+    task_group* group;
+};
+
+// Pool task holding its callable by its own type, in the same allocation as the queue node, so a task costs one
+// allocation and one indirect call whatever it captures
+template <class Function>
+struct pool_task_impl : pool_task {
+    explicit pool_task_impl(Function&& function, task_group* owner)
+        : pool_task { &call, owner }
+        , fn(std::move(function)) {}
+
+    static void call(pool_task* base) {
+        std::unique_ptr<pool_task_impl> self(static_cast<pool_task_impl*>(base));
+        self->fn();
+    }
+
+    Function fn;
+};
+
+template <class Function>
+pool_task* make_pool_task(Function&& fn, task_group* group) {
+    using F = std::decay_t<Function>;
+    return new pool_task_impl<F>(F(std::forward<Function>(fn)), group);
+}
+
+// Pool and worker index of the calling thread, if it is a pool worker
+struct worker_context {
+    thread_pool* pool;
+    unsigned index;
+};
+
+inline thread_local worker_context current_worker { nullptr, 0 };
+
+}   // namespace detail
+
+// Fixed set of worker threads running tasks, each worker with its own work-stealing deque
+//
+// Tasks spawned by a worker go to the bottom of its deque and it runs them newest first, keeping their data in
+// cache; idle workers steal the oldest task of a random victim, which in fork/join code is the largest piece of
+// work left. Tasks submitted from other threads go through a shared queue. Workers that find nothing park on a
+// condition variable instead of spinning, and every new task wakes one. Threads waiting on a `task_group` run
+// tasks while they wait, so nested fork/join can't deadlock the pool
+class thread_pool {
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Starts `num_threads` workers, or one per core if 0
+    explicit thread_pool(unsigned num_threads = 0)
+        : thread_pool(num_threads, vector<int>()) {}
+
+    // Starts `num_threads` workers, or one per core if 0, pinning worker `i` to cpu `cpus[i % cpus.size()]`
+    thread_pool(unsigned num_threads, const vector<int>& cpus)
+        : _deques()
+        , _threads()
+        , _cpus(cpus)
+        , _injected()
+        , _injected_head(0)
+        , _injected_lock()
+        , _park_lock()
+        , _park()
+        , _epoch(0)
+        , _sleepers(0)
+        , _stopping(false) {
+        if (!num_threads) num_threads = std::thread::hardware_concurrency();
+        if (!num_threads) num_threads = 1;
+
+        _deques.reserve(num_threads);
+        for (unsigned i = 0; i < num_threads; ++i) _deques.push_back(new work_stealing_deque<detail::pool_task>());
+        _threads.reserve(num_threads);
+        for (unsigned i = 0; i < num_threads; ++i) _threads.emplace_back(&thread_pool::worker_main, this, i);
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Runs every queued task, then stops the workers
+    ~thread_pool() {
+        _stopping.store(true, std::memory_order_seq_cst);
+        notify_all();
+        for (std::thread& thread : _threads) thread.join();
+        for (auto* deque : _deques) delete deque;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Number of worker threads
+    unsigned size() const { return unsigned(_threads.size()); }
+
+    // Index of the calling thread among this pool's workers, or -1 if it isn't one
+    int current_worker() const {
+        return detail::current_worker.pool == this ? int(detail::current_worker.index) : -1;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Run `fn()` on some worker, without a way to wait for it. An exception escaping `fn` terminates the program
+    template <class Function>
+    void submit(Function&& fn) {
+        enqueue(detail::make_pool_task(std::forward<Function>(fn), nullptr));
+    }
+
+    // Run `task` on some worker without allocating
+    //
+    // The caller owns `task`, which must stay alive until its `invoke` runs and must not free it there. Suits
+    // tasks embedded in longer-lived objects, such as the awaiters of suspended coroutines
+    void submit_intrusive(detail::pool_task& task) {
+        task.group = nullptr;
+        enqueue(&task);
+    }
+
+private:
+    friend class task_group;
+
+    void enqueue(detail::pool_task* task) {
+        int worker = current_worker();
+        if (worker >= 0) {
+            _deques[unsigned(worker)]->push(task);
+        } else {
+            std::lock_guard<std::mutex> guard(_injected_lock);
+            _injected.push_back(task);
+        }
+        notify_one();
+    }
+
+    // Next task for the calling thread: its own newest, then the oldest submitted, then one stolen
+    detail::pool_task* find_task() {
+        int worker = current_worker();
+        if (worker >= 0) {
+            if (detail::pool_task* task = _deques[unsigned(worker)]->pop()) return task;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(_injected_lock);
+            if (_injected_head < _injected.size()) {
+                detail::pool_task* task = _injected[_injected_head++];
+                if (_injected_head == _injected.size()) {
+                    _injected.clear();
+                    _injected_head = 0;
+                }
+                return task;
+            }
+        }
+
+        // Probe every other deque, starting from a random one
+        size_t count = _deques.size();
+        thread_local uint64_t state = uint64_t(reinterpret_cast<uintptr_t>(&state)) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        size_t start = size_t(state % count);
+        for (size_t i = 0; i < count; ++i) {
+            size_t victim = (start + i) % count;
+            if (int(victim) == worker) continue;
+            if (detail::pool_task* task = _deques[victim]->steal()) return task;
+        }
+        return nullptr;
+    }
+
+    inline void execute(detail::pool_task* task);
+
+    // Run tasks until `done()` holds, parking when there are none
+    template <class Predicate>
+    void run_until(Predicate done) {
+        while (!done()) {
+            if (detail::pool_task* task = find_task()) {
+                execute(task);
+                continue;
+            }
+
+            // A task added after reading the epoch bumps it, so checking again before parking can't miss one
+            uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+            if (done()) return;
+            if (detail::pool_task* task = find_task()) {
+                execute(task);
+                continue;
+            }
+            park(epoch);
+        }
+    }
+
+    void worker_main(unsigned index) {
+        detail::current_worker = { this, index };
+        if (!_cpus.empty()) pin_current_thread(_cpus[index % _cpus.size()]);
+        run_until([this]() { return _stopping.load(std::memory_order_acquire); });
+
+        // Drain what is left after the stop request
+        while (detail::pool_task* task = find_task()) execute(task);
+    }
+
+    void park(uint64_t epoch) {
+        std::unique_lock<std::mutex> lock(_park_lock);
+        _sleepers.fetch_add(1, std::memory_order_seq_cst);
+        while (_epoch.load(std::memory_order_seq_cst) == epoch) _park.wait(lock);
+        _sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify_one() {
+        _epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (_sleepers.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> guard(_park_lock);
+            _park.notify_one();
+        }
+    }
+
+    void notify_all() {
+        _epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (_sleepers.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> guard(_park_lock);
+            _park.notify_all();
+        }
+    }
+
+    vector<work_stealing_deque<detail::pool_task>*> _deques;
+    vector<std::thread> _threads;
+    vector<int> _cpus;
+
+    vector<detail::pool_task*> _injected;
+    size_t _injected_head;
+    std::mutex _injected_lock;
+
+    std::mutex _park_lock;
+    std::condition_variable _park;
+    std::atomic<uint64_t> _epoch;
+    std::atomic<unsigned> _sleepers;
+    std::atomic<bool> _stopping;
+};
+
+// Set of tasks spawned into a pool that can be waited on together
+//
+// `wait` runs pool tasks until every task spawned into the group has finished, then rethrows the first exception
+// any of them threw. Tasks may spawn more tasks into the same group or wait on groups of their own
+class task_group {
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructs a group of tasks run by `pool`
+    explicit task_group(thread_pool& pool)
+        : _pool(pool)
+        , _pending(0)
+        , _error_lock()
+        , _error() {}
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    // Waits for the group's tasks, dropping any exception they threw
+    ~task_group() {
+        _pool.run_until([this]() { return !_pending.load(std::memory_order_acquire); });
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Run `fn()` on the pool as part of this group
+    template <class Function>
+    void spawn(Function&& fn) {
+        _pending.fetch_add(1, std::memory_order_relaxed);
+        _pool.enqueue(detail::make_pool_task(std::forward<Function>(fn), this));
+    }
+
+    // Run pool tasks until all of the group's tasks have finished, then rethrow the first exception one threw
+    void wait() {
+        _pool.run_until([this]() { return !_pending.load(std::memory_order_acquire); });
+        if (_error) {
+            std::exception_ptr error = std::move(_error);
+            _error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    friend class thread_pool;
+
+    void fail(std::exception_ptr error) {
+        std::lock_guard<std::mutex> guard(_error_lock);
+        if (!_error) _error = std::move(error);
+    }
+
+    // Mark one task finished, waking waiters if it was the last. The group may be destroyed as soon as the count
+    // reaches 0, so the pool is read first
+    void finish() {
+        thread_pool& pool = _pool;
+        if (_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) pool.notify_all();
+    }
+
+    thread_pool& _pool;
+    std::atomic<size_t> _pending;
+    std::mutex _error_lock;
+    std::exception_ptr _error;
+};
+
+void thread_pool::execute(detail::pool_task* task) {
+    task_group* group = task->group;
+    if (!group) {
+        task->invoke(task);
+        return;
+    }
+
+    try {
+        task->invoke(task);
+    } catch (...) {
+        group->fail(std::current_exception());
+    }
+    group->finish();
+}
+
+// Pool shared by the parallel algorithms, with one worker per core besides the calling thread
+inline thread_pool& default_thread_pool() {
+    static thread_pool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1);
+    return pool;
+}
+
+}   // namespace ndash
+
+#endif   // THREAD_POOL_H
@@ -37,7 +37,7 @@ concept forward_iterator = forward_pointer<It> || (input_iterator<It> && require
 template <typename It>
 concept bidirectional_iterator = forward_iterator<It> && requires(It it) {
     { --it } -> std::same_as<It&>;
-    { it-- } -> std::same_as<It&>;
+    { it-- } -> std::same_as<It>;
 };
 
 template <typename It>
@@ -51,6 +51,45 @@ concept random_access_iterator = bidirectional_iterator<It> && requires(It it, I
     { it <=> it2 } -> std::same_as<typename It::difference_type>;
 };
 
+// Iterators over elements laid out next to each other in memory
+//
+// Raw pointers qualify, as do random access iterators that declare `static constexpr bool is_contiguous = true`
+template <typename It>
+concept contiguous_iterator = std::is_pointer_v<It> || (random_access_iterator<It> && requires(const It& it) {
+    { it.operator->() } -> std::same_as<typename It::pointer>;
+    requires It::is_contiguous;
+});
+
+// Iterators that can compute the distance between two positions in constant time
+template <typename It>
+concept sized_iterator = random_access_iterator<It> || contiguous_iterator<It>;
+
+///////////////////////////////////////////////////////////////////////////////
+//////////////////////////// Iterator Operations //////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Get a raw pointer to the element at `it` without dereferencing it
+template <contiguous_iterator It>
+constexpr auto to_address(const It& it) {
+    if constexpr (std::is_pointer_v<It>) {
+        return it;
+    } else {
+        return it.operator->();
+    }
+}
+
+// Number of increments needed to get from `first` to `last`
+template <forward_iterator It>
+constexpr ptrdiff_t distance(It first, It last) {
+    if constexpr (sized_iterator<It>) {
+        return last - first;
+    } else {
+        ptrdiff_t n = 0;
+        for (; first != last; ++first) ++n;
+        return n;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ////////////////////////////// Reverse Iterator ///////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -80,7 +119,7 @@ public:
         return *this;
     }
 
-    constexpr reverse_iterator& operator++(int) {
+    constexpr reverse_iterator operator++(int) {
         reverse_iterator tmp = *this;
         --_base;
         return tmp;
@@ -91,7 +130,7 @@ public:
         return *this;
     }
 
-    constexpr reverse_iterator& operator--(int) {
+    constexpr reverse_iterator operator--(int) {
         reverse_iterator tmp = *this;
         ++_base;
         return tmp;
@@ -0,0 +1,181 @@
+#ifndef HASHED_STRING_H
+#define HASHED_STRING_H
+
+#include <cstddef>
+#include <ostream>
+#include <utility>
+
+#include "hash.h"
+#include "ndstring.h"
+#include "swap.h"
+
+namespace ndash {
+
+// String paired with its precomputed hash
+//
+// The hash is computed once on construction or assignment, so hashing the same term for several maps costs a load
+// instead of a pass over every byte. The characters are only reachable through const access, which keeps the cached
+// hash valid; use `assign` or `release` to change them
+class hashed_string {
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor
+    //
+    // Initializes to the empty string
+    hashed_string()
+        : _str()
+        , _hash(FNV_OFFSET_BASIS) {}
+
+    // Constructs from the characters in [ `s`, `s + count` )
+    hashed_string(const char* s, size_t count)
+        : _str(s, count)
+        , _hash(fnv1a(s, count)) {}
+
+    // Constructs from null terminated `s`
+    hashed_string(const char* s)
+        : hashed_string(s, ndash::strlen(s)) {}
+
+    // Constructs from a copy of `str`
+    explicit hashed_string(const string& str)
+        : _str(str)
+        , _hash(fnv1a(str.data(), str.size())) {}
+
+    // Constructs by taking the characters of `str`
+    explicit hashed_string(string&& str)
+        : _str(std::move(str))
+        , _hash(fnv1a(_str.data(), _str.size())) {}
+
+    // Copy constructor
+    hashed_string(const hashed_string& other) = default;
+
+    // Move constructor
+    hashed_string(hashed_string&& other)
+        : _str(std::move(other._str))
+        , _hash(other._hash) {
+        other._hash = FNV_OFFSET_BASIS;
+    }
+
+    // Assignment operator
+    hashed_string& operator=(const hashed_string& other) {
+        if (&other != this) {
+            _str = other._str;
+            _hash = other._hash;
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    hashed_string& operator=(hashed_string&& other) {
+        if (&other != this) {
+            _str = std::move(other._str);
+            _hash = other._hash;
+            other._hash = FNV_OFFSET_BASIS;
+        }
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////////// Element Access ////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Access specified element
+    const char& operator[](size_t pos) const { return _str[pos]; }
+
+    // Directly access data
+    const char* data() const { return _str.data(); }
+
+    // Get c string
+    const char* c_str() const { return _str.c_str(); }
+
+    // Get the underlying string
+    const string& str() const { return _str; }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if string is empty
+    bool empty() const { return _str.empty(); }
+
+    // Number of characters in string
+    size_t size() const { return _str.size(); }
+
+    // Number of characters in string
+    size_t length() const { return _str.size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Replace the contents with `str` and recompute the hash
+    hashed_string& assign(string str) {
+        _str = std::move(str);
+        _hash = fnv1a(_str.data(), _str.size());
+        return *this;
+    }
+
+    // Move the characters out, leaving the empty string behind
+    string release() {
+        string out(std::move(_str));
+        _str = string();
+        _hash = FNV_OFFSET_BASIS;
+        return out;
+    }
+
+    // Swap with another hashed string
+    void swap(hashed_string& other) {
+        ndash::swap(_str, other._str);
+        ndash::swap(_hash, other._hash);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Iterators ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Iterator begin
+    auto begin() const { return _str.begin(); }
+
+    // Iterator end
+    auto end() const { return _str.end(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Operations //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Get the cached hash, equal to `ndash::hash<string>` of the characters
+    size_t hash() const { return _hash; }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////// Non-member functions //////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Equality compares the cached hashes before the characters
+    friend bool operator==(const hashed_string& a, const hashed_string& b) {
+        return a._hash == b._hash && a._str == b._str;
+    }
+    friend int operator<=>(const hashed_string& a, const hashed_string& b) { return a._str.compare(b._str); }
+
+    friend bool operator==(const hashed_string& a, const string& b) { return a._str == b; }
+    friend bool operator==(const hashed_string& a, const char* b) { return a._str == b; }
+
+    friend std::ostream& operator<<(std::ostream& os, const hashed_string& str) { return os << str._str; }
+
+    // Swap specialization
+    friend void swap(hashed_string& a, hashed_string& b) { a.swap(b); }
+
+private:
+    string _str;
+    size_t _hash;
+};
+
+template <>
+struct hash<hashed_string> {
+    inline size_t operator()(const hashed_string& str) const { return str.hash(); }
+};
+
+}   // namespace ndash
+
+#endif   // HASHED_STRING_H
@@ -0,0 +1,301 @@
+#ifndef INTERN_POOL_H
+#define INTERN_POOL_H
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+#include "hash.h"
+#include "ndstring.h"
+#include "vector.h"
+
+namespace ndash {
+
+// Pool of unique strings, each identified by a stable 32 bit atom id
+//
+// Strings are copied once into an append-only arena and never move or get freed until the pool is destroyed.
+// Interning takes a lock only when the string is not already in the pool, while `find`, `c_str`, `length` and
+// `hash` never lock. Atom ids are handed out densely starting at 0
+class intern_pool {
+public:
+    using atom = uint32_t;
+
+    // Special value indicating no atom
+    static constexpr const atom npos = atom(-1);
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructs a pool sized to hold `expected_count` strings before its lookup table grows
+    explicit intern_pool(size_t expected_count = DEFAULT_EXPECTED_COUNT)
+        : _count(0)
+        , _chunk(nullptr)
+        , _chunk_used(CHUNK_SIZE)
+        , _bytes(0) {
+        size_t capacity = MIN_TABLE_CAPACITY;
+        while (capacity < expected_count * 2) capacity *= 2;
+        _table.store(new table(capacity, nullptr), std::memory_order_relaxed);
+
+        for (auto& block : _blocks) block.store(nullptr, std::memory_order_relaxed);
+    }
+
+    intern_pool(const intern_pool& other) = delete;
+    intern_pool& operator=(const intern_pool& other) = delete;
+
+    // Destructor
+    ~intern_pool() {
+        delete _table.load(std::memory_order_relaxed);
+        for (auto& block : _blocks) delete[] block.load(std::memory_order_relaxed);
+        for (char* chunk : _chunks) delete[] chunk;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Get the atom for [ `s`, `s + len` ), adding it to the pool if it isn't there yet
+    //
+    // Throws `std::length_error` if `len` doesn't fit the 32-bit length entries keep, or if the string is new and
+    // every atom below `npos` is taken
+    atom intern(const char* s, size_t len) {
+        if (len > UINT32_MAX) throw std::length_error("intern_pool strings are shorter than 4 GiB");
+        size_t h = fnv1a(s, len);
+        atom id = find(s, len, h);
+        if (id != npos) return id;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Another thread may have interned the string while we waited
+        id = find(s, len, h);
+        if (id != npos) return id;
+
+        size_t count = _count.load(std::memory_order_relaxed);
+        if (count >= npos) throw std::length_error("intern_pool has run out of atoms");
+        id = static_cast<atom>(count);
+        entry* e = allocate_entry(s, len, h);
+        publish_entry(id, e);
+
+        table* t = _table.load(std::memory_order_relaxed);
+        if ((count + 1) * 2 > t->capacity) {
+            t = grow(t);
+        }
+        insert_slot(t, h, id);
+
+        _count.store(count + 1, std::memory_order_release);
+        return id;
+    }
+
+    // Get the atom for null terminated `s`, adding it to the pool if it isn't there yet
+    atom intern(const char* s) { return intern(s, ndash::strlen(s)); }
+
+    // Get the atom for `str`, adding it to the pool if it isn't there yet
+    atom intern(const string& str) { return intern(str.data(), str.size()); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Lookup /////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Find the atom for [ `s`, `s + len` ) without adding it. If it isn't interned, `npos` is returned
+    atom find(const char* s, size_t len) const { return find(s, len, fnv1a(s, len)); }
+
+    // Find the atom for null terminated `s` without adding it
+    atom find(const char* s) const { return find(s, ndash::strlen(s)); }
+
+    // Find the atom for `str` without adding it
+    atom find(const string& str) const { return find(str.data(), str.size()); }
+
+    // Returns true if [ `s`, `s + len` ) has been interned
+    bool contains(const char* s, size_t len) const { return find(s, len) != npos; }
+
+    // Returns true if `str` has been interned
+    bool contains(const string& str) const { return find(str) != npos; }
+
+    // Get the null terminated characters of atom `id`
+    const char* c_str(atom id) const { return get_entry(id)->data; }
+
+    // Get the length of atom `id`
+    size_t length(atom id) const { return get_entry(id)->length; }
+
+    // Get the cached hash of atom `id`, equal to `ndash::hash<string>` of its characters
+    size_t hash(atom id) const { return get_entry(id)->hash; }
+
+    // Copy atom `id` into a new string
+    string str(atom id) const {
+        const entry* e = get_entry(id);
+        return string(e->data, e->length);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Number of unique strings in the pool
+    size_t size() const { return _count.load(std::memory_order_acquire); }
+
+    // Check if pool is empty
+    bool empty() const { return size() == 0; }
+
+    // Number of string bytes held in the arena, including headers and terminators
+    size_t bytes_used() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _bytes;
+    }
+
+private:
+    // Arena record for a single interned string
+    struct entry {
+        size_t hash;
+        uint32_t length;
+        char data[1];
+    };
+
+    // Open addressed lookup table
+    //
+    // Each slot holds the upper 32 bits of the string hash and the atom id plus one, so probes only touch the arena
+    // when the hash tags match. Replaced tables are kept alive through `previous` since readers may still probe them
+    struct table {
+        table(size_t cap, table* prev)
+            : capacity(cap)
+            , slots(new std::atomic<uint64_t>[cap])
+            , previous(prev) {
+            for (size_t i = 0; i < cap; ++i) slots[i].store(0, std::memory_order_relaxed);
+        }
+
+        ~table() {
+            delete[] slots;
+            delete previous;
+        }
+
+        size_t capacity;
+        std::atomic<uint64_t>* slots;
+        table* previous;
+    };
+
+    static constexpr const size_t DEFAULT_EXPECTED_COUNT = 1024;
+    static constexpr const size_t MIN_TABLE_CAPACITY = 64;
+    static constexpr const size_t CHUNK_SIZE = 64 * 1024;
+
+    // Atom `id` lives in block `bit_width(id + FIRST_BLOCK_SIZE) - FIRST_BLOCK_SHIFT - 1`, block `k` holding
+    // `FIRST_BLOCK_SIZE << k` entries, so the directory never moves an entry once it is published
+    static constexpr const unsigned FIRST_BLOCK_SHIFT = 6;
+    static constexpr const size_t FIRST_BLOCK_SIZE = size_t(1) << FIRST_BLOCK_SHIFT;
+    static constexpr const unsigned NUM_BLOCKS = 33 - FIRST_BLOCK_SHIFT;
+
+    static constexpr uint64_t make_slot(size_t h, atom id) { return (uint64_t(h >> 32) << 32) | (uint64_t(id) + 1); }
+
+    static constexpr atom slot_atom(uint64_t slot) { return static_cast<atom>((slot & 0xFFFFFFFFu) - 1); }
+
+    static constexpr bool slot_matches(uint64_t slot, size_t h) { return (slot >> 32) == (h >> 32); }
+
+    atom find(const char* s, size_t len, size_t h) const {
+        const table* t = _table.load(std::memory_order_acquire);
+        size_t mask = t->capacity - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            uint64_t slot = t->slots[i].load(std::memory_order_acquire);
+            if (!slot) return npos;
+            if (!slot_matches(slot, h)) continue;
+
+            atom id = slot_atom(slot);
+            const entry* e = get_entry(id);
+            if (e->hash == h && e->length == len && std::memcmp(e->data, s, len) == 0) return id;
+        }
+    }
+
+    const entry* get_entry(atom id) const {
+        size_t index = size_t(id) + FIRST_BLOCK_SIZE;
+        unsigned block = std::bit_width(index) - 1;
+        size_t offset = index - (size_t(1) << block);
+        return _blocks[block - FIRST_BLOCK_SHIFT].load(std::memory_order_acquire)[offset];
+    }
+
+    // Copy string into the arena. Must hold `_mutex`
+    entry* allocate_entry(const char* s, size_t len, size_t h) {
+        size_t bytes = (offsetof(entry, data) + len + 1 + alignof(entry) - 1) & ~(alignof(entry) - 1);
+        _bytes += bytes;
+
+        // Large strings get their own chunk so the current one keeps filling
+        if (bytes > CHUNK_SIZE / 4) {
+            char* chunk = new char[bytes];
+            _chunks.push_back(chunk);
+            return construct_entry(chunk, s, len, h);
+        }
+
+        if (_chunk_used + bytes > CHUNK_SIZE) {
+            _chunk = new char[CHUNK_SIZE];
+            _chunks.push_back(_chunk);
+            _chunk_used = 0;
+        }
+
+        char* memory = _chunk + _chunk_used;
+        _chunk_used += bytes;
+        return construct_entry(memory, s, len, h);
+    }
+
+    static entry* construct_entry(char* memory, const char* s, size_t len, size_t h) {
+        entry* e = reinterpret_cast<entry*>(memory);
+        e->hash = h;
+        e->length = static_cast<uint32_t>(len);
+        std::memcpy(e->data, s, len);
+        e->data[len] = '\0';
+        return e;
+    }
+
+    // Store entry pointer for atom `id` in the directory. Must hold `_mutex`
+    void publish_entry(atom id, entry* e) {
+        size_t index = size_t(id) + FIRST_BLOCK_SIZE;
+        unsigned block = std::bit_width(index) - 1;
+        size_t offset = index - (size_t(1) << block);
+
+        auto& slot = _blocks[block - FIRST_BLOCK_SHIFT];
+        entry** entries = slot.load(std::memory_order_relaxed);
+        if (!entries) {
+            entries = new entry*[size_t(1) << block];
+            slot.store(entries, std::memory_order_release);
+        }
+        entries[offset] = e;
+    }
+
+    // Replace the lookup table with one twice the size. Must hold `_mutex`
+    table* grow(table* old) {
+        table* t = new table(old->capacity * 2, old);
+        size_t mask = t->capacity - 1;
+        for (size_t i = 0; i < old->capacity; ++i) {
+            uint64_t slot = old->slots[i].load(std::memory_order_relaxed);
+            if (!slot) continue;
+
+            size_t h = get_entry(slot_atom(slot))->hash;
+            size_t j = h & mask;
+            while (t->slots[j].load(std::memory_order_relaxed)) j = (j + 1) & mask;
+            t->slots[j].store(slot, std::memory_order_relaxed);
+        }
+        _table.store(t, std::memory_order_release);
+        return t;
+    }
+
+    // Insert atom `id` into table `t`. Must hold `_mutex`
+    static void insert_slot(table* t, size_t h, atom id) {
+        size_t mask = t->capacity - 1;
+        size_t i = h & mask;
+        while (t->slots[i].load(std::memory_order_relaxed)) i = (i + 1) & mask;
+        t->slots[i].store(make_slot(h, id), std::memory_order_release);
+    }
+
+    std::atomic<table*> _table;
+    std::atomic<entry**> _blocks[NUM_BLOCKS];
+    std::atomic<size_t> _count;
+
+    mutable std::mutex _mutex;
+    vector<char*> _chunks;
+    char* _chunk;
+    size_t _chunk_used;
+    size_t _bytes;
+};
+
+}   // namespace ndash
+
+#endif   // INTERN_POOL_H
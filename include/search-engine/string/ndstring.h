@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <cstring>
+#include <functional>
 #include <ostream>
 
 #include "hash.h"
@@ -39,7 +40,9 @@ public:
 
     // Constructs a string with `count` copies of `ch`
     string(size_t count, char ch)
-        : _data(count, ch) {
+        : _data() {
+        _data.reserve(count + 1);
+        _data.resize(count, ch);
         _data.push_back('\0');
     }
 
@@ -47,14 +50,14 @@ public:
     template <typename ForwardIt>
     string(ForwardIt first, ForwardIt last)
     requires forward_iterator<ForwardIt>
-        : _data(first, last) {
-        _data.push_back('\0');
+        : _data() {
+        assign(first, last);
     }
 
     // Constructs string from cstring with defined size
     string(const char* s, size_t count)
-        : _data(s, s + count) {
-        _data.push_back('\0');
+        : _data() {
+        assign(s, count);
     }
 
     // Constructs string from cstring
@@ -63,8 +66,8 @@ public:
 
     // Constructs a vector from the initializer list
     string(std::initializer_list<char> list)
-        : _data(list) {
-        _data.push_back('\0');
+        : _data() {
+        assign(list.begin(), list.end());
     }
 
     // Copy constructor
@@ -92,12 +95,7 @@ public:
     }
 
     // C str assignment
-    string& operator=(const char* s) {
-        auto s_size = ndash::strlen(s);
-        resize(s_size);
-        memcpy(_data.data(), s, s_size);
-        return *this;
-    }
+    string& operator=(const char* s) { return assign(s, ndash::strlen(s)); }
 
     // Char assignment
     string& operator=(char ch) {
@@ -107,14 +105,7 @@ public:
     }
 
     // Initializer list assignment
-    string& operator=(std::initializer_list<char> ilist) {
-        resize(ilist.size());
-        int index = 0;
-        for (auto it = ilist.begin(); it != ilist.end(); ++it, ++index) {
-            _data[index] = *it;
-        }
-        return *this;
-    }
+    string& operator=(std::initializer_list<char> ilist) { return assign(ilist.begin(), ilist.end()); }
 
     ///////////////////////////////////////////////////////////////////////////
     /////////////////////////////// Element Access ////////////////////////////
@@ -152,17 +143,20 @@ public:
     ///////////////////////////////////////////////////////////////////////////
 
     // Check if string is empty
-    constexpr bool empty() const { return _data.size() == 1; }
+    constexpr bool empty() const { return _data.size() <= 1; }
 
     // Number of characters in string
-    constexpr size_t size() const { return _data.size() - 1; }
+    constexpr size_t size() const { return _data.size() ? _data.size() - 1 : 0; }
 
     // Number of characters in string
-    constexpr size_t length() const { return _data.size() - 1; }
+    constexpr size_t length() const { return size(); }
 
     // Reserves storage
     void reserve(size_t new_cap) { _data.reserve(new_cap + 1); }
 
+    // Number of characters that can be held in currently allocated storage, 0 for a moved-from string
+    constexpr size_t capacity() const { return _data.capacity() ? _data.capacity() - 1 : 0; }
+
     ///////////////////////////////////////////////////////////////////////////
     ///////////////////////////////// Modifiers ///////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
@@ -173,6 +167,33 @@ public:
         _data.push_back('\0');
     }
 
+    // Replace the contents with the range [`first`, `last`)
+    //
+    // Ranges with a known size allocate at most once, and contiguous ranges are copied with a single memcpy. A
+    // contiguous range inside the string itself is copied out first, since reserving may free it
+    template <typename ForwardIt>
+    string& assign(ForwardIt first, ForwardIt last)
+    requires forward_iterator<ForwardIt>
+    {
+        if constexpr (contiguous_iterator<ForwardIt>) {
+            if (first != last && overlaps(ndash::to_address(first))) {
+                string copy(first, last);
+                swap(copy);
+                return *this;
+            }
+        }
+        if constexpr (sized_iterator<ForwardIt>) {
+            _data.clear();
+            _data.reserve(size_t(last - first) + 1);
+        }
+        _data.assign(first, last);
+        _data.push_back('\0');
+        return *this;
+    }
+
+    // Replace the contents with the first `count` characters of `s`
+    string& assign(const char* s, size_t count) { return assign(s, s + count); }
+
     // Adds a character to the end of the string
     void push_back(const char ch) {
         _data.back() = ch;
@@ -476,19 +497,19 @@ public:
     friend void swap(string& a, string& b) { a.swap(b); }
 
 private:
+    // Check if `p` points into the buffer, terminator included
+    bool overlaps(const char* p) const {
+        if (_data.empty()) return false;
+        const char* begin = _data.data();
+        return std::less_equal<const char*>()(begin, p) && std::less<const char*>()(p, begin + _data.size());
+    }
+
     vector<char> _data;
 };
 
 template <>
 struct hash<string> {
-    constexpr inline size_t operator()(const string& str) const {
-        size_t hash = FNV_OFFSET_BASIS;
-        for (auto it = str.begin(); it != str.end(); ++it) {
-            hash ^= *it;
-            hash *= FNV_PRIME;
-        }
-        return hash;
-    }
+    constexpr inline size_t operator()(const string& str) const { return fnv1a(str.data(), str.size()); }
 };
 
 }   // namespace ndash
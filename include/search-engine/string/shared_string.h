@@ -0,0 +1,232 @@
+#ifndef SHARED_STRING_H
+#define SHARED_STRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <ostream>
+
+#include "hash.h"
+#include "ndstring.h"
+#include "swap.h"
+
+namespace ndash {
+
+// Immutable reference counted string
+//
+// The reference count, length, hash and characters share a single allocation, so copying is a reference count bump
+// and hashing is a load. The empty string doesn't allocate
+class shared_string {
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor
+    //
+    // Initializes to the empty string without allocating
+    constexpr shared_string()
+        : _rep(nullptr) {}
+
+    // Constructs from the characters in [ `s`, `s + count` )
+    shared_string(const char* s, size_t count)
+        : _rep(count ? make_rep(s, count) : nullptr) {}
+
+    // Constructs from null terminated `s`
+    shared_string(const char* s)
+        : shared_string(s, ndash::strlen(s)) {}
+
+    // Constructs from the characters of `str`
+    explicit shared_string(const string& str)
+        : shared_string(str.data(), str.size()) {}
+
+    // Copy constructor
+    shared_string(const shared_string& other)
+        : _rep(other._rep) {
+        retain();
+    }
+
+    // Move constructor
+    shared_string(shared_string&& other)
+        : _rep(other._rep) {
+        other._rep = nullptr;
+    }
+
+    // Assignment operator
+    shared_string& operator=(const shared_string& other) {
+        if (other._rep != _rep) {
+            other.retain();
+            release();
+            _rep = other._rep;
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    shared_string& operator=(shared_string&& other) {
+        if (&other != this) {
+            release();
+            _rep = other._rep;
+            other._rep = nullptr;
+        }
+        return *this;
+    }
+
+    // Destructor
+    ~shared_string() { release(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////////// Element Access ////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Access specified element
+    const char& operator[](size_t pos) const { return data()[pos]; }
+
+    // Access first element
+    const char& front() const { return data()[0]; }
+
+    // Access last element
+    const char& back() const { return data()[size() - 1]; }
+
+    // Directly access data
+    const char* data() const { return _rep ? _rep->data : ""; }
+
+    // Get c string
+    const char* c_str() const { return data(); }
+
+    // Copy the characters into a mutable string
+    string str() const { return string(data(), size()); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if string is empty
+    bool empty() const { return !_rep; }
+
+    // Number of characters in string
+    size_t size() const { return _rep ? _rep->length : 0; }
+
+    // Number of characters in string
+    size_t length() const { return size(); }
+
+    // Number of `shared_string` objects sharing the characters. The empty string reports 0
+    size_t use_count() const { return _rep ? _rep->refs.load(std::memory_order_relaxed) : 0; }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Swap with another shared string
+    void swap(shared_string& other) { ndash::swap(_rep, other._rep); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Iterators ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Iterator begin
+    const char* begin() const { return data(); }
+
+    // Iterator end
+    const char* end() const { return data() + size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Operations //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Get the hash of the characters, equal to `ndash::hash<string>` of the same characters
+    size_t hash() const { return _rep ? _rep->hash : FNV_OFFSET_BASIS; }
+
+    // Compares the string to the characters in [ `s`, `s + count` )
+    int compare(const char* s, size_t count) const {
+        size_t len = size();
+        int result = std::memcmp(data(), s, len < count ? len : count);
+        if (result) return result;
+        return len < count ? -1 : (len > count ? 1 : 0);
+    }
+
+    // Compares the string to `other`
+    int compare(const shared_string& other) const {
+        if (_rep == other._rep) return 0;
+        return compare(other.data(), other.size());
+    }
+
+    // Compares the string to `str`
+    int compare(const string& str) const { return compare(str.data(), str.size()); }
+
+    // Compares the string to null terminated `s`
+    int compare(const char* s) const { return compare(s, ndash::strlen(s)); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////// Non-member functions //////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Equality checks shared storage, then the cached hashes, before comparing characters
+    friend bool operator==(const shared_string& a, const shared_string& b) {
+        if (a._rep == b._rep) return true;
+        if (a.hash() != b.hash() || a.size() != b.size()) return false;
+        return std::memcmp(a.data(), b.data(), a.size()) == 0;
+    }
+    friend int operator<=>(const shared_string& a, const shared_string& b) { return a.compare(b); }
+
+    friend bool operator==(const shared_string& a, const string& b) {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size()) == 0;
+    }
+    friend int operator<=>(const shared_string& a, const string& b) { return a.compare(b); }
+
+    friend bool operator==(const shared_string& a, const char* b) { return a.compare(b) == 0; }
+    friend int operator<=>(const shared_string& a, const char* b) { return a.compare(b); }
+
+    friend std::ostream& operator<<(std::ostream& os, const shared_string& str) {
+        os.write(str.data(), str.size());
+        return os;
+    }
+
+    // Swap specialization
+    friend void swap(shared_string& a, shared_string& b) { a.swap(b); }
+
+private:
+    // Header of the single allocation, followed by the null terminated characters
+    struct rep {
+        std::atomic<size_t> refs;
+        size_t length;
+        size_t hash;
+        char data[1];
+    };
+
+    static rep* make_rep(const char* s, size_t count) {
+        size_t bytes = offsetof(rep, data) + count + 1;
+        void* memory = ::operator new(bytes < sizeof(rep) ? sizeof(rep) : bytes);
+        rep* r = new (memory) rep;
+        r->refs.store(1, std::memory_order_relaxed);
+        r->length = count;
+        r->hash = fnv1a(s, count);
+        std::memcpy(r->data, s, count);
+        r->data[count] = '\0';
+        return r;
+    }
+
+    void retain() const {
+        if (_rep) _rep->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release() {
+        if (_rep && _rep->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            _rep->~rep();
+            ::operator delete(_rep);
+        }
+        _rep = nullptr;
+    }
+
+    rep* _rep;
+};
+
+template <>
+struct hash<shared_string> {
+    inline size_t operator()(const shared_string& str) const { return str.hash(); }
+};
+
+}   // namespace ndash
+
+#endif   // SHARED_STRING_H
@@ -0,0 +1,164 @@
+#ifndef STRING_VIEW_H
+#define STRING_VIEW_H
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+
+#include "hash.h"
+#include "ndstring.h"
+
+namespace ndash {
+
+// Non-owning view over a contiguous range of characters
+class string_view {
+public:
+    // Special value indicating no position
+    static constexpr const size_t npos = size_t(-1);
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor
+    //
+    // Initializes to an empty view
+    constexpr string_view()
+        : _data(nullptr)
+        , _size(0) {}
+
+    // Views the characters in [ `s`, `s + count` )
+    constexpr string_view(const char* s, size_t count)
+        : _data(s)
+        , _size(count) {}
+
+    // Views null terminated `s`
+    constexpr string_view(const char* s)
+        : _data(s)
+        , _size(ndash::strlen(s)) {}
+
+    // Views the characters of `str`
+    constexpr string_view(const string& str)
+        : _data(str.data())
+        , _size(str.size()) {}
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////////// Element Access ////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Access specified element
+    constexpr const char& operator[](size_t pos) const { return _data[pos]; }
+
+    // Access first element
+    constexpr const char& front() const { return _data[0]; }
+
+    // Access last element
+    constexpr const char& back() const { return _data[_size - 1]; }
+
+    // Directly access data
+    constexpr const char* data() const { return _data; }
+
+    // Copy the viewed characters into a string
+    string str() const { return string(_data, _size); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Capacity ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if view is empty
+    constexpr bool empty() const { return _size == 0; }
+
+    // Number of characters in view
+    constexpr size_t size() const { return _size; }
+
+    // Number of characters in view
+    constexpr size_t length() const { return _size; }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Shrink the view by moving its start forward by `n` characters
+    constexpr void remove_prefix(size_t n) {
+        _data += n;
+        _size -= n;
+    }
+
+    // Shrink the view by moving its end back by `n` characters
+    constexpr void remove_suffix(size_t n) { _size -= n; }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Iterators ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Iterator begin
+    constexpr const char* begin() const { return _data; }
+
+    // Iterator end
+    constexpr const char* end() const { return _data + _size; }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Operations //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Get the view of [ `pos`, `pos + count` )
+    constexpr string_view substr(size_t pos, size_t count = npos) const {
+        if (count > _size - pos) count = _size - pos;
+        return string_view(_data + pos, count);
+    }
+
+    // Find the first instance of `ch` after `pos`
+    constexpr size_t find(char ch, size_t pos = 0) const {
+        for (; pos < _size; ++pos) {
+            if (_data[pos] == ch) return pos;
+        }
+        return npos;
+    }
+
+    // Compares the view to `other`
+    int compare(string_view other) const {
+        size_t count = _size < other._size ? _size : other._size;
+        int result = count ? std::memcmp(_data, other._data, count) : 0;
+        if (result) return result;
+        return _size < other._size ? -1 : (_size > other._size ? 1 : 0);
+    }
+
+    // Check if view begins with `prefix`
+    bool starts_with(string_view prefix) const {
+        if (prefix._size == 0) return true;
+        return prefix._size <= _size && std::memcmp(_data, prefix._data, prefix._size) == 0;
+    }
+
+    // Check if view ends with `suffix`
+    bool ends_with(string_view suffix) const {
+        if (suffix._size == 0) return true;
+        return suffix._size <= _size && std::memcmp(_data + _size - suffix._size, suffix._data, suffix._size) == 0;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /////////////////////////// Non-member functions //////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    friend bool operator==(string_view a, string_view b) {
+        return a._size == b._size && (a._size == 0 || std::memcmp(a._data, b._data, a._size) == 0);
+    }
+    friend int operator<=>(string_view a, string_view b) { return a.compare(b); }
+
+    friend std::ostream& operator<<(std::ostream& os, string_view view) {
+        os.write(view._data, view._size);
+        return os;
+    }
+
+private:
+    const char* _data;
+    size_t _size;
+};
+
+template <>
+struct hash<string_view> {
+    constexpr inline size_t operator()(string_view view) const { return fnv1a(view.data(), view.size()); }
+};
+
+}   // namespace ndash
+
+#endif   // STRING_VIEW_H
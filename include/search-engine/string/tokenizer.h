@@ -0,0 +1,310 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "cpu_features.h"
+#include "ndstring.h"
+#include "string_view.h"
+#include "vector.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NDASH_TOKENIZER_X86 1
+#endif
+
+namespace ndash {
+
+// Token found by a tokenizer, as a range of the source buffer
+struct token {
+    size_t offset;
+    size_t length;
+
+    // View the token's characters in `source`
+    constexpr string_view view(const char* source) const { return string_view(source + offset, length); }
+
+    friend constexpr bool operator==(const token& a, const token& b) {
+        return a.offset == b.offset && a.length == b.length;
+    }
+};
+
+namespace detail {
+
+// Bitmap of delimiter bytes arranged for a nibble lookup
+//
+// Byte `b` below 0x80 is a delimiter when bit `b >> 4` of `rows[b & 0xF]` is set. Bytes at or above 0x80 belong
+// to multibyte UTF-8 sequences and are never delimiters
+struct delimiter_table {
+    alignas(16) uint8_t rows[16];
+
+    constexpr bool contains(unsigned char ch) const { return ch < 0x80 && (rows[ch & 0xF] >> (ch >> 4)) & 1; }
+};
+
+// Mask with bit `i` set when `data[i]` is a delimiter, for `len` up to 64 bytes
+inline uint64_t classify_scalar(const delimiter_table& table, const char* data, size_t len) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < len; ++i) {
+        mask |= uint64_t(table.contains(static_cast<unsigned char>(data[i]))) << i;
+    }
+    return mask;
+}
+
+#ifdef NDASH_TOKENIZER_X86
+
+__attribute__((target("avx2"))) inline uint32_t classify_block(__m256i rows, __m256i bits, __m256i input) {
+    __m256i low = _mm256_and_si256(input, _mm256_set1_epi8(0x0F));
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(input, 4), _mm256_set1_epi8(0x0F));
+
+    // `bits` is zero for high nibbles 8 to 15, which rejects every non-ASCII byte
+    __m256i hit = _mm256_and_si256(_mm256_shuffle_epi8(rows, low), _mm256_shuffle_epi8(bits, high));
+    __m256i is_delimiter = _mm256_cmpeq_epi8(_mm256_cmpeq_epi8(hit, _mm256_setzero_si256()), _mm256_setzero_si256());
+    return static_cast<uint32_t>(_mm256_movemask_epi8(is_delimiter));
+}
+
+// Delimiter mask of 64 bytes at `data`
+__attribute__((target("avx2"))) inline uint64_t classify_avx2(const delimiter_table& table, const char* data) {
+    __m256i rows = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table.rows)));
+    __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, char(128), 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64,
+                                    char(128), 0, 0, 0, 0, 0, 0, 0, 0);
+
+    uint64_t low = classify_block(rows, bits, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)));
+    uint64_t high = classify_block(rows, bits, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32)));
+    return low | (high << 32);
+}
+
+#endif   // NDASH_TOKENIZER_X86
+
+}   // namespace detail
+
+// Splits text into tokens separated by runs of delimiter bytes
+//
+// Bytes are classified 64 at a time with AVX2 where available. Tokens are reported as ranges of the source buffer
+// instead of copies. Bytes of multibyte UTF-8 sequences are never delimiters, so non-ASCII words stay whole
+class tokenizer {
+public:
+    // Classes of ASCII bytes that can be used as delimiters
+    enum delimiter_class : unsigned {
+        WHITESPACE = 1 << 0,    // Space, '\t', '\n', '\v', '\f' and '\r'
+        PUNCTUATION = 1 << 1,   // Printable ASCII that isn't a letter, digit or space
+        CONTROL = 1 << 2,       // Control characters other than whitespace
+        DIGITS = 1 << 3,        // '0' to '9'
+    };
+
+    static constexpr const unsigned DEFAULT_DELIMITERS = WHITESPACE | PUNCTUATION | CONTROL;
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////// Constructors/Destructors ///////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructs a tokenizer splitting on every byte in `classes`
+    explicit tokenizer(unsigned classes = DEFAULT_DELIMITERS)
+        : _table {} {
+        for (unsigned ch = 0; ch < 0x80; ++ch) {
+            bool whitespace = ch == ' ' || (ch >= '\t' && ch <= '\r');
+            bool control = !whitespace && (ch < 0x20 || ch == 0x7F);
+            bool digit = ch >= '0' && ch <= '9';
+            bool alpha = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+            bool punctuation = ch > ' ' && ch < 0x7F && !digit && !alpha;
+
+            if (((classes & WHITESPACE) && whitespace) || ((classes & CONTROL) && control)
+                || ((classes & DIGITS) && digit) || ((classes & PUNCTUATION) && punctuation)) {
+                add_delimiter(static_cast<char>(ch));
+            }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Modifiers ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Split on `ch` as well. Only ASCII bytes can be delimiters
+    tokenizer& add_delimiter(char ch) {
+        auto byte = static_cast<unsigned char>(ch);
+        if (byte < 0x80) _table.rows[byte & 0xF] |= uint8_t(1u << (byte >> 4));
+        return *this;
+    }
+
+    // Stop splitting on `ch`
+    tokenizer& remove_delimiter(char ch) {
+        auto byte = static_cast<unsigned char>(ch);
+        if (byte < 0x80) _table.rows[byte & 0xF] &= uint8_t(~(1u << (byte >> 4)));
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Lookup /////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Check if `ch` separates tokens
+    bool is_delimiter(char ch) const { return _table.contains(static_cast<unsigned char>(ch)); }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////// Operations //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Call `func(token)` for each token in [ `data`, `data + len` ) in order
+    template <class Func>
+    void for_each(const char* data, size_t len, Func&& func) const {
+        scan_state state;
+        scan(state, data, len, 0, [&](size_t start, size_t end) { func(token { start, end - start }); });
+        if (state.in_token) func(token { state.start, len - state.start });
+    }
+
+    // Call `func(token)` for each token in `text` in order
+    template <class Func>
+    void for_each(string_view text, Func&& func) const {
+        for_each(text.data(), text.size(), std::forward<Func>(func));
+    }
+
+    // Append the tokens in [ `data`, `data + len` ) to `tokens`
+    void tokenize(const char* data, size_t len, vector<token>& tokens) const {
+        for_each(data, len, [&](token t) { tokens.push_back(t); });
+    }
+
+    // Get the tokens in `text`
+    vector<token> tokenize(string_view text) const {
+        vector<token> tokens;
+        tokenize(text.data(), text.size(), tokens);
+        return tokens;
+    }
+
+    // Count the tokens in `text` without storing them
+    size_t count(string_view text) const {
+        size_t n = 0;
+        for_each(text, [&](token) { ++n; });
+        return n;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ////////////////////////////////// Streaming //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+private:
+    // Position between calls to `scan`
+    struct scan_state {
+        bool in_token = false;
+        size_t start = 0;
+    };
+
+public:
+    // Tokenizes a document fed in consecutive buffers
+    //
+    // Tokens are reported as a view and their offset from the start of the stream. Views of tokens inside one buffer
+    // point into it, while a token spanning buffers is assembled in the stream and its view stays valid until the
+    // next call. The tokenizer must outlive the stream
+    class stream {
+    public:
+        explicit stream(const tokenizer& tok)
+            : _tokenizer(tok)
+            , _state()
+            , _consumed(0)
+            , _carry() {}
+
+        // Tokenize the next buffer, calling `func(string_view, size_t offset)` for each token it completes
+        template <class Func>
+        void feed(const char* data, size_t len, Func&& func) {
+            size_t base = _consumed;
+            _tokenizer.scan(_state, data, len, base, [&](size_t start, size_t end) {
+                if (start >= base) {
+                    func(string_view(data + (start - base), end - start), start);
+                } else {
+                    // Finish the token carried over from earlier buffers
+                    _carry.append(data, end - base);
+                    func(string_view(_carry), start);
+                    _carry.clear();
+                }
+            });
+
+            if (_state.in_token) {
+                size_t from = _state.start >= base ? _state.start - base : 0;
+                _carry.append(data + from, len - from);
+            }
+            _consumed += len;
+        }
+
+        // Tokenize the next buffer
+        template <class Func>
+        void feed(string_view data, Func&& func) {
+            feed(data.data(), data.size(), std::forward<Func>(func));
+        }
+
+        // Flush the token at the end of the stream, if any, and reset for a new document
+        template <class Func>
+        void finish(Func&& func) {
+            if (_state.in_token) func(string_view(_carry), _state.start);
+            _state = scan_state();
+            _consumed = 0;
+            _carry.clear();
+        }
+
+        // Number of bytes fed since the stream started
+        size_t consumed() const { return _consumed; }
+
+    private:
+        const tokenizer& _tokenizer;
+        scan_state _state;
+        size_t _consumed;
+        string _carry;
+    };
+
+private:
+    // Call `emit(start, end)` with stream offsets for each token ending in [ `data`, `data + len` )
+    //
+    // `base` is the stream offset of `data`. A token still open at the end is left in `state`
+    template <class Emit>
+    void scan(scan_state& state, const char* data, size_t len, size_t base, Emit&& emit) const {
+        size_t i = 0;
+
+#ifdef NDASH_TOKENIZER_X86
+        if (cpu::has_avx2()) {
+            for (; i + 64 <= len; i += 64) {
+                scan_mask(state, detail::classify_avx2(_table, data + i), 64, base + i, emit);
+            }
+        }
+#endif
+
+        for (; i < len; i += 64) {
+            size_t n = len - i < 64 ? len - i : 64;
+            scan_mask(state, detail::classify_scalar(_table, data + i, n), n, base + i, emit);
+        }
+    }
+
+    // Emit the tokens ending in a block of `n` bytes at stream offset `offset`, given its delimiter mask
+    template <class Emit>
+    static void scan_mask(scan_state& state, uint64_t delimiters, size_t n, size_t offset, Emit& emit) {
+        uint64_t valid = n == 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+        uint64_t token_bytes = ~delimiters & valid;
+
+        // Tokens start on a token byte after a delimiter and end on a delimiter after a token byte
+        uint64_t previous = (token_bytes << 1) | uint64_t(state.in_token);
+        uint64_t starts = token_bytes & ~previous;
+        uint64_t ends = ~token_bytes & previous & valid;
+
+        if (state.in_token) {
+            if (!ends) return;
+            emit(state.start, offset + __builtin_ctzll(ends));
+            ends &= ends - 1;
+        }
+
+        // Starts and ends now alternate, so pair them off without branching on the state
+        while (ends) {
+            emit(offset + __builtin_ctzll(starts), offset + __builtin_ctzll(ends));
+            starts &= starts - 1;
+            ends &= ends - 1;
+        }
+
+        state.in_token = starts != 0;
+        if (starts) state.start = offset + __builtin_ctzll(starts);
+    }
+
+    detail::delimiter_table _table;
+};
+
+}   // namespace ndash
+
+#undef NDASH_TOKENIZER_X86
+
+#endif   // TOKENIZER_H
@@ -0,0 +1,541 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "cpu_features.h"
+#include "ndstring.h"
+#include "string_view.h"
+#include "vector.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NDASH_UTF8_X86 1
+#endif
+
+// UTF-8 validation and case folding kernels
+//
+// On x86 the kernels check for AVX2 at runtime and process 32 bytes per step, falling back to scalar loops on
+// other machines. Validation follows Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte".
+// Case folding uses the Unicode simple case folding table (statuses C and S) and never changes the number of code
+// points, although a handful of mappings change the encoded length
+namespace ndash::utf8 {
+
+// Largest number of bytes `fold_case` can write for `len` input bytes
+//
+// Only U+023A and U+023E grow when folded, from two bytes to three
+constexpr size_t max_fold_size(size_t len) { return len + len / 2; }
+
+namespace detail {
+
+// Range of code points folding by the same offset. Every `stride`-th code point from `first` to `last` is folded
+struct fold_range {
+    uint32_t first;
+    uint32_t last;
+    int32_t delta;
+    uint32_t stride;
+};
+
+// Generated from CaseFolding.txt (Unicode 14.0), statuses C and S
+inline constexpr fold_range FOLD_RANGES[] = {
+    { 0xB5, 0xB5, 775, 1 }, { 0xC0, 0xD6, 32, 1 }, { 0xD8, 0xDE, 32, 1 }, { 0x100, 0x12E, 1, 2 },
+    { 0x132, 0x136, 1, 2 }, { 0x139, 0x147, 1, 2 }, { 0x14A, 0x176, 1, 2 }, { 0x178, 0x178, -121, 1 },
+    { 0x179, 0x17D, 1, 2 }, { 0x17F, 0x17F, -268, 1 }, { 0x181, 0x181, 210, 1 }, { 0x182, 0x184, 1, 2 },
+    { 0x186, 0x186, 206, 1 }, { 0x187, 0x187, 1, 1 }, { 0x189, 0x18A, 205, 1 }, { 0x18B, 0x18B, 1, 1 },
+    { 0x18E, 0x18E, 79, 1 }, { 0x18F, 0x18F, 202, 1 }, { 0x190, 0x190, 203, 1 }, { 0x191, 0x191, 1, 1 },
+    { 0x193, 0x193, 205, 1 }, { 0x194, 0x194, 207, 1 }, { 0x196, 0x196, 211, 1 }, { 0x197, 0x197, 209, 1 },
+    { 0x198, 0x198, 1, 1 }, { 0x19C, 0x19C, 211, 1 }, { 0x19D, 0x19D, 213, 1 }, { 0x19F, 0x19F, 214, 1 },
+    { 0x1A0, 0x1A4, 1, 2 }, { 0x1A6, 0x1A6, 218, 1 }, { 0x1A7, 0x1A7, 1, 1 }, { 0x1A9, 0x1A9, 218, 1 },
+    { 0x1AC, 0x1AC, 1, 1 }, { 0x1AE, 0x1AE, 218, 1 }, { 0x1AF, 0x1AF, 1, 1 }, { 0x1B1, 0x1B2, 217, 1 },
+    { 0x1B3, 0x1B5, 1, 2 }, { 0x1B7, 0x1B7, 219, 1 }, { 0x1B8, 0x1B8, 1, 1 }, { 0x1BC, 0x1BC, 1, 1 },
+    { 0x1C4, 0x1C4, 2, 1 }, { 0x1C5, 0x1C5, 1, 1 }, { 0x1C7, 0x1C7, 2, 1 }, { 0x1C8, 0x1C8, 1, 1 },
+    { 0x1CA, 0x1CA, 2, 1 }, { 0x1CB, 0x1DB, 1, 2 }, { 0x1DE, 0x1EE, 1, 2 }, { 0x1F1, 0x1F1, 2, 1 },
+    { 0x1F2, 0x1F4, 1, 2 }, { 0x1F6, 0x1F6, -97, 1 }, { 0x1F7, 0x1F7, -56, 1 }, { 0x1F8, 0x21E, 1, 2 },
+    { 0x220, 0x220, -130, 1 }, { 0x222, 0x232, 1, 2 }, { 0x23A, 0x23A, 10795, 1 }, { 0x23B, 0x23B, 1, 1 },
+    { 0x23D, 0x23D, -163, 1 }, { 0x23E, 0x23E, 10792, 1 }, { 0x241, 0x241, 1, 1 }, { 0x243, 0x243, -195, 1 },
+    { 0x244, 0x244, 69, 1 }, { 0x245, 0x245, 71, 1 }, { 0x246, 0x24E, 1, 2 }, { 0x345, 0x345, 116, 1 },
+    { 0x370, 0x372, 1, 2 }, { 0x376, 0x376, 1, 1 }, { 0x37F, 0x37F, 116, 1 }, { 0x386, 0x386, 38, 1 },
+    { 0x388, 0x38A, 37, 1 }, { 0x38C, 0x38C, 64, 1 }, { 0x38E, 0x38F, 63, 1 }, { 0x391, 0x3A1, 32, 1 },
+    { 0x3A3, 0x3AB, 32, 1 }, { 0x3C2, 0x3C2, 1, 1 }, { 0x3CF, 0x3CF, 8, 1 }, { 0x3D0, 0x3D0, -30, 1 },
+    { 0x3D1, 0x3D1, -25, 1 }, { 0x3D5, 0x3D5, -15, 1 }, { 0x3D6, 0x3D6, -22, 1 }, { 0x3D8, 0x3EE, 1, 2 },
+    { 0x3F0, 0x3F0, -54, 1 }, { 0x3F1, 0x3F1, -48, 1 }, { 0x3F4, 0x3F4, -60, 1 }, { 0x3F5, 0x3F5, -64, 1 },
+    { 0x3F7, 0x3F7, 1, 1 }, { 0x3F9, 0x3F9, -7, 1 }, { 0x3FA, 0x3FA, 1, 1 }, { 0x3FD, 0x3FF, -130, 1 },
+    { 0x400, 0x40F, 80, 1 }, { 0x410, 0x42F, 32, 1 }, { 0x460, 0x480, 1, 2 }, { 0x48A, 0x4BE, 1, 2 },
+    { 0x4C0, 0x4C0, 15, 1 }, { 0x4C1, 0x4CD, 1, 2 }, { 0x4D0, 0x52E, 1, 2 }, { 0x531, 0x556, 48, 1 },
+    { 0x10A0, 0x10C5, 7264, 1 }, { 0x10C7, 0x10C7, 7264, 1 }, { 0x10CD, 0x10CD, 7264, 1 }, { 0x13F8, 0x13FD, -8, 1 },
+    { 0x1C80, 0x1C80, -6222, 1 }, { 0x1C81, 0x1C81, -6221, 1 }, { 0x1C82, 0x1C82, -6212, 1 },
+    { 0x1C83, 0x1C84, -6210, 1 }, { 0x1C85, 0x1C85, -6211, 1 }, { 0x1C86, 0x1C86, -6204, 1 },
+    { 0x1C87, 0x1C87, -6180, 1 }, { 0x1C88, 0x1C88, 35267, 1 }, { 0x1C90, 0x1CBA, -3008, 1 },
+    { 0x1CBD, 0x1CBF, -3008, 1 }, { 0x1E00, 0x1E94, 1, 2 }, { 0x1E9B, 0x1E9B, -58, 1 }, { 0x1E9E, 0x1E9E, -7615, 1 },
+    { 0x1EA0, 0x1EFE, 1, 2 }, { 0x1F08, 0x1F0F, -8, 1 }, { 0x1F18, 0x1F1D, -8, 1 }, { 0x1F28, 0x1F2F, -8, 1 },
+    { 0x1F38, 0x1F3F, -8, 1 }, { 0x1F48, 0x1F4D, -8, 1 }, { 0x1F59, 0x1F5F, -8, 2 }, { 0x1F68, 0x1F6F, -8, 1 },
+    { 0x1F88, 0x1F8F, -8, 1 }, { 0x1F98, 0x1F9F, -8, 1 }, { 0x1FA8, 0x1FAF, -8, 1 }, { 0x1FB8, 0x1FB9, -8, 1 },
+    { 0x1FBA, 0x1FBB, -74, 1 }, { 0x1FBC, 0x1FBC, -9, 1 }, { 0x1FBE, 0x1FBE, -7173, 1 }, { 0x1FC8, 0x1FCB, -86, 1 },
+    { 0x1FCC, 0x1FCC, -9, 1 }, { 0x1FD8, 0x1FD9, -8, 1 }, { 0x1FDA, 0x1FDB, -100, 1 }, { 0x1FE8, 0x1FE9, -8, 1 },
+    { 0x1FEA, 0x1FEB, -112, 1 }, { 0x1FEC, 0x1FEC, -7, 1 }, { 0x1FF8, 0x1FF9, -128, 1 }, { 0x1FFA, 0x1FFB, -126, 1 },
+    { 0x1FFC, 0x1FFC, -9, 1 }, { 0x2126, 0x2126, -7517, 1 }, { 0x212A, 0x212A, -8383, 1 },
+    { 0x212B, 0x212B, -8262, 1 }, { 0x2132, 0x2132, 28, 1 }, { 0x2160, 0x216F, 16, 1 }, { 0x2183, 0x2183, 1, 1 },
+    { 0x24B6, 0x24CF, 26, 1 }, { 0x2C00, 0x2C2F, 48, 1 }, { 0x2C60, 0x2C60, 1, 1 }, { 0x2C62, 0x2C62, -10743, 1 },
+    { 0x2C63, 0x2C63, -3814, 1 }, { 0x2C64, 0x2C64, -10727, 1 }, { 0x2C67, 0x2C6B, 1, 2 },
+    { 0x2C6D, 0x2C6D, -10780, 1 }, { 0x2C6E, 0x2C6E, -10749, 1 }, { 0x2C6F, 0x2C6F, -10783, 1 },
+    { 0x2C70, 0x2C70, -10782, 1 }, { 0x2C72, 0x2C72, 1, 1 }, { 0x2C75, 0x2C75, 1, 1 }, { 0x2C7E, 0x2C7F, -10815, 1 },
+    { 0x2C80, 0x2CE2, 1, 2 }, { 0x2CEB, 0x2CED, 1, 2 }, { 0x2CF2, 0x2CF2, 1, 1 }, { 0xA640, 0xA66C, 1, 2 },
+    { 0xA680, 0xA69A, 1, 2 }, { 0xA722, 0xA72E, 1, 2 }, { 0xA732, 0xA76E, 1, 2 }, { 0xA779, 0xA77B, 1, 2 },
+    { 0xA77D, 0xA77D, -35332, 1 }, { 0xA77E, 0xA786, 1, 2 }, { 0xA78B, 0xA78B, 1, 1 }, { 0xA78D, 0xA78D, -42280, 1 },
+    { 0xA790, 0xA792, 1, 2 }, { 0xA796, 0xA7A8, 1, 2 }, { 0xA7AA, 0xA7AA, -42308, 1 }, { 0xA7AB, 0xA7AB, -42319, 1 },
+    { 0xA7AC, 0xA7AC, -42315, 1 }, { 0xA7AD, 0xA7AD, -42305, 1 }, { 0xA7AE, 0xA7AE, -42308, 1 },
+    { 0xA7B0, 0xA7B0, -42258, 1 }, { 0xA7B1, 0xA7B1, -42282, 1 }, { 0xA7B2, 0xA7B2, -42261, 1 },
+    { 0xA7B3, 0xA7B3, 928, 1 }, { 0xA7B4, 0xA7C2, 1, 2 }, { 0xA7C4, 0xA7C4, -48, 1 }, { 0xA7C5, 0xA7C5, -42307, 1 },
+    { 0xA7C6, 0xA7C6, -35384, 1 }, { 0xA7C7, 0xA7C9, 1, 2 }, { 0xA7D0, 0xA7D0, 1, 1 }, { 0xA7D6, 0xA7D8, 1, 2 },
+    { 0xA7F5, 0xA7F5, 1, 1 }, { 0xAB70, 0xABBF, -38864, 1 }, { 0xFF21, 0xFF3A, 32, 1 }, { 0x10400, 0x10427, 40, 1 },
+    { 0x104B0, 0x104D3, 40, 1 }, { 0x10570, 0x1057A, 39, 1 }, { 0x1057C, 0x1058A, 39, 1 },
+    { 0x1058C, 0x10592, 39, 1 }, { 0x10594, 0x10595, 39, 1 }, { 0x10C80, 0x10CB2, 64, 1 },
+    { 0x118A0, 0x118BF, 32, 1 }, { 0x16E40, 0x16E5F, 32, 1 }, { 0x1E900, 0x1E921, 34, 1 },
+};
+
+// Fold a single code point, returning it unchanged if it has no simple case folding
+constexpr char32_t fold_code_point(char32_t cp) {
+    if (cp < 0x80) return (cp >= 'A' && cp <= 'Z') ? cp + 32 : cp;
+    if (cp < 0x100) {
+        if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7) return cp + 32;
+        return cp == 0xB5 ? 0x3BC : cp;
+    }
+
+    // Binary search for the first range ending at or after `cp`
+    size_t lo = 0, hi = sizeof(FOLD_RANGES) / sizeof(FOLD_RANGES[0]);
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (FOLD_RANGES[mid].last < cp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo == sizeof(FOLD_RANGES) / sizeof(FOLD_RANGES[0])) return cp;
+    const fold_range& range = FOLD_RANGES[lo];
+    if (cp < range.first || (cp - range.first) % range.stride) return cp;
+    return static_cast<char32_t>(static_cast<int32_t>(cp) + range.delta);
+}
+
+constexpr char ascii_lower(char ch) { return (ch >= 'A' && ch <= 'Z') ? ch + 32 : ch; }
+
+// Decode the code point starting at `s` with at most `len` bytes available
+//
+// Returns the number of bytes consumed, or 0 if the bytes aren't a valid encoding
+inline size_t decode(const unsigned char* s, size_t len, char32_t& cp) {
+    unsigned char b0 = s[0];
+    if (b0 < 0x80) {
+        cp = b0;
+        return 1;
+    }
+    if (b0 < 0xC2) return 0;
+
+    if (b0 < 0xE0) {
+        if (len < 2 || (s[1] & 0xC0) != 0x80) return 0;
+        cp = (char32_t(b0 & 0x1F) << 6) | (s[1] & 0x3F);
+        return 2;
+    }
+
+    if (b0 < 0xF0) {
+        if (len < 3 || (s[1] & 0xC0) != 0x80 || (s[2] & 0xC0) != 0x80) return 0;
+        if (b0 == 0xE0 && s[1] < 0xA0) return 0;   // Overlong
+        if (b0 == 0xED && s[1] > 0x9F) return 0;   // Surrogate
+        cp = (char32_t(b0 & 0x0F) << 12) | (char32_t(s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+        return 3;
+    }
+
+    if (b0 < 0xF5) {
+        if (len < 4 || (s[1] & 0xC0) != 0x80 || (s[2] & 0xC0) != 0x80 || (s[3] & 0xC0) != 0x80) return 0;
+        if (b0 == 0xF0 && s[1] < 0x90) return 0;   // Overlong
+        if (b0 == 0xF4 && s[1] > 0x8F) return 0;   // Above U+10FFFF
+        cp = (char32_t(b0 & 0x07) << 18) | (char32_t(s[1] & 0x3F) << 12) | (char32_t(s[2] & 0x3F) << 6)
+           | (s[3] & 0x3F);
+        return 4;
+    }
+    return 0;
+}
+
+// Encode `cp` to `out`, returning the number of bytes written
+inline size_t encode(char32_t cp, unsigned char* out) {
+    if (cp < 0x80) {
+        out[0] = static_cast<unsigned char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = static_cast<unsigned char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = static_cast<unsigned char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<unsigned char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<unsigned char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//////////////////////////////// Scalar Kernels ///////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+inline bool validate_scalar(const unsigned char* s, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        if (s[i] < 0x80) {
+            ++i;
+            continue;
+        }
+        char32_t cp;
+        size_t n = decode(s + i, len - i, cp);
+        if (!n) return false;
+        i += n;
+    }
+    return true;
+}
+
+inline void to_lower_ascii_scalar(const char* src, size_t len, char* dst) {
+    for (size_t i = 0; i < len; ++i) dst[i] = ascii_lower(src[i]);
+}
+
+// Fold the code point at `src + in`, writing it to `dst + out`. Bytes that don't decode are copied unchanged
+inline void fold_one(const char* src, size_t len, char* dst, size_t& in, size_t& out) {
+    auto s = reinterpret_cast<const unsigned char*>(src);
+    char32_t cp;
+    size_t n = decode(s + in, len - in, cp);
+    if (!n) {
+        dst[out++] = src[in++];
+        return;
+    }
+
+    // Read the whole sequence before writing in case `dst` aliases `src`
+    in += n;
+    unsigned char buf[4];
+    size_t written = encode(fold_code_point(cp), buf);
+    std::memcpy(dst + out, buf, written);
+    out += written;
+}
+
+inline size_t fold_case_scalar(const char* src, size_t len, char* dst, size_t in = 0, size_t out = 0) {
+    while (in < len) {
+        if (static_cast<unsigned char>(src[in]) < 0x80) {
+            dst[out++] = ascii_lower(src[in++]);
+        } else {
+            fold_one(src, len, dst, in, out);
+        }
+    }
+    return out;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////// AVX2 Kernels ////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef NDASH_UTF8_X86
+
+// Error bits of the Keiser-Lemire lookup tables, indexed by the high and low nibble of the previous byte and the
+// high nibble of the current byte. A pair of bytes is invalid when all three lookups share a set bit
+constexpr uint8_t TOO_SHORT = 1 << 0;        // 11______ 0_______ or 11______ 11______
+constexpr uint8_t TOO_LONG = 1 << 1;         // 0_______ 10______
+constexpr uint8_t OVERLONG_3 = 1 << 2;       // 11100000 100_____
+constexpr uint8_t TOO_LARGE = 1 << 3;        // 11110100 1001____ and above
+constexpr uint8_t SURROGATE = 1 << 4;        // 11101101 101_____
+constexpr uint8_t OVERLONG_2 = 1 << 5;       // 1100000_ 10______
+constexpr uint8_t TOO_LARGE_1000 = 1 << 6;   // 11110101 1000____ and above
+constexpr uint8_t OVERLONG_4 = 1 << 6;       // 11110000 1000____
+constexpr uint8_t TWO_CONTS = 1 << 7;        // 10______ 10______
+constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+__attribute__((target("avx2"))) inline __m256i lookup16(__m256i nibbles, __m256i table) {
+    return _mm256_shuffle_epi8(table, nibbles);
+}
+
+__attribute__((target("avx2"))) inline __m256i high_nibbles(__m256i v) {
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+
+// Bytes of `input` shifted right by `N`, with the last `N` bytes of `prev` moved in
+template <int N>
+__attribute__((target("avx2"))) inline __m256i prev_bytes(__m256i input, __m256i prev) {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+}
+
+constexpr uint8_t ALL_LARGE = CARRY | TOO_LARGE | TOO_LARGE_1000;
+constexpr uint8_t CONT_1000 = TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4;
+constexpr uint8_t CONT_1001 = TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE;
+constexpr uint8_t CONT_101 = TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE;
+
+alignas(16) inline constexpr uint8_t BYTE_1_HIGH[16] = {
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,   // 0_______
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,                                       // 10______
+    TOO_SHORT | OVERLONG_2,                                                           // 1100____
+    TOO_SHORT,                                                                        // 1101____
+    TOO_SHORT | OVERLONG_3 | SURROGATE,                                               // 1110____
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,                              // 1111____
+};
+
+alignas(16) inline constexpr uint8_t BYTE_1_LOW[16] = {
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,   // ____0000
+    CARRY | OVERLONG_2,                             // ____0001
+    CARRY, CARRY,                                   // ____001_
+    CARRY | TOO_LARGE,                              // ____0100
+    ALL_LARGE, ALL_LARGE, ALL_LARGE,                // ____0101 to ____0111
+    ALL_LARGE, ALL_LARGE, ALL_LARGE, ALL_LARGE,     // ____1000 to ____1011
+    ALL_LARGE,                                      // ____1100
+    ALL_LARGE | SURROGATE,                          // ____1101
+    ALL_LARGE, ALL_LARGE,                           // ____111_
+};
+
+alignas(16) inline constexpr uint8_t BYTE_2_HIGH[16] = {
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,   // 0_______
+    CONT_1000,                                                                                // 1000____
+    CONT_1001,                                                                                // 1001____
+    CONT_101, CONT_101,                                                                       // 101_____
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,                                               // 11______
+};
+
+__attribute__((target("avx2"))) inline __m256i load_table(const uint8_t (&table)[16]) {
+    return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+__attribute__((target("avx2"))) inline __m256i check_special_cases(__m256i input, __m256i prev1) {
+    __m256i byte_1_high = lookup16(high_nibbles(prev1), load_table(BYTE_1_HIGH));
+    __m256i byte_1_low = lookup16(_mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)), load_table(BYTE_1_LOW));
+    __m256i byte_2_high = lookup16(high_nibbles(input), load_table(BYTE_2_HIGH));
+    return _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+}
+
+__attribute__((target("avx2"))) inline __m256i check_multibyte_lengths(__m256i input, __m256i prev,
+                                                                       __m256i special_cases) {
+    __m256i prev2 = prev_bytes<2>(input, prev);
+    __m256i prev3 = prev_bytes<3>(input, prev);
+
+    // Only 111_____ two back and 1111____ three back leave the high bit set, marking a required continuation
+    __m256i is_third_byte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xE0 - 0x80)));
+    __m256i is_fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xF0 - 0x80)));
+    __m256i must_be_continuation
+      = _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte), _mm256_set1_epi8(char(0x80)));
+    return _mm256_xor_si256(must_be_continuation, special_cases);
+}
+
+// Flags a block ending in the middle of a multibyte sequence
+__attribute__((target("avx2"))) inline __m256i is_incomplete(__m256i input) {
+    const __m256i max_value = _mm256_setr_epi8(char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF),
+                                               char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF),
+                                               char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF),
+                                               char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF),
+                                               char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF),
+                                               char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1));
+    return _mm256_subs_epu8(input, max_value);
+}
+
+// Running state of the validator between 32 byte blocks
+struct validation_state {
+    __m256i error;
+    __m256i prev_input;
+    __m256i prev_incomplete;
+};
+
+__attribute__((target("avx2"))) inline void validate_block(validation_state& state, __m256i input) {
+    if (_mm256_movemask_epi8(input) == 0) {
+        // An ASCII block is only an error if the previous block ended mid sequence
+        state.error = _mm256_or_si256(state.error, state.prev_incomplete);
+    } else {
+        __m256i prev1 = prev_bytes<1>(input, state.prev_input);
+        __m256i special_cases = check_special_cases(input, prev1);
+        state.error = _mm256_or_si256(state.error, check_multibyte_lengths(input, state.prev_input, special_cases));
+        state.prev_incomplete = is_incomplete(input);
+    }
+    state.prev_input = input;
+}
+
+__attribute__((target("avx2"))) inline bool validate_avx2(const unsigned char* s, size_t len) {
+    validation_state state { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        validate_block(state, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i)));
+    }
+
+    // Pad the tail with ASCII zeros, which also checks that the input doesn't end mid sequence
+    alignas(32) unsigned char tail[32] = {};
+    if (len > i) std::memcpy(tail, s + i, len - i);
+    validate_block(state, _mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+    state.error = _mm256_or_si256(state.error, state.prev_incomplete);
+
+    return _mm256_testz_si256(state.error, state.error);
+}
+
+__attribute__((target("avx2"))) inline __m256i to_lower_ascii_block(__m256i v) {
+    // Bytes at or above 0x80 compare as negative, so only 'A' to 'Z' pass both checks
+    __m256i is_upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                        _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+    return _mm256_or_si256(v, _mm256_and_si256(is_upper, _mm256_set1_epi8(0x20)));
+}
+
+__attribute__((target("avx2"))) inline void to_lower_ascii_avx2(const char* src, size_t len, char* dst) {
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), to_lower_ascii_block(v));
+    }
+    to_lower_ascii_scalar(src + i, len - i, dst + i);
+}
+
+// Safe when `dst == src`, as long as the output hasn't overtaken the input
+__attribute__((target("avx2"))) inline size_t fold_case_avx2(const char* src, size_t len, char* dst) {
+    size_t in = 0, out = 0;
+    while (in + 32 <= len) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + in));
+        unsigned non_ascii = static_cast<unsigned>(_mm256_movemask_epi8(v));
+        if (!non_ascii) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + out), to_lower_ascii_block(v));
+            in += 32;
+            out += 32;
+            continue;
+        }
+
+        // Copy lowered ASCII runs out of the block and fold each multibyte sequence between them
+        alignas(32) char lowered[32];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lowered), to_lower_ascii_block(v));
+
+        size_t block_start = in;
+        size_t i = 0;
+        while (i < 32) {
+            unsigned remaining = non_ascii >> i;
+            size_t run = remaining ? __builtin_ctz(remaining) : 32 - i;
+            std::memcpy(dst + out, lowered + i, run);
+            in += run;
+            out += run;
+            if (!remaining) break;
+
+            fold_one(src, len, dst, in, out);
+            i = in - block_start;
+        }
+    }
+    return fold_case_scalar(src, len, dst, in, out);
+}
+
+#endif   // NDASH_UTF8_X86
+
+// Check if a buffer contains one of the two sequences that grow when folded
+inline bool fold_may_grow(const char* s, size_t len) {
+    const void* it = s;
+    size_t remaining = len;
+    while ((it = std::memchr(it, 0xC8, remaining))) {
+        auto p = static_cast<const unsigned char*>(it);
+        size_t offset = p - reinterpret_cast<const unsigned char*>(s);
+        if (offset + 1 < len && (p[1] == 0xBA || p[1] == 0xBE)) return true;
+        it = p + 1;
+        remaining = len - offset - 1;
+    }
+    return false;
+}
+
+}   // namespace detail
+
+///////////////////////////////////////////////////////////////////////////////
+////////////////////////////////// Validation /////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Check if [ `s`, `s + len` ) is valid UTF-8
+inline bool validate(const char* s, size_t len) {
+    auto bytes = reinterpret_cast<const unsigned char*>(s);
+#ifdef NDASH_UTF8_X86
+    if (cpu::has_avx2()) return detail::validate_avx2(bytes, len);
+#endif
+    return detail::validate_scalar(bytes, len);
+}
+
+// Check if `view` is valid UTF-8. Strings convert to views
+inline bool validate(string_view view) { return validate(view.data(), view.size()); }
+
+///////////////////////////////////////////////////////////////////////////////
+//////////////////////////////// ASCII Lowercase //////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Lowercase the ASCII letters in [ `src`, `src + len` ) into `dst`, copying every other byte unchanged
+inline void to_lower_ascii(const char* src, size_t len, char* dst) {
+#ifdef NDASH_UTF8_X86
+    if (cpu::has_avx2()) return detail::to_lower_ascii_avx2(src, len, dst);
+#endif
+    detail::to_lower_ascii_scalar(src, len, dst);
+}
+
+// Lowercase the ASCII letters in [ `s`, `s + len` ) in place
+inline void to_lower_ascii(char* s, size_t len) { to_lower_ascii(s, len, s); }
+
+// Lowercase the ASCII letters of `view` into `dst`, which must hold `view.size()` bytes
+inline void to_lower_ascii(string_view view, char* dst) { to_lower_ascii(view.data(), view.size(), dst); }
+
+// Lowercase the ASCII letters of `str` in place
+inline void to_lower_ascii(string& str) { to_lower_ascii(str.data(), str.size()); }
+
+///////////////////////////////////////////////////////////////////////////////
+////////////////////////////////// Case Folding ///////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Get the simple case folding of code point `cp`
+constexpr char32_t fold_case(char32_t cp) { return detail::fold_code_point(cp); }
+
+// Fold the case of UTF-8 [ `src`, `src + len` ) into `dst`, returning the number of bytes written
+//
+// `dst` must hold `max_fold_size(len)` bytes and must not overlap `src`. Invalid bytes are copied unchanged
+inline size_t fold_case(const char* src, size_t len, char* dst) {
+#ifdef NDASH_UTF8_X86
+    if (cpu::has_avx2()) return detail::fold_case_avx2(src, len, dst);
+#endif
+    return detail::fold_case_scalar(src, len, dst);
+}
+
+// Fold the case of UTF-8 [ `s`, `s + len` ) in place, returning the new length
+//
+// The buffer must hold `max_fold_size(len)` bytes in case the folded text is longer
+inline size_t fold_case(char* s, size_t len) {
+    if (detail::fold_may_grow(s, len)) {
+        vector<char> copy(s, s + len);
+        return fold_case(copy.data(), len, s);
+    }
+#ifdef NDASH_UTF8_X86
+    if (cpu::has_avx2()) return detail::fold_case_avx2(s, len, s);
+#endif
+    return detail::fold_case_scalar(s, len, s);
+}
+
+// Fold the case of `view` into `dst`, which must hold `max_fold_size(view.size())` bytes
+inline size_t fold_case(string_view view, char* dst) { return fold_case(view.data(), view.size(), dst); }
+
+// Fold the case of `str` in place
+inline void fold_case(string& str) {
+    size_t len = str.size();
+    if (detail::fold_may_grow(str.data(), len)) {
+        string folded;
+        folded.resize(max_fold_size(len));
+        folded.resize(fold_case(str.data(), len, folded.data()));
+        str.swap(folded);
+        return;
+    }
+    str.resize(fold_case(str.data(), len));
+}
+
+// Validate and case fold `str` in place, as done to every token before it is hashed
+//
+// Returns false and leaves `str` unchanged if it isn't valid UTF-8
+inline bool normalize(string& str) {
+    if (!validate(str)) return false;
+    fold_case(str);
+    return true;
+}
+
+}   // namespace ndash::utf8
+
+#undef NDASH_UTF8_X86
+
+#endif   // UTF8_H
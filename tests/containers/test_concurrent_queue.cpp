@@ -0,0 +1,228 @@
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "concurrent_queue.h"
+#include "test_framework.h"
+#include "vector.h"
+
+namespace {
+
+// Counts live instances to check that queued elements are destroyed
+struct tracked {
+    static inline std::atomic<int> live { 0 };
+    int value;
+
+    tracked(int v = 0)
+        : value(v) {
+        ++live;
+    }
+    tracked(const tracked& other) noexcept
+        : value(other.value) {
+        ++live;
+    }
+    tracked& operator=(const tracked&) = default;
+    ~tracked() { --live; }
+};
+
+// Copies throw when `fail` is set, moves never do
+struct fragile {
+    int value;
+    bool fail;
+
+    fragile(int v = 0, bool f = false)
+        : value(v)
+        , fail(f) { }
+    fragile(const fragile& other)
+        : value(other.value)
+        , fail(other.fail) {
+        if (fail) throw 1;
+    }
+    fragile(fragile&&) noexcept = default;
+    fragile& operator=(const fragile&) = default;
+    fragile& operator=(fragile&&) noexcept = default;
+};
+
+}   // namespace
+
+TEST_CASE(ConcurrentQueue) {
+    SECTION(test_mpmc_single_thread) {
+        ndash::mpmc_queue<int> queue(5);
+        REQUIRE_THAT(queue.capacity(), EQ(8));
+        REQUIRE(queue.empty());
+
+        int out = 0;
+        REQUIRE(!queue.try_pop(out));
+        for (int i = 0; i < 8; ++i) {
+            REQUIRE(queue.try_push(i));
+        }
+        REQUIRE(!queue.try_push(8));
+        REQUIRE_THAT(queue.size(), EQ(8));
+
+        for (int i = 0; i < 3; ++i) {
+            REQUIRE(queue.try_pop(out));
+            REQUIRE_THAT(out, EQ(i));
+        }
+
+        // Batches take as much as fits, wrapping around the ring
+        int batch[6] = { 10, 11, 12, 13, 14, 15 };
+        REQUIRE_THAT(queue.try_push_batch(batch, 6), EQ(3));
+        int drained[10];
+        REQUIRE_THAT(queue.try_pop_batch(drained, 10), EQ(8));
+        REQUIRE_THAT(drained[0], EQ(3));
+        REQUIRE_THAT(drained[4], EQ(7));
+        REQUIRE_THAT(drained[7], EQ(12));
+        REQUIRE_THAT(queue.try_pop_batch(drained, 10), EQ(0));
+        REQUIRE(queue.empty());
+    };
+
+    SECTION(test_move_only_and_destruction) {
+        ndash::mpmc_queue<std::unique_ptr<int>> queue(4);
+        std::unique_ptr<int> value(new int(7));
+        REQUIRE(queue.try_push(std::move(value)));
+        REQUIRE(value == nullptr);
+        std::unique_ptr<int> out = queue.pop();
+        REQUIRE_THAT(*out, EQ(7));
+
+        ndash::spsc_ring<std::unique_ptr<int>> ring(4);
+        ring.push(std::unique_ptr<int>(new int(9)));
+        REQUIRE_THAT(*ring.pop(), EQ(9));
+
+        {
+            ndash::mpmc_queue<tracked> q(8);
+            ndash::spsc_ring<tracked> r(8);
+            for (int i = 0; i < 5; ++i) {
+                q.push(tracked(i));
+                r.push(tracked(i));
+            }
+            tracked t;
+            REQUIRE(q.try_pop(t));
+            REQUIRE(r.try_pop(t));
+        }
+        REQUIRE_THAT(tracked::live.load(), EQ(0));
+    };
+
+    SECTION(test_throwing_copy) {
+        // A copy that throws must not claim a cell, or the elements behind it could never be popped
+        ndash::mpmc_queue<fragile> queue(4);
+        const fragile bad(1, true);
+        bool thrown = false;
+        try {
+            queue.try_push(bad);
+        } catch (int) {
+            thrown = true;
+        }
+        REQUIRE(thrown);
+
+        thrown = false;
+        try {
+            queue.push(bad);
+        } catch (int) {
+            thrown = true;
+        }
+        REQUIRE(thrown);
+        REQUIRE(queue.empty());
+
+        const fragile good(2);
+        queue.push(good);
+        REQUIRE(queue.try_push(fragile(3)));
+        fragile out;
+        REQUIRE(queue.try_pop(out));
+        REQUIRE_THAT(out.value, EQ(2));
+        REQUIRE(queue.try_pop(out));
+        REQUIRE_THAT(out.value, EQ(3));
+        REQUIRE(!queue.try_pop(out));
+    };
+
+    SECTION(test_spsc_single_thread) {
+        ndash::spsc_ring<int> ring(3);
+        REQUIRE_THAT(ring.capacity(), EQ(4));
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(ring.try_push(i));
+        }
+        REQUIRE(!ring.try_push(4));
+
+        int out = 0;
+        REQUIRE(ring.try_pop(out));
+        REQUIRE_THAT(out, EQ(0));
+        int batch[3] = { 4, 5, 6 };
+        REQUIRE_THAT(ring.try_push_batch(batch, 3), EQ(1));
+
+        int drained[8];
+        REQUIRE_THAT(ring.try_pop_batch(drained, 8), EQ(4));
+        REQUIRE_THAT(drained[0], EQ(1));
+        REQUIRE_THAT(drained[3], EQ(4));
+        REQUIRE(ring.empty());
+    };
+
+    SECTION(test_mpmc_many_threads) {
+        constexpr int PRODUCERS = 3, CONSUMERS = 3, PER_PRODUCER = 30000;
+        ndash::mpmc_queue<uint32_t> queue(64);
+        std::atomic<uint64_t> sum(0);
+        std::atomic<int> consumed(0);
+
+        ndash::vector<std::thread> threads;
+        for (int p = 0; p < PRODUCERS; ++p) {
+            threads.emplace_back([&queue, p]() {
+                uint32_t batch[16];
+                for (int i = 0; i < PER_PRODUCER;) {
+                    if (i % 1000 < 500) {
+                        queue.push(uint32_t(p * PER_PRODUCER + i++));
+                    } else {
+                        size_t n = 0;
+                        for (; n < 16 && i < PER_PRODUCER; ++n) batch[n] = uint32_t(p * PER_PRODUCER + i++);
+                        queue.push_batch(batch, n);
+                    }
+                }
+            });
+        }
+        for (int c = 0; c < CONSUMERS; ++c) {
+            threads.emplace_back([&]() {
+                uint32_t batch[8];
+                while (consumed.load() < PRODUCERS * PER_PRODUCER) {
+                    size_t n = queue.try_pop_batch(batch, 8);
+                    for (size_t i = 0; i < n; ++i) sum.fetch_add(batch[i]);
+                    consumed.fetch_add(int(n));
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        uint64_t total = uint64_t(PRODUCERS * PER_PRODUCER);
+        REQUIRE_THAT(sum.load(), EQ(total * (total - 1) / 2));
+        REQUIRE(queue.empty());
+    };
+
+    SECTION(test_spsc_order_across_threads) {
+        constexpr uint32_t TOTAL = 200000;
+        ndash::spsc_ring<uint32_t> ring(128);
+        std::thread producer([&ring]() {
+            uint32_t batch[32];
+            for (uint32_t i = 0; i < TOTAL;) {
+                if ((i / 1000) % 2) {
+                    ring.push(i++);
+                } else {
+                    size_t n = 0;
+                    for (; n < 32 && i < TOTAL; ++n) batch[n] = i++;
+                    ring.push_batch(batch, n);
+                }
+            }
+        });
+
+        bool in_order = true;
+        uint32_t expected = 0;
+        uint32_t batch[20];
+        while (expected < TOTAL) {
+            if (expected % 3) {
+                in_order &= ring.pop() == expected++;
+            } else {
+                size_t n = ring.pop_batch(batch, 20);
+                for (size_t i = 0; i < n; ++i) in_order &= batch[i] == expected++;
+            }
+        }
+        producer.join();
+        REQUIRE(in_order);
+        REQUIRE(ring.empty());
+    };
+}
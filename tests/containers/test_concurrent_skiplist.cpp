@@ -0,0 +1,152 @@
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "concurrent_skiplist.h"
+#include "test_framework.h"
+#include "vector.h"
+
+namespace {
+
+// Insert scrambled keys and check lookups and ordered iteration
+template <class List>
+bool sequential_checks() {
+    List list;
+    if (!list.empty() || list.begin() != list.end() || list.contains(1)) return false;
+
+    constexpr uint32_t COUNT = 5000;
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        uint32_t key = (i * 7919u) % COUNT * 2;
+        auto [it, added] = list.insert({ key, key + 1 });
+        if (!added || it->first != key || it->second != key + 1) return false;
+    }
+    if (list.size() != COUNT) return false;
+
+    auto [existing, added] = list.emplace(10, 0u);
+    if (added || existing->second != 11) return false;
+
+    uint32_t expected = 0;
+    for (const auto& entry : list) {
+        if (entry.first != expected || entry.second != expected + 1) return false;
+        expected += 2;
+    }
+    if (expected != COUNT * 2) return false;
+
+    if (list.find(7) != list.end() || list.find(8)->second != 9) return false;
+    if (list.lower_bound(7)->first != 8 || list.lower_bound(COUNT * 2) != list.end()) return false;
+    return list.contains(0) && !list.contains(COUNT * 2);
+}
+
+}   // namespace
+
+TEST_CASE(ConcurrentSkiplist) {
+    SECTION(test_insert_and_lookup) {
+        using heap_list = ndash::concurrent_skiplist<uint32_t, uint32_t>;
+        REQUIRE(sequential_checks<heap_list>());
+        REQUIRE_THAT(heap_list::MAX_HEIGHT, EQ(24));
+    };
+
+    SECTION(test_arena_layout) {
+        using arena_list = ndash::concurrent_skiplist<uint32_t, uint32_t, std::less<uint32_t>, 4>;
+        REQUIRE(sequential_checks<arena_list>());
+        REQUIRE_THAT(arena_list::MAX_HEIGHT, EQ(4));
+    };
+
+    SECTION(test_comparator_and_values) {
+        ndash::concurrent_skiplist<int, std::string, std::greater<int>> list;
+        list.emplace(1, "one");
+        list.emplace(3, "three");
+        list.emplace(2, 3, 'x');
+        REQUIRE(!list.emplace(3, "again").second);
+
+        ndash::vector<int> keys;
+        for (const auto& entry : list) keys.push_back(entry.first);
+        REQUIRE_THAT(keys.size(), EQ(3));
+        REQUIRE_THAT(keys[0], EQ(3));
+        REQUIRE_THAT(keys[2], EQ(1));
+        REQUIRE_THAT(list.find(2)->second, EQ(std::string("xxx")));
+        REQUIRE_THAT(list.find(3)->second, EQ(std::string("three")));
+
+        const auto& view = list;
+        REQUIRE(view.lower_bound(0) == view.end());
+        REQUIRE_THAT(view.lower_bound(2)->first, EQ(2));
+    };
+
+    SECTION(test_concurrent_inserts_and_readers) {
+        constexpr uint32_t WRITERS = 4;
+        constexpr uint32_t PER_WRITER = 20000;
+        ndash::concurrent_skiplist<uint32_t, uint32_t, std::less<uint32_t>, 8> list;
+        std::atomic<uint32_t> writers_left(WRITERS);
+        std::atomic<bool> unordered(false);
+        std::atomic<bool> wrong_value(false);
+
+        ndash::vector<std::thread> threads;
+        for (uint32_t t = 0; t < 2; ++t) {
+            threads.emplace_back([&]() {
+                while (writers_left.load()) {
+                    uint32_t previous = 0;
+                    bool first = true;
+                    for (const auto& entry : list) {
+                        if (!first && entry.first <= previous) unordered.store(true);
+                        if (entry.second != entry.first * 3) wrong_value.store(true);
+                        previous = entry.first;
+                        first = false;
+                    }
+                }
+            });
+        }
+        // Writers interleave their keys and all try to add the same duplicates
+        for (uint32_t t = 0; t < WRITERS; ++t) {
+            threads.emplace_back([&, t]() {
+                for (uint32_t i = 0; i < PER_WRITER; ++i) {
+                    uint32_t key = ((i * 7919u) % PER_WRITER) * WRITERS + t;
+                    list.insert({ key, key * 3 });
+                    list.insert({ i % 64, (i % 64) * 3 });
+                }
+                writers_left.fetch_sub(1);
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+
+        REQUIRE(!unordered.load());
+        REQUIRE(!wrong_value.load());
+        REQUIRE_THAT(list.size(), EQ(WRITERS * PER_WRITER));
+        uint32_t expected = 0;
+        bool dense = true;
+        for (const auto& entry : list) dense = dense && entry.first == expected++;
+        REQUIRE(dense);
+        REQUIRE_THAT(expected, EQ(WRITERS * PER_WRITER));
+    };
+
+    SECTION(test_concurrent_arena_inserts) {
+        // Many writers into an empty arena race to add each of its blocks
+        constexpr uint32_t WRITERS = 8;
+        constexpr uint32_t PER_WRITER = 25000;
+        using arena_list = ndash::concurrent_skiplist<uint64_t, uint64_t, std::less<uint64_t>, 12>;
+        arena_list list;
+
+        ndash::vector<std::thread> writers;
+        for (uint32_t t = 0; t < WRITERS; ++t) {
+            writers.emplace_back([&, t]() {
+                for (uint64_t i = 0; i < PER_WRITER; ++i) {
+                    uint64_t key = i * WRITERS + t;
+                    list.insert({ key, ~key });
+                }
+            });
+        }
+        for (std::thread& writer : writers) writer.join();
+
+        REQUIRE_THAT(list.size(), EQ(WRITERS * PER_WRITER));
+        uint64_t expected = 0;
+        bool intact = true;
+        for (const auto& entry : list) {
+            intact = intact && entry.first == expected && entry.second == ~expected;
+            ++expected;
+        }
+        REQUIRE(intact);
+        REQUIRE_THAT(expected, EQ(uint64_t(WRITERS) * PER_WRITER));
+        REQUIRE(list.find(uint64_t(WRITERS) * PER_WRITER - 1)->second == ~(uint64_t(WRITERS) * PER_WRITER - 1));
+    };
+}
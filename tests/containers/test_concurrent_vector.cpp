@@ -0,0 +1,176 @@
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+
+#include "concurrent_vector.h"
+#include "ndstring.h"
+#include "test_framework.h"
+#include "vector.h"
+
+namespace {
+
+// Element whose construction throws for negative values
+struct checked {
+    static inline int alive = 0;
+    int value;
+
+    explicit checked(int v)
+        : value(v) {
+        if (v < 0) throw std::invalid_argument("negative");
+        ++alive;
+    }
+    ~checked() { --alive; }
+};
+
+// Element large enough that a first block of 2^44 of them can't be allocated
+struct huge {
+    char bytes[1 << 20];
+};
+
+}   // namespace
+
+TEST_CASE(ConcurrentVector) {
+    SECTION(test_single_thread) {
+        ndash::concurrent_vector<int, 2> vec;
+
+        REQUIRE(vec.empty());
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE_THAT(vec.push_back(i * 2), EQ((size_t) i));
+        }
+
+        REQUIRE_THAT(vec.size(), EQ(100));
+        REQUIRE_THAT(vec.reserved_size(), EQ(100));
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE_THAT(vec[i], EQ(i * 2));
+        }
+
+        int expected = 0;
+        for (int value : vec) {
+            REQUIRE_THAT(value, EQ(expected));
+            expected += 2;
+        }
+    };
+
+    SECTION(test_references_stay_valid) {
+        ndash::concurrent_vector<ndash::string, 1> vec;
+
+        size_t index = vec.emplace_back("first");
+        const ndash::string* address = &vec[index];
+        for (int i = 0; i < 1000; ++i) vec.emplace_back(3, 'x');
+
+        REQUIRE_THAT(&vec[0], EQ(address));
+        REQUIRE_THAT(vec[0], EQ("first"));
+        REQUIRE_THAT(vec[1000], EQ("xxx"));
+
+        vec.clear();
+        REQUIRE(vec.empty());
+        vec.emplace_back("again");
+        REQUIRE_THAT(vec[0], EQ("again"));
+        REQUIRE_THAT(vec.size(), EQ(1));
+    };
+
+    SECTION(test_failed_construction_is_skipped) {
+        {
+            ndash::concurrent_vector<checked, 1> vec;
+            vec.emplace_back(1);
+            bool thrown = false;
+            try {
+                vec.emplace_back(-1);
+            } catch (const std::invalid_argument&) {
+                thrown = true;
+            }
+            REQUIRE(thrown);
+            vec.emplace_back(3);
+
+            // Later elements still publish past the failed slot
+            REQUIRE_THAT(vec.size(), EQ(3));
+            REQUIRE(vec.constructed(0));
+            REQUIRE(!vec.constructed(1));
+            REQUIRE(vec.constructed(2));
+            REQUIRE_THAT(vec[2].value, EQ(3));
+            REQUIRE_THAT(checked::alive, EQ(2));
+
+            vec.clear();
+            REQUIRE_THAT(checked::alive, EQ(0));
+            vec.emplace_back(4);
+            REQUIRE(vec.constructed(0));
+        }
+        REQUIRE_THAT(checked::alive, EQ(0));
+    };
+
+    SECTION(test_failed_block_allocation_is_skipped) {
+        ndash::concurrent_vector<huge, 44> vec;
+        for (int i = 0; i < 3; ++i) {
+            bool thrown = false;
+            try {
+                vec.emplace_back();
+            } catch (const std::bad_alloc&) {
+                thrown = true;
+            }
+            REQUIRE(thrown);
+        }
+
+        // The failed slots publish, so a reader isn't held at the first of them
+        REQUIRE_THAT(vec.reserved_size(), EQ(3));
+        REQUIRE_THAT(vec.size(), EQ(3));
+        REQUIRE(!vec.constructed(0));
+        REQUIRE(!vec.constructed(2));
+
+        vec.clear();
+        REQUIRE(vec.empty());
+    };
+
+    SECTION(test_concurrent_push_back) {
+        constexpr const size_t num_threads = 4;
+        constexpr const size_t per_thread = 20000;
+
+        ndash::concurrent_vector<size_t, 3> vec;
+        ndash::vector<std::thread> threads;
+        for (size_t t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&vec, t]() {
+                for (size_t i = 0; i < per_thread; ++i) vec.push_back(t * per_thread + i);
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        REQUIRE_THAT(vec.size(), EQ(num_threads * per_thread));
+
+        ndash::vector<bool> seen(num_threads * per_thread, false);
+        for (size_t value : vec) seen[value] = true;
+        for (size_t i = 0; i < seen.size(); ++i) {
+            REQUIRE(seen[i]);
+        }
+    };
+
+    SECTION(test_reads_during_appends) {
+        constexpr const size_t num_writers = 3;
+        constexpr const size_t per_thread = 20000;
+
+        ndash::concurrent_vector<size_t, 2> vec;
+        std::atomic<bool> done = false;
+        std::atomic<size_t> bad_reads = 0;
+
+        std::thread reader([&]() {
+            while (!done.load()) {
+                size_t size = vec.size();
+                for (size_t i = size > 64 ? size - 64 : 0; i < size; ++i) {
+                    if (vec[i] % 7 != 0) bad_reads++;
+                }
+            }
+        });
+
+        ndash::vector<std::thread> writers;
+        for (size_t t = 0; t < num_writers; ++t) {
+            writers.emplace_back([&vec]() {
+                for (size_t i = 0; i < per_thread; ++i) vec.push_back(i * 7);
+            });
+        }
+        for (auto& writer : writers) writer.join();
+        done = true;
+        reader.join();
+
+        REQUIRE_THAT(bad_reads.load(), EQ(0));
+        REQUIRE_THAT(vec.size(), EQ(num_writers * per_thread));
+    };
+}
@@ -0,0 +1,156 @@
+#include <cstddef>
+#include <random>
+
+#include "dynamic_bitset.h"
+#include "test_framework.h"
+#include "vector.h"
+
+TEST_CASE(DynamicBitset) {
+    SECTION(test_construction) {
+        ndash::dynamic_bitset empty;
+        REQUIRE(empty.empty());
+        REQUIRE_THAT(empty.count(), EQ(0));
+        REQUIRE_THAT(empty.find_first(), EQ(ndash::dynamic_bitset::npos));
+
+        ndash::dynamic_bitset ones(130, true);
+        REQUIRE_THAT(ones.size(), EQ(130));
+        REQUIRE_THAT(ones.num_words(), EQ(3));
+        REQUIRE_THAT(ones.count(), EQ(130));
+        REQUIRE(ones.all());
+        REQUIRE_THAT(ones.data()[2], EQ(3u));
+    };
+
+    SECTION(test_set_reset_flip) {
+        ndash::dynamic_bitset bits(200);
+
+        bits.set(0).set(63).set(64).set(199);
+        REQUIRE(bits.test(63));
+        REQUIRE(bits[64]);
+        REQUIRE(!bits[65]);
+        REQUIRE_THAT(bits.count(), EQ(4));
+
+        bits.reset(63).flip(65).set(1, true).set(0, false);
+        REQUIRE(!bits[63]);
+        REQUIRE(bits[65]);
+        REQUIRE(bits[1]);
+        REQUIRE(!bits[0]);
+        REQUIRE_THAT(bits.count(), EQ(4));
+
+        bits.flip();
+        REQUIRE_THAT(bits.count(), EQ(196));
+        bits.reset();
+        REQUIRE(bits.none());
+        bits.set();
+        REQUIRE(bits.all());
+    };
+
+    SECTION(test_find_and_iterate) {
+        ndash::dynamic_bitset bits(1000);
+        size_t positions[] = { 3, 64, 65, 500, 999 };
+        for (size_t pos : positions) bits.set(pos);
+
+        size_t index = 0;
+        for (size_t pos = bits.find_first(); pos != ndash::dynamic_bitset::npos; pos = bits.find_next(pos)) {
+            REQUIRE_THAT(pos, EQ(positions[index++]));
+        }
+        REQUIRE_THAT(index, EQ(5));
+
+        ndash::vector<size_t> seen;
+        bits.for_each_set([&](size_t pos) { seen.push_back(pos); });
+        REQUIRE_THAT(seen.size(), EQ(5));
+        REQUIRE_THAT(seen[4], EQ(999));
+        REQUIRE_THAT(bits.find_next(999), EQ(ndash::dynamic_bitset::npos));
+    };
+
+    SECTION(test_resize_and_push_back) {
+        ndash::dynamic_bitset bits;
+        for (int i = 0; i < 70; ++i) bits.push_back(i % 2 == 0);
+        REQUIRE_THAT(bits.size(), EQ(70));
+        REQUIRE_THAT(bits.count(), EQ(35));
+
+        bits.resize(200, true);
+        REQUIRE_THAT(bits.count(), EQ(35 + 130));
+        REQUIRE(bits[70]);
+        REQUIRE(bits[199]);
+
+        bits.resize(65);
+        REQUIRE_THAT(bits.count(), EQ(33));
+        bits.resize(128);
+        REQUIRE_THAT(bits.count(), EQ(33));
+
+        bits.clear();
+        REQUIRE(bits.empty());
+    };
+
+    SECTION(test_combine_matches_scalar) {
+        std::mt19937_64 rng(11);
+        for (size_t size : { 1, 63, 64, 65, 255, 256, 257, 1000, 4099 }) {
+            ndash::dynamic_bitset a(size);
+            ndash::dynamic_bitset b(size);
+            for (size_t i = 0; i < size; ++i) {
+                if (rng() % 3 == 0) a.set(i);
+                if (rng() % 2 == 0) b.set(i);
+            }
+
+            size_t expect_and = 0, expect_or = 0, expect_xor = 0, expect_and_not = 0;
+            for (size_t i = 0; i < size; ++i) {
+                expect_and += a[i] && b[i];
+                expect_or += a[i] || b[i];
+                expect_xor += a[i] != b[i];
+                expect_and_not += a[i] && !b[i];
+            }
+
+            REQUIRE_THAT((a & b).count(), EQ(expect_and));
+            REQUIRE_THAT((a | b).count(), EQ(expect_or));
+            REQUIRE_THAT((a ^ b).count(), EQ(expect_xor));
+            REQUIRE_THAT(and_not(a, b).count(), EQ(expect_and_not));
+            REQUIRE_THAT(a.count_and(b), EQ(expect_and));
+            REQUIRE_THAT(a.count_and_not(b), EQ(expect_and_not));
+
+            ndash::dynamic_bitset c(a);
+            c &= b;
+            REQUIRE(c == (a & b));
+            c = a;
+            c |= b;
+            REQUIRE(c == (a | b));
+            c = a;
+            c ^= b;
+            REQUIRE(c == (a ^ b));
+            c = a;
+            c.and_not(b);
+            REQUIRE(c == and_not(a, b));
+
+            for (size_t i = 0; i < size; ++i) {
+                REQUIRE_THAT(c[i], EQ(a[i] && !b[i]));
+            }
+        }
+    };
+
+    SECTION(test_select) {
+        uint64_t word = 0x8000000100010001ull;
+        REQUIRE_THAT(ndash::detail::select_in_word(word, 0), EQ(0u));
+        REQUIRE_THAT(ndash::detail::select_in_word(word, 2), EQ(32u));
+        REQUIRE_THAT(ndash::detail::select_in_word(word, 3), EQ(63u));
+        REQUIRE_THAT(ndash::detail::select_in_word_scalar(word, 3), EQ(63u));
+
+        std::mt19937_64 rng(9);
+        ndash::dynamic_bitset bits(2000);
+        for (size_t i = 0; i < bits.size(); ++i) bits.set(i, rng() % 3 == 0);
+
+        // Every set and clear bit is found by its rank, starting from any earlier position
+        size_t ones = 0, zeros = 0;
+        bool all_match = true;
+        for (size_t i = 0; i < bits.size(); ++i) {
+            if (bits[i]) {
+                all_match &= ndash::detail::select_bits<false>(bits.data(), 0, ones) == i;
+                all_match &= ndash::detail::select_bits_scalar<false>(bits.data(), 0, ones) == i;
+                ++ones;
+            } else {
+                all_match &= ndash::detail::select_bits<true>(bits.data(), 0, zeros) == i;
+                all_match &= ndash::detail::select_bits<true>(bits.data(), i, 0) == i;
+                ++zeros;
+            }
+        }
+        REQUIRE(all_match);
+    };
+}
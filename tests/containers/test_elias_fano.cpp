@@ -0,0 +1,146 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+
+#include "elias_fano.h"
+#include "test_framework.h"
+#include "vector.h"
+
+namespace {
+
+ndash::vector<uint32_t> random_sorted(std::mt19937_64& rng, size_t count, uint32_t max_gap) {
+    ndash::vector<uint32_t> values;
+    uint32_t value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        value += uint32_t(rng() % (max_gap + 1));
+        values.push_back(value);
+    }
+    return values;
+}
+
+}   // namespace
+
+TEST_CASE(EliasFano) {
+    SECTION(test_construction) {
+        ndash::elias_fano empty;
+        REQUIRE(empty.empty());
+        REQUIRE(empty.begin() == empty.end());
+        REQUIRE(empty.next_geq(0) == empty.end());
+
+        ndash::elias_fano small { 3, 4, 7, 13, 14, 15, 21, 43 };
+        REQUIRE_THAT(small.size(), EQ(8));
+        REQUIRE_THAT(small.universe(), EQ(44));
+        REQUIRE_THAT(small.low_bits(), EQ(2u));
+        REQUIRE_THAT(small.front(), EQ(3u));
+        REQUIRE_THAT(small[3], EQ(13u));
+        REQUIRE_THAT(small.back(), EQ(43u));
+
+        ndash::elias_fano single { 0xFFFFFFFF };
+        REQUIRE_THAT(single.low_bits(), EQ(32u));
+        REQUIRE_THAT(single[0], EQ(0xFFFFFFFFu));
+        REQUIRE_THAT(*single.next_geq(5), EQ(0xFFFFFFFFu));
+
+        // Dense values need no low bits
+        ndash::elias_fano dense { 0, 1, 1, 2, 3, 5 };
+        REQUIRE_THAT(dense.low_bits(), EQ(0u));
+        REQUIRE_THAT(dense[2], EQ(1u));
+        REQUIRE_THAT(dense.back(), EQ(5u));
+        REQUIRE_THAT(*dense.next_geq(4), EQ(5u));
+
+        ndash::vector<uint32_t> values = { 2, 9, 40 };
+        ndash::elias_fano wide(values, 1000);
+        REQUIRE_THAT(wide.universe(), EQ(1000));
+        REQUIRE_THAT(wide[2], EQ(40u));
+        ndash::elias_fano full(values, uint64_t(1) << 32);
+        REQUIRE_THAT(full[1], EQ(9u));
+        for (uint64_t universe : { uint64_t(40), uint64_t(7), (uint64_t(1) << 32) + 1, uint64_t(1) << 63 }) {
+            bool thrown = false;
+            try {
+                ndash::elias_fano invalid(values, universe);
+            } catch (const std::invalid_argument&) {
+                thrown = true;
+            }
+            REQUIRE(thrown);
+        }
+    };
+
+    SECTION(test_access_and_iteration) {
+        std::mt19937_64 rng(1);
+        uint32_t gaps[] = { 0, 1, 3, 100, 100000 };
+        for (uint32_t gap : gaps) {
+            ndash::vector<uint32_t> values = random_sorted(rng, 5000, gap);
+            ndash::elias_fano ef(values);
+
+            bool all_match = true;
+            for (size_t i = 0; i < values.size(); ++i) all_match &= ef[i] == values[i];
+            REQUIRE(all_match);
+
+            size_t index = 0;
+            for (auto it = ef.begin(); it != ef.end(); ++it, ++index) {
+                all_match &= *it == values[index] && it.index() == index;
+            }
+            REQUIRE(all_match);
+            REQUIRE_THAT(index, EQ(values.size()));
+        }
+    };
+
+    SECTION(test_next_geq) {
+        std::mt19937_64 rng(2);
+        ndash::vector<uint32_t> values = random_sorted(rng, 3000, 50);
+        ndash::elias_fano ef(values);
+
+        bool all_match = true;
+        for (uint32_t target = 0; target <= values.back() + 2; ++target) {
+            size_t expected = 0;
+            while (expected < values.size() && values[expected] < target) ++expected;
+            auto it = ef.next_geq(target);
+            all_match &= it.index() == expected && ef.lower_bound(target) == expected;
+            if (expected < values.size()) all_match &= *it == values[expected];
+        }
+        REQUIRE(all_match);
+        REQUIRE(ef.next_geq(values.back() + 1) == ef.end());
+    };
+
+    SECTION(test_skip_to_intersection) {
+        std::mt19937_64 rng(3);
+        ndash::vector<uint32_t> a = random_sorted(rng, 20000, 20);
+        ndash::vector<uint32_t> b = random_sorted(rng, 2000, 200);
+        ndash::elias_fano ef_a(a), ef_b(b);
+
+        ndash::vector<uint32_t> expected;
+        for (size_t i = 0, j = 0; i < a.size() && j < b.size();) {
+            if (a[i] < b[j]) {
+                ++i;
+            } else if (b[j] < a[i]) {
+                ++j;
+            } else {
+                if (expected.empty() || expected.back() != a[i]) expected.push_back(a[i]);
+                ++i;
+                ++j;
+            }
+        }
+
+        // Leapfrog the sparse list through the dense one
+        ndash::vector<uint32_t> found;
+        auto it_a = ef_a.begin();
+        for (auto it_b = ef_b.begin(); it_b != ef_b.end(); ++it_b) {
+            it_a.skip_to(*it_b);
+            if (it_a == ef_a.end()) break;
+            if (*it_a == *it_b && (found.empty() || found.back() != *it_a)) found.push_back(*it_a);
+        }
+        REQUIRE_THAT(found.size(), EQ(expected.size()));
+        bool all_match = true;
+        for (size_t i = 0; i < found.size(); ++i) all_match &= found[i] == expected[i];
+        REQUIRE(all_match);
+    };
+
+    SECTION(test_space) {
+        std::mt19937_64 rng(4);
+        ndash::vector<uint32_t> values = random_sorted(rng, 100000, 64);
+        ndash::elias_fano ef(values);
+
+        // About 2 + log2(32) bits per value, against 32 for a plain array
+        REQUIRE(ef.memory_usage() * 8 < values.size() * 8);
+    };
+}
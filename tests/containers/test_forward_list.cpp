@@ -283,4 +283,34 @@ TEST_CASE(ForwardList) {
         REQUIRE_THAT(*(++list.begin()), EQ(4));
         REQUIRE_THAT(list.back(), EQ(4));
     };
+
+    SECTION(test_assign) {
+        ndash::forward_list<int> list = { 1, 2, 3 };
+        auto first = list.begin();
+
+        int longer[] = { 4, 5, 6, 7, 8 };
+        list.assign(longer, longer + 5);
+        REQUIRE_THAT(list.size(), EQ(5));
+        REQUIRE(list.begin() == first);
+        REQUIRE_THAT(list.front(), EQ(4));
+        REQUIRE_THAT(list.back(), EQ(8));
+
+        list = { 9, 10 };
+        REQUIRE_THAT(list.size(), EQ(2));
+        REQUIRE(list.begin() == first);
+        REQUIRE_THAT(list.back(), EQ(10));
+
+        ndash::forward_list<int> other = { 11 };
+        list = other;
+        REQUIRE_THAT(list.size(), EQ(1));
+        REQUIRE_THAT(list.front(), EQ(11));
+        REQUIRE_THAT(list.back(), EQ(11));
+
+        list.assign(longer, longer);
+        REQUIRE(list.empty());
+
+        list.push_back(1);
+        REQUIRE_THAT(list.front(), EQ(1));
+        REQUIRE_THAT(list.back(), EQ(1));
+    };
 }
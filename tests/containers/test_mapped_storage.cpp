@@ -0,0 +1,97 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "mapped_storage.h"
+#include "ndstring.h"
+#include "test_framework.h"
+#include "vector.h"
+
+// Small threshold so tests cross into mapped storage quickly
+using small_mapped_storage = ndash::mapped_storage<4096>;
+
+TEST_CASE(MappedStorage) {
+    SECTION(test_small_vectors_use_heap) {
+        ndash::mapped_vector<uint32_t> vec = { 1, 2, 3 };
+
+        REQUIRE_THAT(vec.size(), EQ(3));
+        REQUIRE_THAT(vec.capacity(), EQ(3));
+        REQUIRE_THAT(vec[2], EQ(3u));
+    };
+
+    SECTION(test_growth_keeps_contents) {
+        ndash::vector<uint32_t, small_mapped_storage> vec;
+        for (uint32_t i = 0; i < 1000000; ++i) vec.push_back(i * 7);
+
+        REQUIRE_THAT(vec.size(), EQ(1000000));
+        REQUIRE_THAT(reinterpret_cast<uintptr_t>(vec.data()) % small_mapped_storage::HUGE_PAGE_SIZE, EQ(0u));
+        for (uint32_t i = 0; i < 1000000; i += 97) {
+            REQUIRE_THAT(vec[i], EQ(i * 7));
+        }
+
+        vec.insert(vec.begin(), 5, 9u);
+        REQUIRE_THAT(vec.size(), EQ(1000005));
+        REQUIRE_THAT(vec[4], EQ(9u));
+        REQUIRE_THAT(vec[5], EQ(0u));
+        REQUIRE_THAT(vec.back(), EQ(999999u * 7));
+    };
+
+    SECTION(test_shrink_releases_pages) {
+        ndash::vector<uint64_t, small_mapped_storage> vec(1 << 20, 5);
+
+        vec.resize(100);
+        REQUIRE_THAT(vec.size(), EQ(100));
+        REQUIRE_THAT(vec.capacity(), EQ(1 << 20));
+        REQUIRE_THAT(vec[99], EQ(5u));
+
+        // Pages handed back read as zero before they are written again
+        vec.resize(1 << 20, 6);
+        REQUIRE_THAT(vec[100], EQ(6u));
+        REQUIRE_THAT(vec.back(), EQ(6u));
+
+        vec.resize(1000);
+        vec.shrink_to_fit();
+        REQUIRE_THAT(vec.capacity(), EQ(1000));
+        REQUIRE_THAT(vec[999], EQ(6u));
+
+        vec.resize(10);
+        vec.shrink_to_fit();
+        REQUIRE_THAT(vec.capacity(), EQ(10));
+        REQUIRE_THAT(vec[0], EQ(5u));
+
+        vec.clear();
+        vec.shrink_to_fit();
+        REQUIRE_THAT(vec.capacity(), EQ(0));
+        REQUIRE(vec.data() == nullptr);
+    };
+
+    SECTION(test_non_trivial_elements) {
+        ndash::vector<ndash::string, small_mapped_storage> vec;
+        for (int i = 0; i < 2000; ++i) {
+            char buf[16];
+            int len = snprintf(buf, sizeof(buf), "%d", i);
+            vec.emplace_back(buf, len);
+        }
+
+        REQUIRE_THAT(vec.size(), EQ(2000));
+        REQUIRE_THAT(vec[0], EQ("0"));
+        REQUIRE_THAT(vec[1999], EQ("1999"));
+
+        vec.erase(vec.begin(), vec.begin() + 1000);
+        REQUIRE_THAT(vec.front(), EQ("1000"));
+    };
+
+    SECTION(test_copy_and_move) {
+        ndash::vector<int, small_mapped_storage> vec(10000, 3);
+        ndash::vector<int, small_mapped_storage> copy(vec);
+        ndash::vector<int, small_mapped_storage> moved(std::move(vec));
+
+        REQUIRE_THAT(copy.size(), EQ(10000));
+        REQUIRE_THAT(moved.size(), EQ(10000));
+        REQUIRE_THAT(copy[9999], EQ(3));
+        REQUIRE(copy.data() != moved.data());
+
+        copy = { 1, 2 };
+        REQUIRE_THAT(copy.size(), EQ(2));
+    };
+}
@@ -0,0 +1,56 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "ndstring.h"
+#include "numa.h"
+#include "numa_storage.h"
+#include "test_framework.h"
+#include "vector.h"
+
+// Small threshold so tests cross into mapped storage quickly
+using small_numa_storage = ndash::numa_storage<4096>;
+
+TEST_CASE(NumaStorage) {
+    SECTION(test_vector_lands_on_scope_node) {
+        int node = ndash::numa::node_id(ndash::numa::node_count() - 1);
+        ndash::vector<uint64_t, small_numa_storage> vec;
+        {
+            ndash::numa::placement_scope place(node);
+            vec.resize(1 << 20, 3);
+        }
+        REQUIRE_THAT(ndash::numa::node_of(vec.data()), EQ(node));
+        REQUIRE_THAT(ndash::numa::node_of(&vec.back()), EQ(node));
+
+        // Remapped growth outside the scope keeps the node
+        for (uint64_t i = 0; i < (1 << 20); ++i) vec.push_back(i);
+        REQUIRE_THAT(vec.size(), EQ(size_t(2) << 20));
+        REQUIRE_THAT(vec[5], EQ(3u));
+        REQUIRE_THAT(vec.back(), EQ((1u << 20) - 1));
+        REQUIRE_THAT(ndash::numa::node_of(&vec.back()), EQ(node));
+    };
+
+    SECTION(test_small_and_unscoped_vectors) {
+        ndash::numa_vector<uint32_t> small = { 1, 2, 3 };
+        REQUIRE_THAT(small[2], EQ(3u));
+
+        ndash::vector<uint32_t, small_numa_storage> unscoped(100000, 7);
+        REQUIRE_THAT(unscoped[99999], EQ(7u));
+        REQUIRE(ndash::numa::node_of(unscoped.data()) >= 0);
+    };
+
+    SECTION(test_non_trivial_elements) {
+        ndash::numa::placement_scope place(ndash::numa::node_id(0));
+        ndash::vector<ndash::string, small_numa_storage> vec;
+        for (int i = 0; i < 2000; ++i) {
+            char buf[16];
+            int len = snprintf(buf, sizeof(buf), "%d", i);
+            vec.emplace_back(buf, len);
+        }
+
+        REQUIRE_THAT(vec.size(), EQ(2000));
+        REQUIRE_THAT(vec[0], EQ("0"));
+        REQUIRE_THAT(vec[1999], EQ("1999"));
+        REQUIRE_THAT(ndash::numa::node_of(vec.data()), EQ(ndash::numa::node_id(0)));
+    };
+}
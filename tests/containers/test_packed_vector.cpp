@@ -0,0 +1,139 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+
+#include "packed_vector.h"
+#include "test_framework.h"
+#include "vector.h"
+
+TEST_CASE(PackedVector) {
+    SECTION(test_construction) {
+        ndash::packed_vector<7> fixed;
+        REQUIRE(fixed.empty());
+        REQUIRE_THAT(fixed.width(), EQ(7u));
+        REQUIRE_THAT(fixed.max_value(), EQ(127u));
+        REQUIRE_THAT(fixed.num_words(), EQ(0));
+
+        ndash::packed_vector<5> filled(100, 17);
+        REQUIRE_THAT(filled.size(), EQ(100));
+        REQUIRE_THAT(filled.num_words(), EQ(9));
+        REQUIRE_THAT(filled[0], EQ(17u));
+        REQUIRE_THAT(filled[99], EQ(17u));
+
+        ndash::packed_vector<> runtime(12, 10, 4095);
+        REQUIRE_THAT(runtime.width(), EQ(12u));
+        REQUIRE_THAT(runtime.back(), EQ(4095u));
+
+        ndash::packed_vector<3> list { 1, 2, 3, 9 };
+        REQUIRE_THAT(list.size(), EQ(4));
+        REQUIRE_THAT(list[3], EQ(1u));
+
+        REQUIRE_THAT(ndash::packed_vector<>::width_for(0), EQ(1u));
+        REQUIRE_THAT(ndash::packed_vector<>::width_for(255), EQ(8u));
+        REQUIRE_THAT(ndash::packed_vector<>::width_for(256), EQ(9u));
+        REQUIRE_THAT(ndash::packed_vector<>::width_for(0xFFFFFFFF), EQ(32u));
+
+        ndash::packed_vector<> widest(32, 2, 0xFFFFFFFF);
+        REQUIRE_THAT(widest[1], EQ(0xFFFFFFFFu));
+        for (unsigned width : { 0u, 33u, 64u }) {
+            bool thrown = false;
+            try {
+                ndash::packed_vector<> invalid(width);
+            } catch (const std::invalid_argument&) {
+                thrown = true;
+            }
+            REQUIRE(thrown);
+        }
+    };
+
+    SECTION(test_get_set_every_width) {
+        std::mt19937_64 rng(1);
+        for (unsigned width = 1; width <= 32; ++width) {
+            ndash::packed_vector<> packed(width);
+            ndash::vector<uint32_t> expected;
+            uint32_t mask = uint32_t((uint64_t(1) << width) - 1);
+            for (int i = 0; i < 300; ++i) {
+                uint32_t value = uint32_t(rng()) & mask;
+                packed.push_back(value);
+                expected.push_back(value);
+            }
+
+            // Overwrite neighbours of straddling values to check nothing else changes
+            for (size_t i = 0; i < expected.size(); i += 3) {
+                expected[i] = uint32_t(rng()) & mask;
+                packed.set(i, expected[i]);
+            }
+
+            bool all_match = true;
+            for (size_t i = 0; i < expected.size(); ++i) all_match &= packed[i] == expected[i];
+            REQUIRE(all_match);
+        }
+    };
+
+    SECTION(test_truncation) {
+        ndash::packed_vector<4> packed(3);
+        packed.set(1, 0x1F);
+        REQUIRE_THAT(packed[0], EQ(0u));
+        REQUIRE_THAT(packed[1], EQ(0xFu));
+        REQUIRE_THAT(packed[2], EQ(0u));
+    };
+
+    SECTION(test_unpack) {
+        std::mt19937_64 rng(2);
+        unsigned widths[] = { 1, 5, 7, 12, 17, 25, 26, 31, 32 };
+        for (unsigned width : widths) {
+            ndash::packed_vector<> packed(width);
+            uint32_t mask = uint32_t((uint64_t(1) << width) - 1);
+            for (int i = 0; i < 1000; ++i) packed.push_back(uint32_t(rng()) & mask);
+
+            // Unaligned starts and lengths mix the 64-value blocks with the scalar tail
+            size_t starts[] = { 0, 1, 63, 500 };
+            for (size_t start : starts) {
+                size_t count = packed.size() - start;
+                ndash::vector<uint32_t> out(count);
+                packed.unpack(start, count, out.data());
+
+                bool all_match = true;
+                for (size_t i = 0; i < count; ++i) all_match &= out[i] == packed[start + i];
+                REQUIRE(all_match);
+            }
+        }
+    };
+
+    SECTION(test_resize_pop_and_equality) {
+        ndash::packed_vector<9> a;
+        for (uint32_t i = 0; i < 200; ++i) a.push_back(i * 3);
+        ndash::packed_vector<9> b = a;
+        REQUIRE(a == b);
+
+        a.resize(50);
+        REQUIRE_THAT(a.size(), EQ(50));
+        REQUIRE_THAT(a.back(), EQ(147u));
+        a.resize(60, 5);
+        REQUIRE_THAT(a[49], EQ(147u));
+        REQUIRE_THAT(a[59], EQ(5u));
+
+        b.resize(50);
+        b.resize(60, 5);
+        REQUIRE(a == b);
+
+        b.pop_back();
+        REQUIRE(!(a == b));
+        b.push_back(5);
+        REQUIRE(a == b);
+
+        uint32_t values[] = { 1, 2, 3 };
+        a.append(values, values + 3);
+        REQUIRE_THAT(a.size(), EQ(63));
+        REQUIRE_THAT(a.back(), EQ(3u));
+
+        a.clear();
+        REQUIRE(a.empty());
+    };
+
+    SECTION(test_memory) {
+        ndash::packed_vector<10> packed(100000, 1000);
+        REQUIRE(packed.memory_usage() < 100000 * sizeof(uint32_t) / 3);
+    };
+}
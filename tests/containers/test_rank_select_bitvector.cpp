@@ -0,0 +1,87 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+#include "dynamic_bitset.h"
+#include "rank_select_bitvector.h"
+#include "test_framework.h"
+#include "vector.h"
+
+namespace {
+
+// Compare every rank and select against a linear count
+bool check_all(const ndash::rank_select_bitvector& rs, const ndash::vector<uint8_t>& bits) {
+    bool ok = true;
+    size_t ones = 0, zeros = 0;
+    for (size_t i = 0; i < bits.size(); ++i) {
+        ok &= rs.rank1(i) == ones && rs.rank0(i) == zeros && rs[i] == bool(bits[i]);
+        if (bits[i]) {
+            ok &= rs.select1(ones++) == i;
+        } else {
+            ok &= rs.select0(zeros++) == i;
+        }
+    }
+    ok &= rs.rank1(bits.size()) == ones && rs.count() == ones;
+    return ok;
+}
+
+}   // namespace
+
+TEST_CASE(RankSelectBitvector) {
+    SECTION(test_empty_and_small) {
+        ndash::rank_select_bitvector empty;
+        REQUIRE(empty.empty());
+        REQUIRE_THAT(empty.count(), EQ(0));
+
+        bool values[] = { true, false, false, true, true };
+        ndash::rank_select_bitvector small(values, values + 5);
+        REQUIRE_THAT(small.size(), EQ(5));
+        REQUIRE_THAT(small.count(), EQ(3));
+        REQUIRE_THAT(small.rank1(4), EQ(2));
+        REQUIRE_THAT(small.rank0(5), EQ(2));
+        REQUIRE_THAT(small.select1(2), EQ(4));
+        REQUIRE_THAT(small.select0(1), EQ(2));
+    };
+
+    SECTION(test_densities) {
+        std::mt19937_64 rng(1);
+        unsigned densities[] = { 0, 1, 10, 50, 90, 99, 100 };
+        size_t sizes[] = { 511, 512, 513, 20000 };
+        for (unsigned density : densities) {
+            for (size_t size : sizes) {
+                ndash::vector<uint8_t> bits(size, 0);
+                for (auto& bit : bits) bit = rng() % 100 < density;
+                ndash::rank_select_bitvector rs(bits.begin(), bits.end());
+                REQUIRE(check_all(rs, bits));
+            }
+        }
+    };
+
+    SECTION(test_from_words_and_bitset) {
+        std::mt19937_64 rng(2);
+        ndash::dynamic_bitset bitset(100000);
+        ndash::vector<uint8_t> bits(bitset.size(), 0);
+        for (size_t i = 0; i < bitset.size(); ++i) {
+            // Long runs of ones and zeros stretch the distance between select samples
+            bits[i] = (i / 3000) % 2 ? rng() % 100 < 95 : rng() % 100 < 2;
+            bitset.set(i, bits[i]);
+        }
+
+        ndash::rank_select_bitvector from_bitset(bitset);
+        REQUIRE(check_all(from_bitset, bits));
+
+        // Bits past `num_bits` in the last word are ignored
+        ndash::vector<uint64_t> words = { ~uint64_t(0), ~uint64_t(0) };
+        ndash::rank_select_bitvector from_words(words.data(), 70);
+        REQUIRE_THAT(from_words.count(), EQ(70));
+        REQUIRE_THAT(from_words.select1(69), EQ(69));
+        REQUIRE_THAT(from_words.rank1(70), EQ(70));
+    };
+
+    SECTION(test_overhead) {
+        ndash::dynamic_bitset bitset(1 << 20);
+        for (size_t i = 0; i < bitset.size(); i += 2) bitset.set(i);
+        ndash::rank_select_bitvector rs(bitset);
+        REQUIRE(rs.memory_usage() < size_t(1 << 20) / 8 * 13 / 10);
+    };
+}
@@ -0,0 +1,216 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+#include "roaring_bitmap.h"
+#include "test_framework.h"
+#include "vector.h"
+
+namespace {
+
+// Reference set of values in [0, `universe`), as one flag per value
+ndash::vector<uint8_t> random_flags(std::mt19937_64& rng, size_t universe, unsigned percent) {
+    ndash::vector<uint8_t> flags(universe, 0);
+    for (size_t i = 0; i < universe; ++i) flags[i] = rng() % 100 < percent;
+    return flags;
+}
+
+ndash::roaring_bitmap from_flags(const ndash::vector<uint8_t>& flags) {
+    ndash::vector<uint32_t> values;
+    for (size_t i = 0; i < flags.size(); ++i) {
+        if (flags[i]) values.push_back(uint32_t(i));
+    }
+    ndash::roaring_bitmap bitmap;
+    bitmap.add_many(values.data(), values.size());
+    return bitmap;
+}
+
+bool matches(const ndash::roaring_bitmap& bitmap, const ndash::vector<uint8_t>& flags) {
+    ndash::vector<uint32_t> values = bitmap.to_vector();
+    size_t expected = 0;
+    for (size_t i = 0; i < flags.size(); ++i) expected += flags[i];
+    if (values.size() != expected || bitmap.cardinality() != expected) return false;
+    for (uint32_t value : values) {
+        if (value >= flags.size() || !flags[value]) return false;
+    }
+    return true;
+}
+
+}   // namespace
+
+TEST_CASE(RoaringBitmap) {
+    SECTION(test_add_remove_contains) {
+        ndash::roaring_bitmap bitmap;
+        REQUIRE(bitmap.empty());
+        REQUIRE(bitmap.add(5));
+        REQUIRE(!bitmap.add(5));
+        REQUIRE(bitmap.add(70000));
+        REQUIRE(bitmap.add(0xFFFFFFFF));
+        REQUIRE_THAT(bitmap.num_containers(), EQ(3));
+        REQUIRE_THAT(bitmap.cardinality(), EQ(3));
+        REQUIRE(bitmap.contains(70000));
+        REQUIRE(!bitmap.contains(70001));
+
+        REQUIRE(bitmap.remove(70000));
+        REQUIRE(!bitmap.remove(70000));
+        REQUIRE_THAT(bitmap.num_containers(), EQ(2));
+
+        ndash::vector<uint32_t> values = bitmap.to_vector();
+        REQUIRE_THAT(values.size(), EQ(2));
+        REQUIRE_THAT(values[0], EQ(5u));
+        REQUIRE_THAT(values[1], EQ(0xFFFFFFFFu));
+    };
+
+    SECTION(test_array_bitmap_conversion) {
+        ndash::roaring_bitmap bitmap;
+        for (uint32_t i = 0; i < 5000; ++i) bitmap.add(i * 2);
+        REQUIRE_THAT(bitmap.cardinality(), EQ(5000));
+        REQUIRE(bitmap.contains(9998));
+        REQUIRE(!bitmap.contains(9999));
+
+        // Dropping back under 4096 values returns to a sorted array
+        for (uint32_t i = 0; i < 1000; ++i) bitmap.remove(i * 2);
+        REQUIRE_THAT(bitmap.cardinality(), EQ(4000));
+        REQUIRE(bitmap.memory_usage() < 4000 * sizeof(uint16_t) + 1024);
+        REQUIRE(bitmap.contains(2000));
+        REQUIRE(!bitmap.contains(1998));
+
+        // A range overlapping values already present stays an array when the union is small enough
+        ndash::roaring_bitmap overlapping;
+        for (uint32_t i = 0; i < 1000; ++i) overlapping.add(i * 2);
+        overlapping.add_range(0, 3501);
+        REQUIRE_THAT(overlapping.cardinality(), EQ(3501));
+        REQUIRE(overlapping.memory_usage() < 3501 * sizeof(uint16_t) + 1024);
+        REQUIRE(overlapping.contains(3500));
+        REQUIRE(!overlapping.contains(3501));
+    };
+
+    SECTION(test_add_many_unsorted) {
+        std::mt19937_64 rng(1);
+        ndash::vector<uint8_t> flags(300000, 0);
+        ndash::vector<uint32_t> values;
+        for (int i = 0; i < 50000; ++i) {
+            uint32_t value = uint32_t(rng() % flags.size());
+            flags[value] = 1;
+            values.push_back(value);
+        }
+
+        ndash::roaring_bitmap bitmap;
+        bitmap.add_many(values.data(), values.size() / 2);
+        bitmap.add_many(values.data() + values.size() / 2, values.size() - values.size() / 2);
+        REQUIRE(matches(bitmap, flags));
+    };
+
+    SECTION(test_ranges_and_runs) {
+        ndash::roaring_bitmap bitmap;
+        bitmap.add_range(65530, 200000);
+        REQUIRE_THAT(bitmap.cardinality(), EQ(200000 - 65530));
+        REQUIRE(bitmap.contains(65530));
+        REQUIRE(bitmap.contains(199999));
+        REQUIRE(!bitmap.contains(200000));
+        REQUIRE(!bitmap.contains(65529));
+        REQUIRE(bitmap.memory_usage() < 1024);
+
+        // Modifying a run container converts it
+        REQUIRE(bitmap.remove(100000));
+        REQUIRE(!bitmap.contains(100000));
+        REQUIRE_THAT(bitmap.cardinality(), EQ(200000 - 65530 - 1));
+
+        ndash::roaring_bitmap dense;
+        for (uint32_t i = 0; i < 60000; ++i) dense.add(i);
+        size_t before = dense.memory_usage();
+        REQUIRE(dense.run_optimize());
+        REQUIRE(dense.memory_usage() < before / 10);
+        REQUIRE_THAT(dense.cardinality(), EQ(60000));
+        REQUIRE(dense.contains(59999));
+        REQUIRE(!dense.contains(60000));
+
+        ndash::roaring_bitmap sparse { 1, 100, 1000 };
+        REQUIRE(!sparse.run_optimize());
+    };
+
+    SECTION(test_set_operations) {
+        std::mt19937_64 rng(2);
+        const size_t universe = 400000;
+        unsigned densities[] = { 1, 10, 60 };
+
+        for (unsigned da : densities) {
+            for (unsigned db : densities) {
+                ndash::vector<uint8_t> fa = random_flags(rng, universe, da);
+                ndash::vector<uint8_t> fb = random_flags(rng, universe, db);
+                ndash::roaring_bitmap a = from_flags(fa);
+                ndash::roaring_bitmap b = from_flags(fb);
+
+                ndash::vector<uint8_t> f_and(universe, 0), f_or(universe, 0), f_sub(universe, 0);
+                for (size_t i = 0; i < universe; ++i) {
+                    f_and[i] = fa[i] & fb[i];
+                    f_or[i] = fa[i] | fb[i];
+                    f_sub[i] = fa[i] & !fb[i];
+                }
+
+                REQUIRE(matches(a & b, f_and));
+                REQUIRE(matches(a | b, f_or));
+                REQUIRE(matches(a - b, f_sub));
+
+                // Run containers take part through conversion
+                ndash::roaring_bitmap runs;
+                runs.add_range(1000, 150000);
+                ndash::vector<uint8_t> f_runs(universe, 0);
+                for (size_t i = 1000; i < 150000; ++i) f_runs[i] = 1;
+                for (size_t i = 0; i < universe; ++i) f_and[i] = fa[i] & f_runs[i];
+                REQUIRE(matches(a & runs, f_and));
+
+                ndash::roaring_bitmap c = a;
+                c &= b;
+                REQUIRE(c == (a & b));
+                c |= a;
+                REQUIRE(c == a);
+                c -= a;
+                REQUIRE(c.empty());
+            }
+        }
+    };
+
+    SECTION(test_array_intersection) {
+        // Arrays with matches at every offset within blocks of 8
+        ndash::roaring_bitmap a, b;
+        for (uint32_t i = 0; i < 3000; ++i) a.add(i * 3);
+        for (uint32_t i = 0; i < 2000; ++i) b.add(i * 4);
+        ndash::roaring_bitmap both = a & b;
+        REQUIRE_THAT(both.cardinality(), EQ(667));
+        both.for_each([&](uint32_t value) { REQUIRE_THAT(value % 12, EQ(0u)); });
+
+        // Very different sizes use galloping
+        ndash::roaring_bitmap few { 3, 300, 3001 };
+        REQUIRE_THAT((few & a).cardinality(), EQ(2));
+    };
+
+    SECTION(test_equality) {
+        ndash::roaring_bitmap a, b;
+        a.add_range(0, 70000);
+        for (uint32_t i = 0; i < 70000; ++i) b.add(i);
+        REQUIRE(a == b);
+        b.remove(5);
+        REQUIRE(!(a == b));
+    };
+
+    SECTION(test_serialization) {
+        std::mt19937_64 rng(3);
+        ndash::roaring_bitmap bitmap = from_flags(random_flags(rng, 300000, 20));
+        for (uint32_t i = 0; i < 100; ++i) bitmap.add(1000000 + i * 7);
+        bitmap.add_range(5000000, 5100000);
+
+        ndash::vector<char> bytes(bitmap.serialized_size());
+        bitmap.serialize(bytes.data());
+
+        ndash::roaring_bitmap copy;
+        REQUIRE(ndash::roaring_bitmap::deserialize(bytes.data(), bytes.size(), copy));
+        REQUIRE(copy == bitmap);
+        REQUIRE_THAT(copy.cardinality(), EQ(bitmap.cardinality()));
+
+        REQUIRE(!ndash::roaring_bitmap::deserialize(bytes.data(), bytes.size() - 1, copy));
+        REQUIRE(copy.empty());
+        bytes[0] ^= 1;
+        REQUIRE(!ndash::roaring_bitmap::deserialize(bytes.data(), bytes.size(), copy));
+    };
+}
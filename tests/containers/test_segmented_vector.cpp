@@ -0,0 +1,124 @@
+#include <cstddef>
+
+#include "ndstring.h"
+#include "segmented_vector.h"
+#include "test_framework.h"
+#include "vector.h"
+
+TEST_CASE(SegmentedVector) {
+    SECTION(test_empty) {
+        ndash::segmented_vector<int> vec;
+
+        REQUIRE(vec.empty());
+        REQUIRE_THAT(vec.size(), EQ(0));
+        REQUIRE_THAT(vec.capacity(), EQ(0));
+        REQUIRE(vec.begin() == vec.end());
+    };
+
+    SECTION(test_block_sizes) {
+        ndash::segmented_vector<int, 2> vec;
+
+        vec.push_back(0);
+        REQUIRE_THAT(vec.capacity(), EQ(4));
+        for (int i = 1; i < 12; ++i) vec.push_back(i);
+        REQUIRE_THAT(vec.num_blocks(), EQ(2));
+        REQUIRE_THAT(vec.capacity(), EQ(12));
+
+        vec.push_back(12);
+        REQUIRE_THAT(vec.num_blocks(), EQ(3));
+        REQUIRE_THAT(vec.capacity(), EQ(28));
+
+        for (int i = 0; i < 13; ++i) {
+            REQUIRE_THAT(vec[i], EQ(i));
+        }
+    };
+
+    SECTION(test_references_stay_valid) {
+        ndash::segmented_vector<int, 3> vec;
+
+        int& first = vec.emplace_back(42);
+        int* address = &first;
+        for (int i = 0; i < 100000; ++i) vec.push_back(i);
+
+        REQUIRE_THAT(&vec[0], EQ(address));
+        REQUIRE_THAT(first, EQ(42));
+        REQUIRE_THAT(vec.back(), EQ(99999));
+    };
+
+    SECTION(test_iteration) {
+        ndash::segmented_vector<size_t, 4> vec;
+        for (size_t i = 0; i < 5000; ++i) vec.push_back(i * 2);
+
+        size_t expected = 0;
+        for (auto value : vec) {
+            REQUIRE_THAT(value, EQ(expected * 2));
+            ++expected;
+        }
+        REQUIRE_THAT(expected, EQ(5000));
+
+        auto it = vec.begin() + 1000;
+        REQUIRE_THAT(*it, EQ(2000));
+        REQUIRE_THAT(it[17], EQ(2034));
+        --it;
+        REQUIRE_THAT(*it, EQ(1998));
+        it += 2500;
+        REQUIRE_THAT(*it, EQ(6998));
+        REQUIRE_THAT(vec.end() - it, EQ(1501));
+
+        const auto& cvec = vec;
+        ndash::segmented_vector<size_t, 4>::const_iterator cit = vec.begin();
+        REQUIRE(cit == cvec.begin());
+        REQUIRE_THAT(*(cvec.end() - 1), EQ(9998));
+
+        ndash::vector<size_t> copy(vec.begin(), vec.end());
+        REQUIRE_THAT(copy.size(), EQ(5000));
+        REQUIRE_THAT(copy[4999], EQ(9998));
+    };
+
+    SECTION(test_non_trivial) {
+        ndash::segmented_vector<ndash::string, 1> vec = { "a", "b", "c" };
+        vec.emplace_back(3, 'd');
+        vec.push_back("e");
+
+        REQUIRE_THAT(vec.size(), EQ(5));
+        REQUIRE_THAT(vec[3], EQ("ddd"));
+
+        ndash::segmented_vector<ndash::string, 1> copy(vec);
+        vec.pop_back();
+        REQUIRE_THAT(vec.size(), EQ(4));
+        REQUIRE_THAT(copy.size(), EQ(5));
+        REQUIRE_THAT(copy.back(), EQ("e"));
+
+        ndash::segmented_vector<ndash::string, 1> moved(std::move(copy));
+        REQUIRE(copy.empty());
+        REQUIRE_THAT(moved[4], EQ("e"));
+
+        copy = moved;
+        moved = std::move(vec);
+        REQUIRE_THAT(copy.size(), EQ(5));
+        REQUIRE_THAT(moved.size(), EQ(4));
+        REQUIRE_THAT(moved.front(), EQ("a"));
+    };
+
+    SECTION(test_resize_and_shrink) {
+        ndash::segmented_vector<int, 2> vec(30, 7);
+        REQUIRE_THAT(vec.size(), EQ(30));
+        REQUIRE_THAT(vec.num_blocks(), EQ(4));
+
+        vec.resize(5);
+        vec.shrink_to_fit();
+        REQUIRE_THAT(vec.num_blocks(), EQ(2));
+        REQUIRE_THAT(vec[4], EQ(7));
+
+        vec.resize(8);
+        REQUIRE_THAT(vec[7], EQ(0));
+
+        vec.clear();
+        vec.shrink_to_fit();
+        REQUIRE_THAT(vec.capacity(), EQ(0));
+
+        vec.reserve(100);
+        REQUIRE_THAT(vec.capacity(), GT(99));
+        REQUIRE(vec.empty());
+    };
+}
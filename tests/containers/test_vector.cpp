@@ -1,5 +1,7 @@
 #include <cstddef>
 
+#include "forward_list.h"
+#include "ndstring.h"
 #include "pair.h"
 #include "test_framework.h"
 #include "vector.h"
@@ -307,4 +309,172 @@ TEST_CASE(Vector) {
             REQUIRE_THAT(it->second, EQ(index + 3));
         }
     };
+
+    SECTION(test_range_constructor_dispatch) {
+        static_assert(ndash::contiguous_iterator<int*>);
+        static_assert(ndash::contiguous_iterator<ndash::vector<int>::const_iterator>);
+        static_assert(!ndash::contiguous_iterator<ndash::forward_list<int>::iterator>);
+
+        int raw[] = { 1, 2, 3, 4, 5 };
+        ndash::vector<int> from_pointers(raw, raw + 5);
+        REQUIRE_THAT(from_pointers.size(), EQ(5));
+        REQUIRE_THAT(from_pointers.capacity(), EQ(5));
+
+        ndash::vector<int> from_iterators(from_pointers.begin() + 1, from_pointers.end());
+        REQUIRE_THAT(from_iterators.size(), EQ(4));
+        REQUIRE_THAT(from_iterators.capacity(), EQ(4));
+        REQUIRE_THAT(from_iterators[0], EQ(2));
+        REQUIRE_THAT(from_iterators[3], EQ(5));
+
+        ndash::forward_list<int> list = { 7, 8, 9 };
+        ndash::vector<int> from_list(list.begin(), list.end());
+        REQUIRE_THAT(from_list.size(), EQ(3));
+        REQUIRE_THAT(from_list[2], EQ(9));
+
+        ndash::vector<long> widened(raw, raw + 5);
+        REQUIRE_THAT(widened.capacity(), EQ(5));
+        REQUIRE_THAT(widened[4], EQ(5l));
+    };
+
+    SECTION(test_assign) {
+        ndash::vector<int> vec = { 1, 2, 3, 4, 5, 6 };
+        auto* storage = vec.data();
+
+        int raw[] = { 9, 8, 7 };
+        vec.assign(raw, raw + 3);
+        REQUIRE_THAT(vec.size(), EQ(3));
+        REQUIRE_THAT(vec.data(), EQ(storage));
+        REQUIRE_THAT(vec[0], EQ(9));
+        REQUIRE_THAT(vec[2], EQ(7));
+
+        vec.assign({ 1, 2, 3, 4, 5, 6, 7, 8 });
+        REQUIRE_THAT(vec.size(), EQ(8));
+        REQUIRE_THAT(vec.capacity(), EQ(8));
+        REQUIRE_THAT(vec[7], EQ(8));
+
+        ndash::vector<ndash::string> strings = { "a", "b" };
+        ndash::string words[] = { "x", "y", "z" };
+        strings.assign(words, words + 3);
+        REQUIRE_THAT(strings.size(), EQ(3));
+        REQUIRE_THAT(strings[2], EQ("z"));
+    };
+
+    SECTION(test_insert) {
+        ndash::vector<int> vec = { 1, 2, 6 };
+
+        auto it = vec.insert(vec.begin() + 2, 5);
+        REQUIRE_THAT(*it, EQ(5));
+        REQUIRE_THAT(vec.size(), EQ(4));
+
+        int middle[] = { 3, 4 };
+        it = vec.insert(vec.begin() + 2, middle, middle + 2);
+        REQUIRE_THAT(it - vec.begin(), EQ(2));
+        REQUIRE_THAT(vec.size(), EQ(6));
+        for (int i = 0; i < 6; ++i) {
+            REQUIRE_THAT(vec[i], EQ(i + 1));
+        }
+
+        vec.insert(vec.begin(), 2, 0);
+        REQUIRE_THAT(vec.size(), EQ(8));
+        REQUIRE_THAT(vec[0], EQ(0));
+        REQUIRE_THAT(vec[1], EQ(0));
+        REQUIRE_THAT(vec[2], EQ(1));
+
+        vec.insert(vec.end(), { 7, 8 });
+        REQUIRE_THAT(vec.size(), EQ(10));
+        REQUIRE_THAT(vec.back(), EQ(8));
+
+        // Inserting an element of the vector itself must copy it before shifting
+        vec.insert(vec.begin(), vec[9]);
+        REQUIRE_THAT(vec.front(), EQ(8));
+        REQUIRE_THAT(vec.back(), EQ(8));
+
+        ndash::forward_list<int> list = { 100, 101, 102 };
+        it = vec.insert(vec.begin() + 1, list.begin(), list.end());
+        REQUIRE_THAT(*it, EQ(100));
+        REQUIRE_THAT(vec[3], EQ(102));
+        REQUIRE_THAT(vec.size(), EQ(14));
+    };
+
+    SECTION(test_insert_non_trivial) {
+        ndash::vector<ndash::string> vec = { "a", "d" };
+        ndash::string middle[] = { "b", "c" };
+
+        vec.insert(vec.begin() + 1, middle, middle + 2);
+        vec.emplace(vec.end(), "e");
+        vec.emplace(vec.begin(), 3, 'z');
+
+        REQUIRE_THAT(vec.size(), EQ(6));
+        REQUIRE_THAT(vec[0], EQ("zzz"));
+        REQUIRE_THAT(vec[1], EQ("a"));
+        REQUIRE_THAT(vec[2], EQ("b"));
+        REQUIRE_THAT(vec[3], EQ("c"));
+        REQUIRE_THAT(vec[4], EQ("d"));
+        REQUIRE_THAT(vec[5], EQ("e"));
+
+        vec.erase(vec.begin(), vec.begin() + 2);
+        REQUIRE_THAT(vec.size(), EQ(4));
+        REQUIRE_THAT(vec[0], EQ("b"));
+        REQUIRE_THAT(vec[3], EQ("e"));
+    };
+
+    SECTION(test_erase) {
+        ndash::vector<int> vec = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+        auto it = vec.erase(vec.begin() + 2);
+        REQUIRE_THAT(*it, EQ(3));
+        REQUIRE_THAT(vec.size(), EQ(7));
+
+        it = vec.erase(vec.begin() + 1, vec.begin() + 4);
+        REQUIRE_THAT(*it, EQ(5));
+        REQUIRE_THAT(vec.size(), EQ(4));
+        REQUIRE_THAT(vec[0], EQ(0));
+        REQUIRE_THAT(vec[1], EQ(5));
+        REQUIRE_THAT(vec[3], EQ(7));
+
+        it = vec.erase(vec.begin() + 2, vec.end());
+        REQUIRE(it == vec.end());
+        REQUIRE_THAT(vec.size(), EQ(2));
+
+        it = vec.erase(vec.begin(), vec.begin());
+        REQUIRE(it == vec.begin());
+        REQUIRE_THAT(vec.size(), EQ(2));
+    };
+
+    SECTION(test_erase_if) {
+        ndash::vector<int> vec;
+        for (int i = 0; i < 100; ++i) vec.push_back(i);
+
+        size_t removed = erase_if(vec, [](int x) { return x % 3 != 0; });
+        REQUIRE_THAT(removed, EQ(66));
+        REQUIRE_THAT(vec.size(), EQ(34));
+        for (size_t i = 0; i < vec.size(); ++i) {
+            REQUIRE_THAT(vec[i], EQ(int(i * 3)));
+        }
+
+        ndash::vector<ndash::string> words = { "keep", "drop", "keep", "drop" };
+        erase_if(words, [](const ndash::string& w) { return w == "drop"; });
+        REQUIRE_THAT(words.size(), EQ(2));
+        REQUIRE_THAT(words[1], EQ("keep"));
+    };
+
+    SECTION(test_append_range) {
+        ndash::vector<int> vec = { 1, 2 };
+        ndash::vector<int> more = { 3, 4, 5, 6, 7 };
+
+        vec.append_range(more);
+        REQUIRE_THAT(vec.size(), EQ(7));
+        REQUIRE_THAT(vec.capacity(), EQ(7));
+        REQUIRE_THAT(vec[6], EQ(7));
+
+        vec.append_range(more.begin(), more.begin() + 1);
+        REQUIRE_THAT(vec.size(), EQ(8));
+        REQUIRE_THAT(vec.capacity(), EQ(14));
+        REQUIRE_THAT(vec.back(), EQ(3));
+
+        ndash::forward_list<int> list = { 9, 10 };
+        vec.append_range(list);
+        REQUIRE_THAT(vec.size(), EQ(10));
+        REQUIRE_THAT(vec.back(), EQ(10));
+    };
 }
@@ -0,0 +1,159 @@
+#include <cstdint>
+#include <functional>
+
+#include "algorithm.h"
+#include "pair.h"
+#include "test_framework.h"
+#include "vector.h"
+
+namespace {
+
+// Deterministic pseudo-random values
+struct lcg {
+    uint64_t state;
+
+    uint32_t operator()() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return uint32_t(state >> 33);
+    }
+};
+
+// Inputs that defeat naive quicksorts: random, sorted, reversed, all equal, organ pipe, few distinct, sawtooth
+ndash::vector<int> pattern(int kind, size_t n, uint64_t seed) {
+    lcg rng { seed };
+    ndash::vector<int> values;
+    for (size_t i = 0; i < n; ++i) {
+        int index = int(i), size = int(n);
+        switch (kind) {
+        case 0: values.push_back(int(rng() % 1000000)); break;
+        case 1: values.push_back(index); break;
+        case 2: values.push_back(size - index); break;
+        case 3: values.push_back(7); break;
+        case 4: values.push_back(index < size / 2 ? index : size - index); break;
+        case 5: values.push_back(int(rng() % 4)); break;
+        default: values.push_back(index % 37); break;
+        }
+    }
+    return values;
+}
+
+// Sum of squares, as a cheap check that sorting permuted the values
+long long checksum(const ndash::vector<int>& values) {
+    long long sum = 0;
+    for (int value : values) sum += (long long) value * value;
+    return sum;
+}
+
+}   // namespace
+
+TEST_CASE(Algorithm) {
+    SECTION(test_sort_patterns) {
+        for (int kind = 0; kind < 7; ++kind) {
+            for (size_t n : { 0, 1, 2, 5, 23, 24, 100, 129, 1000, 20000 }) {
+                ndash::vector<int> values = pattern(kind, n, n + kind);
+                long long before = checksum(values);
+                ndash::sort(values.begin(), values.end());
+                REQUIRE(ndash::is_sorted(values.begin(), values.end()));
+                REQUIRE_THAT(checksum(values), EQ(before));
+            }
+        }
+    };
+
+    SECTION(test_sort_pointers_and_comparators) {
+        lcg rng { 3 };
+        ndash::vector<double> values;
+        for (int i = 0; i < 5000; ++i) values.push_back(double(rng() % 1000) / 7.0);
+
+        ndash::sort(values.data(), values.data() + values.size(), std::greater<>());
+        REQUIRE(ndash::is_sorted(values.data(), values.data() + values.size(), std::greater<>()));
+
+        // A custom comparator takes the branching partition
+        auto by_last_digit = [](double a, double b) { return int(a * 7) % 10 < int(b * 7) % 10; };
+        ndash::sort(values.begin(), values.end(), by_last_digit);
+        REQUIRE(ndash::is_sorted(values.begin(), values.end(), by_last_digit));
+    };
+
+    SECTION(test_sort_pairs) {
+        lcg rng { 11 };
+        ndash::vector<ndash::pair<float, uint32_t>> hits;
+        for (uint32_t doc = 0; doc < 3000; ++doc) hits.push_back({ float(rng() % 50), doc });
+
+        auto by_score = [](const auto& a, const auto& b) { return a.first > b.first; };
+        ndash::sort(hits.begin(), hits.end(), by_score);
+        REQUIRE(ndash::is_sorted(hits.begin(), hits.end(), by_score));
+
+        ndash::sort(hits.begin(), hits.end());
+        for (size_t i = 1; i < hits.size(); ++i) {
+            REQUIRE(hits[i - 1] < hits[i]);
+        }
+    };
+
+    SECTION(test_stable_sort) {
+        for (int kind = 0; kind < 7; ++kind) {
+            ndash::vector<int> keys = pattern(kind, 5000, kind + 1);
+            ndash::vector<ndash::pair<int, uint32_t>> entries;
+            for (uint32_t i = 0; i < keys.size(); ++i) entries.push_back({ keys[i] % 100, i });
+
+            auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+            ndash::stable_sort(entries.begin(), entries.end(), by_key);
+            for (size_t i = 1; i < entries.size(); ++i) {
+                REQUIRE(entries[i - 1].first <= entries[i].first);
+                if (entries[i - 1].first == entries[i].first) {
+                    REQUIRE(entries[i - 1].second < entries[i].second);
+                }
+            }
+        }
+    };
+
+    SECTION(test_stable_sort_in_place) {
+        ndash::vector<int> keys = pattern(0, 3000, 5);
+        ndash::vector<ndash::pair<int, uint32_t>> entries;
+        for (uint32_t i = 0; i < keys.size(); ++i) entries.push_back({ keys[i] % 50, i });
+
+        // Merge without a buffer, as when the buffer can't be allocated
+        auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+        ndash::vector<ndash::pair<int, uint32_t>> buffer;
+        ndash::detail::merge_sort(entries.begin(), entries.end(), buffer, false, by_key);
+        REQUIRE_THAT(buffer.capacity(), EQ(0));
+        for (size_t i = 1; i < entries.size(); ++i) {
+            REQUIRE(entries[i - 1].first <= entries[i].first);
+            if (entries[i - 1].first == entries[i].first) {
+                REQUIRE(entries[i - 1].second < entries[i].second);
+            }
+        }
+    };
+
+    SECTION(test_nth_element) {
+        for (int kind = 0; kind < 7; ++kind) {
+            ndash::vector<int> sorted = pattern(kind, 4000, kind + 7);
+            ndash::sort(sorted.begin(), sorted.end());
+
+            for (size_t nth : { 0, 1, 1999, 3998, 3999 }) {
+                ndash::vector<int> values = pattern(kind, 4000, kind + 7);
+                ndash::nth_element(values.begin(), values.begin() + ptrdiff_t(nth), values.end());
+                REQUIRE_THAT(values[nth], EQ(sorted[nth]));
+                for (size_t i = 0; i < nth; ++i) {
+                    REQUIRE(values[i] <= values[nth]);
+                }
+                for (size_t i = nth + 1; i < values.size(); ++i) {
+                    REQUIRE(values[i] >= values[nth]);
+                }
+            }
+        }
+    };
+
+    SECTION(test_partial_sort) {
+        for (int kind = 0; kind < 7; ++kind) {
+            ndash::vector<int> sorted = pattern(kind, 3000, kind + 13);
+            ndash::sort(sorted.begin(), sorted.end(), std::greater<>());
+
+            for (size_t k : { 0, 1, 10, 1000, 3000 }) {
+                ndash::vector<int> values = pattern(kind, 3000, kind + 13);
+                ndash::partial_sort(values.begin(), values.begin() + ptrdiff_t(k), values.end(), std::greater<>());
+                for (size_t i = 0; i < k; ++i) {
+                    REQUIRE_THAT(values[i], EQ(sorted[i]));
+                }
+            }
+        }
+    };
+}
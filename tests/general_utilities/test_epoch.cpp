@@ -0,0 +1,142 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "epoch.h"
+#include "test_framework.h"
+#include "thread_pool.h"
+#include "vector.h"
+
+namespace {
+
+std::atomic<size_t> freed_count(0);
+
+struct node {
+    uint64_t value;
+    uint64_t check;
+
+    explicit node(uint64_t v)
+        : value(v)
+        , check(~v) {}
+
+    ~node() {
+        check = value;
+        freed_count.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// Flush until everything retired so far is freed; no other thread may be pinned
+void drain() {
+    for (int i = 0; i < 4; ++i) ndash::epoch::flush();
+}
+
+}   // namespace
+
+TEST_CASE(Epoch) {
+    // First so that, run alone, the domain is first used by pool workers that are joined after static destruction
+    SECTION(test_pool_workers_outlive_statics) {
+        ndash::task_group group(ndash::default_thread_pool());
+        for (int i = 0; i < 64; ++i) {
+            group.spawn([]() {
+                ndash::epoch::guard pin;
+                ndash::epoch::retire(new node(1));
+            });
+        }
+        group.wait();
+        drain();
+    };
+
+    SECTION(test_guard_nesting) {
+        REQUIRE(!ndash::epoch::is_pinned());
+        {
+            ndash::epoch::guard outer;
+            REQUIRE(ndash::epoch::is_pinned());
+            {
+                ndash::epoch::guard inner;
+                REQUIRE(ndash::epoch::is_pinned());
+            }
+            REQUIRE(ndash::epoch::is_pinned());
+        }
+        REQUIRE(!ndash::epoch::is_pinned());
+    };
+
+    SECTION(test_retire_waits_for_guards) {
+        drain();
+        size_t before = freed_count.load();
+        std::atomic<bool> pinned(false);
+        std::atomic<bool> release(false);
+        std::thread reader([&]() {
+            ndash::epoch::guard guard;
+            pinned.store(true);
+            while (!release.load()) std::this_thread::yield();
+        });
+        while (!pinned.load()) std::this_thread::yield();
+
+        ndash::epoch::retire(new node(1));
+        drain();
+        REQUIRE_THAT(freed_count.load(), EQ(before));
+
+        release.store(true);
+        reader.join();
+        drain();
+        REQUIRE_THAT(freed_count.load(), EQ(before + 1));
+    };
+
+    SECTION(test_custom_deleter) {
+        drain();
+        static int deleted = 0;
+        int value = 7;
+        ndash::epoch::retire(&value, [](void* p) { deleted = *static_cast<int*>(p); });
+        drain();
+        REQUIRE_THAT(deleted, EQ(7));
+    };
+
+    SECTION(test_batched_reclamation) {
+        drain();
+        size_t before = freed_count.load();
+        // Retiring past the batch size frees earlier retirements without an explicit flush
+        for (size_t i = 0; i < 4 * ndash::epoch::detail::RETIRE_BATCH; ++i) ndash::epoch::retire(new node(i));
+        REQUIRE(freed_count.load() > before);
+        drain();
+        REQUIRE_THAT(freed_count.load(), EQ(before + 4 * ndash::epoch::detail::RETIRE_BATCH));
+    };
+
+    SECTION(test_concurrent_readers_and_writers) {
+        constexpr int READERS = 3;
+        constexpr int WRITERS = 2;
+        constexpr uint64_t SWAPS = 20000;
+        drain();
+        size_t before = freed_count.load();
+
+        std::atomic<node*> shared(new node(0));
+        std::atomic<int> writers_left(WRITERS);
+        std::atomic<bool> corrupt(false);
+
+        ndash::vector<std::thread> threads;
+        for (int t = 0; t < READERS; ++t) {
+            threads.emplace_back([&]() {
+                while (writers_left.load(std::memory_order_relaxed)) {
+                    ndash::epoch::guard guard;
+                    node* n = shared.load(std::memory_order_acquire);
+                    if (n->check != ~n->value) corrupt.store(true);
+                }
+            });
+        }
+        for (int t = 0; t < WRITERS; ++t) {
+            threads.emplace_back([&, t]() {
+                for (uint64_t i = 1; i <= SWAPS; ++i) {
+                    node* old = shared.exchange(new node(i * WRITERS + uint64_t(t)), std::memory_order_acq_rel);
+                    ndash::epoch::retire(old);
+                }
+                writers_left.fetch_sub(1);
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+
+        // The writers exited with retirements pending, which the remaining thread frees
+        drain();
+        REQUIRE(!corrupt.load());
+        REQUIRE_THAT(freed_count.load(), EQ(before + WRITERS * SWAPS));
+        delete shared.load();
+    };
+}
@@ -0,0 +1,138 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "executor.h"
+#include "task.h"
+#include "test_framework.h"
+#include "thread_pool.h"
+#include "vector.h"
+
+namespace {
+
+using std::chrono::milliseconds;
+
+ndash::task<int> worker_index(ndash::executor& exec) {
+    co_await exec.schedule();
+    co_return exec.pool().current_worker();
+}
+
+// Shard lookup that takes `delay` to answer
+ndash::task<int> slow_shard(ndash::executor& exec, int shard, milliseconds delay) {
+    co_await exec.sleep_for(delay);
+    co_return shard;
+}
+
+ndash::task<std::string> read_at(ndash::executor& exec, int fd, size_t count, uint64_t offset) {
+    std::string buffer(count, '\0');
+    size_t n = co_await exec.read(fd, buffer.data(), count, offset);
+    buffer.resize(n);
+    co_return buffer;
+}
+
+// Fans out to every shard, reading each shard's frames from `arena`
+ndash::task<int> query(ndash::executor& exec, int shards) {
+    ndash::vector<ndash::task<int>> lookups;
+    for (int shard = 0; shard < shards; ++shard) lookups.push_back(slow_shard(exec, shard, milliseconds(1)));
+    ndash::vector<int> results = co_await ndash::when_all(std::move(lookups));
+    int sum = 0;
+    for (int result : results) sum += result;
+    co_return sum;
+}
+
+}   // namespace
+
+TEST_CASE(Executor) {
+    SECTION(test_schedule_on_pool) {
+        ndash::thread_pool pool(2);
+        ndash::executor exec(pool);
+        int worker = ndash::sync_wait(worker_index(exec));
+        REQUIRE(worker == 0 || worker == 1);
+    };
+
+    SECTION(test_timers) {
+        ndash::thread_pool pool(2);
+        ndash::executor exec(pool);
+        auto start = ndash::executor::clock::now();
+        REQUIRE_THAT(ndash::sync_wait(slow_shard(exec, 3, milliseconds(20))), EQ(3));
+        REQUIRE(ndash::executor::clock::now() - start >= milliseconds(20));
+
+        // A past deadline doesn't suspend
+        REQUIRE_THAT(ndash::sync_wait(slow_shard(exec, 4, milliseconds(-5))), EQ(4));
+    };
+
+    SECTION(test_fan_out_waits_for_slowest) {
+        ndash::thread_pool pool(2);
+        ndash::executor exec(pool);
+        ndash::vector<ndash::task<int>> shards;
+        for (int shard = 0; shard < 8; ++shard) shards.push_back(slow_shard(exec, shard, milliseconds(40)));
+
+        auto start = ndash::executor::clock::now();
+        ndash::vector<int> results = ndash::sync_wait(ndash::when_all(std::move(shards)));
+        auto elapsed = ndash::executor::clock::now() - start;
+        REQUIRE_THAT(results.size(), EQ(8));
+        REQUIRE_THAT(results[7], EQ(7));
+        // Sequential lookups would take 320ms
+        REQUIRE(elapsed < milliseconds(200));
+
+        ndash::vector<ndash::task<int>> racing;
+        racing.push_back(slow_shard(exec, 0, milliseconds(200)));
+        racing.push_back(slow_shard(exec, 1, milliseconds(1)));
+        auto first = ndash::sync_wait(ndash::when_any(std::move(racing)));
+        REQUIRE_THAT(first.first, EQ(1));
+        REQUIRE_THAT(first.second, EQ(1));
+    };
+
+    SECTION(test_pending_timers_fire_on_destruction) {
+        ndash::thread_pool pool(1);
+        ndash::vector<ndash::task<int>> racing;
+        {
+            ndash::executor exec(pool);
+            racing.push_back(slow_shard(exec, 0, milliseconds(1)));
+            racing.push_back(slow_shard(exec, 1, std::chrono::hours(1)));
+            REQUIRE_THAT(ndash::sync_wait(ndash::when_any(std::move(racing))).first, EQ(0));
+        }
+    };
+
+    SECTION(test_read_file) {
+        char path[] = "/tmp/ndash_executor_XXXXXX";
+        int fd = mkstemp(path);
+        REQUIRE(fd >= 0);
+        const char* contents = "postings for shard zero";
+        REQUIRE_THAT(write(fd, contents, strlen(contents)), EQ(ssize_t(strlen(contents))));
+
+        ndash::thread_pool pool(2);
+        ndash::executor exec(pool);
+        REQUIRE_THAT(ndash::sync_wait(read_at(exec, fd, 8, 0)), EQ(std::string("postings")));
+        REQUIRE_THAT(ndash::sync_wait(read_at(exec, fd, 100, 13)), EQ(std::string("shard zero")));
+        REQUIRE_THAT(ndash::sync_wait(read_at(exec, fd, 10, 1000)), EQ(std::string("")));
+        close(fd);
+        unlink(path);
+
+        bool failed = false;
+        try {
+            ndash::sync_wait(read_at(exec, -1, 10, 0));
+        } catch (const std::system_error& error) {
+            failed = error.code().value() == EBADF;
+        }
+        REQUIRE(failed);
+    };
+
+    SECTION(test_query_frames_from_arena) {
+        ndash::thread_pool pool(2);
+        ndash::executor exec(pool);
+        ndash::frame_arena arena;
+        {
+            ndash::frame_arena::scope use(arena);
+            REQUIRE_THAT(ndash::sync_wait(query(exec, 16)), EQ(120));
+        }
+        REQUIRE_THAT(arena.live_frames(), EQ(0));
+        // The query, its when_all, and each shard lookup with its watcher
+        REQUIRE(arena.bytes_used() >= 34 * ndash::detail::FRAME_HEADER);
+    };
+}
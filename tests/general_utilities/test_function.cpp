@@ -0,0 +1,146 @@
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "function.h"
+#include "test_framework.h"
+#include "vector.h"
+
+namespace {
+
+int twice(int x) { return 2 * x; }
+
+// Callable counting its live copies
+struct counted {
+    static inline int alive = 0;
+    int value;
+
+    explicit counted(int v)
+        : value(v) {
+        ++alive;
+    }
+    counted(const counted& other) noexcept
+        : value(other.value) {
+        ++alive;
+    }
+    ~counted() { --alive; }
+
+    int operator()(int x) const { return x + value; }
+};
+
+struct large_capture {
+    uint64_t values[16];
+
+    uint64_t operator()() const { return values[0] + values[15]; }
+};
+
+}   // namespace
+
+TEST_CASE(Function) {
+    SECTION(test_empty_function) {
+        ndash::function<int(int)> f;
+        REQUIRE(!f);
+        REQUIRE(f == nullptr);
+        bool thrown = false;
+        try {
+            f(1);
+        } catch (const std::bad_function_call&) {
+            thrown = true;
+        }
+        REQUIRE(thrown);
+
+        int (*null_pointer)(int) = nullptr;
+        ndash::function<int(int)> from_null(null_pointer);
+        REQUIRE(!from_null);
+    };
+
+    SECTION(test_inline_and_heap_callables) {
+        ndash::function<int(int)> pointer(twice);
+        REQUIRE_THAT(pointer(4), EQ(8));
+
+        uint64_t a = 1, b = 2, c = 3, d = 4, e = 5;
+        auto sum = [a, b, c, d, e]() { return a + b + c + d + e; };
+        ndash::function<uint64_t()> captures(sum);
+        REQUIRE_THAT(captures(), EQ(15));
+        REQUIRE(ndash::function<uint64_t()>::fits_inline<decltype(sum)>());
+
+        large_capture big {};
+        big.values[0] = 7;
+        big.values[15] = 8;
+        using wide_function = ndash::function<uint64_t(), 128>;
+        REQUIRE(!ndash::function<uint64_t()>::fits_inline<large_capture>());
+        REQUIRE(wide_function::fits_inline<large_capture>());
+        ndash::function<uint64_t()> heap(big);
+        wide_function wide(big);
+        REQUIRE_THAT(heap(), EQ(15));
+        REQUIRE_THAT(wide(), EQ(15));
+
+        REQUIRE_THAT(sizeof(ndash::function<void()>), EQ(64));
+    };
+
+    SECTION(test_copy_move_and_lifetime) {
+        {
+            ndash::function<int(int)> f(counted(10));
+            REQUIRE_THAT(counted::alive, EQ(1));
+            ndash::function<int(int)> copy = f;
+            REQUIRE_THAT(counted::alive, EQ(2));
+            ndash::function<int(int)> moved = std::move(f);
+            REQUIRE(!f);
+            REQUIRE_THAT(counted::alive, EQ(2));
+            REQUIRE_THAT(moved(1), EQ(11));
+            REQUIRE_THAT(copy(2), EQ(12));
+
+            copy = twice;
+            REQUIRE_THAT(counted::alive, EQ(1));
+            copy.swap(moved);
+            REQUIRE_THAT(copy(1), EQ(11));
+            REQUIRE_THAT(moved(1), EQ(2));
+            moved = copy;
+            REQUIRE_THAT(counted::alive, EQ(2));
+            moved = nullptr;
+            REQUIRE_THAT(counted::alive, EQ(1));
+        }
+        REQUIRE_THAT(counted::alive, EQ(0));
+    };
+
+    SECTION(test_mutable_and_reference_arguments) {
+        int calls = 0;
+        ndash::function<void(int&)> increment([calls](int& x) mutable { x += ++calls; });
+        int value = 0;
+        increment(value);
+        increment(value);
+        REQUIRE_THAT(value, EQ(3));
+
+        ndash::function<std::string(const std::string&, std::string)> join(
+          [](const std::string& a, std::string b) { return a + b; });
+        REQUIRE_THAT(join("ab", "cd"), EQ(std::string("abcd")));
+    };
+
+    SECTION(test_move_only_function) {
+        auto owned = std::make_unique<int>(5);
+        ndash::move_only_function<int()> f([p = std::move(owned)]() { return *p; });
+        REQUIRE_THAT(f(), EQ(5));
+        ndash::move_only_function<int()> g = std::move(f);
+        REQUIRE(!f);
+        REQUIRE_THAT(g(), EQ(5));
+
+        ndash::vector<ndash::move_only_function<int()>> queue;
+        for (int i = 0; i < 100; ++i) {
+            queue.push_back([p = std::make_unique<int>(i)]() { return *p; });
+        }
+        int sum = 0;
+        for (auto& task : queue) sum += task();
+        REQUIRE_THAT(sum, EQ(4950));
+
+        {
+            ndash::move_only_function<int(int)> counting(counted(1));
+            ndash::move_only_function<int(int)> other(counted(2));
+            REQUIRE_THAT(counted::alive, EQ(2));
+            counting.swap(other);
+            REQUIRE_THAT(counting(0), EQ(2));
+            REQUIRE_THAT(counted::alive, EQ(2));
+        }
+        REQUIRE_THAT(counted::alive, EQ(0));
+    };
+}
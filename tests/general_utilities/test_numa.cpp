@@ -0,0 +1,150 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include <sched.h>
+#include <sys/mman.h>
+
+#include "numa.h"
+#include "test_framework.h"
+#include "vector.h"
+
+namespace {
+
+bool contains(const ndash::vector<int>& values, int value) {
+    for (int v : values) {
+        if (v == value) return true;
+    }
+    return false;
+}
+
+}   // namespace
+
+TEST_CASE(Numa) {
+    SECTION(test_parse_list) {
+        ndash::vector<int> values;
+        REQUIRE(ndash::numa::detail::parse_list("0-3,8,10-11\n", values));
+        REQUIRE_THAT(values.size(), EQ(7));
+        REQUIRE_THAT(values[3], EQ(3));
+        REQUIRE_THAT(values[4], EQ(8));
+        REQUIRE_THAT(values[6], EQ(11));
+
+        REQUIRE(ndash::numa::detail::parse_list("5", values));
+        REQUIRE_THAT(values.size(), EQ(1));
+        REQUIRE(ndash::numa::detail::parse_list("\n", values));
+        REQUIRE(values.empty());
+
+        REQUIRE(!ndash::numa::detail::parse_list("x", values));
+        REQUIRE(!ndash::numa::detail::parse_list("3-1", values));
+        REQUIRE(!ndash::numa::detail::parse_list("2-", values));
+    };
+
+    SECTION(test_topology) {
+        REQUIRE(ndash::numa::node_count() >= 1);
+        for (size_t i = 0; i < ndash::numa::node_count(); ++i) {
+            int node = ndash::numa::node_id(i);
+            REQUIRE(!ndash::numa::cpus_of(node).empty());
+            if (i > 0) {
+                REQUIRE(node > ndash::numa::node_id(i - 1));
+            }
+        }
+        REQUIRE(ndash::numa::cpus_of(-1).empty());
+        REQUIRE(ndash::numa::cpus_of(ndash::numa::detail::MAX_NODES).empty());
+        REQUIRE(ndash::numa::detail::find_node(ndash::numa::current_node()) != nullptr);
+    };
+
+    SECTION(test_shard_nodes) {
+        size_t count = ndash::numa::node_count();
+        ndash::vector<size_t> per_node(count, 0);
+        for (size_t shard = 0; shard < 64; ++shard) {
+            int node = ndash::numa::shard_node(shard, 64);
+            size_t index = 0;
+            while (ndash::numa::node_id(index) != node) ++index;
+            ++per_node[index];
+            // Blocks are contiguous
+            if (shard > 0) {
+                REQUIRE(node >= ndash::numa::shard_node(shard - 1, 64));
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            REQUIRE(per_node[i] >= 64 / count && per_node[i] <= 64 / count + 1);
+        }
+        REQUIRE_THAT(ndash::numa::shard_node(0, 0), EQ(ndash::numa::node_id(0)));
+    };
+
+    SECTION(test_bind_and_node_of) {
+        size_t bytes = size_t(4) << 20;
+        void* raw = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        REQUIRE(raw != MAP_FAILED);
+        char* data = static_cast<char*>(raw);
+
+        int target = ndash::numa::node_id(ndash::numa::node_count() - 1);
+        REQUIRE(ndash::numa::bind(data + 100, bytes - 100, target));
+        REQUIRE(!ndash::numa::bind(data, bytes, -1));
+        for (size_t i = 0; i < bytes; i += 4096) data[i] = char(i);
+        REQUIRE_THAT(ndash::numa::node_of(data), EQ(target));
+        REQUIRE_THAT(ndash::numa::node_of(data + bytes - 1), EQ(target));
+
+        // Binding again moves the touched pages
+        int other = ndash::numa::node_id(0);
+        REQUIRE(ndash::numa::bind(data, bytes, other));
+        REQUIRE_THAT(ndash::numa::node_of(data + bytes / 2), EQ(other));
+        REQUIRE_THAT(data[4096], EQ(char(4096)));
+        munmap(raw, bytes);
+    };
+
+    SECTION(test_pin_current_thread_to_node) {
+        int node = ndash::numa::node_id(ndash::numa::node_count() - 1);
+        bool pinned = false;
+        int cpu = -1;
+        std::thread pinning([&]() {
+            pinned = ndash::numa::pin_current_thread_to_node(node);
+            cpu = sched_getcpu();
+        });
+        pinning.join();
+        REQUIRE(pinned);
+        REQUIRE(contains(ndash::numa::cpus_of(node), cpu));
+        REQUIRE(!ndash::numa::pin_current_thread_to_node(-1));
+    };
+
+    SECTION(test_placement_scopes_nest) {
+        REQUIRE_THAT(ndash::numa::placement_node(), EQ(-1));
+        {
+            ndash::numa::placement_scope outer(ndash::numa::node_id(0));
+            REQUIRE_THAT(ndash::numa::placement_node(), EQ(ndash::numa::node_id(0)));
+            {
+                ndash::numa::placement_scope inner(7);
+                REQUIRE_THAT(ndash::numa::placement_node(), EQ(7));
+            }
+            REQUIRE_THAT(ndash::numa::placement_node(), EQ(ndash::numa::node_id(0)));
+
+            int seen = 0;
+            std::thread other([&]() { seen = ndash::numa::placement_node(); });
+            other.join();
+            REQUIRE_THAT(seen, EQ(-1));
+        }
+        REQUIRE_THAT(ndash::numa::placement_node(), EQ(-1));
+    };
+
+    SECTION(test_worker_groups_run_on_their_node) {
+        ndash::numa::worker_groups groups(2);
+        REQUIRE_THAT(groups.size(), EQ(ndash::numa::node_count()));
+
+        constexpr size_t SHARDS = 16;
+        std::atomic<size_t> done(0);
+        std::atomic<size_t> on_node(0);
+        for (size_t shard = 0; shard < SHARDS; ++shard) {
+            int node = ndash::numa::shard_node(shard, SHARDS);
+            ndash::thread_pool& pool = groups.pool_for_shard(shard, SHARDS);
+            REQUIRE_THAT(pool.size(), EQ(2));
+            pool.submit([&, node]() {
+                if (contains(ndash::numa::cpus_of(node), sched_getcpu())) on_node.fetch_add(1);
+                done.fetch_add(1);
+            });
+        }
+        while (done.load() < SHARDS) std::this_thread::yield();
+        REQUIRE_THAT(on_node.load(), EQ(SHARDS));
+        REQUIRE(&groups.pool_for_node(-1) == &groups[0]);
+    };
+}
@@ -48,4 +48,17 @@ TEST_CASE(Pair) {
         REQUIRE_THAT(p1.first, EQ(25));
         REQUIRE_THAT(p1.second, EQ(3.1415));
     };
+
+    SECTION(test_pair_compare) {
+        ndash::pair<int, int> p1 { 1, 5 };
+        ndash::pair<int, int> p2 { 1, 7 };
+        ndash::pair<int, int> p3 { 2, 0 };
+
+        REQUIRE(p1 == p1);
+        REQUIRE(!(p1 == p2));
+        REQUIRE(p1 < p2);
+        REQUIRE(p2 < p3);
+        REQUIRE(!(p2 < p1));
+        REQUIRE(!(p1 < p1));
+    };
 }
@@ -0,0 +1,106 @@
+#include <cstdint>
+
+#include "algorithm.h"
+#include "pair.h"
+#include "parallel.h"
+#include "test_framework.h"
+#include "vector.h"
+
+TEST_CASE(Parallel) {
+    ndash::par::set_concurrency(4);
+
+    SECTION(test_for_each_and_transform) {
+        for (size_t grain : { 1, 7, 4096 }) {
+            ndash::vector<uint64_t> values(100000);
+            for (size_t i = 0; i < values.size(); ++i) values[i] = i;
+
+            ndash::par::for_each(values.begin(), values.end(), [](uint64_t& value) { value *= 3; }, grain);
+            ndash::vector<uint64_t> squares(values.size());
+            auto end = ndash::par::transform(values.begin(), values.end(), squares.begin(),
+                                             [](uint64_t value) { return value * value; }, grain);
+            REQUIRE(end == squares.end());
+            bool ok = true;
+            for (size_t i = 0; i < values.size(); ++i) ok &= values[i] == 3 * i && squares[i] == 9 * i * i;
+            REQUIRE(ok);
+        }
+
+        // Empty ranges do nothing
+        ndash::vector<int> empty;
+        ndash::par::for_each(empty.begin(), empty.end(), [](int& value) { value = 1; });
+        REQUIRE_THAT(ndash::par::count_if(empty.begin(), empty.end(), [](int) { return true; }), EQ(0));
+    };
+
+    SECTION(test_reduce_and_count_if) {
+        ndash::vector<uint32_t> values(250001);
+        for (size_t i = 0; i < values.size(); ++i) values[i] = uint32_t(i);
+
+        uint64_t sum = ndash::par::reduce(values.begin(), values.end(), uint64_t(5));
+        REQUIRE_THAT(sum, EQ(uint64_t(250000) * 250001 / 2 + 5));
+        REQUIRE_THAT(ndash::par::count_if(values.begin(), values.end(), [](uint32_t v) { return v % 3 == 0; }, 100),
+                     EQ(83334));
+
+        // Partial results combine in order, so a non-commutative operation matches the sequential result. Each
+        // element is the map x -> 10x + digit modulo a prime, and the operation composes two maps
+        constexpr uint64_t P = 1000000007;
+        ndash::vector<ndash::pair<uint64_t, uint64_t>> maps(1000);
+        for (size_t i = 0; i < maps.size(); ++i) maps[i] = { 10, i % 10 };
+        auto compose = [](const auto& f, const auto& g) {
+            return ndash::pair<uint64_t, uint64_t>(g.first * f.first % P, (g.first * f.second + g.second) % P);
+        };
+        uint64_t expected = 0;
+        for (size_t i = 0; i < maps.size(); ++i) expected = (expected * 10 + i % 10) % P;
+        ndash::pair<uint64_t, uint64_t> identity(1, 0);
+        auto composed = ndash::par::reduce(maps.begin(), maps.end(), identity, compose, 16);
+        REQUIRE_THAT(composed.second, EQ(expected));
+    };
+
+    SECTION(test_scans) {
+        for (size_t grain : { 1, 33, 4096 }) {
+            ndash::vector<uint64_t> values(50000);
+            for (size_t i = 0; i < values.size(); ++i) values[i] = i % 17;
+
+            ndash::vector<uint64_t> inclusive(values.size()), exclusive(values.size());
+            ndash::par::inclusive_scan(values.begin(), values.end(), inclusive.begin(), std::plus<>(), grain);
+            ndash::par::exclusive_scan(values.begin(), values.end(), exclusive.begin(), uint64_t(100), std::plus<>(),
+                                       grain);
+
+            bool ok = true;
+            uint64_t running = 0;
+            for (size_t i = 0; i < values.size(); ++i) {
+                ok &= exclusive[i] == running + 100;
+                running += values[i];
+                ok &= inclusive[i] == running;
+            }
+            REQUIRE(ok);
+
+            // In place
+            ndash::par::inclusive_scan(values.data(), values.data() + values.size(), values.data(), std::plus<>(),
+                                       grain);
+            REQUIRE_THAT(values.back(), EQ(inclusive.back()));
+            REQUIRE_THAT(values[values.size() / 2], EQ(inclusive[values.size() / 2]));
+        }
+    };
+
+    SECTION(test_sort) {
+        for (unsigned threads : { 1u, 3u, 4u }) {
+            ndash::par::set_concurrency(threads);
+            uint64_t state = threads;
+            ndash::vector<uint32_t> values(200000);
+            for (auto& value : values) value = uint32_t((state = state * 6364136223846793005ULL + 1) >> 40);
+
+            ndash::par::sort(values.begin(), values.end(), std::less<>(), 1000);
+            REQUIRE(ndash::is_sorted(values.begin(), values.end()));
+        }
+        ndash::par::set_concurrency(4);
+    };
+
+    SECTION(test_chunks_cover_range_once) {
+        ndash::vector<int> hits(10007, 0);
+        ndash::par::for_each(hits.begin(), hits.end(), [](int& hit) { ++hit; }, 3);
+        bool ok = true;
+        for (int hit : hits) ok &= hit == 1;
+        REQUIRE(ok);
+    };
+
+    ndash::par::set_concurrency(0);
+}
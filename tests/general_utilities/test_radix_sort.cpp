@@ -0,0 +1,125 @@
+#include <cstdint>
+
+#include "algorithm.h"
+#include "radix_sort.h"
+#include "test_framework.h"
+#include "vector.h"
+
+namespace {
+
+// Deterministic pseudo-random values
+struct lcg {
+    uint64_t state;
+
+    uint64_t operator()() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return state ^ (state >> 29);
+    }
+};
+
+struct posting {
+    uint32_t term_id;
+    uint32_t doc_id;
+    uint32_t position;
+};
+
+uint64_t term_doc_key(const posting& p) { return uint64_t(p.term_id) << 32 | p.doc_id; }
+
+template <typename T>
+bool sorted_equal(ndash::vector<T>& values, ndash::vector<T>& expected) {
+    ndash::sort(expected.begin(), expected.end());
+    if (values.size() != expected.size()) return false;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i] != expected[i]) return false;
+    }
+    return true;
+}
+
+}   // namespace
+
+TEST_CASE(RadixSort) {
+    SECTION(test_radix_sort_widths) {
+        lcg rng { 1 };
+        for (size_t n : { 0, 1, 2, 63, 64, 1000, 70000 }) {
+            ndash::vector<uint32_t> u32;
+            ndash::vector<uint64_t> u64;
+            ndash::vector<uint16_t> u16;
+            ndash::vector<uint8_t> u8;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t r = rng();
+                u32.push_back(uint32_t(r));
+                u64.push_back(r);
+                u16.push_back(uint16_t(r));
+                u8.push_back(uint8_t(r));
+            }
+            ndash::vector<uint32_t> e32 = u32;
+            ndash::vector<uint64_t> e64 = u64;
+            ndash::vector<uint16_t> e16 = u16;
+            ndash::vector<uint8_t> e8 = u8;
+
+            ndash::radix_sort(u32.begin(), u32.end());
+            ndash::radix_sort(u64.begin(), u64.end());
+            ndash::radix_sort(u16.data(), u16.data() + u16.size());
+            ndash::radix_sort(u8.begin(), u8.end());
+            REQUIRE(sorted_equal(u32, e32));
+            REQUIRE(sorted_equal(u64, e64));
+            REQUIRE(sorted_equal(u16, e16));
+            REQUIRE(sorted_equal(u8, e8));
+        }
+    };
+
+    SECTION(test_radix_sort_shared_digits) {
+        // Only the low 12 bits vary, so most passes are skipped; the high bits are set to catch a skipped pass that
+        // still needed to run
+        lcg rng { 2 };
+        ndash::vector<uint64_t> values;
+        for (int i = 0; i < 100000; ++i) values.push_back(0xABCD000000000000ULL | (rng() & 0xFFF));
+        ndash::vector<uint64_t> expected = values;
+        ndash::radix_sort(values.begin(), values.end());
+        REQUIRE(sorted_equal(values, expected));
+
+        ndash::vector<uint32_t> equal(5000, 42);
+        ndash::radix_sort(equal.begin(), equal.end());
+        REQUIRE_THAT(equal[0], EQ(42));
+        REQUIRE_THAT(equal[4999], EQ(42));
+    };
+
+    SECTION(test_radix_sort_projection_is_stable) {
+        lcg rng { 3 };
+        for (size_t n : { 50, 5000, 100000 }) {
+            ndash::vector<posting> postings;
+            for (uint32_t i = 0; i < n; ++i) postings.push_back({ uint32_t(rng() % 40), uint32_t(rng() % 300), i });
+
+            ndash::radix_sort(postings.begin(), postings.end(), term_doc_key);
+            for (size_t i = 1; i < postings.size(); ++i) {
+                uint64_t prev = term_doc_key(postings[i - 1]), cur = term_doc_key(postings[i]);
+                REQUIRE(prev <= cur);
+                if (prev == cur) {
+                    REQUIRE(postings[i - 1].position < postings[i].position);
+                }
+            }
+        }
+    };
+
+    SECTION(test_parallel_radix_sort) {
+        lcg rng { 4 };
+        ndash::vector<posting> postings;
+        for (uint32_t i = 0; i < 300000; ++i) postings.push_back({ uint32_t(rng() % 1000), uint32_t(rng() % 5000), i });
+
+        ndash::parallel_radix_sort(postings.begin(), postings.end(), term_doc_key, 4);
+        for (size_t i = 1; i < postings.size(); ++i) {
+            uint64_t prev = term_doc_key(postings[i - 1]), cur = term_doc_key(postings[i]);
+            REQUIRE(prev <= cur);
+            if (prev == cur) {
+                REQUIRE(postings[i - 1].position < postings[i].position);
+            }
+        }
+
+        // Small keys put everything in a few buckets
+        ndash::vector<uint32_t> values;
+        for (int i = 0; i < 300000; ++i) values.push_back(uint32_t(rng() % 3));
+        ndash::vector<uint32_t> expected = values;
+        ndash::parallel_radix_sort(values.begin(), values.end(), ndash::detail::identity_key(), 3);
+        REQUIRE(sorted_equal(values, expected));
+    };
+}
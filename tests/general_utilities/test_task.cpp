@@ -0,0 +1,174 @@
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include "task.h"
+#include "test_framework.h"
+#include "vector.h"
+
+namespace {
+
+ndash::task<int> constant(int value) { co_return value; }
+
+ndash::task<int> add(int a, int b) { co_return co_await constant(a) + co_await constant(b); }
+
+ndash::task<void> nothing() { co_return; }
+
+ndash::task<void> fail(const char* message) {
+    throw std::runtime_error(message);
+    co_return;
+}
+
+ndash::task<int> fail_int() {
+    co_await fail("int");
+    co_return 0;
+}
+
+// Awaits `depth` nested tasks that all complete synchronously
+ndash::task<size_t> count_down(size_t depth) {
+    size_t total = 0;
+    for (size_t i = 0; i < depth; ++i) total += co_await constant(1);
+    co_return total;
+}
+
+ndash::task<std::string> text(const char* value) { co_return std::string(value); }
+
+ndash::task<int> await_empty() {
+    ndash::task<int> empty;
+    co_return co_await empty;
+}
+
+}   // namespace
+
+TEST_CASE(Task) {
+    SECTION(test_task_results) {
+        REQUIRE_THAT(ndash::sync_wait(add(2, 3)), EQ(5));
+        REQUIRE_THAT(ndash::sync_wait(text("abc")), EQ(std::string("abc")));
+
+        ndash::task<int> lazy = constant(7);
+        REQUIRE(bool(lazy));
+        REQUIRE(!lazy.done());
+        ndash::task<int> moved = std::move(lazy);
+        REQUIRE(!bool(lazy));
+        REQUIRE_THAT(ndash::sync_wait(std::move(moved)), EQ(7));
+    };
+
+    SECTION(test_task_exceptions) {
+        bool caught = false;
+        try {
+            ndash::sync_wait(fail_int());
+        } catch (const std::runtime_error& error) {
+            caught = std::string(error.what()) == "int";
+        }
+        REQUIRE(caught);
+    };
+
+    SECTION(test_symmetric_transfer) {
+        // Unoptimized builds don't turn the transfers into tail calls, so the depth is kept within a debug stack;
+        // bench_task awaits a million in a row
+        REQUIRE_THAT(ndash::sync_wait(count_down(2000)), EQ(2000));
+    };
+
+    SECTION(test_when_all) {
+        ndash::vector<ndash::task<int>> tasks;
+        for (int i = 0; i < 10; ++i) tasks.push_back(add(i, i));
+        ndash::vector<int> results = ndash::sync_wait(ndash::when_all(std::move(tasks)));
+        REQUIRE_THAT(results.size(), EQ(10));
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE_THAT(results[i], EQ(2 * i));
+        }
+
+        REQUIRE(ndash::sync_wait(ndash::when_all(ndash::vector<ndash::task<int>>())).empty());
+
+        auto [number, word, empty] = ndash::sync_wait(ndash::when_all(constant(1), text("two"), nothing()));
+        (void) empty;
+        REQUIRE_THAT(number, EQ(1));
+        REQUIRE_THAT(word, EQ(std::string("two")));
+    };
+
+    SECTION(test_when_all_exceptions) {
+        ndash::vector<ndash::task<void>> tasks;
+        tasks.push_back(fail("first"));
+        tasks.push_back(fail("second"));
+        std::string message;
+        try {
+            ndash::sync_wait(ndash::when_all(std::move(tasks)));
+        } catch (const std::runtime_error& error) {
+            message = error.what();
+        }
+        REQUIRE_THAT(message, EQ(std::string("first")));
+    };
+
+    SECTION(test_when_any) {
+        ndash::vector<ndash::task<int>> tasks;
+        tasks.push_back(constant(4));
+        tasks.push_back(constant(5));
+        auto first = ndash::sync_wait(ndash::when_any(std::move(tasks)));
+        REQUIRE_THAT(first.first, EQ(0));
+        REQUIRE_THAT(first.second, EQ(4));
+
+        ndash::vector<ndash::task<void>> failing;
+        failing.push_back(fail("any"));
+        bool caught = false;
+        try {
+            ndash::sync_wait(ndash::when_any(std::move(failing)));
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        REQUIRE(caught);
+    };
+
+    SECTION(test_empty_tasks_are_rejected) {
+        bool caught = false;
+        try {
+            ndash::sync_wait(await_empty());
+        } catch (const std::logic_error&) {
+            caught = true;
+        }
+        REQUIRE(caught);
+
+        caught = false;
+        try {
+            ndash::sync_wait(ndash::task<int>());
+        } catch (const std::logic_error&) {
+            caught = true;
+        }
+        REQUIRE(caught);
+
+        caught = false;
+        try {
+            ndash::sync_wait(ndash::when_any(ndash::vector<ndash::task<int>>()));
+        } catch (const std::invalid_argument&) {
+            caught = true;
+        }
+        REQUIRE(caught);
+
+        caught = false;
+        try {
+            ndash::sync_wait(ndash::when_any(ndash::vector<ndash::task<void>>()));
+        } catch (const std::invalid_argument&) {
+            caught = true;
+        }
+        REQUIRE(caught);
+    };
+
+    SECTION(test_frame_arena) {
+        ndash::frame_arena arena(256);
+        {
+            ndash::frame_arena::scope use(arena);
+            ndash::vector<ndash::task<int>> tasks;
+            for (int i = 0; i < 100; ++i) tasks.push_back(add(i, 1));
+            REQUIRE_THAT(arena.live_frames(), EQ(100));
+            ndash::vector<int> results = ndash::sync_wait(ndash::when_all(std::move(tasks)));
+            REQUIRE_THAT(results[99], EQ(100));
+        }
+        // Frames of finished tasks are counted as freed; the memory stays with the arena
+        REQUIRE_THAT(arena.live_frames(), EQ(0));
+        REQUIRE(arena.bytes_used() > 100 * sizeof(void*));
+
+        // Outside the scope frames come from the heap again
+        ndash::task<int> heap_task = constant(1);
+        REQUIRE_THAT(arena.live_frames(), EQ(0));
+        REQUIRE_THAT(ndash::sync_wait(std::move(heap_task)), EQ(1));
+    };
+}
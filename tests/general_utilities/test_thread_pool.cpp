@@ -0,0 +1,185 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+#include "test_framework.h"
+#include "thread_pool.h"
+#include "vector.h"
+
+namespace {
+
+uint64_t fib(ndash::thread_pool& pool, unsigned n) {
+    if (n < 12) return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    uint64_t a = 0, b = 0;
+    ndash::task_group group(pool);
+    group.spawn([&]() { a = fib(pool, n - 1); });
+    b = fib(pool, n - 2);
+    group.wait();
+    return a + b;
+}
+
+}   // namespace
+
+TEST_CASE(ThreadPool) {
+    SECTION(test_deque_owner_and_thief_ends) {
+        ndash::work_stealing_deque<int> deque(2);
+        int values[100];
+        REQUIRE(deque.empty());
+        REQUIRE(deque.pop() == nullptr);
+        REQUIRE(deque.steal() == nullptr);
+
+        // Pushing past the capacity grows the ring
+        for (int i = 0; i < 100; ++i) {
+            values[i] = i;
+            deque.push(&values[i]);
+        }
+        REQUIRE(deque.pop() == &values[99]);
+        REQUIRE(deque.steal() == &values[0]);
+        REQUIRE(deque.steal() == &values[1]);
+        REQUIRE(deque.pop() == &values[98]);
+
+        size_t remaining = 0;
+        while (deque.pop()) ++remaining;
+        REQUIRE_THAT(remaining, EQ(96));
+        REQUIRE(deque.empty());
+    };
+
+    SECTION(test_deque_concurrent_steals) {
+        constexpr int TOTAL = 200000;
+        ndash::work_stealing_deque<int> deque(64);
+        ndash::vector<int> values(TOTAL, 0);
+        std::atomic<int> taken(0);
+        std::atomic<bool> done(false);
+        ndash::vector<int> seen(TOTAL, 0);
+
+        ndash::vector<std::thread> thieves;
+        for (int t = 0; t < 3; ++t) {
+            thieves.emplace_back([&]() {
+                while (!done.load() || !deque.empty()) {
+                    if (int* value = deque.steal()) {
+                        ++seen[size_t(value - values.data())];
+                        taken.fetch_add(1);
+                    }
+                }
+            });
+        }
+        for (int i = 0; i < TOTAL; ++i) {
+            deque.push(&values[i]);
+            if (i % 3 == 0) {
+                if (int* value = deque.pop()) {
+                    ++seen[size_t(value - values.data())];
+                    taken.fetch_add(1);
+                }
+            }
+        }
+        while (int* value = deque.pop()) {
+            ++seen[size_t(value - values.data())];
+            taken.fetch_add(1);
+        }
+        done.store(true);
+        for (auto& thief : thieves) thief.join();
+
+        REQUIRE_THAT(taken.load(), EQ(TOTAL));
+        bool once = true;
+        for (int count : seen) once &= count == 1;
+        REQUIRE(once);
+    };
+
+    SECTION(test_submit_and_group_wait) {
+        ndash::thread_pool pool(4);
+        REQUIRE_THAT(pool.size(), EQ(4u));
+        REQUIRE_THAT(pool.current_worker(), EQ(-1));
+
+        std::atomic<int> sum(0);
+        ndash::task_group group(pool);
+        for (int i = 1; i <= 1000; ++i) group.spawn([&sum, i]() { sum.fetch_add(i); });
+        group.wait();
+        REQUIRE_THAT(sum.load(), EQ(500500));
+
+        // Submitted tasks run on workers, and the pool runs them all before it is destroyed
+        std::atomic<int> on_worker(0);
+        {
+            ndash::thread_pool inner(2);
+            for (int i = 0; i < 100; ++i) {
+                inner.submit([&inner, &on_worker]() { on_worker.fetch_add(inner.current_worker() >= 0); });
+            }
+        }
+        REQUIRE_THAT(on_worker.load(), EQ(100));
+    };
+
+    SECTION(test_nested_fork_join) {
+        ndash::thread_pool pool(3);
+        REQUIRE_THAT(fib(pool, 24), EQ(46368));
+
+        // Waiting inside a task runs other tasks instead of blocking a worker
+        ndash::thread_pool single(1);
+        std::atomic<int> leaves(0);
+        ndash::task_group outer(single);
+        for (int i = 0; i < 8; ++i) {
+            outer.spawn([&]() {
+                ndash::task_group inner(single);
+                for (int j = 0; j < 8; ++j) inner.spawn([&]() { leaves.fetch_add(1); });
+                inner.wait();
+            });
+        }
+        outer.wait();
+        REQUIRE_THAT(leaves.load(), EQ(64));
+    };
+
+    SECTION(test_exceptions_reach_wait) {
+        ndash::thread_pool pool(2);
+        ndash::task_group group(pool);
+        std::atomic<int> ran(0);
+        for (int i = 0; i < 20; ++i) {
+            group.spawn([&ran, i]() {
+                ran.fetch_add(1);
+                if (i == 7) throw std::runtime_error("task failed");
+            });
+        }
+
+        bool caught = false;
+        try {
+            group.wait();
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        REQUIRE(caught);
+        REQUIRE_THAT(ran.load(), EQ(20));
+    };
+
+    SECTION(test_parked_workers_wake) {
+        ndash::thread_pool pool(2);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        for (int round = 0; round < 50; ++round) {
+            std::atomic<bool> ran(false);
+            ndash::task_group group(pool);
+            group.spawn([&ran]() { ran.store(true); });
+            group.wait();
+            REQUIRE(ran.load());
+        }
+    };
+
+    SECTION(test_pinning) {
+        // Pin a thread of its own so the test runner stays unpinned
+        bool pinned = false, rejected = false;
+        std::thread([&]() {
+            pinned = ndash::pin_current_thread(0);
+            rejected = !ndash::pin_current_thread(-1);
+        }).join();
+#ifdef __linux__
+        REQUIRE(pinned);
+#endif
+        REQUIRE(rejected);
+
+        ndash::vector<int> cpus;
+        cpus.push_back(0);
+        ndash::thread_pool pool(2, cpus);
+        std::atomic<int> ran(0);
+        ndash::task_group group(pool);
+        for (int i = 0; i < 10; ++i) group.spawn([&ran]() { ran.fetch_add(1); });
+        group.wait();
+        REQUIRE_THAT(ran.load(), EQ(10));
+    };
+}
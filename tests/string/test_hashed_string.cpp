@@ -0,0 +1,88 @@
+#include "hashed_string.h"
+#include "ndstring.h"
+#include "test_framework.h"
+#include "unordered_map.h"
+
+TEST_CASE(HashedString) {
+    SECTION(test_empty_hashed_string) {
+        ndash::hashed_string str;
+
+        REQUIRE(str.empty());
+        REQUIRE_THAT(str.size(), EQ(0));
+        REQUIRE_THAT(str.hash(), EQ(ndash::hash<ndash::string> {}(ndash::string())));
+    };
+
+    SECTION(test_hash_matches_string_hash) {
+        ndash::string term("inverted index");
+        ndash::hashed_string a(term);
+        ndash::hashed_string b("inverted index");
+        ndash::hashed_string c("inverted index!", 14);
+
+        auto expected = ndash::hash<ndash::string> {}(term);
+        REQUIRE_THAT(a.hash(), EQ(expected));
+        REQUIRE_THAT(b.hash(), EQ(expected));
+        REQUIRE_THAT(c.hash(), EQ(expected));
+        REQUIRE_THAT(ndash::hash<ndash::hashed_string> {}(a), EQ(expected));
+        REQUIRE_THAT(a.str(), EQ(term));
+        REQUIRE_THAT(a.length(), EQ(14));
+    };
+
+    SECTION(test_copy_and_move) {
+        ndash::hashed_string a("term");
+        ndash::hashed_string b(a);
+
+        REQUIRE_THAT(b, EQ(a));
+        REQUIRE_THAT(b.hash(), EQ(a.hash()));
+        REQUIRE_THAT(b.data(), NEQ(a.data()));
+
+        ndash::hashed_string c(std::move(b));
+        REQUIRE_THAT(c, EQ(a));
+
+        ndash::hashed_string d;
+        d = c;
+        REQUIRE_THAT(d, EQ(a));
+
+        ndash::hashed_string e;
+        e = std::move(d);
+        REQUIRE_THAT(e, EQ(a));
+        REQUIRE_THAT(e.hash(), EQ(a.hash()));
+    };
+
+    SECTION(test_assign_recomputes_hash) {
+        ndash::hashed_string a("before");
+        auto old_hash = a.hash();
+
+        a.assign(ndash::string("after"));
+        REQUIRE_THAT(a.hash(), NEQ(old_hash));
+        REQUIRE_THAT(a.hash(), EQ(ndash::hash<ndash::string> {}(ndash::string("after"))));
+        REQUIRE(a == "after");
+
+        ndash::string released = a.release();
+        REQUIRE_THAT(released, EQ("after"));
+        REQUIRE(a.empty());
+        REQUIRE_THAT(a.hash(), EQ(ndash::hashed_string().hash()));
+    };
+
+    SECTION(test_comparisons) {
+        ndash::hashed_string a("apple");
+        ndash::hashed_string b("banana");
+
+        REQUIRE(a != b);
+        REQUIRE(a < b);
+        REQUIRE(a == ndash::string("apple"));
+        REQUIRE(a == "apple");
+    };
+
+    SECTION(test_map_keys) {
+        ndash::unordered_map<ndash::hashed_string, int> map;
+
+        map[ndash::hashed_string("alpha")] = 1;
+        map[ndash::hashed_string("beta")] = 2;
+        map[ndash::hashed_string("alpha")] += 10;
+
+        REQUIRE_THAT(map.size(), EQ(2));
+        REQUIRE_THAT(map[ndash::hashed_string("alpha")], EQ(11));
+        REQUIRE(map.contains(ndash::hashed_string("beta")));
+        REQUIRE(!map.contains(ndash::hashed_string("gamma")));
+    };
+}
@@ -0,0 +1,154 @@
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+
+#include "intern_pool.h"
+#include "ndstring.h"
+#include "test_framework.h"
+#include "unordered_map.h"
+#include "vector.h"
+
+TEST_CASE(InternPool) {
+    SECTION(test_empty_pool) {
+        ndash::intern_pool pool;
+
+        REQUIRE(pool.empty());
+        REQUIRE_THAT(pool.size(), EQ(0));
+        REQUIRE_THAT(pool.find("term"), EQ(ndash::intern_pool::npos));
+        REQUIRE(!pool.contains("term", 4));
+    };
+
+    SECTION(test_intern_returns_stable_ids) {
+        ndash::intern_pool pool;
+
+        auto a = pool.intern("apple");
+        auto b = pool.intern("banana");
+        auto c = pool.intern(ndash::string("apple"));
+
+        REQUIRE_THAT(a, EQ(0u));
+        REQUIRE_THAT(b, EQ(1u));
+        REQUIRE_THAT(c, EQ(a));
+        REQUIRE_THAT(pool.size(), EQ(2));
+
+        REQUIRE_THAT(pool.find("banana"), EQ(b));
+        REQUIRE_THAT(pool.find(ndash::string("apple")), EQ(a));
+        REQUIRE(pool.contains(ndash::string("banana")));
+    };
+
+    SECTION(test_atom_contents) {
+        ndash::intern_pool pool;
+
+        const char* text = "search engine";
+        auto id = pool.intern(text, 6);
+
+        REQUIRE_THAT(pool.length(id), EQ(6));
+        REQUIRE_THAT(ndash::strlen(pool.c_str(id)), EQ(6));
+        REQUIRE_THAT(pool.str(id), EQ("search"));
+        REQUIRE_THAT(pool.hash(id), EQ(ndash::hash<ndash::string> {}(ndash::string("search"))));
+    };
+
+    SECTION(test_empty_string) {
+        ndash::intern_pool pool;
+
+        auto id = pool.intern("");
+        REQUIRE_THAT(pool.length(id), EQ(0));
+        REQUIRE_THAT(pool.c_str(id)[0], EQ('\0'));
+        REQUIRE_THAT(pool.intern("", 0), EQ(id));
+    };
+
+    SECTION(test_rejects_oversized_strings) {
+        ndash::intern_pool pool;
+
+        // The length is checked before the string is read, so a short buffer is enough
+        bool thrown = false;
+        try {
+            pool.intern("term", size_t(UINT32_MAX) + 1);
+        } catch (const std::length_error&) {
+            thrown = true;
+        }
+        REQUIRE(thrown);
+        REQUIRE(pool.empty());
+    };
+
+    SECTION(test_pointers_stable_across_growth) {
+        ndash::intern_pool pool(4);
+
+        auto first = pool.intern("first");
+        const char* first_ptr = pool.c_str(first);
+
+        for (int i = 0; i < 10000; ++i) {
+            char buf[16];
+            int len = snprintf(buf, sizeof(buf), "term%d", i);
+            REQUIRE_THAT(pool.intern(buf, len), EQ((ndash::intern_pool::atom) i + 1));
+        }
+
+        REQUIRE_THAT(pool.size(), EQ(10001));
+        REQUIRE_THAT(pool.c_str(first), EQ(first_ptr));
+        REQUIRE_THAT(pool.find("first"), EQ(first));
+
+        for (int i = 0; i < 10000; ++i) {
+            char buf[16];
+            int len = snprintf(buf, sizeof(buf), "term%d", i);
+            REQUIRE_THAT(pool.find(buf, len), EQ((ndash::intern_pool::atom) i + 1));
+            REQUIRE_THAT(pool.length(i + 1), EQ((size_t) len));
+        }
+    };
+
+    SECTION(test_large_strings) {
+        ndash::intern_pool pool;
+
+        ndash::string big(100000, 'x');
+        auto small = pool.intern("small");
+        auto id = pool.intern(big);
+        auto after = pool.intern("after");
+
+        REQUIRE_THAT(pool.length(id), EQ(big.size()));
+        REQUIRE_THAT(pool.str(id), EQ(big));
+        REQUIRE_THAT(pool.str(small), EQ("small"));
+        REQUIRE_THAT(pool.str(after), EQ("after"));
+        REQUIRE_THAT(pool.bytes_used(), GT(big.size()));
+    };
+
+    SECTION(test_atoms_as_map_keys) {
+        ndash::intern_pool pool;
+        ndash::unordered_map<ndash::intern_pool::atom, int> counts;
+
+        const char* words[] = { "a", "b", "a", "c", "a", "b" };
+        for (const char* word : words) {
+            counts[pool.intern(word)]++;
+        }
+
+        REQUIRE_THAT(counts.size(), EQ(3));
+        REQUIRE_THAT(counts[pool.find("a")], EQ(3));
+        REQUIRE_THAT(counts[pool.find("b")], EQ(2));
+        REQUIRE_THAT(counts[pool.find("c")], EQ(1));
+    };
+
+    SECTION(test_concurrent_intern) {
+        constexpr const int num_threads = 4;
+        constexpr const int num_terms = 2000;
+
+        ndash::intern_pool pool(16);
+        ndash::vector<ndash::vector<ndash::intern_pool::atom>> ids(num_threads);
+
+        ndash::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&pool, &ids, t]() {
+                for (int i = 0; i < num_terms; ++i) {
+                    char buf[16];
+                    int len = snprintf(buf, sizeof(buf), "term%d", i);
+                    ids[t].push_back(pool.intern(buf, len));
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        REQUIRE_THAT(pool.size(), EQ(num_terms));
+        for (int t = 1; t < num_threads; ++t) {
+            for (int i = 0; i < num_terms; ++i) {
+                REQUIRE_THAT(ids[t][i], EQ(ids[0][i]));
+            }
+        }
+    };
+}
@@ -0,0 +1,124 @@
+#include <thread>
+
+#include "ndstring.h"
+#include "shared_string.h"
+#include "test_framework.h"
+#include "unordered_map.h"
+#include "vector.h"
+
+TEST_CASE(SharedString) {
+    SECTION(test_empty_shared_string) {
+        ndash::shared_string str;
+
+        REQUIRE(str.empty());
+        REQUIRE_THAT(str.size(), EQ(0));
+        REQUIRE_THAT(str.use_count(), EQ(0));
+        REQUIRE_THAT(str.c_str()[0], EQ('\0'));
+        REQUIRE_THAT(str.hash(), EQ(ndash::hash<ndash::string> {}(ndash::string())));
+        REQUIRE(str == ndash::shared_string(""));
+    };
+
+    SECTION(test_constructors) {
+        ndash::shared_string a("posting");
+        ndash::shared_string b("posting list", 7);
+        ndash::shared_string c(ndash::string("posting"));
+
+        REQUIRE_THAT(a.size(), EQ(7));
+        REQUIRE_THAT(b.size(), EQ(7));
+        REQUIRE_THAT(b.c_str()[7], EQ('\0'));
+        REQUIRE_THAT(a, EQ(b));
+        REQUIRE_THAT(a, EQ(c));
+        REQUIRE_THAT(a.str(), EQ("posting"));
+        REQUIRE_THAT(a[0], EQ('p'));
+        REQUIRE_THAT(a.front(), EQ('p'));
+        REQUIRE_THAT(a.back(), EQ('g'));
+    };
+
+    SECTION(test_copy_shares_storage) {
+        ndash::shared_string a("term");
+        REQUIRE_THAT(a.use_count(), EQ(1));
+
+        ndash::shared_string b(a);
+        REQUIRE_THAT(a.use_count(), EQ(2));
+        REQUIRE_THAT(b.data(), EQ(a.data()));
+
+        ndash::shared_string c;
+        c = b;
+        REQUIRE_THAT(a.use_count(), EQ(3));
+
+        ndash::shared_string d(std::move(c));
+        REQUIRE_THAT(a.use_count(), EQ(3));
+        REQUIRE(c.empty());
+
+        d = ndash::shared_string("other");
+        REQUIRE_THAT(a.use_count(), EQ(2));
+        REQUIRE_THAT(d, EQ("other"));
+
+        b = b;
+        REQUIRE_THAT(a.use_count(), EQ(2));
+    };
+
+    SECTION(test_hash_matches_string_hash) {
+        ndash::shared_string a("hello world");
+        ndash::string b("hello world");
+
+        REQUIRE_THAT(a.hash(), EQ(ndash::hash<ndash::string> {}(b)));
+        REQUIRE_THAT(ndash::hash<ndash::shared_string> {}(a), EQ(a.hash()));
+    };
+
+    SECTION(test_comparisons) {
+        ndash::shared_string a("apple");
+        ndash::shared_string b("banana");
+        ndash::shared_string c("app");
+
+        REQUIRE(a != b);
+        REQUIRE(a < b);
+        REQUIRE(b > a);
+        REQUIRE(c < a);
+        REQUIRE(a == ndash::string("apple"));
+        REQUIRE(a == "apple");
+        REQUIRE(a != "apples");
+        REQUIRE_THAT(a.compare("apple"), EQ(0));
+        REQUIRE_THAT(a.compare("apples"), LT(0));
+        REQUIRE_THAT(a.compare("ap"), GT(0));
+    };
+
+    SECTION(test_iterators) {
+        ndash::shared_string a("abc");
+        ndash::string copy(a.begin(), a.end());
+
+        REQUIRE_THAT(copy, EQ("abc"));
+        REQUIRE_THAT(a.end() - a.begin(), EQ(3));
+    };
+
+    SECTION(test_map_keys) {
+        ndash::unordered_map<ndash::shared_string, int> map;
+
+        ndash::shared_string term("index");
+        map[term] = 1;
+        map[ndash::shared_string("query")] = 2;
+
+        REQUIRE_THAT(map.size(), EQ(2));
+        REQUIRE_THAT(map[ndash::shared_string("index")], EQ(1));
+        REQUIRE(map.contains(ndash::shared_string("query")));
+        REQUIRE(!map.contains(ndash::shared_string("missing")));
+        REQUIRE_THAT(term.use_count(), EQ(2));
+    };
+
+    SECTION(test_concurrent_copies) {
+        ndash::shared_string term("shared across threads");
+
+        ndash::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&term]() {
+                for (int i = 0; i < 10000; ++i) {
+                    ndash::shared_string copy(term);
+                    ndash::shared_string other = copy;
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        REQUIRE_THAT(term.use_count(), EQ(1));
+    };
+}
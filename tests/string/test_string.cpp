@@ -90,6 +90,11 @@ TEST_CASE(String) {
         REQUIRE_THAT(str.size(), NEQ(4));
         REQUIRE_THAT(moved.c_str(), EQ(str_loc));
 
+        // A moved-from string reads as empty
+        REQUIRE_THAT(str.size(), EQ(0));
+        REQUIRE_THAT(str.capacity(), EQ(0));
+        REQUIRE(str.empty());
+
         for (int i = 0; i < 5; ++i) {
             REQUIRE_THAT(moved[i], EQ(copy[i]));
         }
@@ -125,6 +130,11 @@ TEST_CASE(String) {
         REQUIRE_THAT(str.size(), NEQ(4));
         REQUIRE_THAT(moved.c_str(), EQ(str_loc));
 
+        // A moved-from string reads as empty
+        REQUIRE_THAT(str.size(), EQ(0));
+        REQUIRE_THAT(str.capacity(), EQ(0));
+        REQUIRE(str.empty());
+
         for (int i = 0; i < 5; ++i) {
             REQUIRE_THAT(moved[i], EQ(copy[i]));
         }
@@ -537,4 +547,56 @@ TEST_CASE(String) {
         REQUIRE(str.contains('q'));
         REQUIRE(!str.contains('z'));
     };
+
+    SECTION(test_range_construction_allocates_once) {
+        const char* text = "inverted index";
+
+        ndash::string str(text, 8);
+        REQUIRE_THAT(str, EQ("inverted"));
+        REQUIRE_THAT(str.capacity(), EQ(str.size()));
+
+        ndash::string copy(str);
+        REQUIRE_THAT(copy, EQ(str));
+        REQUIRE(copy.data() != str.data());
+
+        ndash::string from_iterators(str.begin() + 2, str.end());
+        REQUIRE_THAT(from_iterators, EQ("verted"));
+        REQUIRE_THAT(from_iterators.capacity(), EQ(from_iterators.size()));
+
+        ndash::string filled(4, 'z');
+        REQUIRE_THAT(filled, EQ("zzzz"));
+        REQUIRE_THAT(filled.capacity(), EQ(4));
+    };
+
+    SECTION(test_assign) {
+        ndash::string str("a long string that needs storage");
+        const char* storage = str.data();
+
+        str.assign("short", 5);
+        REQUIRE_THAT(str, EQ("short"));
+        REQUIRE_THAT(str.data(), EQ(storage));
+
+        str = "replaced";
+        REQUIRE_THAT(str, EQ("replaced"));
+        REQUIRE_THAT(str.size(), EQ(8));
+
+        str = { 'a', 'b' };
+        REQUIRE_THAT(str, EQ("ab"));
+        REQUIRE_THAT(ndash::strlen(str.c_str()), EQ(2));
+    };
+
+    SECTION(test_assign_self) {
+        ndash::string str("abcdef");
+        str.assign(str.data() + 1, str.data() + 3);
+        REQUIRE_THAT(str, EQ("bc"));
+        REQUIRE_THAT(str.size(), EQ(2));
+
+        ndash::string whole("a long string that needs storage");
+        whole.assign(whole.begin(), whole.end());
+        REQUIRE_THAT(whole, EQ("a long string that needs storage"));
+
+        whole.assign(whole.data() + 7, whole.size() - 7);
+        REQUIRE_THAT(whole, EQ("string that needs storage"));
+        REQUIRE_THAT(ndash::strlen(whole.c_str()), EQ(25));
+    };
 }
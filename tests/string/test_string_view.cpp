@@ -0,0 +1,77 @@
+#include "ndstring.h"
+#include "string_view.h"
+#include "test_framework.h"
+#include "unordered_map.h"
+
+TEST_CASE(StringView) {
+    SECTION(test_empty_view) {
+        ndash::string_view view;
+
+        REQUIRE(view.empty());
+        REQUIRE_THAT(view.size(), EQ(0));
+        REQUIRE(view == ndash::string_view(""));
+    };
+
+    SECTION(test_constructors) {
+        const char* text = "document body";
+        ndash::string str(text);
+
+        ndash::string_view a(text);
+        ndash::string_view b(text, 8);
+        ndash::string_view c(str);
+
+        REQUIRE_THAT(a.size(), EQ(13));
+        REQUIRE_THAT(b.size(), EQ(8));
+        REQUIRE_THAT(c.data(), EQ(str.data()));
+        REQUIRE(a == c);
+        REQUIRE(a != b);
+        REQUIRE_THAT(b.str(), EQ("document"));
+        REQUIRE_THAT(a.front(), EQ('d'));
+        REQUIRE_THAT(a.back(), EQ('y'));
+    };
+
+    SECTION(test_substr_and_prefix) {
+        ndash::string_view view("alpha beta gamma");
+
+        REQUIRE(view.substr(6, 4) == ndash::string_view("beta"));
+        REQUIRE(view.substr(11) == ndash::string_view("gamma"));
+        REQUIRE(view.substr(11, 100) == ndash::string_view("gamma"));
+        REQUIRE_THAT(view.find(' '), EQ(5));
+        REQUIRE_THAT(view.find('z'), EQ(ndash::string_view::npos));
+
+        view.remove_prefix(6);
+        view.remove_suffix(6);
+        REQUIRE(view == ndash::string_view("beta"));
+        REQUIRE(view.starts_with("be"));
+        REQUIRE(view.ends_with("ta"));
+        REQUIRE(!view.starts_with("beta!"));
+    };
+
+    SECTION(test_empty_affixes) {
+        ndash::string_view empty;
+        REQUIRE(empty.starts_with(empty));
+        REQUIRE(empty.ends_with(empty));
+        REQUIRE(ndash::string_view("beta").starts_with(empty));
+        REQUIRE(ndash::string_view("beta").ends_with(empty));
+        REQUIRE(!empty.starts_with("b"));
+        REQUIRE(!empty.ends_with("a"));
+    };
+
+    SECTION(test_comparisons) {
+        REQUIRE(ndash::string_view("abc") < ndash::string_view("abd"));
+        REQUIRE(ndash::string_view("ab") < ndash::string_view("abc"));
+        REQUIRE(ndash::string_view("b") > ndash::string_view("abc"));
+        REQUIRE_THAT(ndash::string_view("abc").compare("abc"), EQ(0));
+    };
+
+    SECTION(test_hash_and_map_keys) {
+        ndash::string owner("term");
+        ndash::string_view view(owner);
+
+        REQUIRE_THAT(ndash::hash<ndash::string_view> {}(view), EQ(ndash::hash<ndash::string> {}(owner)));
+
+        ndash::unordered_map<ndash::string_view, int> map;
+        map[view] = 3;
+        REQUIRE_THAT(map[ndash::string_view("term")], EQ(3));
+    };
+}
@@ -0,0 +1,173 @@
+#include <random>
+
+#include "ndstring.h"
+#include "string_view.h"
+#include "test_framework.h"
+#include "tokenizer.h"
+#include "vector.h"
+
+// Byte at a time reference tokenizer
+static ndash::vector<ndash::token> reference_tokenize(const ndash::tokenizer& tok, const ndash::string& text) {
+    ndash::vector<ndash::token> tokens;
+    size_t start = 0;
+    bool in_token = false;
+    for (size_t i = 0; i <= text.size(); ++i) {
+        bool delimiter = i == text.size() || tok.is_delimiter(text[i]);
+        if (in_token && delimiter) tokens.push_back({ start, i - start });
+        if (!in_token && !delimiter) start = i;
+        in_token = !delimiter;
+    }
+    return tokens;
+}
+
+TEST_CASE(Tokenizer) {
+    SECTION(test_empty_text) {
+        ndash::tokenizer tok;
+
+        REQUIRE(tok.tokenize("").empty());
+        REQUIRE(tok.tokenize("   ,,, \n").empty());
+        REQUIRE_THAT(tok.count(""), EQ(0));
+    };
+
+    SECTION(test_simple_sentence) {
+        ndash::tokenizer tok;
+        ndash::string text("The quick, brown fox!");
+
+        auto tokens = tok.tokenize(text);
+        REQUIRE_THAT(tokens.size(), EQ(4));
+        REQUIRE(tokens[0].view(text.data()) == ndash::string_view("The"));
+        REQUIRE(tokens[1].view(text.data()) == ndash::string_view("quick"));
+        REQUIRE(tokens[2].view(text.data()) == ndash::string_view("brown"));
+        REQUIRE(tokens[3].view(text.data()) == ndash::string_view("fox"));
+        REQUIRE_THAT(tokens[1].offset, EQ(4));
+        REQUIRE_THAT(tokens[1].length, EQ(5));
+    };
+
+    SECTION(test_token_at_edges) {
+        ndash::tokenizer tok;
+        ndash::string text("edge");
+
+        auto tokens = tok.tokenize(text);
+        REQUIRE_THAT(tokens.size(), EQ(1));
+        REQUIRE_THAT(tokens[0].offset, EQ(0));
+        REQUIRE_THAT(tokens[0].length, EQ(4));
+    };
+
+    SECTION(test_delimiter_classes) {
+        ndash::string text("abc123 def-456");
+
+        ndash::tokenizer whitespace(ndash::tokenizer::WHITESPACE);
+        REQUIRE_THAT(whitespace.count(text), EQ(2));
+
+        ndash::tokenizer with_punctuation(ndash::tokenizer::WHITESPACE | ndash::tokenizer::PUNCTUATION);
+        REQUIRE_THAT(with_punctuation.count(text), EQ(3));
+
+        ndash::tokenizer with_digits(ndash::tokenizer::WHITESPACE | ndash::tokenizer::PUNCTUATION
+                                     | ndash::tokenizer::DIGITS);
+        auto tokens = with_digits.tokenize(text);
+        REQUIRE_THAT(tokens.size(), EQ(2));
+        REQUIRE(tokens[0].view(text.data()) == ndash::string_view("abc"));
+        REQUIRE(tokens[1].view(text.data()) == ndash::string_view("def"));
+    };
+
+    SECTION(test_custom_delimiters) {
+        ndash::tokenizer tok(ndash::tokenizer::WHITESPACE);
+        tok.add_delimiter('|');
+        REQUIRE(tok.is_delimiter('|'));
+        REQUIRE_THAT(tok.count("a|b c|d"), EQ(4));
+
+        ndash::tokenizer keep_hyphens;
+        keep_hyphens.remove_delimiter('-');
+        REQUIRE(!keep_hyphens.is_delimiter('-'));
+        REQUIRE_THAT(keep_hyphens.count("state-of-the-art search"), EQ(2));
+    };
+
+    SECTION(test_utf8_words_stay_whole) {
+        ndash::tokenizer tok;
+        ndash::string text("caf\xC3\xA9 na\xC3\xAFve \xE4\xB8\xAD\xE6\x96\x87");
+
+        auto tokens = tok.tokenize(text);
+        REQUIRE_THAT(tokens.size(), EQ(3));
+        REQUIRE(tokens[0].view(text.data()) == ndash::string_view("caf\xC3\xA9"));
+        REQUIRE(tokens[2].view(text.data()) == ndash::string_view("\xE4\xB8\xAD\xE6\x96\x87"));
+        REQUIRE(!tok.is_delimiter('\xC3'));
+    };
+
+    SECTION(test_matches_reference) {
+        ndash::tokenizer tok;
+        std::mt19937 rng(1234);
+        const char alphabet[] = "aZ9 ,.\n\t-\xC3\xA9";
+
+        for (int round = 0; round < 200; ++round) {
+            ndash::string text;
+            size_t len = rng() % 300;
+            for (size_t i = 0; i < len; ++i) text.push_back(alphabet[rng() % (sizeof(alphabet) - 1)]);
+
+            auto expected = reference_tokenize(tok, text);
+            auto actual = tok.tokenize(text);
+            REQUIRE_THAT(actual.size(), EQ(expected.size()));
+            for (size_t i = 0; i < actual.size(); ++i) {
+                REQUIRE(actual[i] == expected[i]);
+            }
+        }
+    };
+
+    SECTION(test_long_token_across_blocks) {
+        ndash::tokenizer tok;
+        ndash::string text(" ");
+        text.append(200, 'x');
+        text.append(" y");
+
+        auto tokens = tok.tokenize(text);
+        REQUIRE_THAT(tokens.size(), EQ(2));
+        REQUIRE_THAT(tokens[0].offset, EQ(1));
+        REQUIRE_THAT(tokens[0].length, EQ(200));
+        REQUIRE_THAT(tokens[1].offset, EQ(202));
+    };
+
+    SECTION(test_streaming) {
+        ndash::tokenizer tok;
+        ndash::string text("streaming tokens across buffer boundaries, including a verylongtokenthatspans "
+                           "several buffers and ends here.");
+        auto expected = reference_tokenize(tok, text);
+
+        for (size_t chunk = 1; chunk < 40; chunk += 3) {
+            ndash::tokenizer::stream stream(tok);
+            ndash::vector<ndash::string> words;
+            ndash::vector<size_t> offsets;
+            auto collect = [&](ndash::string_view word, size_t offset) {
+                words.push_back(word.str());
+                offsets.push_back(offset);
+            };
+
+            for (size_t pos = 0; pos < text.size(); pos += chunk) {
+                size_t n = text.size() - pos < chunk ? text.size() - pos : chunk;
+                stream.feed(text.data() + pos, n, collect);
+            }
+            stream.finish(collect);
+
+            REQUIRE_THAT(words.size(), EQ(expected.size()));
+            for (size_t i = 0; i < words.size(); ++i) {
+                REQUIRE(ndash::string_view(words[i]) == expected[i].view(text.data()));
+                REQUIRE_THAT(offsets[i], EQ(expected[i].offset));
+            }
+        }
+    };
+
+    SECTION(test_streaming_trailing_token) {
+        ndash::tokenizer tok;
+        ndash::tokenizer::stream stream(tok);
+        ndash::vector<ndash::string> words;
+        auto collect = [&](ndash::string_view word, size_t) { words.push_back(word.str()); };
+
+        stream.feed(ndash::string_view("hello wor"), collect);
+        stream.feed(ndash::string_view("ld"), collect);
+        REQUIRE_THAT(words.size(), EQ(1));
+        REQUIRE_THAT(stream.consumed(), EQ(11));
+
+        stream.finish(collect);
+        REQUIRE_THAT(words.size(), EQ(2));
+        REQUIRE_THAT(words[1], EQ("world"));
+        REQUIRE_THAT(stream.consumed(), EQ(0));
+    };
+}
@@ -0,0 +1,147 @@
+#include "ndstring.h"
+#include "string_view.h"
+#include "test_framework.h"
+#include "utf8.h"
+
+TEST_CASE(Utf8) {
+    SECTION(test_validate_ascii) {
+        REQUIRE(ndash::utf8::validate(""));
+        REQUIRE(ndash::utf8::validate(ndash::string("plain ascii text")));
+        REQUIRE(ndash::utf8::validate(ndash::string(1000, 'a')));
+    };
+
+    SECTION(test_validate_multibyte) {
+        REQUIRE(ndash::utf8::validate("caf\xC3\xA9"));                 // é
+        REQUIRE(ndash::utf8::validate("\xE2\x82\xAC"));                // €
+        REQUIRE(ndash::utf8::validate("\xF0\x9F\x94\x8D search"));     // 🔍
+        REQUIRE(ndash::utf8::validate("\xF4\x8F\xBF\xBF"));            // U+10FFFF
+        REQUIRE(ndash::utf8::validate("\xED\x9F\xBF"));                // U+D7FF
+    };
+
+    SECTION(test_validate_rejects_invalid) {
+        REQUIRE(!ndash::utf8::validate("\x80"));                       // Lone continuation
+        REQUIRE(!ndash::utf8::validate("\xC3"));                       // Truncated
+        REQUIRE(!ndash::utf8::validate("\xC0\xAF"));                   // Overlong 2 byte
+        REQUIRE(!ndash::utf8::validate("\xE0\x80\xAF"));               // Overlong 3 byte
+        REQUIRE(!ndash::utf8::validate("\xF0\x80\x80\xAF"));           // Overlong 4 byte
+        REQUIRE(!ndash::utf8::validate("\xED\xA0\x80"));               // Surrogate
+        REQUIRE(!ndash::utf8::validate("\xF4\x90\x80\x80"));           // Above U+10FFFF
+        REQUIRE(!ndash::utf8::validate("\xF5\x80\x80\x80"));           // Invalid lead
+        REQUIRE(!ndash::utf8::validate("\xE2\x82"));                   // Truncated
+        REQUIRE(!ndash::utf8::validate("a\xC3\xA9\xA9"));              // Extra continuation
+    };
+
+    SECTION(test_validate_across_blocks) {
+        // Place a multibyte sequence across every offset of a 32 byte block boundary
+        for (size_t offset = 0; offset < 40; ++offset) {
+            ndash::string valid(offset, 'x');
+            valid.append("\xF0\x9F\x94\x8D");
+            valid.append(40, 'y');
+            REQUIRE(ndash::utf8::validate(valid));
+
+            ndash::string truncated(offset, 'x');
+            truncated.append("\xF0\x9F\x94");
+            REQUIRE(!ndash::utf8::validate(truncated));
+
+            ndash::string broken(offset, 'x');
+            broken.append("\xF0\x9F\x94");
+            broken.append(40, 'y');
+            REQUIRE(!ndash::utf8::validate(broken));
+        }
+    };
+
+    SECTION(test_validate_string_view) {
+        ndash::string str("ok \xC3\xA9 \xC3");
+        REQUIRE(ndash::utf8::validate(ndash::string_view(str.data(), 5)));
+        REQUIRE(!ndash::utf8::validate(ndash::string_view(str)));
+    };
+
+    SECTION(test_to_lower_ascii) {
+        ndash::string str("Hello WORLD, Caf\xC3\x89 [@Z]");
+        ndash::string expected("hello world, caf\xC3\x89 [@z]");
+
+        char dst[64];
+        ndash::utf8::to_lower_ascii(ndash::string_view(str), dst);
+        REQUIRE_THAT(ndash::string(dst, str.size()), EQ(expected));
+
+        ndash::utf8::to_lower_ascii(str);
+        REQUIRE_THAT(str, EQ(expected));
+    };
+
+    SECTION(test_to_lower_ascii_long) {
+        ndash::string str;
+        for (int i = 0; i < 100; ++i) str.push_back(static_cast<char>('A' + i % 26));
+        ndash::utf8::to_lower_ascii(str);
+
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE_THAT(str[i], EQ(static_cast<char>('a' + i % 26)));
+        }
+    };
+
+    SECTION(test_fold_code_points) {
+        REQUIRE(ndash::utf8::fold_case(U'A') == U'a');
+        REQUIRE(ndash::utf8::fold_case(U'z') == U'z');
+        REQUIRE(ndash::utf8::fold_case(U'É') == U'é');     // É
+        REQUIRE(ndash::utf8::fold_case(U'Ÿ') == U'ÿ');     // Ÿ
+        REQUIRE(ndash::utf8::fold_case(U'Ā') == U'ā');     // Ā
+        REQUIRE(ndash::utf8::fold_case(U'ā') == U'ā');     // ā
+        REQUIRE(ndash::utf8::fold_case(U'Σ') == U'σ');     // Σ
+        REQUIRE(ndash::utf8::fold_case(U'ς') == U'σ');     // ς
+        REQUIRE(ndash::utf8::fold_case(U'Ж') == U'ж');     // Ж
+        REQUIRE(ndash::utf8::fold_case(U'ẞ') == U'ß');     // ẞ
+        REQUIRE(ndash::utf8::fold_case(U'K') == U'k');          // Kelvin sign
+        REQUIRE(ndash::utf8::fold_case(U'Ａ') == U'ａ');     // Fullwidth A
+        REQUIRE(ndash::utf8::fold_case(U'\U00010400') == U'\U00010428');   // Deseret
+        REQUIRE(ndash::utf8::fold_case(U'中') == U'中');     // No folding
+    };
+
+    SECTION(test_fold_case_buffer) {
+        const char* src = "\xC3\x89T\xC3\x89 \xD0\x96\xD0\x98\xD0\x97\xD0\xAC \xE2\x84\xAA";   // ÉTÉ ЖИЗЬ K
+        const char* expected = "\xC3\xA9t\xC3\xA9 \xD0\xB6\xD0\xB8\xD0\xB7\xD1\x8C k";
+        size_t len = ndash::strlen(src);
+
+        char dst[64];
+        size_t written = ndash::utf8::fold_case(src, len, dst);
+        REQUIRE_THAT(ndash::string(dst, written), EQ(expected));
+        REQUIRE_THAT(written, EQ(ndash::strlen(expected)));
+    };
+
+    SECTION(test_fold_case_in_place) {
+        ndash::string str("The QUICK Brown \xCE\xA3\xCE\xA9\xCE\xA3 Fox Jumps Over The LAZY \xC3\x84rger Dog");
+        ndash::utf8::fold_case(str);
+        REQUIRE_THAT(str, EQ("the quick brown \xCF\x83\xCF\x89\xCF\x83 fox jumps over the lazy \xC3\xA4rger dog"));
+
+        // Kelvin sign shrinks from three bytes to one
+        ndash::string kelvin("\xE2\x84\xAA\xE2\x84\xAA");
+        ndash::utf8::fold_case(kelvin);
+        REQUIRE_THAT(kelvin, EQ("kk"));
+    };
+
+    SECTION(test_fold_case_grows) {
+        // U+023A folds to U+2C65, growing from two bytes to three
+        ndash::string str("A\xC8\xBA" "B");
+        ndash::utf8::fold_case(str);
+        REQUIRE_THAT(str.size(), EQ(5));
+        REQUIRE_THAT(str, EQ("a\xE2\xB1\xA5" "b"));
+
+        char buffer[ndash::utf8::max_fold_size(4)] = "A\xC8\xBA" "B";
+        REQUIRE_THAT(ndash::utf8::fold_case(buffer, 4), EQ(5));
+        REQUIRE_THAT(ndash::string(buffer, 5), EQ("a\xE2\xB1\xA5" "b"));
+    };
+
+    SECTION(test_fold_case_keeps_invalid_bytes) {
+        ndash::string str("AB\xFF" "C");
+        ndash::utf8::fold_case(str);
+        REQUIRE_THAT(str, EQ("ab\xFF" "c"));
+    };
+
+    SECTION(test_normalize) {
+        ndash::string valid("Caf\xC3\x89");
+        REQUIRE(ndash::utf8::normalize(valid));
+        REQUIRE_THAT(valid, EQ("caf\xC3\xA9"));
+
+        ndash::string invalid("Caf\xC3");
+        REQUIRE(!ndash::utf8::normalize(invalid));
+        REQUIRE_THAT(invalid, EQ("Caf\xC3"));
+    };
+}